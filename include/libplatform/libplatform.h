@@ -14,6 +14,19 @@ namespace platform {
 
 enum class IdleTaskSupport { kDisabled, kEnabled };
 
+/**
+ * Queueing statistics of the background tasks of a platform created using
+ * |CreateDefaultPlatform|. Short and long running tasks are queued in
+ * separate lanes, see |v8::Platform::ExpectedRuntime|.
+ */
+struct BackgroundTaskQueueStatistics {
+  size_t short_running_tasks_run = 0;
+  size_t long_running_tasks_run = 0;
+  // Time between posting a task and a worker thread picking it up.
+  double total_queue_time_in_seconds = 0;
+  double max_queue_time_in_seconds = 0;
+};
+
 /**
  * Returns a new instance of the default v8::Platform implementation.
  *
@@ -60,6 +73,13 @@ V8_PLATFORM_EXPORT void SetTracingController(
     v8::Platform* platform,
     v8::platform::tracing::TracingController* tracing_controller);
 
+/**
+ * Retrieves the queueing statistics of the background tasks. The |platform|
+ * has to be created using |CreateDefaultPlatform|.
+ */
+V8_PLATFORM_EXPORT void GetBackgroundTaskQueueStatistics(
+    v8::Platform* platform, BackgroundTaskQueueStatistics* statistics);
+
 }  // namespace platform
 }  // namespace v8
 
@@ -15,6 +15,7 @@
 namespace v8 {
 
 class HeapGraphNode;
+class OutputStream;
 struct HeapStatsUpdate;
 
 typedef uint32_t SnapshotObjectId;
@@ -311,6 +312,26 @@ class V8_EXPORT CpuProfiler {
    */
   void StartProfiling(Local<String> title, bool record_samples = false);
 
+  /**
+   * Starts collecting a CPU profile like |StartProfiling| with samples
+   * recorded, but delivers the profile incrementally to |stream| instead of
+   * keeping all samples until the profile is stopped. This allows a profiler
+   * to run continuously with bounded memory.
+   *
+   * The stream receives newline-separated JSON objects in the format of the
+   * "Profile" and "ProfileChunk" trace events: the start time, chunks of newly
+   * created nodes, sample node ids and sample time deltas, and the end time.
+   * Chunks are written on the profiler thread, the last chunk and
+   * |OutputStream::EndOfStream| are written by |StopProfiling|. The profile
+   * returned by |StopProfiling| contains the aggregated tree but no samples.
+   * The stream must stay alive until the profile is stopped.
+   *
+   * Returns false if the profile was not started, e.g. because a profile
+   * with the same title is already being collected. The stream is not used
+   * in that case.
+   */
+  bool StartStreamingProfiling(Local<String> title, OutputStream* stream);
+
   /**
    * Stops collecting CPU profile with a given title and returns it.
    * If the title given is empty, finishes the last profile started.
@@ -460,7 +481,8 @@ class V8_EXPORT OutputStream {  // NOLINT
 class V8_EXPORT HeapSnapshot {
  public:
   enum SerializationFormat {
-    kJSON = 0  // See format description near 'Serialize' method.
+    kJSON = 0,   // See format description near 'Serialize' method.
+    kBinary = 1  // Compact format, see 'ConvertBinaryToJSON'.
   };
 
   /** Returns the root node of the heap graph. */
@@ -510,9 +532,24 @@ class V8_EXPORT HeapSnapshot {
    *
    * Nodes reference strings, other nodes, and edges by their indexes
    * in corresponding arrays.
+   *
+   * The binary format contains the same data in a varint encoding and is
+   * typically several times smaller than the JSON format. Its chunks are
+   * passed to |OutputStream::WriteAsciiChunk| but contain arbitrary bytes.
+   * Both formats are written from the complete in-memory snapshot, so the
+   * choice of format does not change the memory needed to take a snapshot.
    */
   void Serialize(OutputStream* stream,
                  SerializationFormat format = kJSON) const;
+
+  /**
+   * Converts a snapshot serialized in the binary format into the JSON format
+   * and writes it into the stream. Returns false if |data| is not a valid
+   * binary snapshot or if writing was aborted. Can be used without an
+   * isolate, e.g. by tools that process snapshots offline.
+   */
+  static bool ConvertBinaryToJSON(const char* data, size_t length,
+                                  OutputStream* stream);
 };
 
 
@@ -1408,6 +1408,49 @@ class V8_EXPORT ScriptCompiler {
    */
   static uint32_t CachedDataVersionTag();
 
+  /**
+   * Creates a blob with the type feedback, invocation counts and optimization
+   * decisions that were collected for the functions of |unbound_script| so
+   * far. Passing the blob to ConsumeFeedbackCache when the same script is
+   * compiled in a later run lets V8 optimize the functions that were hot
+   * without warming them up again. |source| must be the source string the
+   * script was compiled from. The caller takes ownership of the result.
+   *
+   * Only feedback that doesn't refer to objects of the heap is kept, so the
+   * blob is small, but it is tied to the V8 version and flags like the code
+   * cache.
+   */
+  static CachedData* CreateFeedbackCache(Local<UnboundScript> unbound_script,
+                                         Local<String> source);
+
+  /**
+   * Imports a blob created by CreateFeedbackCache for |unbound_script|. This
+   * is best done right after compiling the script and before running it.
+   * Returns false and sets |cached_data->rejected| if the blob was created
+   * for a different source, V8 version or set of flags.
+   */
+  static bool ConsumeFeedbackCache(Local<UnboundScript> unbound_script,
+                                   Local<String> source,
+                                   CachedData* cached_data);
+
+  /**
+   * Returns a copy of |code_cache|, which must have been produced for
+   * |unbound_script| with kProduceCodeCache, that also carries a recipe for
+   * the optimized code of the script. The recipe consists of the feedback
+   * and tier-up decisions collected so far (see CreateFeedbackCache), so this
+   * is best called once the script has warmed up.
+   *
+   * When the result is consumed with kConsumeCodeCache, the recipe is checked
+   * against the source, V8 version and flags. The functions that were
+   * optimized and whose feedback doesn't depend on maps or other objects of
+   * the previous run are then compiled with TurboFan on their first call.
+   * Returns nullptr if |code_cache| doesn't match |unbound_script|. The caller
+   * takes ownership of the result.
+   */
+  static CachedData* CreateOptimizedCodeCache(
+      Local<UnboundScript> unbound_script, Local<String> source,
+      const CachedData* code_cache);
+
   /**
    * This is an unfinished experimental feature, and is only exposed
    * here for internal testing purposes. DO NOT USE.
@@ -6320,6 +6363,49 @@ enum JitCodeEventOptions {
  */
 typedef void (*JitCodeEventHandler)(const JitCodeEvent* event);
 
+/**
+ * A compilation statistics event is issued each time an optimizing compiler
+ * finishes compiling a function.
+ */
+struct CompilationStatisticsEvent {
+  struct Phase {
+    // Name of the phase, as printed by --turbo-stats.
+    const char* name;
+    // Wall time spent in the phase.
+    double time_in_ms;
+    // Peak zone memory in use during the phase.
+    size_t max_allocated_bytes;
+  };
+
+  // Name of the compiler that produced the code, e.g. "TurboFan".
+  const char* tier;
+  // Name of the compiled function.
+  const char* function_name;
+  // Id of the script that contains the function, or -1.
+  int script_id;
+  // Start position of the function in the script, or -1.
+  int start_position;
+  // Wall time spent in all phases.
+  double time_in_ms;
+  // Peak zone memory in use during the compilation.
+  size_t max_allocated_bytes;
+  // Size of the generated code including metadata.
+  size_t code_size;
+  // Number of functions that were inlined into the function.
+  int inlined_function_count;
+  // Number of times the function was deoptimized before.
+  int deopt_count;
+  // The phases of the compilation in the order they ran.
+  const Phase* phases;
+  size_t phase_count;
+};
+
+/**
+ * Callback function passed to SetCompilationStatisticsCallback.
+ */
+typedef void (*CompilationStatisticsCallback)(
+    Isolate* isolate, const CompilationStatisticsEvent* event);
+
 
 /**
  * Interface for iterating through all external resources in the heap.
@@ -6486,7 +6572,8 @@ class V8_EXPORT Isolate {
           add_histogram_sample_callback(nullptr),
           array_buffer_allocator(nullptr),
           external_references(nullptr),
-          allow_atomics_wait(true) {}
+          allow_atomics_wait(true),
+          stub_cache_primary_table_bits(0) {}
 
     /**
      * The optional entry_hook allows the host application to provide the
@@ -6549,6 +6636,14 @@ class V8_EXPORT Isolate {
      * this isolate.
      */
     bool allow_atomics_wait;
+
+    /**
+     * The number of entries of the primary megamorphic stub cache table as a
+     * power of two, e.g. 11 for 2048 entries. Applications with many
+     * megamorphic property accesses benefit from larger tables. 0 selects
+     * the default size.
+     */
+    int stub_cache_primary_table_bits;
   };
 
 
@@ -7265,6 +7360,21 @@ class V8_EXPORT Isolate {
   void SetJitCodeEventHandler(JitCodeEventOptions options,
                               JitCodeEventHandler event_handler);
 
+  /**
+   * Allows the host application to collect per-function statistics about
+   * optimizing compilations, i.e. the time and zone memory used by each
+   * compiler phase, the generated code size and the number of inlined
+   * functions. Pass NULL to stop collecting statistics.
+   *
+   * \note \p callback is invoked on the thread of the isolate after the
+   *     code was generated. The event and the strings it points to are not
+   *     guaranteed to live past the call.
+   * \note \p callback must not execute JavaScript.
+   * \note No statistics are collected while no callback is installed.
+   */
+  void SetCompilationStatisticsCallback(
+      CompilationStatisticsCallback callback);
+
   /**
    * Modifies the stack limit for this Isolate.
    *
@@ -62,6 +62,7 @@
 #include "src/runtime/runtime.h"
 #include "src/simulator.h"
 #include "src/snapshot/code-serializer.h"
+#include "src/snapshot/feedback-serializer.h"
 #include "src/snapshot/natives.h"
 #include "src/snapshot/snapshot.h"
 #include "src/startup-data-util.h"
@@ -2481,6 +2482,65 @@ uint32_t ScriptCompiler::CachedDataVersionTag() {
       static_cast<uint32_t>(internal::CpuFeatures::SupportedFeatures())));
 }
 
+ScriptCompiler::CachedData* ScriptCompiler::CreateFeedbackCache(
+    Local<UnboundScript> unbound_script, Local<String> source) {
+  i::Handle<i::SharedFunctionInfo> shared =
+      i::Handle<i::SharedFunctionInfo>::cast(
+          Utils::OpenHandle(*unbound_script));
+  i::Isolate* isolate = shared->GetIsolate();
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  i::Handle<i::Script> script(i::Script::cast(shared->script()), isolate);
+  i::ScriptData* script_data = i::FeedbackSerializer::Serialize(
+      isolate, script, Utils::OpenHandle(*source));
+  CachedData* result = new CachedData(
+      script_data->data(), script_data->length(), CachedData::BufferOwned);
+  script_data->ReleaseDataOwnership();
+  delete script_data;
+  return result;
+}
+
+bool ScriptCompiler::ConsumeFeedbackCache(Local<UnboundScript> unbound_script,
+                                          Local<String> source,
+                                          CachedData* cached_data) {
+  i::Handle<i::SharedFunctionInfo> shared =
+      i::Handle<i::SharedFunctionInfo>::cast(
+          Utils::OpenHandle(*unbound_script));
+  i::Isolate* isolate = shared->GetIsolate();
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  i::Handle<i::Script> script(i::Script::cast(shared->script()), isolate);
+  // ScriptData takes care of pointer-aligning the data.
+  i::ScriptData script_data(cached_data->data, cached_data->length);
+  bool result = i::FeedbackSerializer::Deserialize(
+      isolate, &script_data, script, Utils::OpenHandle(*source), false,
+      true);
+  cached_data->rejected = script_data.rejected();
+  return result;
+}
+
+ScriptCompiler::CachedData* ScriptCompiler::CreateOptimizedCodeCache(
+    Local<UnboundScript> unbound_script, Local<String> source,
+    const CachedData* code_cache) {
+  i::Handle<i::SharedFunctionInfo> shared =
+      i::Handle<i::SharedFunctionInfo>::cast(
+          Utils::OpenHandle(*unbound_script));
+  i::Isolate* isolate = shared->GetIsolate();
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  i::Handle<i::Script> script(i::Script::cast(shared->script()), isolate);
+  // ScriptData takes care of pointer-aligning the data.
+  i::ScriptData code_data(code_cache->data, code_cache->length);
+  i::ScriptData* script_data = i::CodeSerializer::AttachOptimizationRecipe(
+      isolate, &code_data, script, Utils::OpenHandle(*source));
+  if (script_data == nullptr) return nullptr;
+  CachedData* result = new CachedData(
+      script_data->data(), script_data->length(), CachedData::BufferOwned);
+  script_data->ReleaseDataOwnership();
+  delete script_data;
+  return result;
+}
+
 
 MaybeLocal<Script> Script::Compile(Local<Context> context, Local<String> source,
                                    ScriptOrigin* origin) {
@@ -8231,6 +8291,8 @@ Isolate* Isolate::New(const Isolate::CreateParams& params) {
 
   isolate->set_api_external_references(params.external_references);
   isolate->set_allow_atomics_wait(params.allow_atomics_wait);
+  isolate->set_stub_cache_primary_table_bits(
+      params.stub_cache_primary_table_bits);
   SetResourceConstraints(isolate, params.constraints);
   // TODO(jochen): Once we got rid of Isolate::Current(), we can remove this.
   Isolate::Scope isolate_scope(v8_isolate);
@@ -8452,6 +8514,13 @@ void Isolate::SetEventLogger(LogEventCallback that) {
 }
 
 
+void Isolate::SetCompilationStatisticsCallback(
+    CompilationStatisticsCallback callback) {
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  isolate->set_compilation_statistics_callback(callback);
+}
+
+
 void Isolate::AddBeforeCallEnteredCallback(BeforeCallEnteredCallback callback) {
   if (callback == NULL) return;
   i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
@@ -9839,6 +9908,13 @@ void CpuProfiler::StartProfiling(Local<String> title, bool record_samples) {
 }
 
 
+bool CpuProfiler::StartStreamingProfiling(Local<String> title,
+                                          OutputStream* stream) {
+  return reinterpret_cast<i::CpuProfiler*>(this)->StartProfiling(
+      *Utils::OpenHandle(*title), true, stream);
+}
+
+
 CpuProfile* CpuProfiler::StopProfiling(Local<String> title) {
   return reinterpret_cast<CpuProfile*>(
       reinterpret_cast<i::CpuProfiler*>(this)->StopProfiling(
@@ -9989,17 +10065,32 @@ SnapshotObjectId HeapSnapshot::GetMaxSnapshotJSObjectId() const {
 
 void HeapSnapshot::Serialize(OutputStream* stream,
                              HeapSnapshot::SerializationFormat format) const {
-  Utils::ApiCheck(format == kJSON,
+  Utils::ApiCheck(format == kJSON || format == kBinary,
                   "v8::HeapSnapshot::Serialize",
                   "Unknown serialization format");
   Utils::ApiCheck(stream->GetChunkSize() > 0,
                   "v8::HeapSnapshot::Serialize",
                   "Invalid stream chunk size");
+  if (format == kBinary) {
+    i::HeapSnapshotBinarySerializer serializer(ToInternal(this));
+    serializer.Serialize(stream);
+    return;
+  }
   i::HeapSnapshotJSONSerializer serializer(ToInternal(this));
   serializer.Serialize(stream);
 }
 
 
+bool HeapSnapshot::ConvertBinaryToJSON(const char* data, size_t length,
+                                       OutputStream* stream) {
+  Utils::ApiCheck(stream->GetChunkSize() > 0,
+                  "v8::HeapSnapshot::ConvertBinaryToJSON",
+                  "Invalid stream chunk size");
+  i::HeapSnapshotBinaryConverter converter(data, length);
+  return converter.ConvertToJSON(stream);
+}
+
+
 // static
 STATIC_CONST_MEMBER_DEFINITION const SnapshotObjectId
     HeapProfiler::kUnknownObjectId;
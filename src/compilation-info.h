@@ -51,6 +51,9 @@ class V8_EXPORT_PRIVATE CompilationInfo final {
     kBailoutOnUninitialized = 1 << 14,
     kOptimizeFromBytecode = 1 << 15,
     kLoopPeelingEnabled = 1 << 16,
+    kLoopUnrollingEnabled = 1 << 17,
+    kBoundsCheckHoistingEnabled = 1 << 18,
+    kLoopVectorizationEnabled = 1 << 19,
   };
 
   CompilationInfo(Zone* zone, ParseInfo* parse_info, Isolate* isolate,
@@ -179,6 +182,28 @@ class V8_EXPORT_PRIVATE CompilationInfo final {
 
   bool is_loop_peeling_enabled() const { return GetFlag(kLoopPeelingEnabled); }
 
+  void MarkAsLoopUnrollingEnabled() { SetFlag(kLoopUnrollingEnabled); }
+
+  bool is_loop_unrolling_enabled() const {
+    return GetFlag(kLoopUnrollingEnabled);
+  }
+
+  void MarkAsBoundsCheckHoistingEnabled() {
+    SetFlag(kBoundsCheckHoistingEnabled);
+  }
+
+  bool is_bounds_check_hoisting_enabled() const {
+    return GetFlag(kBoundsCheckHoistingEnabled);
+  }
+
+  void MarkAsLoopVectorizationEnabled() {
+    SetFlag(kLoopVectorizationEnabled);
+  }
+
+  bool is_loop_vectorization_enabled() const {
+    return GetFlag(kLoopVectorizationEnabled);
+  }
+
   bool GeneratePreagedPrologue() const {
     // Generate a pre-aged prologue if we are optimizing for size, which
     // will make code flushing more aggressive. Only apply to Code::FUNCTION,
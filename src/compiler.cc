@@ -35,6 +35,7 @@
 #include "src/parsing/scanner-character-streams.h"
 #include "src/runtime-profiler.h"
 #include "src/snapshot/code-serializer.h"
+#include "src/snapshot/feedback-serializer.h"
 #include "src/vm-state-inl.h"
 
 namespace v8 {
@@ -185,6 +186,20 @@ void CompilationJob::RecordOptimizedCompilationStats() const {
   double ms_creategraph = time_taken_to_prepare_.InMillisecondsF();
   double ms_optimize = time_taken_to_execute_.InMillisecondsF();
   double ms_codegen = time_taken_to_finalize_.InMillisecondsF();
+
+  // Graph creation and code generation always run on the main thread, the
+  // optimization of the graph only if the job wasn't executed concurrently.
+  Counters* counters = isolate()->counters();
+  base::TimeDelta main_thread_time =
+      time_taken_to_prepare_ + time_taken_to_finalize_;
+  if (executed_on_background_thread()) {
+    counters->compile_optimized_background()->AddSample(
+        static_cast<int>(time_taken_to_execute_.InMicroseconds()));
+  } else {
+    main_thread_time += time_taken_to_execute_;
+  }
+  counters->compile_optimized_main_thread()->AddSample(
+      static_cast<int>(main_thread_time.InMicroseconds()));
   if (FLAG_trace_opt) {
     PrintF("[optimizing ");
     function->ShortPrint();
@@ -193,14 +208,19 @@ void CompilationJob::RecordOptimizedCompilationStats() const {
   }
   if (FLAG_trace_opt_stats) {
     static double compilation_time = 0.0;
+    static double main_thread_compilation_time = 0.0;
     static int compiled_functions = 0;
     static int code_size = 0;
 
     compilation_time += (ms_creategraph + ms_optimize + ms_codegen);
+    main_thread_compilation_time += main_thread_time.InMillisecondsF();
     compiled_functions++;
     code_size += function->shared()->SourceSize();
-    PrintF("Compiled: %d functions with %d byte source size in %fms.\n",
-           compiled_functions, code_size, compilation_time);
+    PrintF(
+        "Compiled: %d functions with %d byte source size in %fms "
+        "(%fms on the main thread).\n",
+        compiled_functions, code_size, compilation_time,
+        main_thread_compilation_time);
   }
   if (FLAG_hydrogen_stats) {
     isolate()->GetHStatistics()->IncrementSubtotals(time_taken_to_prepare_,
@@ -441,6 +461,10 @@ void InstallSharedCompilationResult(CompilationInfo* info,
     DCHECK(!shared->HasBytecodeArray());  // Only compiled once.
     shared->set_bytecode_array(*info->bytecode_array());
   }
+  if (shared->bytecode_flushed()) {
+    shared->set_bytecode_flushed(false);
+    info->isolate()->counters()->bytecode_recompilations()->Increment();
+  }
 }
 
 void InstallUnoptimizedCode(CompilationInfo* info) {
@@ -648,6 +672,29 @@ bool CompileUnoptimizedCode(CompilationInfo* info,
   return true;
 }
 
+// Enqueues the top-level functions that the parser left to the compiler
+// dispatcher, so that they are parsed and compiled on background threads while
+// the main thread starts running the script. Functions that can't be enqueued
+// are compiled lazily when they are first called.
+void EnqueueDispatchedLiterals(CompilationInfo* info) {
+  ParseInfo* parse_info = info->parse_info();
+  if (parse_info->dispatched_literals().empty()) return;
+  Isolate* isolate = info->isolate();
+  CompilerDispatcher* dispatcher = isolate->compiler_dispatcher();
+  if (!dispatcher->IsEnabled() || info->is_debug() || info->will_serialize()) {
+    return;
+  }
+  Handle<Script> script = info->script();
+  for (FunctionLiteral* literal : parse_info->dispatched_literals()) {
+    Handle<SharedFunctionInfo> shared;
+    if (!script->FindSharedFunctionInfo(isolate, literal).ToHandle(&shared)) {
+      continue;
+    }
+    if (shared->is_compiled()) continue;
+    dispatcher->EnqueueAndStep(shared);
+  }
+}
+
 void EnsureSharedFunctionInfosArrayOnScript(ParseInfo* info, Isolate* isolate) {
   DCHECK(info->is_toplevel());
   DCHECK(!info->script().is_null());
@@ -1119,9 +1166,15 @@ Handle<SharedFunctionInfo> CompileToplevel(CompilationInfo* info) {
   PostponeInterruptsScope postpone(isolate);
   DCHECK(!isolate->native_context().is_null());
   ParseInfo* parse_info = info->parse_info();
+  // Streamed scripts were parsed while their source was being loaded, hand
+  // their eager inner functions to the compiler dispatcher so that only the
+  // top-level code is generated once the last chunk has arrived.
+  bool is_streamed = parse_info->source_stream() != nullptr;
   Compiler::ConcurrencyMode inner_function_mode =
-      FLAG_compiler_dispatcher_eager_inner ? Compiler::CONCURRENT
-                                           : Compiler::NOT_CONCURRENT;
+      FLAG_compiler_dispatcher_eager_inner ||
+              (FLAG_compiler_dispatcher_streaming && is_streamed)
+          ? Compiler::CONCURRENT
+          : Compiler::NOT_CONCURRENT;
 
   RuntimeCallTimerScope runtimeTimer(
       isolate, parse_info->is_eval() ? &RuntimeCallStats::CompileEval
@@ -1169,6 +1222,7 @@ Handle<SharedFunctionInfo> CompileToplevel(CompilationInfo* info) {
     if (!CompileUnoptimizedCode(info, inner_function_mode)) {
       return Handle<SharedFunctionInfo>::null();
     }
+    EnqueueDispatchedLiterals(info);
 
     Handle<String> script_name =
         script->name()->IsString()
@@ -1185,7 +1239,7 @@ Handle<SharedFunctionInfo> CompileToplevel(CompilationInfo* info) {
     if (!script.is_null()) {
       script->set_compilation_state(Script::COMPILATION_STATE_COMPILED);
       if (FLAG_preparser_scope_analysis) {
-        Handle<FixedUint32Array> data(
+        Handle<ByteArray> data(
             parse_info->preparsed_scope_data()->Serialize(isolate));
         script->set_preparsed_scope_data(*data);
       }
@@ -1195,6 +1249,32 @@ Handle<SharedFunctionInfo> CompileToplevel(CompilationInfo* info) {
   return result;
 }
 
+// Marks |function| for optimization if the optimization recipe of a code
+// cache says that it was optimized in a previous run based on feedback that
+// was fully restored.
+void MaybeOptimizeFromRecipe(Handle<JSFunction> function) {
+  Isolate* isolate = function->GetIsolate();
+  ImportedFeedback* imported_feedback = isolate->imported_feedback();
+  if (imported_feedback->is_empty()) return;
+  SharedFunctionInfo* shared = function->shared();
+  if (!FLAG_opt || shared->optimization_disabled() ||
+      shared->opt_count() > 0 || shared->HasAsmWasmData()) {
+    return;
+  }
+  if (function->IsOptimized() || function->IsMarkedForOptimization() ||
+      function->IsMarkedForConcurrentOptimization() ||
+      function->IsInOptimizationQueue()) {
+    return;
+  }
+  if (!imported_feedback->ShouldOptimizeOnFirstCall(shared)) return;
+  if (FLAG_trace_opt) {
+    PrintF("[marking ");
+    function->ShortPrint();
+    PrintF(" for optimization from the code cache recipe]\n");
+  }
+  function->AttemptConcurrentOptimization();
+}
+
 }  // namespace
 
 // ----------------------------------------------------------------------------
@@ -1263,6 +1343,7 @@ bool Compiler::Compile(Handle<JSFunction> function, ClearExceptionFlag flag) {
   // Install code on closure.
   function->ReplaceCode(*code);
   JSFunction::EnsureLiterals(function);
+  MaybeOptimizeFromRecipe(function);
 
   // Check postconditions on success.
   DCHECK(!isolate->has_pending_exception());
@@ -1893,6 +1974,7 @@ void Compiler::PostInstantiation(Handle<JSFunction> function,
   if (shared->is_compiled()) {
     // TODO(mvstanton): pass pretenure flag to EnsureLiterals.
     JSFunction::EnsureLiterals(function);
+    MaybeOptimizeFromRecipe(function);
   }
 }
 
@@ -251,6 +251,11 @@ int InstructionScheduler::GetInstructionLatency(const Instruction* instr) {
   return 1;
 }
 
+int InstructionScheduler::GetInstructionThroughput(const Instruction* instr) {
+  // TODO(all): Add instruction throughput modeling.
+  return 1;
+}
+
 }  // namespace compiler
 }  // namespace internal
 }  // namespace v8
@@ -342,6 +342,11 @@ int InstructionScheduler::GetInstructionLatency(const Instruction* instr) {
   }
 }
 
+int InstructionScheduler::GetInstructionThroughput(const Instruction* instr) {
+  // TODO(all): Add instruction throughput modeling.
+  return 1;
+}
+
 }  // namespace compiler
 }  // namespace internal
 }  // namespace v8
@@ -53,7 +53,10 @@ class EscapeStatusAnalysis : public ZoneObject {
     // effect successors.
     kBranchPointComputed = 1u << 6,
     kBranchPoint = 1u << 7,
-    kInQueue = 1u << 8
+    kInQueue = 1u << 8,
+    // The object allocated by an Allocate node is stored to after its
+    // allocation region, possibly through an alias.
+    kModifiedAfterRegion = 1u << 9
   };
   typedef base::Flags<Status, uint16_t> StatusFlags;
 
@@ -65,13 +68,16 @@ class EscapeStatusAnalysis : public ZoneObject {
 
   bool IsInQueue(NodeId id);
   void SetInQueue(NodeId id, bool on_stack);
+  void SetModifiedAfterRegion(NodeId allocation);
 
   void DebugPrint();
 
   EscapeStatusAnalysis(EscapeAnalysis* object_analysis, Graph* graph,
                        Zone* zone);
   void EnqueueForStatusAnalysis(Node* node);
-  bool SetEscaped(Node* node);
+  // Marks {node} as escaping. The {reason} and the {cause} node are reported
+  // under --trace-turbo-escape-reasons.
+  bool SetEscaped(Node* node, const char* reason, Node* cause = nullptr);
   bool IsEffectBranchPoint(Node* node);
   bool IsDanglingEffectNode(Node* node);
   void ResizeStatusVector();
@@ -88,6 +94,8 @@ class EscapeStatusAnalysis : public ZoneObject {
 
   bool IsNotReachable(Node* node);
 
+  void PrintEscapeReasons();
+
  private:
   void Process(Node* node);
   void ProcessAllocate(Node* node);
@@ -106,6 +114,16 @@ class EscapeStatusAnalysis : public ZoneObject {
   bool HasEntry(Node* node);
 
   bool IsAllocationPhi(Node* node);
+  bool IsModifiedAfterRegion(Node* finish);
+  bool IsStoredTo(Node* object);
+  bool HasOnlyLoadUses(Node* node);
+  bool IsVirtualAllocationPhi(Node* node);
+
+  struct EscapeReason {
+    Node* node;
+    const char* reason;
+    Node* cause;
+  };
 
   ZoneVector<Node*> stack_;
   EscapeAnalysis* object_analysis_;
@@ -114,6 +132,7 @@ class EscapeStatusAnalysis : public ZoneObject {
   Alias next_free_alias_;
   ZoneVector<Node*> status_stack_;
   ZoneVector<Alias> aliases_;
+  ZoneMap<NodeId, EscapeReason> escape_reasons_;
 
   DISALLOW_COPY_AND_ASSIGN(EscapeStatusAnalysis);
 };
@@ -585,7 +604,8 @@ EscapeStatusAnalysis::EscapeStatusAnalysis(EscapeAnalysis* object_analysis,
       status_(zone),
       next_free_alias_(0),
       status_stack_(zone),
-      aliases_(zone) {}
+      aliases_(zone),
+      escape_reasons_(zone) {}
 
 bool EscapeStatusAnalysis::HasEntry(Node* node) {
   return status_[node->id()] & (kTracked | kEscaped);
@@ -608,9 +628,13 @@ bool EscapeStatusAnalysis::IsAllocation(Node* node) {
          node->opcode() == IrOpcode::kFinishRegion;
 }
 
-bool EscapeStatusAnalysis::SetEscaped(Node* node) {
+bool EscapeStatusAnalysis::SetEscaped(Node* node, const char* reason,
+                                      Node* cause) {
   bool changed = !(status_[node->id()] & kEscaped);
   status_[node->id()] |= kEscaped | kTracked;
+  if (changed && FLAG_trace_turbo_escape_reasons) {
+    escape_reasons_[node->id()] = {node, reason, cause};
+  }
   return changed;
 }
 
@@ -626,6 +650,10 @@ void EscapeStatusAnalysis::SetInQueue(NodeId id, bool on_stack) {
   }
 }
 
+void EscapeStatusAnalysis::SetModifiedAfterRegion(NodeId allocation) {
+  status_[allocation] |= kModifiedAfterRegion;
+}
+
 void EscapeStatusAnalysis::ResizeStatusVector() {
   if (status_.size() <= graph()->NodeCount()) {
     status_.resize(graph()->NodeCount() * 1.1, kUnknown);
@@ -697,7 +725,7 @@ void EscapeStatusAnalysis::Process(Node* node) {
       } else {
         Node* from = NodeProperties::GetValueInput(node, 0);
         from = object_analysis_->ResolveReplacement(from);
-        if (SetEscaped(from)) {
+        if (SetEscaped(from, "unresolved load", node)) {
           TRACE("Setting #%d (%s) to escaped because of unresolved load #%i\n",
                 from->id(), from->op()->mnemonic(), node->id());
           RevisitInputs(from);
@@ -707,36 +735,128 @@ void EscapeStatusAnalysis::Process(Node* node) {
       RevisitUses(node);
       break;
     }
-    case IrOpcode::kPhi:
+    case IrOpcode::kPhi: {
       if (!HasEntry(node)) {
         status_[node->id()] |= kTracked;
         RevisitUses(node);
       }
-      if (!IsAllocationPhi(node) && SetEscaped(node)) {
+      const char* reason = nullptr;
+      if (!IsAllocationPhi(node)) {
+        reason = "merge of mutable or non-virtual objects";
+      } else if (!HasOnlyLoadUses(node)) {
+        reason = "merge of objects with non-load use";
+      }
+      if (reason != nullptr && SetEscaped(node, reason)) {
         RevisitInputs(node);
         RevisitUses(node);
       }
       CheckUsesForEscape(node);
+      break;
+    }
     default:
       break;
   }
 }
 
+// Returns true if all value inputs of the phi {node} are virtual objects that
+// aren't modified once their allocation region is finished. Loads from such a
+// phi can be replaced by a phi of the objects' initial field values, see
+// EscapeAnalysis::ProcessLoadFromPhi.
 bool EscapeStatusAnalysis::IsAllocationPhi(Node* node) {
-  for (Edge edge : node->input_edges()) {
-    Node* input = edge.to();
-    if (input->opcode() == IrOpcode::kPhi && !IsEscaped(input)) continue;
-    if (IsAllocation(input)) continue;
+  // Phis created by the analysis itself are not tracked.
+  if (node->id() >= aliases_.size() || IsNotReachable(node)) return false;
+  for (int i = 0; i < node->op()->ValueInputCount(); ++i) {
+    Node* input = NodeProperties::GetValueInput(node, i);
+    if (input->opcode() != IrOpcode::kFinishRegion ||
+        input->id() >= aliases_.size() ||
+        aliases_[input->id()] >= kUntrackable || IsEscaped(input)) {
+      return false;
+    }
+    if (IsModifiedAfterRegion(input)) return false;
+  }
+  return true;
+}
+
+// Returns true if the object allocated in the region that ends with {finish}
+// is stored to after the region. Stores through aliases that only the object
+// analysis can resolve, e.g. loads of fields that hold the object, are
+// recorded by EscapeAnalysis::ProcessStoreField and ProcessStoreElement.
+bool EscapeStatusAnalysis::IsModifiedAfterRegion(Node* finish) {
+  DCHECK_EQ(IrOpcode::kFinishRegion, finish->opcode());
+  Node* allocate = NodeProperties::GetValueInput(finish, 0);
+  if (status_[allocate->id()] & kModifiedAfterRegion) return true;
+  if (IsStoredTo(finish)) return true;
+  for (Edge edge : allocate->use_edges()) {
+    Node* store = edge.from();
+    if ((store->opcode() != IrOpcode::kStoreField &&
+         store->opcode() != IrOpcode::kStoreElement) ||
+        edge.index() != 0 || IsNotReachable(store)) {
+      continue;
+    }
+    // Stores to the allocation that initialize it are part of the region.
+    bool in_region = false;
+    for (Node* effect = NodeProperties::GetEffectInput(finish);;
+         effect = NodeProperties::GetEffectInput(effect)) {
+      if (effect == store) {
+        in_region = true;
+        break;
+      }
+      if (effect->opcode() == IrOpcode::kBeginRegion ||
+          effect->op()->EffectInputCount() == 0) {
+        break;
+      }
+    }
+    if (!in_region) return true;
+  }
+  return false;
+}
+
+// Returns true if {object} or a type guard that renames it is the object
+// input of a store.
+bool EscapeStatusAnalysis::IsStoredTo(Node* object) {
+  for (Edge edge : object->use_edges()) {
+    Node* use = edge.from();
+    if (IsNotReachable(use)) continue;
+    if (use->opcode() == IrOpcode::kTypeGuard) {
+      if (IsStoredTo(use)) return true;
+    } else if ((use->opcode() == IrOpcode::kStoreField ||
+                use->opcode() == IrOpcode::kStoreElement) &&
+               edge.index() == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns true if the phi {node} is only used as the object of loads. Phis
+// that end up in frame states, in other objects or in other phis would have
+// to be materialized, which is not supported.
+bool EscapeStatusAnalysis::HasOnlyLoadUses(Node* node) {
+  for (Edge edge : node->use_edges()) {
+    Node* use = edge.from();
+    if (IsNotReachable(use)) continue;
+    if ((use->opcode() == IrOpcode::kLoadField ||
+         use->opcode() == IrOpcode::kLoadElement) &&
+        edge.index() == 0) {
+      continue;
+    }
     return false;
   }
   return true;
 }
 
+// Returns true if the objects merged by the phi {node} can stay virtual.
+bool EscapeStatusAnalysis::IsVirtualAllocationPhi(Node* node) {
+  DCHECK_EQ(IrOpcode::kPhi, node->opcode());
+  return !IsEscaped(node) && IsAllocationPhi(node) && HasOnlyLoadUses(node);
+}
+
 void EscapeStatusAnalysis::ProcessStoreField(Node* node) {
   DCHECK_EQ(node->opcode(), IrOpcode::kStoreField);
   Node* to = NodeProperties::GetValueInput(node, 0);
   Node* val = NodeProperties::GetValueInput(node, 1);
-  if ((IsEscaped(to) || !IsAllocation(to)) && SetEscaped(val)) {
+  if ((IsEscaped(to) || !IsAllocation(to)) &&
+      SetEscaped(val, "stored to escaping object", node)) {
     RevisitUses(val);
     RevisitInputs(val);
     TRACE("Setting #%d (%s) to escaped because of store to field of #%d\n",
@@ -748,7 +868,8 @@ void EscapeStatusAnalysis::ProcessStoreElement(Node* node) {
   DCHECK_EQ(node->opcode(), IrOpcode::kStoreElement);
   Node* to = NodeProperties::GetValueInput(node, 0);
   Node* val = NodeProperties::GetValueInput(node, 2);
-  if ((IsEscaped(to) || !IsAllocation(to)) && SetEscaped(val)) {
+  if ((IsEscaped(to) || !IsAllocation(to)) &&
+      SetEscaped(val, "stored to escaping object", node)) {
     RevisitUses(val);
     RevisitInputs(val);
     TRACE("Setting #%d (%s) to escaped because of store to field of #%d\n",
@@ -768,7 +889,7 @@ void EscapeStatusAnalysis::ProcessAllocate(Node* node) {
            node->InputAt(0)->opcode() != IrOpcode::kFloat32Constant &&
            node->InputAt(0)->opcode() != IrOpcode::kFloat64Constant);
     RevisitUses(node);
-    if (!size.HasValue() && SetEscaped(node)) {
+    if (!size.HasValue() && SetEscaped(node, "non-constant size")) {
       TRACE("Setting #%d to escaped because of non-const alloc\n", node->id());
       // This node is already known to escape, uses do not have to be checked
       // for escape.
@@ -790,7 +911,8 @@ bool EscapeStatusAnalysis::CheckUsesForEscape(Node* uses, Node* rep,
       continue;
     switch (use->opcode()) {
       case IrOpcode::kPhi:
-        if (phi_escaping && SetEscaped(rep)) {
+        if (phi_escaping && !IsVirtualAllocationPhi(use) &&
+            SetEscaped(rep, "merged by phi", use)) {
           TRACE(
               "Setting #%d (%s) to escaped because of use by phi node "
               "#%d (%s)\n",
@@ -808,7 +930,7 @@ bool EscapeStatusAnalysis::CheckUsesForEscape(Node* uses, Node* rep,
       case IrOpcode::kReferenceEqual:
       case IrOpcode::kFinishRegion:
       case IrOpcode::kCheckMaps:
-        if (IsEscaped(use) && SetEscaped(rep)) {
+        if (IsEscaped(use) && SetEscaped(rep, "used by escaping node", use)) {
           TRACE(
               "Setting #%d (%s) to escaped because of use by escaping node "
               "#%d (%s)\n",
@@ -818,7 +940,7 @@ bool EscapeStatusAnalysis::CheckUsesForEscape(Node* uses, Node* rep,
         }
         break;
       case IrOpcode::kObjectIsSmi:
-        if (!IsAllocation(rep) && SetEscaped(rep)) {
+        if (!IsAllocation(rep) && SetEscaped(rep, "used by", use)) {
           TRACE("Setting #%d (%s) to escaped because of use by #%d (%s)\n",
                 rep->id(), rep->op()->mnemonic(), use->id(),
                 use->op()->mnemonic());
@@ -847,7 +969,7 @@ bool EscapeStatusAnalysis::CheckUsesForEscape(Node* uses, Node* rep,
       case IrOpcode::kObjectIsString:
       case IrOpcode::kObjectIsSymbol:
       case IrOpcode::kObjectIsUndetectable:
-        if (SetEscaped(rep)) {
+        if (SetEscaped(rep, "used by", use)) {
           TRACE("Setting #%d (%s) to escaped because of use by #%d (%s)\n",
                 rep->id(), rep->op()->mnemonic(), use->id(),
                 use->op()->mnemonic());
@@ -862,7 +984,7 @@ bool EscapeStatusAnalysis::CheckUsesForEscape(Node* uses, Node* rep,
                    "Encountered unaccounted use by #%d (%s)\n", use->id(),
                    use->op()->mnemonic());
         }
-        if (SetEscaped(rep)) {
+        if (SetEscaped(rep, "used by", use)) {
           TRACE("Setting #%d (%s) to escaped because of use by #%d (%s)\n",
                 rep->id(), rep->op()->mnemonic(), use->id(),
                 use->op()->mnemonic());
@@ -885,6 +1007,28 @@ void EscapeStatusAnalysis::ProcessFinishRegion(Node* node) {
   }
 }
 
+void EscapeStatusAnalysis::PrintEscapeReasons() {
+  const int kMaxChainLength = 16;
+  for (auto const& entry : escape_reasons_) {
+    Node* node = entry.second.node;
+    if (node->opcode() != IrOpcode::kAllocate) continue;
+    PrintF("Allocation #%d escapes:", node->id());
+    // Follow the uses through which the allocation escapes.
+    const EscapeReason* reason = &entry.second;
+    for (int i = 0; i < kMaxChainLength; ++i) {
+      PrintF(" %s", reason->reason);
+      Node* cause = reason->cause;
+      if (cause == nullptr) break;
+      PrintF(" #%d:%s", cause->id(), cause->op()->mnemonic());
+      auto it = escape_reasons_.find(cause->id());
+      if (it == escape_reasons_.end()) break;
+      PrintF(",");
+      reason = &it->second;
+    }
+    PrintF("\n");
+  }
+}
+
 void EscapeStatusAnalysis::DebugPrint() {
   for (NodeId id = 0; id < status_.size(); id++) {
     if (status_[id] & kTracked) {
@@ -903,6 +1047,7 @@ EscapeAnalysis::EscapeAnalysis(Graph* graph, CommonOperatorBuilder* common,
       virtual_states_(zone),
       replacements_(zone),
       cycle_detection_(zone),
+      deferred_phi_loads_(zone),
       cache_(nullptr) {
   // Type slot_not_analyzed_ manually.
   double v = OpParameter<double>(slot_not_analyzed_);
@@ -920,6 +1065,9 @@ bool EscapeAnalysis::Run() {
     status_analysis_->ResizeStatusVector();
     RunObjectAnalysis();
     status_analysis_->RunStatusAnalysis();
+    if (FLAG_trace_turbo_escape_reasons) {
+      status_analysis_->PrintEscapeReasons();
+    }
     return true;
   } else {
     return false;
@@ -1035,6 +1183,16 @@ void EscapeAnalysis::RunObjectAnalysis() {
       danglers.clear();
     }
   }
+  // Loads from loop phis can merge objects that are allocated later in the
+  // loop body, whose state is only known now.
+  ZoneVector<std::pair<Node*, int>> deferred_phi_loads(zone());
+  deferred_phi_loads.swap(deferred_phi_loads_);
+  for (auto const& entry : deferred_phi_loads) {
+    Node* load = entry.first;
+    Node* from = ResolveReplacement(NodeProperties::GetValueInput(load, 0));
+    ProcessLoadFromPhi(entry.second, from, load);
+  }
+  deferred_phi_loads_.clear();
 #ifdef DEBUG
   if (FLAG_trace_turbo_escape) {
     DebugPrint();
@@ -1445,21 +1603,34 @@ int OffsetForElementAccess(Node* node, int index) {
 
 }  // namespace
 
-void EscapeAnalysis::ProcessLoadFromPhi(int offset, Node* from, Node* load,
-                                        VirtualState* state) {
+void EscapeAnalysis::ProcessLoadFromPhi(int offset, Node* from, Node* load) {
   TRACE("Load #%d from phi #%d", load->id(), from->id());
 
-  cache_->fields().clear();
-  for (int i = 0; i < load->op()->ValueInputCount(); ++i) {
-    Node* input = NodeProperties::GetValueInput(load, i);
-    cache_->fields().push_back(input);
+  // The objects merged by {from} are not modified once their allocation
+  // region is finished (see EscapeStatusAnalysis::IsAllocationPhi), so their
+  // fields are read from the state right after the region.
+  cache_->objects().clear();
+  for (int i = 0; i < from->op()->ValueInputCount(); ++i) {
+    Node* input = NodeProperties::GetValueInput(from, i);
+    if (input->opcode() != IrOpcode::kFinishRegion) break;
+    VirtualState* state = virtual_states_[input->id()];
+    if (state == nullptr) {
+      // The region is in a loop body that wasn't analyzed yet, try again once
+      // the whole graph was analyzed.
+      TRACE(" is deferred.\n");
+      deferred_phi_loads_.push_back(std::make_pair(load, offset));
+      return;
+    }
+    VirtualObject* object = GetVirtualObject(state, input);
+    if (object == nullptr || !object->IsTracked()) break;
+    cache_->objects().push_back(object);
   }
 
-  cache_->LoadVirtualObjectsForFieldsFrom(state,
-                                          status_analysis_->GetAliasMap());
-  if (cache_->objects().size() == cache_->fields().size()) {
+  if (cache_->objects().size() ==
+      static_cast<size_t>(from->op()->ValueInputCount())) {
     cache_->GetFields(offset);
     if (cache_->fields().size() == cache_->objects().size()) {
+      for (Node*& field : cache_->fields()) field = ResolveReplacement(field);
       Node* rep = replacement(load);
       if (!rep || !IsEquivalentPhi(rep, cache_->fields())) {
         int value_input_count = static_cast<int>(cache_->fields().size());
@@ -1501,7 +1672,7 @@ void EscapeAnalysis::ProcessLoadField(Node* node) {
       // For now, we just mark the {object} as escaping.
       // TODO(turbofan): Consider introducing an Undefined or None operator
       // that we can replace this load with, since we know it's dead code.
-      if (status_analysis_->SetEscaped(from)) {
+      if (status_analysis_->SetEscaped(from, "load outside of object", node)) {
         TRACE(
             "Setting #%d (%s) to escaped because load field #%d from "
             "offset %d outside of object\n",
@@ -1518,8 +1689,7 @@ void EscapeAnalysis::ProcessLoadField(Node* node) {
   } else if (from->opcode() == IrOpcode::kPhi &&
              IsOffsetForFieldAccessCorrect(FieldAccessOf(node->op()))) {
     int offset = OffsetForFieldAccess(node);
-    // Only binary phis are supported for now.
-    ProcessLoadFromPhi(offset, from, node, state);
+    ProcessLoadFromPhi(offset, from, node);
   } else {
     UpdateReplacement(state, node, nullptr);
   }
@@ -1533,7 +1703,7 @@ void EscapeAnalysis::ProcessCheckMaps(Node* node) {
     VirtualState* state = virtual_states_[node->id()];
     if (VirtualObject* object = GetVirtualObject(state, checked)) {
       if (!object->IsTracked()) {
-        if (status_analysis_->SetEscaped(node)) {
+        if (status_analysis_->SetEscaped(node, "check of untracked object")) {
           TRACE(
               "Setting #%d (%s) to escaped because checked object #%i is not "
               "tracked\n",
@@ -1559,7 +1729,7 @@ void EscapeAnalysis::ProcessCheckMaps(Node* node) {
       }
     }
   }
-  if (status_analysis_->SetEscaped(node)) {
+  if (status_analysis_->SetEscaped(node, "map check")) {
     TRACE("Setting #%d (%s) to escaped (checking #%i)\n", node->id(),
           node->op()->mnemonic(), checked->id());
   }
@@ -1589,13 +1759,14 @@ void EscapeAnalysis::ProcessLoadElement(Node* node) {
       UpdateReplacement(state, node, value);
     } else if (from->opcode() == IrOpcode::kPhi) {
       int offset = OffsetForElementAccess(node, index.Value());
-      ProcessLoadFromPhi(offset, from, node, state);
+      ProcessLoadFromPhi(offset, from, node);
     } else {
       UpdateReplacement(state, node, nullptr);
     }
   } else {
     // We have a load from a non-const index, cannot eliminate object.
-    if (status_analysis_->SetEscaped(from)) {
+    if (status_analysis_->SetEscaped(from, "load from non-constant index",
+                                     node)) {
       TRACE(
           "Setting #%d (%s) to escaped because load element #%d from non-const "
           "index #%d (%s)\n",
@@ -1619,7 +1790,7 @@ void EscapeAnalysis::ProcessStoreField(Node* node) {
       // For now, we just mark the {object} as escaping.
       // TODO(turbofan): Consider just eliminating the store in the reducer
       // pass, as it's dead code anyways.
-      if (status_analysis_->SetEscaped(to)) {
+      if (status_analysis_->SetEscaped(to, "store outside of object", node)) {
         TRACE(
             "Setting #%d (%s) to escaped because store field #%d to "
             "offset %d outside of object\n",
@@ -1637,6 +1808,9 @@ void EscapeAnalysis::ProcessStoreField(Node* node) {
              FieldAccessOf(node->op()).offset == Name::kHashFieldOffset);
       val = slot_not_analyzed_;
     }
+    if (object->IsInitialized()) {
+      status_analysis_->SetModifiedAfterRegion(object->id());
+    }
     if (object->GetField(offset) != val) {
       object = CopyForModificationAt(object, state, node);
       object->SetField(offset, val);
@@ -1661,6 +1835,9 @@ void EscapeAnalysis::ProcessStoreElement(Node* node) {
       int offset = OffsetForElementAccess(node, index.Value());
       if (static_cast<size_t>(offset) >= object->field_count()) return;
       Node* val = ResolveReplacement(NodeProperties::GetValueInput(node, 2));
+      if (object->IsInitialized()) {
+        status_analysis_->SetModifiedAfterRegion(object->id());
+      }
       if (object->GetField(offset) != val) {
         object = CopyForModificationAt(object, state, node);
         object->SetField(offset, val);
@@ -1668,7 +1845,8 @@ void EscapeAnalysis::ProcessStoreElement(Node* node) {
     }
   } else {
     // We have a store to a non-const index, cannot eliminate object.
-    if (status_analysis_->SetEscaped(to)) {
+    if (status_analysis_->SetEscaped(to, "store to non-constant index",
+                                     node)) {
       TRACE(
           "Setting #%d (%s) to escaped because store element #%d to non-const "
           "index #%d (%s)\n",
@@ -52,8 +52,7 @@ class V8_EXPORT_PRIVATE EscapeAnalysis {
   void ProcessCall(Node* node);
   void ProcessStart(Node* node);
   bool ProcessEffectPhi(Node* node);
-  void ProcessLoadFromPhi(int offset, Node* from, Node* node,
-                          VirtualState* states);
+  void ProcessLoadFromPhi(int offset, Node* from, Node* load);
 
   void ForwardVirtualState(Node* node);
   VirtualState* CopyForModificationAt(VirtualState* state, Node* node);
@@ -79,6 +78,9 @@ class V8_EXPORT_PRIVATE EscapeAnalysis {
   ZoneVector<VirtualState*> virtual_states_;
   ZoneVector<Node*> replacements_;
   ZoneSet<VirtualObject*> cycle_detection_;
+  // Loads from phis and their field offsets that have to be processed again
+  // once the whole graph was analyzed.
+  ZoneVector<std::pair<Node*, int>> deferred_phi_loads_;
   MergeCache* cache_;
 
   DISALLOW_COPY_AND_ASSIGN(EscapeAnalysis);
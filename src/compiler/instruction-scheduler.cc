@@ -29,8 +29,10 @@ InstructionScheduler::CriticalPathFirstQueue::PopBestCandidate(int cycle) {
   DCHECK(!IsEmpty());
   auto candidate = nodes_.end();
   for (auto iterator = nodes_.begin(); iterator != nodes_.end(); ++iterator) {
-    // We only consider instructions that have all their operands ready.
-    if (cycle >= (*iterator)->start_cycle()) {
+    // We only consider instructions that have all their operands ready and
+    // whose execution unit is free.
+    if (cycle >= (*iterator)->start_cycle() &&
+        scheduler_->IsUnitFree(*iterator, cycle)) {
       candidate = iterator;
       break;
     }
@@ -66,6 +68,7 @@ InstructionScheduler::ScheduleGraphNode::ScheduleGraphNode(
       successors_(zone),
       unscheduled_predecessors_count_(0),
       latency_(GetInstructionLatency(instr)),
+      throughput_(GetInstructionThroughput(instr)),
       total_latency_(-1),
       start_cycle_(-1) {
 }
@@ -87,7 +90,8 @@ InstructionScheduler::InstructionScheduler(Zone* zone,
       pending_loads_(zone),
       last_live_in_reg_marker_(nullptr),
       last_deopt_(nullptr),
-      operands_map_(zone) {}
+      operands_map_(zone),
+      unpipelined_unit_free_cycle_(0) {}
 
 
 void InstructionScheduler::StartBlock(RpoNumber rpo) {
@@ -214,11 +218,15 @@ void InstructionScheduler::ScheduleBlock() {
 
   // Go through the ready list and schedule the instructions.
   int cycle = 0;
+  unpipelined_unit_free_cycle_ = 0;
   while (!ready_list.IsEmpty()) {
     ScheduleGraphNode* candidate = ready_list.PopBestCandidate(cycle);
 
     if (candidate != nullptr) {
       sequence()->AddInstruction(candidate->instruction());
+      if (candidate->throughput() > 1) {
+        unpipelined_unit_free_cycle_ = cycle + candidate->throughput();
+      }
 
       for (ScheduleGraphNode* successor : candidate->successors()) {
         successor->DropUnscheduledPredecessor();
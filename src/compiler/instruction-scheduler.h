@@ -64,6 +64,7 @@ class InstructionScheduler final : public ZoneObject {
     Instruction* instruction() { return instr_; }
     ZoneDeque<ScheduleGraphNode*>& successors() { return successors_; }
     int latency() const { return latency_; }
+    int throughput() const { return throughput_; }
 
     int total_latency() const { return total_latency_; }
     void set_total_latency(int latency) { total_latency_ = latency; }
@@ -82,6 +83,10 @@ class InstructionScheduler final : public ZoneObject {
     // instruction to complete).
     int latency_;
 
+    // Estimate of the reciprocal throughput of the instruction (the number of
+    // cycles before its execution unit can start the next instruction).
+    int throughput_;
+
     // The sum of all the latencies on the path from this node to the end of
     // the graph (i.e. a node with no successor).
     int total_latency_;
@@ -193,6 +198,14 @@ class InstructionScheduler final : public ZoneObject {
   void ComputeTotalLatencies();
 
   static int GetInstructionLatency(const Instruction* instr);
+  static int GetInstructionThroughput(const Instruction* instr);
+
+  // Return true if the execution unit of the instruction is free at the
+  // given cycle. Only instructions which are not pipelined can occupy their
+  // unit for more than one cycle.
+  bool IsUnitFree(ScheduleGraphNode* node, int cycle) const {
+    return node->throughput() == 1 || cycle >= unpipelined_unit_free_cycle_;
+  }
 
   Zone* zone() { return zone_; }
   InstructionSequence* sequence() { return sequence_; }
@@ -223,6 +236,10 @@ class InstructionScheduler final : public ZoneObject {
   // Keep track of definition points for virtual registers. This is used to
   // record operand dependencies in the scheduling graph.
   ZoneMap<int32_t, ScheduleGraphNode*> operands_map_;
+
+  // The cycle from which the unit executing unpipelined instructions (e.g.
+  // divisions) is free again.
+  int unpipelined_unit_free_cycle_;
 };
 
 }  // namespace compiler
@@ -0,0 +1,324 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/compiler/loop-bounds-check-elimination.h"
+
+#include "src/compiler/all-nodes.h"
+#include "src/compiler/common-operator.h"
+#include "src/compiler/graph.h"
+#include "src/compiler/js-graph.h"
+#include "src/compiler/loop-analysis.h"
+#include "src/compiler/node-properties.h"
+#include "src/compiler/node.h"
+#include "src/compiler/simplified-operator.h"
+#include "src/compiler/type-cache.h"
+
+namespace v8 {
+namespace internal {
+namespace compiler {
+
+#define TRACE(...)                                  \
+  do {                                              \
+    if (FLAG_trace_turbo_loop) PrintF(__VA_ARGS__); \
+  } while (false)
+
+namespace {
+
+// Limits the number of control nodes visited per dominance query.
+const int kMaxControlWalk = 256;
+
+// Limits the number of effect nodes visited when looking for a checkpoint
+// before a loop.
+const int kMaxEffectWalk = 32;
+
+bool IsLessThan(Node* node) {
+  return node->opcode() == IrOpcode::kNumberLessThan ||
+         node->opcode() == IrOpcode::kSpeculativeNumberLessThan;
+}
+
+bool IsLessThanOrEqual(Node* node) {
+  return node->opcode() == IrOpcode::kNumberLessThanOrEqual ||
+         node->opcode() == IrOpcode::kSpeculativeNumberLessThanOrEqual;
+}
+
+bool IsSpeculative(Node* node) {
+  return node->opcode() == IrOpcode::kSpeculativeNumberLessThan ||
+         node->opcode() == IrOpcode::kSpeculativeNumberLessThanOrEqual;
+}
+
+// The negation of a comparison only bounds the index if the other operand
+// cannot be NaN.
+bool CannotBeNaN(Node* comparison, Node* limit) {
+  if (NodeProperties::GetType(limit)->Is(Type::OrderedNumber())) return true;
+  if (IsSpeculative(comparison)) {
+    NumberOperationHint hint = NumberOperationHintOf(comparison->op());
+    return hint == NumberOperationHint::kSignedSmall ||
+           hint == NumberOperationHint::kSigned32;
+  }
+  return false;
+}
+
+bool ControlIsDominatedBy(Node* control, Node* dominator, int* budget) {
+  while (control != dominator) {
+    if (--*budget < 0) return false;
+    switch (control->opcode()) {
+      case IrOpcode::kMerge:
+        for (Node* input : control->inputs()) {
+          if (!ControlIsDominatedBy(input, dominator, budget)) return false;
+        }
+        return true;
+      case IrOpcode::kLoop:
+        // The backedges start at the loop header again, so only the paths
+        // through the entry need to be considered.
+        control = NodeProperties::GetControlInput(control,
+                                                  kAssumedLoopEntryIndex);
+        break;
+      case IrOpcode::kStart:
+      case IrOpcode::kDead:
+        return false;
+      default:
+        if (control->op()->ControlInputCount() == 0) return false;
+        control = NodeProperties::GetControlInput(control);
+        break;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+LoopBoundsCheckElimination::LoopBoundsCheckElimination(JSGraph* jsgraph,
+                                                       Flags flags, Zone* zone)
+    : jsgraph_(jsgraph),
+      flags_(flags),
+      zone_(zone),
+      type_cache_(TypeCache::Get()),
+      loop_tree_(nullptr),
+      hoisted_checks_(zone) {}
+
+void LoopBoundsCheckElimination::Run() {
+  AllNodes all(zone(), graph());
+  NodeVector checks(zone());
+  for (Node* node : all.reachable) {
+    if (node->opcode() == IrOpcode::kCheckBounds) checks.push_back(node);
+  }
+  if (checks.empty()) return;
+
+  loop_tree_ = LoopFinder::BuildLoopTree(graph(), zone());
+  for (Node* check : checks) {
+    int id = check->id();
+    if (TryEliminate(check)) TRACE("Eliminated bounds check #%d\n", id);
+  }
+}
+
+bool LoopBoundsCheckElimination::TryEliminate(Node* check) {
+  Node* index = NodeProperties::GetValueInput(check, 0);
+  Node* length = NodeProperties::GetValueInput(check, 1);
+  Node* control = NodeProperties::GetControlInput(check);
+  if (!NodeProperties::GetType(check)->IsInhabited()) return false;
+  if (!NodeProperties::GetType(index)->Is(type_cache_.kPositiveSafeInteger)) {
+    return false;
+  }
+
+  ZoneVector<Bound> bounds(zone());
+  FindBounds(index, &bounds);
+
+  // Look for a dominating index < length first.
+  for (Bound const& bound : bounds) {
+    if (bound.strict && bound.limit == length &&
+        IsDominatedBy(control, bound.projection)) {
+      ReplaceCheck(check);
+      return true;
+    }
+  }
+
+  // Otherwise try to prove limit <= length before entering the loop.
+  if (!(flags() & kHoistingEnabled)) return false;
+  if (!IsIncreasingInductionVariable(index)) return false;
+  for (Bound const& bound : bounds) {
+    if (bound.limit == length) continue;
+    if (IsDominatedBy(control, bound.projection) &&
+        TryHoist(index, length, control, bound)) {
+      ReplaceCheck(check);
+      return true;
+    }
+  }
+  return false;
+}
+
+void LoopBoundsCheckElimination::FindBounds(Node* index,
+                                            ZoneVector<Bound>* bounds) {
+  for (Node* comparison : index->uses()) {
+    bool const less_than = IsLessThan(comparison);
+    if (!less_than && !IsLessThanOrEqual(comparison)) continue;
+    Node* left = NodeProperties::GetValueInput(comparison, 0);
+    Node* right = NodeProperties::GetValueInput(comparison, 1);
+    if (left == right) continue;
+
+    // Normalize the comparison to index < limit or index <= limit. If the
+    // {index} is on the right hand side, the bound holds if the comparison
+    // is false.
+    bool const index_on_left = (left == index);
+    Node* limit = index_on_left ? right : left;
+    bool const strict = index_on_left ? less_than : !less_than;
+    if (!index_on_left && !CannotBeNaN(comparison, limit)) continue;
+    IrOpcode::Value const projection_opcode =
+        index_on_left ? IrOpcode::kIfTrue : IrOpcode::kIfFalse;
+
+    for (Node* branch : comparison->uses()) {
+      if (branch->opcode() != IrOpcode::kBranch) continue;
+      for (Node* projection : branch->uses()) {
+        if (projection->opcode() != projection_opcode) continue;
+        bounds->push_back({projection, comparison, limit, strict});
+      }
+    }
+  }
+}
+
+bool LoopBoundsCheckElimination::IsDominatedBy(Node* control,
+                                               Node* dominator) {
+  int budget = kMaxControlWalk;
+  return ControlIsDominatedBy(control, dominator, &budget);
+}
+
+bool LoopBoundsCheckElimination::IsIncreasingInductionVariable(Node* node) {
+  if (node->opcode() != IrOpcode::kPhi) return false;
+  if (node->op()->ValueInputCount() != 2) return false;
+  Node* loop = NodeProperties::GetControlInput(node);
+  if (loop->opcode() != IrOpcode::kLoop) return false;
+
+  Node* arith = NodeProperties::GetValueInput(node, 1);
+  while (arith->opcode() == IrOpcode::kTypeGuard) {
+    arith = NodeProperties::GetValueInput(arith, 0);
+  }
+  if (arith->opcode() != IrOpcode::kNumberAdd &&
+      arith->opcode() != IrOpcode::kSpeculativeNumberAdd) {
+    return false;
+  }
+  if (NodeProperties::GetValueInput(arith, 0) != node) return false;
+  Node* increment = NodeProperties::GetValueInput(arith, 1);
+  return NodeProperties::GetType(increment)->Is(
+      type_cache_.kPositiveSafeInteger);
+}
+
+bool LoopBoundsCheckElimination::TryHoist(Node* index, Node* length,
+                                          Node* control, Bound const& bound) {
+  Node* loop = NodeProperties::GetControlInput(index);
+  LoopTree::Loop* loop_info = loop_tree_->ContainingLoop(loop);
+  if (loop_info == nullptr) return false;
+  // The hoisted check fails at the loop entry. That is only as good as the
+  // original check if the check runs on every iteration, i.e. dominates the
+  // back edges.
+  for (int i = kAssumedLoopEntryIndex + 1; i < loop->InputCount(); ++i) {
+    if (!IsDominatedBy(NodeProperties::GetControlInput(loop, i), control)) {
+      return false;
+    }
+  }
+  // Both sides of the hoisted check must be available before the loop.
+  if (loop_tree_->Contains(loop_info, bound.limit) ||
+      loop_tree_->Contains(loop_info, length)) {
+    return false;
+  }
+
+  for (HoistedCheck const& hoisted : hoisted_checks_) {
+    if (hoisted.loop == loop && hoisted.limit == bound.limit &&
+        hoisted.length == length && hoisted.strict == bound.strict) {
+      return true;
+    }
+  }
+
+  Node* effect_phi = nullptr;
+  Node* frame_state = FindPreheaderFrameState(loop, &effect_phi);
+  if (frame_state == nullptr) return false;
+
+  // Deoptimize before entering the loop unless index < limit <= length (or
+  // index <= limit < length) holds for all iterations.
+  Node* effect =
+      NodeProperties::GetEffectInput(effect_phi, kAssumedLoopEntryIndex);
+  control = NodeProperties::GetControlInput(loop, kAssumedLoopEntryIndex);
+  effect = graph()->NewNode(common()->Checkpoint(), frame_state, effect,
+                            control);
+  Node* condition;
+  if (IsSpeculative(bound.comparison)) {
+    NumberOperationHint hint = NumberOperationHintOf(bound.comparison->op());
+    const Operator* op =
+        bound.strict ? simplified()->SpeculativeNumberLessThanOrEqual(hint)
+                     : simplified()->SpeculativeNumberLessThan(hint);
+    condition = effect =
+        graph()->NewNode(op, bound.limit, length, effect, control);
+  } else {
+    const Operator* op = bound.strict ? simplified()->NumberLessThanOrEqual()
+                                      : simplified()->NumberLessThan();
+    condition = graph()->NewNode(op, bound.limit, length);
+  }
+  NodeProperties::SetType(condition, Type::Boolean());
+  effect =
+      graph()->NewNode(simplified()->CheckIf(), condition, effect, control);
+  NodeProperties::ReplaceEffectInput(effect_phi, effect,
+                                     kAssumedLoopEntryIndex);
+
+  TRACE("Hoisted bounds check #%d:%s %s #%d:%s into preheader of loop #%d\n",
+        bound.limit->id(), bound.limit->op()->mnemonic(),
+        bound.strict ? "<=" : "<", length->id(), length->op()->mnemonic(),
+        loop->id());
+  hoisted_checks_.push_back({loop, bound.limit, length, bound.strict});
+  return true;
+}
+
+Node* LoopBoundsCheckElimination::FindPreheaderFrameState(Node* loop,
+                                                          Node** effect_phi) {
+  for (Node* use : loop->uses()) {
+    if (use->opcode() == IrOpcode::kEffectPhi) {
+      *effect_phi = use;
+      break;
+    }
+  }
+  if (*effect_phi == nullptr) return nullptr;
+
+  // The frame state of a checkpoint can be reused if there are no observable
+  // side effects between the checkpoint and the loop entry.
+  Node* effect =
+      NodeProperties::GetEffectInput(*effect_phi, kAssumedLoopEntryIndex);
+  for (int i = 0; i < kMaxEffectWalk; i++) {
+    if (effect->opcode() == IrOpcode::kCheckpoint) {
+      return NodeProperties::GetFrameStateInput(effect);
+    }
+    if (effect->opcode() == IrOpcode::kBeginRegion ||
+        effect->opcode() == IrOpcode::kFinishRegion ||
+        effect->op()->EffectInputCount() != 1 ||
+        !effect->op()->HasProperty(Operator::kNoWrite)) {
+      return nullptr;
+    }
+    effect = NodeProperties::GetEffectInput(effect);
+  }
+  return nullptr;
+}
+
+void LoopBoundsCheckElimination::ReplaceCheck(Node* check) {
+  // Keep the range of the check on the index for representation selection.
+  Node* index = NodeProperties::GetValueInput(check, 0);
+  Node* effect = NodeProperties::GetEffectInput(check);
+  Node* control = NodeProperties::GetControlInput(check);
+  Type* type = NodeProperties::GetType(check);
+  Node* guard = graph()->NewNode(common()->TypeGuard(type), index, control);
+  NodeProperties::SetType(guard, type);
+  NodeProperties::ReplaceUses(check, guard, effect);
+  check->Kill();
+}
+
+CommonOperatorBuilder* LoopBoundsCheckElimination::common() const {
+  return jsgraph()->common();
+}
+
+Graph* LoopBoundsCheckElimination::graph() const { return jsgraph()->graph(); }
+
+SimplifiedOperatorBuilder* LoopBoundsCheckElimination::simplified() const {
+  return jsgraph()->simplified();
+}
+
+#undef TRACE
+
+}  // namespace compiler
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,99 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_COMPILER_LOOP_BOUNDS_CHECK_ELIMINATION_H_
+#define V8_COMPILER_LOOP_BOUNDS_CHECK_ELIMINATION_H_
+
+#include "src/base/compiler-specific.h"
+#include "src/base/flags.h"
+#include "src/globals.h"
+#include "src/zone/zone-containers.h"
+
+namespace v8 {
+namespace internal {
+namespace compiler {
+
+// Forward declarations.
+class CommonOperatorBuilder;
+class Graph;
+class JSGraph;
+class LoopTree;
+class Node;
+class SimplifiedOperatorBuilder;
+class TypeCache;
+
+// Removes CheckBounds nodes whose index is known to be in bounds because of a
+// dominating comparison, typically the condition of a loop over an array.
+//
+// A CheckBounds(index, length) is redundant if {index} is a non-negative
+// integer and every path to the check passes through a branch on
+// index < length for the same {length} node. If the dominating branch
+// compares the induction variable of a loop against some other loop
+// invariant {limit} instead, a single check limit <= length is placed in the
+// loop preheader and the checks inside the loop are removed. Only checks that
+// run on every iteration of the loop are hoisted.
+class V8_EXPORT_PRIVATE LoopBoundsCheckElimination final {
+ public:
+  // Flags that control the mode of operation.
+  enum Flag {
+    kNoFlags = 0u,
+    kHoistingEnabled = 1u << 0,
+  };
+  typedef base::Flags<Flag> Flags;
+
+  LoopBoundsCheckElimination(JSGraph* jsgraph, Flags flags, Zone* zone);
+
+  void Run();
+
+ private:
+  // A condition index < limit (or index <= limit if not {strict}) that holds
+  // on all paths leaving {projection}.
+  struct Bound {
+    Node* projection;
+    Node* comparison;
+    Node* limit;
+    bool strict;
+  };
+
+  // A check limit <= length (or limit < length) in the preheader of {loop}.
+  struct HoistedCheck {
+    Node* loop;
+    Node* limit;
+    Node* length;
+    bool strict;
+  };
+
+  bool TryEliminate(Node* check);
+  bool IsDominatedBy(Node* control, Node* dominator);
+  bool IsIncreasingInductionVariable(Node* node);
+  bool TryHoist(Node* index, Node* length, Node* control, Bound const& bound);
+  Node* FindPreheaderFrameState(Node* loop, Node** effect_phi);
+  void ReplaceCheck(Node* check);
+
+  void FindBounds(Node* index, ZoneVector<Bound>* bounds);
+
+  CommonOperatorBuilder* common() const;
+  Flags flags() const { return flags_; }
+  Graph* graph() const;
+  JSGraph* jsgraph() const { return jsgraph_; }
+  SimplifiedOperatorBuilder* simplified() const;
+  Zone* zone() const { return zone_; }
+
+  JSGraph* const jsgraph_;
+  Flags const flags_;
+  Zone* const zone_;
+  TypeCache const& type_cache_;
+  LoopTree* loop_tree_;
+  ZoneVector<HoistedCheck> hoisted_checks_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopBoundsCheckElimination);
+};
+
+DEFINE_OPERATORS_FOR_FLAGS(LoopBoundsCheckElimination::Flags)
+
+}  // namespace compiler
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_COMPILER_LOOP_BOUNDS_CHECK_ELIMINATION_H_
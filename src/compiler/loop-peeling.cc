@@ -3,6 +3,9 @@
 // found in the LICENSE file.
 
 #include "src/compiler/loop-peeling.h"
+
+#include <algorithm>
+
 #include "src/compiler/common-operator.h"
 #include "src/compiler/graph.h"
 #include "src/compiler/node-marker.h"
@@ -298,6 +301,148 @@ PeeledIteration* LoopPeeler::Peel(Graph* graph, CommonOperatorBuilder* common,
   return iter;
 }
 
+// Loop unrolling reuses the copying machinery of peeling, but places the
+// copies of the body inside the loop: the backedge of the original body
+// enters the first copy, the backedge of every copy enters the next one and
+// the backedge of the last copy becomes the new backedge of the loop. Each
+// copy keeps its own exits, which are marked with their own loop exit nodes
+// and merged with the exits of the original body afterwards.
+bool LoopPeeler::Unroll(Graph* graph, CommonOperatorBuilder* common,
+                        LoopTree* loop_tree, LoopTree::Loop* loop, int factor,
+                        Zone* tmp_zone) {
+  if (factor < 2) return false;
+  Node* loop_node = loop_tree->GetLoopControl(loop);
+  // Only unroll loops with a single backedge.
+  if (loop_node->InputCount() != 2) return false;
+  if (!CanPeel(loop_tree, loop)) return false;
+
+  NodeVector headers(tmp_zone);
+  NodeVector backedges(tmp_zone);
+  for (Node* node : loop_tree->HeaderNodes(loop)) {
+    headers.push_back(node);
+    backedges.push_back(node->InputAt(1));
+  }
+  NodeVector exits(tmp_zone);
+  for (Node* node : loop_tree->ExitNodes(loop)) exits.push_back(node);
+
+  // The inputs of the exit nodes in every copy, indexed by exit and copy.
+  size_t const copies = static_cast<size_t>(factor - 1);
+  NodeVector exit_inputs(exits.size() * copies, nullptr, tmp_zone);
+
+  //============================================================================
+  // Construct the copies of the loop body.
+  //============================================================================
+  Node* dead = graph->NewNode(common->Dead());
+  size_t estimated_copy_size = 5 + (loop->TotalSize()) * 2;
+  for (size_t copy = 0; copy < copies; copy++) {
+    NodeVector pairs(tmp_zone);
+    Peeling peeling(graph, tmp_zone, estimated_copy_size, &pairs);
+
+    // The loop header nodes of the copy are the backedge values of the
+    // previous copy.
+    for (size_t i = 0; i < headers.size(); i++) {
+      peeling.Insert(headers[i], backedges[i]);
+    }
+    peeling.CopyNodes(graph, tmp_zone, dead, loop_tree->BodyNodes(loop));
+
+    for (size_t i = 0; i < headers.size(); i++) {
+      backedges[i] = peeling.map(headers[i]->InputAt(1));
+    }
+    for (size_t i = 0; i < exits.size(); i++) {
+      exit_inputs[i * copies + copy] = peeling.map(exits[i]->InputAt(0));
+    }
+  }
+
+  // Close the loop with the backedge of the last copy.
+  for (size_t i = 0; i < headers.size(); i++) {
+    headers[i]->ReplaceInput(1, backedges[i]);
+  }
+
+  //============================================================================
+  // Mark the exits of the copies and merge them with the original exits.
+  //============================================================================
+  NodeVector exit_copies(exits.size() * copies, nullptr, tmp_zone);
+  for (size_t i = 0; i < exits.size(); i++) {
+    if (exits[i]->opcode() != IrOpcode::kLoopExit) continue;
+    for (size_t copy = 0; copy < copies; copy++) {
+      exit_copies[i * copies + copy] = graph->NewNode(
+          common->LoopExit(), exit_inputs[i * copies + copy], loop_node);
+    }
+  }
+  for (size_t i = 0; i < exits.size(); i++) {
+    Node* exit = exits[i];
+    if (exit->opcode() == IrOpcode::kLoopExit) continue;
+    DCHECK(exit->opcode() == IrOpcode::kLoopExitValue ||
+           exit->opcode() == IrOpcode::kLoopExitEffect);
+    size_t const loop_exit = static_cast<size_t>(
+        std::find(exits.begin(), exits.end(),
+                  NodeProperties::GetControlInput(exit)) -
+        exits.begin());
+    DCHECK_LT(loop_exit, exits.size());
+    for (size_t copy = 0; copy < copies; copy++) {
+      Node* marker =
+          graph->NewNode(exit->op(), exit_inputs[i * copies + copy],
+                         exit_copies[loop_exit * copies + copy]);
+      if (NodeProperties::IsTyped(exit)) {
+        NodeProperties::SetType(marker, NodeProperties::GetType(exit));
+      }
+      exit_copies[i * copies + copy] = marker;
+    }
+  }
+
+  NodeVector inputs(tmp_zone);
+  for (size_t i = 0; i < exits.size(); i++) {
+    Node* exit = exits[i];
+    if (exit->opcode() != IrOpcode::kLoopExit) continue;
+    inputs.clear();
+    inputs.push_back(exit);
+    for (size_t copy = 0; copy < copies; copy++) {
+      inputs.push_back(exit_copies[i * copies + copy]);
+    }
+    Node* merge = graph->NewNode(common->Merge(factor), factor, &inputs[0]);
+
+    // Merge the values and effects leaving the loop through the copies.
+    for (size_t j = 0; j < exits.size(); j++) {
+      Node* marker = exits[j];
+      if (marker->opcode() == IrOpcode::kLoopExit ||
+          NodeProperties::GetControlInput(marker) != exit) {
+        continue;
+      }
+      inputs.clear();
+      inputs.push_back(marker);
+      for (size_t copy = 0; copy < copies; copy++) {
+        inputs.push_back(exit_copies[j * copies + copy]);
+      }
+      inputs.push_back(merge);
+      Node* phi;
+      if (marker->opcode() == IrOpcode::kLoopExitValue) {
+        phi = graph->NewNode(common->Phi(MachineRepresentation::kTagged, factor),
+                             factor + 1, &inputs[0]);
+        if (NodeProperties::IsTyped(marker)) {
+          NodeProperties::SetType(phi, NodeProperties::GetType(marker));
+        }
+      } else {
+        phi = graph->NewNode(common->EffectPhi(factor), factor + 1,
+                             &inputs[0]);
+      }
+      for (Edge edge : marker->use_edges()) {
+        if (edge.from() != phi) edge.UpdateTo(phi);
+      }
+    }
+
+    for (Edge edge : exit->use_edges()) {
+      Node* use = edge.from();
+      if (use == merge) continue;
+      if (use->opcode() == IrOpcode::kLoopExitValue ||
+          use->opcode() == IrOpcode::kLoopExitEffect) {
+        continue;
+      }
+      edge.UpdateTo(merge);
+    }
+  }
+  return true;
+}
+
 namespace {
 
 void PeelInnerLoops(Graph* graph, CommonOperatorBuilder* common,
@@ -323,6 +468,30 @@ void PeelInnerLoops(Graph* graph, CommonOperatorBuilder* common,
   LoopPeeler::Peel(graph, common, loop_tree, loop, temp_zone);
 }
 
+void UnrollInnerLoops(Graph* graph, CommonOperatorBuilder* common,
+                      LoopTree* loop_tree, LoopTree::Loop* loop, int factor,
+                      Zone* temp_zone) {
+  // If the loop has nested loops, unroll those.
+  if (!loop->children().empty()) {
+    for (LoopTree::Loop* inner_loop : loop->children()) {
+      UnrollInnerLoops(graph, common, loop_tree, inner_loop, factor,
+                       temp_zone);
+    }
+    return;
+  }
+  // Only unroll small-enough loops.
+  if (loop->TotalSize() * static_cast<size_t>(factor) >
+      LoopPeeler::kMaxUnrolledNodes) {
+    return;
+  }
+  if (FLAG_trace_turbo_loop) {
+    PrintF("Unrolling loop with header %i by %i\n",
+           loop_tree->GetLoopControl(loop)->id(), factor);
+  }
+
+  LoopPeeler::Unroll(graph, common, loop_tree, loop, factor, temp_zone);
+}
+
 void EliminateLoopExit(Node* node) {
   DCHECK_EQ(IrOpcode::kLoopExit, node->opcode());
   // The exit markers take the loop exit as input. We iterate over uses
@@ -358,6 +527,17 @@ void LoopPeeler::PeelInnerLoopsOfTree(Graph* graph,
   EliminateLoopExits(graph, temp_zone);
 }
 
+// static
+void LoopPeeler::UnrollInnerLoopsOfTree(Graph* graph,
+                                        CommonOperatorBuilder* common,
+                                        LoopTree* loop_tree, int factor,
+                                        Zone* temp_zone) {
+  if (factor < 2) return;
+  for (LoopTree::Loop* loop : loop_tree->outer_loops()) {
+    UnrollInnerLoops(graph, common, loop_tree, loop, factor, temp_zone);
+  }
+}
+
 // static
 void LoopPeeler::EliminateLoopExits(Graph* graph, Zone* temp_zone) {
   ZoneQueue<Node*> queue(temp_zone);
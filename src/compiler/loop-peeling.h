@@ -38,8 +38,20 @@ class V8_EXPORT_PRIVATE LoopPeeler {
   static void PeelInnerLoopsOfTree(Graph* graph, CommonOperatorBuilder* common,
                                    LoopTree* loop_tree, Zone* tmp_zone);
 
+  // Unrolls {loop} by copying its body {factor} - 1 times. Every copy keeps
+  // the exits of the original body, so no trip count is required. Returns
+  // false if the loop cannot be unrolled.
+  static bool Unroll(Graph* graph, CommonOperatorBuilder* common,
+                     LoopTree* loop_tree, LoopTree::Loop* loop, int factor,
+                     Zone* tmp_zone);
+  static void UnrollInnerLoopsOfTree(Graph* graph,
+                                     CommonOperatorBuilder* common,
+                                     LoopTree* loop_tree, int factor,
+                                     Zone* tmp_zone);
+
   static void EliminateLoopExits(Graph* graph, Zone* temp_zone);
   static const size_t kMaxPeeledNodes = 1000;
+  static const size_t kMaxUnrolledNodes = 1000;
 };
 
 
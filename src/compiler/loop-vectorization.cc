@@ -0,0 +1,698 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/compiler/loop-vectorization.h"
+
+#include <algorithm>
+
+#include "src/assembler.h"
+#include "src/compiler/common-operator.h"
+#include "src/compiler/graph.h"
+#include "src/compiler/js-graph.h"
+#include "src/compiler/machine-operator.h"
+#include "src/compiler/node-matchers.h"
+#include "src/compiler/node-properties.h"
+#include "src/compiler/node.h"
+#include "src/compiler/simplified-operator.h"
+#include "src/conversions-inl.h"
+
+namespace v8 {
+namespace internal {
+namespace compiler {
+
+#define TRACE(...)                                  \
+  do {                                              \
+    if (FLAG_trace_turbo_loop) PrintF(__VA_ARGS__); \
+  } while (false)
+
+namespace {
+
+// The number of elements processed per iteration of a vector loop.
+const int kLanes = 4;
+
+// All supported element types are four bytes wide.
+const int kElementSizeLog2 = 2;
+
+// Limits the size of loops that are copied.
+const size_t kMaxVectorizedNodes = 1000;
+
+}  // namespace
+
+LoopVectorization::LoopVectorization(JSGraph* jsgraph, Zone* zone)
+    : jsgraph_(jsgraph),
+      zone_(zone),
+      loop_tree_(nullptr),
+      candidate_(nullptr),
+      copies_(zone),
+      vectors_(zone),
+      vector_induction_(nullptr),
+      last_index_(nullptr) {}
+
+// static
+bool LoopVectorization::IsSupported() {
+#if V8_TARGET_ARCH_X64
+  // Lane extraction and 32-bit lane multiplication require SSE4.1.
+  return CpuFeatures::IsSupported(SSE4_1);
+#else
+  return false;
+#endif
+}
+
+void LoopVectorization::Run() {
+  loop_tree_ = LoopFinder::BuildLoopTree(graph(), zone());
+  for (LoopTree::Loop* loop : loop_tree_->outer_loops()) {
+    VisitLoop(loop);
+  }
+}
+
+void LoopVectorization::VisitLoop(LoopTree::Loop* loop) {
+  // Only innermost loops are vectorized.
+  if (!loop->children().empty()) {
+    for (LoopTree::Loop* inner_loop : loop->children()) {
+      VisitLoop(inner_loop);
+    }
+    return;
+  }
+  Candidate candidate(zone());
+  candidate.loop = loop;
+  if (!Analyze(&candidate)) return;
+  TRACE("Vectorizing loop with header %i\n", candidate.header->id());
+  Vectorize(candidate);
+}
+
+bool LoopVectorization::Analyze(Candidate* candidate) {
+  if (candidate->loop->TotalSize() > kMaxVectorizedNodes) return false;
+  candidate->header = loop_tree_->HeaderNode(candidate->loop);
+  if (candidate->header->InputCount() != 2) return false;
+  for (Node* node : loop_tree_->HeaderNodes(candidate->loop)) {
+    switch (node->opcode()) {
+      case IrOpcode::kLoop:
+        break;
+      case IrOpcode::kEffectPhi:
+        if (candidate->effect_phi != nullptr) return false;
+        candidate->effect_phi = node;
+        break;
+      case IrOpcode::kPhi:
+        if (PhiRepresentationOf(node->op()) != MachineRepresentation::kWord32) {
+          return false;
+        }
+        break;
+      default:
+        return false;
+    }
+  }
+  if (candidate->effect_phi == nullptr) return false;
+  if (!AnalyzeControl(candidate)) return false;
+  if (!AnalyzeEffects(candidate)) return false;
+  if (!AnalyzeReductions(candidate)) return false;
+  return !candidate->loads.empty() &&
+         (candidate->store != nullptr || !candidate->reductions.empty());
+}
+
+bool LoopVectorization::AnalyzeControl(Candidate* candidate) {
+  // The loop must be exited through a single branch at the header.
+  Node* branch = nullptr;
+  size_t control_nodes = 0;
+  for (Node* node : loop_tree_->BodyNodes(candidate->loop)) {
+    if (node->op()->ControlOutputCount() == 0) continue;
+    control_nodes++;
+    if (node->opcode() == IrOpcode::kBranch) {
+      if (branch != nullptr) return false;
+      branch = node;
+    }
+  }
+  if (branch == nullptr) return false;
+  if (NodeProperties::GetControlInput(branch) != candidate->header) {
+    return false;
+  }
+
+  // The body must be a straight line from the true projection to the
+  // backedge. Stack checks are executed once per vector iteration.
+  Node* control = NodeProperties::GetControlInput(candidate->header, 1);
+  size_t chain_length = 2;  // The branch and its true projection.
+  while (control->opcode() == IrOpcode::kJSStackCheck) {
+    control = NodeProperties::GetControlInput(control);
+    chain_length++;
+  }
+  if (control->opcode() != IrOpcode::kIfTrue) return false;
+  if (NodeProperties::GetControlInput(control) != branch) return false;
+  if (chain_length != control_nodes) return false;
+
+  // The branch must compare the induction variable against a loop invariant
+  // limit.
+  Node* condition = NodeProperties::GetValueInput(branch, 0);
+  switch (condition->opcode()) {
+    case IrOpcode::kInt32LessThan:
+    case IrOpcode::kInt32LessThanOrEqual:
+    case IrOpcode::kUint32LessThan:
+    case IrOpcode::kUint32LessThanOrEqual:
+      break;
+    default:
+      return false;
+  }
+  Node* induction = condition->InputAt(0);
+  Node* limit = condition->InputAt(1);
+  if (induction->opcode() != IrOpcode::kPhi ||
+      NodeProperties::GetControlInput(induction) != candidate->header) {
+    return false;
+  }
+  if (loop_tree_->Contains(candidate->loop, limit)) return false;
+
+  // The induction variable must be incremented by one.
+  Node* increment = induction->InputAt(1);
+  if (increment->opcode() != IrOpcode::kInt32Add &&
+      increment->opcode() != IrOpcode::kCheckedInt32Add) {
+    return false;
+  }
+  Node* left = increment->InputAt(0);
+  Node* right = increment->InputAt(1);
+  if (!(left == induction && Int32Matcher(right).Is(1)) &&
+      !(right == induction && Int32Matcher(left).Is(1))) {
+    return false;
+  }
+
+  candidate->branch = branch;
+  candidate->condition = condition;
+  candidate->induction = induction;
+  candidate->increment = increment;
+  candidate->limit = limit;
+  return true;
+}
+
+bool LoopVectorization::AnalyzeEffects(Candidate* candidate) {
+  // Collect the effect chain from the backedge up to the effect phi.
+  ZoneVector<Node*>& chain = candidate->chain;
+  Node* effect = NodeProperties::GetEffectInput(candidate->effect_phi, 1);
+  while (effect != candidate->effect_phi) {
+    if (effect->op()->EffectInputCount() != 1) return false;
+    if (effect->op()->ControlInputCount() != 1) return false;
+    if (loop_tree_->ContainingLoop(effect) != candidate->loop) return false;
+    if (chain.size() > kMaxVectorizedNodes) return false;
+    chain.push_back(effect);
+    effect = NodeProperties::GetEffectInput(effect);
+  }
+  std::reverse(chain.begin(), chain.end());
+
+  // The chain must contain all effectful nodes of the body.
+  size_t effect_nodes = 0;
+  for (Node* node : loop_tree_->BodyNodes(candidate->loop)) {
+    if (node->op()->EffectOutputCount() > 0) effect_nodes++;
+  }
+  if (effect_nodes != chain.size()) return false;
+
+  // The nodes before the branch are controlled by the loop header. The last
+  // of them is the effect that leaves the loop.
+  candidate->exit_effect = candidate->effect_phi;
+  bool before_branch = true;
+  for (Node* node : chain) {
+    if (NodeProperties::GetControlInput(node) == candidate->header) {
+      if (!before_branch) return false;
+      candidate->exit_effect = node;
+    } else {
+      before_branch = false;
+    }
+  }
+
+  // Apart from checks of loop invariant values, the body may only access
+  // elements at the induction variable. Nothing but checkpoints and the
+  // increment of the induction variable may follow the store, because a
+  // deoptimization after the store would repeat the remaining lanes.
+  bool has_checkpoint = false;
+  for (Node* node : chain) {
+    if (candidate->store != nullptr && node != candidate->increment &&
+        node->opcode() != IrOpcode::kCheckpoint) {
+      return false;
+    }
+    switch (node->opcode()) {
+      case IrOpcode::kCheckpoint:
+        has_checkpoint = true;
+        break;
+      case IrOpcode::kJSStackCheck:
+        // Stack checks are lowered to calls, after which checks need a new
+        // checkpoint.
+        has_checkpoint = false;
+        break;
+      case IrOpcode::kLoadTypedElement:
+        if (Classify(candidate, node) != kVector) return false;
+        if (!MergeLaneType(candidate, LaneTypeOf(node))) return false;
+        candidate->loads.push_back(node);
+        break;
+      case IrOpcode::kStoreTypedElement:
+        // The overlap checks take the frame state of a preceding checkpoint.
+        if (!has_checkpoint) return false;
+        if (Classify(candidate, node->InputAt(3)) != kIndex) return false;
+        for (int i = 0; i < 3; ++i) {
+          if (Classify(candidate, node->InputAt(i)) != kUniform) return false;
+        }
+        if (Classify(candidate, node->InputAt(4)) != kVector) return false;
+        if (!MergeLaneType(candidate, LaneTypeOf(node))) return false;
+        candidate->store = node;
+        break;
+      default: {
+        if (node == candidate->increment) break;
+        Kind const kind = Classify(candidate, node);
+        if (kind != kUniform && kind != kIndex) return false;
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+bool LoopVectorization::AnalyzeReductions(Candidate* candidate) {
+  // All phis other than the induction variable must be int32 sums of
+  // element-wise values.
+  for (Node* node : loop_tree_->HeaderNodes(candidate->loop)) {
+    if (node->opcode() != IrOpcode::kPhi) continue;
+    if (node == candidate->induction) continue;
+    Node* update = node->InputAt(1);
+    if (update->opcode() != IrOpcode::kInt32Add) return false;
+    Node* value = nullptr;
+    if (update->InputAt(0) == node) {
+      value = update->InputAt(1);
+    } else if (update->InputAt(1) == node) {
+      value = update->InputAt(0);
+    } else {
+      return false;
+    }
+    if (Classify(candidate, value) != kVector) return false;
+    if (!MergeLaneType(candidate, kInt32Lanes)) return false;
+    candidate->reductions.push_back(node);
+  }
+  return true;
+}
+
+bool LoopVectorization::MergeLaneType(Candidate* candidate,
+                                      LaneType lane_type) {
+  if (lane_type == kNoLanes) return false;
+  if (candidate->lane_type == kNoLanes) candidate->lane_type = lane_type;
+  return candidate->lane_type == lane_type;
+}
+
+// static
+LoopVectorization::LaneType LoopVectorization::LaneTypeOf(Node* access) {
+  switch (ExternalArrayTypeOf(access->op())) {
+    case kExternalFloat32Array:
+      return kFloat32Lanes;
+    case kExternalInt32Array:
+    case kExternalUint32Array:
+      return kInt32Lanes;
+    default:
+      return kNoLanes;
+  }
+}
+
+LoopVectorization::Kind LoopVectorization::Classify(Candidate* candidate,
+                                                    Node* node) {
+  auto it = candidate->kinds.find(node);
+  if (it != candidate->kinds.end()) return it->second;
+  // Cycles only go through phis, which are never uniform.
+  candidate->kinds[node] = kScalar;
+  Kind const kind = ComputeKind(candidate, node);
+  candidate->kinds[node] = kind;
+  return kind;
+}
+
+LoopVectorization::Kind LoopVectorization::ComputeKind(Candidate* candidate,
+                                                       Node* node) {
+  if (!loop_tree_->Contains(candidate->loop, node)) return kUniform;
+  if (node == candidate->induction) return kIndex;
+  switch (node->opcode()) {
+    case IrOpcode::kPhi:
+    case IrOpcode::kEffectPhi:
+      return kScalar;
+    case IrOpcode::kCheckBounds:
+      if (Classify(candidate, node->InputAt(0)) == kIndex) {
+        return Classify(candidate, node->InputAt(1)) == kUniform ? kIndex
+                                                                 : kScalar;
+      }
+      break;
+    case IrOpcode::kLoadTypedElement: {
+      // Elements are never uniform, since the loop may store to the array.
+      if (Classify(candidate, node->InputAt(3)) != kIndex) return kScalar;
+      for (int i = 0; i < 3; ++i) {
+        if (Classify(candidate, node->InputAt(i)) != kUniform) return kScalar;
+      }
+      return LaneTypeOf(node) == kNoLanes ? kScalar : kVector;
+    }
+    case IrOpcode::kInt32Add:
+    case IrOpcode::kInt32Sub:
+    case IrOpcode::kInt32Mul: {
+      Kind const left = Classify(candidate, node->InputAt(0));
+      Kind const right = Classify(candidate, node->InputAt(1));
+      if (left == kUniform && right == kUniform) return kUniform;
+      if ((left == kUniform || left == kVector) &&
+          (right == kUniform || right == kVector)) {
+        return kVector;
+      }
+      return kScalar;
+    }
+    case IrOpcode::kTruncateFloat64ToFloat32: {
+      // Float32 elements are combined in float64 arithmetic and rounded back
+      // to float32. For a single addition, subtraction or multiplication of
+      // float32 values this yields the float32 result of the operation.
+      Node* input = node->InputAt(0);
+      switch (input->opcode()) {
+        case IrOpcode::kChangeFloat32ToFloat64:
+          if (Classify(candidate, input->InputAt(0)) == kVector) {
+            return kVector;
+          }
+          break;
+        case IrOpcode::kFloat64Add:
+        case IrOpcode::kFloat64Sub:
+        case IrOpcode::kFloat64Mul: {
+          bool left_is_vector = false;
+          bool right_is_vector = false;
+          if (IsFloat32Operand(candidate, input->InputAt(0),
+                               &left_is_vector) &&
+              IsFloat32Operand(candidate, input->InputAt(1),
+                               &right_is_vector) &&
+              (left_is_vector || right_is_vector)) {
+            return kVector;
+          }
+          break;
+        }
+        default:
+          break;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  // Nodes that don't write and only depend on uniform values are uniform.
+  // The loop doesn't store to fields, so this includes field loads.
+  if (node->op()->ControlOutputCount() > 0) return kScalar;
+  if (node->op()->EffectOutputCount() > 0 &&
+      (!node->op()->HasProperty(Operator::kNoWrite) ||
+       node->opcode() == IrOpcode::kLoadTypedElement)) {
+    return kScalar;
+  }
+  for (int i = 0; i < node->op()->ValueInputCount(); ++i) {
+    if (Classify(candidate, node->InputAt(i)) != kUniform) return kScalar;
+  }
+  return kUniform;
+}
+
+bool LoopVectorization::IsFloat32Operand(Candidate* candidate, Node* node,
+                                         bool* is_vector) {
+  if (node->opcode() == IrOpcode::kChangeFloat32ToFloat64) {
+    Kind const kind = Classify(candidate, node->InputAt(0));
+    *is_vector = kind == kVector;
+    return kind == kVector || kind == kUniform;
+  }
+  Float64Matcher m(node);
+  *is_vector = false;
+  return m.HasValue() && DoubleToFloat32(m.Value()) == m.Value();
+}
+
+void LoopVectorization::Vectorize(Candidate const& candidate) {
+  candidate_ = &candidate;
+  copies_.clear();
+  vectors_.clear();
+
+  // Copy the loop. The copy becomes the vector loop, which is entered first
+  // and exits into the original loop.
+  for (Node* node : loop_tree_->LoopNodes(candidate.loop)) {
+    copies_[node] = graph()->CloneNode(node);
+  }
+  for (auto& pair : copies_) {
+    Node* copy = pair.second;
+    for (int i = 0; i < copy->InputCount(); ++i) {
+      auto it = copies_.find(copy->InputAt(i));
+      if (it != copies_.end()) copy->ReplaceInput(i, it->second);
+    }
+  }
+  Node* vector_header = CopyOf(candidate.header);
+  Node* vector_effect_phi = CopyOf(candidate.effect_phi);
+  vector_induction_ = CopyOf(candidate.induction);
+
+  // Advance by the number of lanes and only enter the body if the last lane
+  // is in range.
+  vector_induction_->ReplaceInput(
+      1, graph()->NewNode(machine()->Int32Add(), vector_induction_,
+                          jsgraph()->Int32Constant(kLanes)));
+  last_index_ = graph()->NewNode(machine()->Int32Add(), vector_induction_,
+                                 jsgraph()->Int32Constant(kLanes - 1));
+  Node* vector_branch = CopyOf(candidate.branch);
+  vector_branch->ReplaceInput(
+      0, graph()->NewNode(candidate.condition->op(), last_index_,
+                          candidate.limit));
+  Node* vector_exit = graph()->NewNode(common()->IfFalse(), vector_branch);
+
+  for (Node* node : candidate.chain) {
+    switch (node->opcode()) {
+      case IrOpcode::kCheckBounds:
+        if (KindOf(node) == kIndex) WidenBoundsCheck(CopyOf(node));
+        break;
+      case IrOpcode::kLoadTypedElement:
+        VectorizeLoad(node);
+        break;
+      default:
+        break;
+    }
+  }
+  if (candidate.store != nullptr) VectorizeStore();
+  for (Node* phi : candidate.reductions) {
+    VectorizeReduction(phi);
+  }
+
+  Node* terminate = graph()->NewNode(common()->Terminate(), vector_effect_phi,
+                                     vector_header);
+  NodeProperties::MergeControlToEnd(graph(), common(), terminate);
+
+  // The original loop processes the remaining elements.
+  candidate.header->ReplaceInput(0, vector_exit);
+  candidate.effect_phi->ReplaceInput(0, CopyOf(candidate.exit_effect));
+  candidate.induction->ReplaceInput(0, vector_induction_);
+  candidate_ = nullptr;
+}
+
+void LoopVectorization::WidenBoundsCheck(Node* check) {
+  // The check of the first lane remains, since the index may be negative.
+  Node* control = NodeProperties::GetControlInput(check);
+  Node* widened = graph()->NewNode(simplified()->CheckBounds(), last_index_,
+                                   check->InputAt(1), check, control);
+  for (Edge edge : check->use_edges()) {
+    if (edge.from() != widened && NodeProperties::IsEffectEdge(edge)) {
+      edge.UpdateTo(widened);
+    }
+  }
+}
+
+void LoopVectorization::VectorizeLoad(Node* load) {
+  Node* copy = CopyOf(load);
+  Node* effect = NodeProperties::GetEffectInput(copy);
+  Node* control = NodeProperties::GetControlInput(copy);
+  // Keep the buffer alive like the scalar access does.
+  effect = graph()->NewNode(common()->Retain(), copy->InputAt(0), effect);
+  Node* storage = Storage(copy->InputAt(1), copy->InputAt(2), &effect, control);
+  Node* vector =
+      graph()->NewNode(machine()->Load(MachineType::Simd128()), storage,
+                       Offset(vector_induction_), effect, control);
+  // Deoptimization points see the element of the first lane.
+  NodeProperties::ReplaceUses(copy, ExtractLane(vector, 0), vector);
+  copy->Kill();
+  vectors_[load] = vector;
+}
+
+void LoopVectorization::VectorizeStore() {
+  Node* store = candidate_->store;
+  Node* copy = CopyOf(store);
+  Node* value = GetVector(store->InputAt(4));
+  Node* effect = NodeProperties::GetEffectInput(copy);
+  Node* control = NodeProperties::GetControlInput(copy);
+  Node* storage = Storage(copy->InputAt(1), copy->InputAt(2), &effect, control);
+
+  // If the stored elements start less than a vector after the elements of a
+  // loaded array, the scalar loop would load elements that were stored in
+  // an earlier iteration of the same block. Deoptimize in that case.
+  ZoneVector<Node*> checked_arrays(zone());
+  for (Node* load : candidate_->loads) {
+    Node* base = CopyOf(load->InputAt(1));
+    Node* external = CopyOf(load->InputAt(2));
+    if (base == copy->InputAt(1) && external == copy->InputAt(2)) continue;
+    if (std::find(checked_arrays.begin(), checked_arrays.end(), external) !=
+        checked_arrays.end()) {
+      continue;
+    }
+    checked_arrays.push_back(external);
+    Node* distance =
+        graph()->NewNode(machine()->IntSub(), storage,
+                         Storage(base, external, &effect, control));
+    Node* overlap = graph()->NewNode(
+        machine()->UintLessThan(),
+        graph()->NewNode(machine()->IntSub(), distance,
+                         jsgraph()->IntPtrConstant(1)),
+        jsgraph()->IntPtrConstant(kSimd128Size - 1));
+    Node* no_overlap = graph()->NewNode(machine()->Word32Equal(), overlap,
+                                        jsgraph()->Int32Constant(0));
+    effect = graph()->NewNode(simplified()->CheckIf(), no_overlap, effect,
+                              control);
+  }
+
+  effect = graph()->NewNode(common()->Retain(), copy->InputAt(0), effect);
+  effect = graph()->NewNode(
+      machine()->Store(StoreRepresentation(MachineRepresentation::kSimd128,
+                                           kNoWriteBarrier)),
+      storage, Offset(vector_induction_), value, effect, control);
+  NodeProperties::ReplaceUses(copy, nullptr, effect);
+  copy->Kill();
+}
+
+void LoopVectorization::VectorizeReduction(Node* phi) {
+  Node* update = phi->InputAt(1);
+  Node* value =
+      update->InputAt(0) == phi ? update->InputAt(1) : update->InputAt(0);
+  Node* zero = graph()->NewNode(machine()->S128Zero());
+  Node* accumulator = graph()->NewNode(
+      common()->Phi(MachineRepresentation::kSimd128, 2), zero, zero,
+      CopyOf(candidate_->header));
+  accumulator->ReplaceInput(
+      1, graph()->NewNode(machine()->I32x4Add(), accumulator,
+                          GetVector(value)));
+
+  // The scalar value of the reduction is the initial value plus the sum of
+  // all lanes. It is used by deoptimization points and the original loop.
+  Node* sum = phi->InputAt(0);
+  for (int lane = 0; lane < kLanes; ++lane) {
+    sum = graph()->NewNode(machine()->Int32Add(), sum,
+                           ExtractLane(accumulator, lane));
+  }
+  Node* copy = CopyOf(phi);
+  NodeProperties::ReplaceUses(copy, sum);
+  copy->Kill();
+  phi->ReplaceInput(0, sum);
+}
+
+Node* LoopVectorization::GetVector(Node* node) {
+  auto it = vectors_.find(node);
+  if (it != vectors_.end()) return it->second;
+  Node* vector;
+  if (KindOf(node) == kUniform) {
+    vector = Splat(CopyOf(node));
+  } else {
+    switch (node->opcode()) {
+      case IrOpcode::kInt32Add:
+        vector = graph()->NewNode(machine()->I32x4Add(),
+                                  GetVector(node->InputAt(0)),
+                                  GetVector(node->InputAt(1)));
+        break;
+      case IrOpcode::kInt32Sub:
+        vector = graph()->NewNode(machine()->I32x4Sub(),
+                                  GetVector(node->InputAt(0)),
+                                  GetVector(node->InputAt(1)));
+        break;
+      case IrOpcode::kInt32Mul:
+        vector = graph()->NewNode(machine()->I32x4Mul(),
+                                  GetVector(node->InputAt(0)),
+                                  GetVector(node->InputAt(1)));
+        break;
+      case IrOpcode::kTruncateFloat64ToFloat32: {
+        Node* input = node->InputAt(0);
+        if (input->opcode() == IrOpcode::kChangeFloat32ToFloat64) {
+          vector = GetVector(input->InputAt(0));
+          break;
+        }
+        const Operator* op = nullptr;
+        switch (input->opcode()) {
+          case IrOpcode::kFloat64Add:
+            op = machine()->F32x4Add();
+            break;
+          case IrOpcode::kFloat64Sub:
+            op = machine()->F32x4Sub();
+            break;
+          case IrOpcode::kFloat64Mul:
+            op = machine()->F32x4Mul();
+            break;
+          default:
+            UNREACHABLE();
+        }
+        vector = graph()->NewNode(op, GetFloat32Operand(input->InputAt(0)),
+                                  GetFloat32Operand(input->InputAt(1)));
+        break;
+      }
+      default:
+        UNREACHABLE();
+        return nullptr;
+    }
+  }
+  vectors_[node] = vector;
+  return vector;
+}
+
+Node* LoopVectorization::GetFloat32Operand(Node* node) {
+  if (node->opcode() == IrOpcode::kChangeFloat32ToFloat64) {
+    return GetVector(node->InputAt(0));
+  }
+  Float64Matcher m(node);
+  DCHECK(m.HasValue());
+  return Splat(jsgraph()->Float32Constant(DoubleToFloat32(m.Value())));
+}
+
+Node* LoopVectorization::Splat(Node* value) {
+  const Operator* op = candidate_->lane_type == kFloat32Lanes
+                           ? machine()->F32x4Splat()
+                           : machine()->I32x4Splat();
+  return graph()->NewNode(op, value);
+}
+
+Node* LoopVectorization::ExtractLane(Node* vector, int lane) {
+  const Operator* op = candidate_->lane_type == kFloat32Lanes
+                           ? machine()->F32x4ExtractLane(lane)
+                           : machine()->I32x4ExtractLane(lane);
+  return graph()->NewNode(op, vector);
+}
+
+Node* LoopVectorization::Storage(Node* base, Node* external, Node** effect,
+                                 Node* control) {
+  // The effective storage pointer of a typed array, where the {external}
+  // pointer alone is the storage pointer if the {base} is Smi zero. The
+  // addition is part of the effect chain, like in GraphAssembler, so that
+  // the GC can't move {base} before the pointer is used.
+  if (NumberMatcher(base).Is(0)) return external;
+  return *effect = graph()->NewNode(machine()->UnsafePointerAdd(), base,
+                                    external, *effect, control);
+}
+
+Node* LoopVectorization::Offset(Node* index) {
+  Node* offset = graph()->NewNode(machine()->Word32Shl(), index,
+                                  jsgraph()->Int32Constant(kElementSizeLog2));
+  if (machine()->Is64()) {
+    offset = graph()->NewNode(machine()->ChangeUint32ToUint64(), offset);
+  }
+  return offset;
+}
+
+Node* LoopVectorization::CopyOf(Node* node) {
+  auto it = copies_.find(node);
+  return it == copies_.end() ? node : it->second;
+}
+
+LoopVectorization::Kind LoopVectorization::KindOf(Node* node) {
+  auto it = candidate_->kinds.find(node);
+  if (it != candidate_->kinds.end()) return it->second;
+  DCHECK(!loop_tree_->Contains(candidate_->loop, node));
+  return kUniform;
+}
+
+CommonOperatorBuilder* LoopVectorization::common() const {
+  return jsgraph()->common();
+}
+
+Graph* LoopVectorization::graph() const { return jsgraph()->graph(); }
+
+MachineOperatorBuilder* LoopVectorization::machine() const {
+  return jsgraph()->machine();
+}
+
+SimplifiedOperatorBuilder* LoopVectorization::simplified() const {
+  return jsgraph()->simplified();
+}
+
+#undef TRACE
+
+}  // namespace compiler
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,151 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_COMPILER_LOOP_VECTORIZATION_H_
+#define V8_COMPILER_LOOP_VECTORIZATION_H_
+
+#include "src/base/compiler-specific.h"
+#include "src/compiler/loop-analysis.h"
+#include "src/globals.h"
+#include "src/zone/zone-containers.h"
+
+namespace v8 {
+namespace internal {
+namespace compiler {
+
+// Forward declarations.
+class CommonOperatorBuilder;
+class Graph;
+class JSGraph;
+class MachineOperatorBuilder;
+class Node;
+class SimplifiedOperatorBuilder;
+
+// Vectorizes counted loops over Float32Array, Int32Array and Uint32Array
+// elements into 128-bit SIMD machine operators.
+//
+// A loop qualifies if its body is straight-line code that, apart from checks
+// on loop invariant values, only accesses typed array elements at the
+// induction variable and either stores an element-wise combination of those
+// elements or adds them up into an int32 variable. Such a loop is versioned:
+// a copy that processes four elements per iteration runs first and the
+// original loop finishes the remaining elements.
+//
+// Deoptimization points inside the vector loop resume the scalar loop at the
+// first element of the current block, with the values of that element. This
+// is correct because no element of the block has been stored at that point.
+// The vector loop deoptimizes if the stored array partially overlaps one of
+// the loaded arrays.
+//
+// This runs after simplified lowering, i.e. it matches machine operators.
+class V8_EXPORT_PRIVATE LoopVectorization final {
+ public:
+  LoopVectorization(JSGraph* jsgraph, Zone* zone);
+
+  void Run();
+
+  // Returns true if the target supports the SIMD operators that are used for
+  // vectorized loops.
+  static bool IsSupported();
+
+ private:
+  // The classification of a node inside a candidate loop.
+  enum Kind {
+    kUniform,  // The same value in each iteration.
+    kIndex,    // The induction variable or a bounds check of it.
+    kVector,   // An element-wise value that can be computed in lanes.
+    kScalar    // Anything else.
+  };
+
+  enum LaneType { kNoLanes, kFloat32Lanes, kInt32Lanes };
+
+  // A loop that can be vectorized.
+  struct Candidate {
+    explicit Candidate(Zone* zone)
+        : loop(nullptr),
+          header(nullptr),
+          effect_phi(nullptr),
+          induction(nullptr),
+          increment(nullptr),
+          branch(nullptr),
+          condition(nullptr),
+          limit(nullptr),
+          exit_effect(nullptr),
+          store(nullptr),
+          lane_type(kNoLanes),
+          chain(zone),
+          loads(zone),
+          reductions(zone),
+          kinds(zone) {}
+
+    LoopTree::Loop* loop;
+    Node* header;
+    Node* effect_phi;
+    Node* induction;
+    Node* increment;
+    Node* branch;
+    Node* condition;
+    Node* limit;
+    // The effect that leaves the loop through the exit of {branch}.
+    Node* exit_effect;
+    Node* store;
+    LaneType lane_type;
+    // The effect chain of the loop body in program order.
+    ZoneVector<Node*> chain;
+    ZoneVector<Node*> loads;
+    ZoneVector<Node*> reductions;
+    ZoneMap<Node*, Kind> kinds;
+  };
+
+  void VisitLoop(LoopTree::Loop* loop);
+  bool Analyze(Candidate* candidate);
+  bool AnalyzeControl(Candidate* candidate);
+  bool AnalyzeEffects(Candidate* candidate);
+  bool AnalyzeReductions(Candidate* candidate);
+  bool MergeLaneType(Candidate* candidate, LaneType lane_type);
+  Kind Classify(Candidate* candidate, Node* node);
+  Kind ComputeKind(Candidate* candidate, Node* node);
+  bool IsFloat32Operand(Candidate* candidate, Node* node, bool* is_vector);
+  static LaneType LaneTypeOf(Node* access);
+  void Vectorize(Candidate const& candidate);
+
+  // Helpers for the vector loop.
+  Node* GetVector(Node* node);
+  Node* GetFloat32Operand(Node* node);
+  Node* Splat(Node* value);
+  Node* ExtractLane(Node* vector, int lane);
+  Node* Storage(Node* base, Node* external, Node** effect, Node* control);
+  Node* Offset(Node* index);
+  Node* CopyOf(Node* node);
+  Kind KindOf(Node* node);
+  void VectorizeLoad(Node* load);
+  void VectorizeStore();
+  void WidenBoundsCheck(Node* check);
+  void VectorizeReduction(Node* phi);
+
+  CommonOperatorBuilder* common() const;
+  Graph* graph() const;
+  JSGraph* jsgraph() const { return jsgraph_; }
+  MachineOperatorBuilder* machine() const;
+  SimplifiedOperatorBuilder* simplified() const;
+  Zone* zone() const { return zone_; }
+
+  JSGraph* const jsgraph_;
+  Zone* const zone_;
+  LoopTree* loop_tree_;
+  // State of the loop that is being vectorized.
+  Candidate const* candidate_;
+  ZoneMap<Node*, Node*> copies_;
+  ZoneMap<Node*, Node*> vectors_;
+  Node* vector_induction_;
+  Node* last_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopVectorization);
+};
+
+}  // namespace compiler
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_COMPILER_LOOP_VECTORIZATION_H_
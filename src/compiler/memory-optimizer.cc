@@ -4,6 +4,8 @@
 
 #include "src/compiler/memory-optimizer.h"
 
+#include <algorithm>
+
 #include "src/compiler/js-graph.h"
 #include "src/compiler/linkage.h"
 #include "src/compiler/node-matchers.h"
@@ -144,6 +146,15 @@ void MemoryOptimizer::VisitAllocate(Node* node, AllocationState const* state) {
           pretenure = TENURED;
           break;
         }
+        // The {parent} might already have been lowered and folded into the
+        // current allocation group, in which case the pretenuring decision
+        // of the group applies to this child object as well.
+        if (state->group() != nullptr &&
+            state->group()->pretenure() == TENURED &&
+            state->group()->Contains(parent)) {
+          pretenure = TENURED;
+          break;
+        }
       }
     }
   }
@@ -415,22 +426,38 @@ WriteBarrierKind MemoryOptimizer::ComputeWriteBarrierKind(
 }
 
 MemoryOptimizer::AllocationState const* MemoryOptimizer::MergeStates(
-    AllocationStates const& states) {
+    AllocationStates const& states, Node* control) {
   // Check if all states are the same; or at least if all allocation
   // states belong to the same allocation group.
   AllocationState const* state = states.front();
   AllocationGroup* group = state->group();
+  bool all_open = state->top() != nullptr;
+  int size = state->size();
   for (size_t i = 1; i < states.size(); ++i) {
     if (states[i] != state) state = nullptr;
     if (states[i]->group() != group) group = nullptr;
+    if (states[i]->top() == nullptr) all_open = false;
+    size = std::max(size, states[i]->size());
   }
   if (state == nullptr) {
-    if (group != nullptr) {
+    if (group != nullptr && all_open) {
+      // All inputs continued to bump allocate in the same group, so the
+      // reservation made at the beginning of the group covers the largest
+      // of the input sizes, and we can keep folding allocations into the
+      // group after the merge. The tops of the inputs are either the top of
+      // a state that dominates the merge or pure arithmetic on it, so a Phi
+      // on the {control} merge is always schedulable.
+      int const input_count = static_cast<int>(states.size());
+      Node** inputs = zone()->NewArray<Node*>(input_count + 1);
+      for (int i = 0; i < input_count; ++i) inputs[i] = states[i]->top();
+      inputs[input_count] = control;
+      Node* top = graph()->NewNode(
+          common()->Phi(MachineType::PointerRepresentation(), input_count),
+          input_count + 1, inputs);
+      state = AllocationState::Open(group, size, top, zone());
+    } else if (group != nullptr) {
       // We cannot fold any more allocations into this group, but we can still
       // eliminate write barriers on stores to this group.
-      // TODO(bmeurer): We could potentially just create a Phi here to merge
-      // the various tops; but we need to pay special attention not to create
-      // an unschedulable graph.
       state = AllocationState::Closed(group, zone());
     } else {
       // The states are from different allocation groups.
@@ -455,17 +482,23 @@ void MemoryOptimizer::EnqueueMerge(Node* node, int index,
     NodeId const id = node->id();
     auto it = pending_.find(id);
     if (it == pending_.end()) {
-      // Insert a new pending merge.
-      it = pending_.insert(std::make_pair(id, AllocationStates(zone()))).first;
+      // Insert a new pending merge, with one slot per input so that the
+      // states line up with the inputs of the {control} merge.
+      it = pending_
+               .insert(std::make_pair(
+                   id, AllocationStates(input_count, nullptr, zone())))
+               .first;
     }
     // Add the next input state.
-    it->second.push_back(state);
+    DCHECK_NULL(it->second[index]);
+    it->second[index] = state;
     // Check if states for all inputs are available by now.
-    if (it->second.size() == static_cast<size_t>(input_count)) {
+    if (std::find(it->second.begin(), it->second.end(), nullptr) ==
+        it->second.end()) {
       // All inputs to this effect merge are done, merge the states given all
       // input constraints, drop the pending merge and enqueue uses of the
       // EffectPhi {node}.
-      state = MergeStates(it->second);
+      state = MergeStates(it->second, control);
       EnqueueUses(node, state);
       pending_.erase(it);
     }
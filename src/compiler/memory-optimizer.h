@@ -119,7 +119,8 @@ class MemoryOptimizer final {
                                            AllocationState const* state,
                                            WriteBarrierKind);
 
-  AllocationState const* MergeStates(AllocationStates const& states);
+  AllocationState const* MergeStates(AllocationStates const& states,
+                                     Node* control);
 
   void EnqueueMerge(Node*, int, AllocationState const*);
   void EnqueueUses(Node*, AllocationState const*);
@@ -21,6 +21,10 @@ int InstructionScheduler::GetInstructionLatency(const Instruction* instr) {
   UNIMPLEMENTED();
 }
 
+int InstructionScheduler::GetInstructionThroughput(const Instruction* instr) {
+  UNIMPLEMENTED();
+}
+
 }  // namespace compiler
 }  // namespace internal
 }  // namespace v8
@@ -8,6 +8,7 @@
 #include "src/compiler/pipeline-statistics.h"
 #include "src/compiler/zone-stats.h"
 #include "src/isolate.h"
+#include "src/objects-inl.h"
 
 namespace v8 {
 namespace internal {
@@ -48,7 +49,9 @@ PipelineStatistics::PipelineStatistics(CompilationInfo* info,
     : isolate_(info->isolate()),
       outer_zone_(info->zone()),
       zone_stats_(zone_stats),
-      compilation_stats_(isolate_->GetTurboStatistics()),
+      compilation_stats_(FLAG_turbo_stats || FLAG_turbo_stats_nvp
+                             ? isolate_->GetTurboStatistics()
+                             : nullptr),
       source_size_(0),
       phase_kind_name_(nullptr),
       phase_name_(nullptr) {
@@ -66,7 +69,9 @@ PipelineStatistics::~PipelineStatistics() {
   if (InPhaseKind()) EndPhaseKind();
   CompilationStatistics::BasicStats diff;
   total_stats_.End(this, &diff);
-  compilation_stats_->RecordTotalStats(source_size_, diff);
+  if (compilation_stats_ != nullptr) {
+    compilation_stats_->RecordTotalStats(source_size_, diff);
+  }
 }
 
 
@@ -82,7 +87,9 @@ void PipelineStatistics::EndPhaseKind() {
   DCHECK(!InPhase());
   CompilationStatistics::BasicStats diff;
   phase_kind_stats_.End(this, &diff);
-  compilation_stats_->RecordPhaseKindStats(phase_kind_name_, diff);
+  if (compilation_stats_ != nullptr) {
+    compilation_stats_->RecordPhaseKindStats(phase_kind_name_, diff);
+  }
 }
 
 
@@ -97,7 +104,55 @@ void PipelineStatistics::EndPhase() {
   DCHECK(InPhaseKind());
   CompilationStatistics::BasicStats diff;
   phase_stats_.End(this, &diff);
-  compilation_stats_->RecordPhaseStats(phase_kind_name_, phase_name_, diff);
+  if (compilation_stats_ != nullptr) {
+    compilation_stats_->RecordPhaseStats(phase_kind_name_, phase_name_, diff);
+  }
+  phase_records_.push_back(
+      {phase_name_, diff.delta_, diff.absolute_max_allocated_bytes_});
+}
+
+void PipelineStatistics::ReportToEmbedder(CompilationInfo* info,
+                                          const char* tier) {
+  DCHECK(!InPhase());
+  CompilationStatisticsCallback callback =
+      isolate_->compilation_statistics_callback();
+  if (callback == nullptr) return;
+
+  std::vector<CompilationStatisticsEvent::Phase> phases;
+  double time_in_ms = 0;
+  for (const PhaseRecord& record : phase_records_) {
+    phases.push_back({record.name, record.delta.InMillisecondsF(),
+                      record.max_allocated_bytes});
+    time_in_ms += phases.back().time_in_ms;
+  }
+
+  CompilationStatisticsEvent event;
+  event.tier = tier;
+  event.function_name = function_name_.c_str();
+  event.script_id = -1;
+  event.start_position = -1;
+  event.deopt_count = 0;
+  if (info->has_shared_info()) {
+    Handle<SharedFunctionInfo> shared = info->shared_info();
+    if (shared->script()->IsScript()) {
+      event.script_id = Script::cast(shared->script())->id();
+    }
+    event.start_position = shared->start_position();
+    event.deopt_count = shared->deopt_count();
+  }
+  event.time_in_ms = time_in_ms;
+  event.max_allocated_bytes = OuterZoneSize() -
+                              total_stats_.outer_zone_initial_size_ +
+                              total_stats_.scope_->GetMaxAllocatedBytes();
+  event.code_size = info->code().is_null()
+                        ? 0
+                        : static_cast<size_t>(
+                              info->code()->SizeIncludingMetadata());
+  event.inlined_function_count =
+      static_cast<int>(info->inlined_functions().size());
+  event.phases = phases.data();
+  event.phase_count = phases.size();
+  callback(reinterpret_cast<v8::Isolate*>(isolate_), &event);
 }
 
 }  // namespace compiler
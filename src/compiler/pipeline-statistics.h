@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "src/base/platform/elapsed-timer.h"
 #include "src/compilation-statistics.h"
@@ -26,6 +27,11 @@ class PipelineStatistics : public Malloced {
   void BeginPhaseKind(const char* phase_kind_name);
   void EndPhaseKind();
 
+  // Reports the statistics of the compilation described by |info| to the
+  // embedder, if it installed a compilation statistics callback. Must be
+  // called on the main thread once the code was generated.
+  void ReportToEmbedder(CompilationInfo* info, const char* tier);
+
  private:
   size_t OuterZoneSize() {
     return static_cast<size_t>(outer_zone_->allocation_size());
@@ -73,6 +79,14 @@ class PipelineStatistics : public Malloced {
   const char* phase_name_;
   CommonStats phase_stats_;
 
+  // Stats for each phase that ran, in order, for reporting to the embedder.
+  struct PhaseRecord {
+    const char* name;
+    base::TimeDelta delta;
+    size_t max_allocated_bytes;
+  };
+  std::vector<PhaseRecord> phase_records_;
+
   DISALLOW_COPY_AND_ASSIGN(PipelineStatistics);
 };
 
@@ -44,8 +44,10 @@
 #include "src/compiler/live-range-separator.h"
 #include "src/compiler/load-elimination.h"
 #include "src/compiler/loop-analysis.h"
+#include "src/compiler/loop-bounds-check-elimination.h"
 #include "src/compiler/loop-peeling.h"
 #include "src/compiler/loop-variable-optimizer.h"
+#include "src/compiler/loop-vectorization.h"
 #include "src/compiler/machine-graph-verifier.h"
 #include "src/compiler/machine-operator-reducer.h"
 #include "src/compiler/memory-optimizer.h"
@@ -513,7 +515,9 @@ PipelineStatistics* CreatePipelineStatistics(CompilationInfo* info,
                                              ZoneStats* zone_stats) {
   PipelineStatistics* pipeline_statistics = nullptr;
 
-  if (FLAG_turbo_stats || FLAG_turbo_stats_nvp) {
+  if (FLAG_turbo_stats || FLAG_turbo_stats_nvp ||
+      (info->IsOptimizing() &&
+       info->isolate()->compilation_statistics_callback() != nullptr)) {
     pipeline_statistics = new PipelineStatistics(info, zone_stats);
     pipeline_statistics->BeginPhaseKind("initializing");
   }
@@ -542,6 +546,15 @@ PipelineStatistics* CreatePipelineStatistics(CompilationInfo* info,
   return pipeline_statistics;
 }
 
+// Huge functions, where register allocation dominates compile time, use the
+// single pass register allocator.
+bool UseFastRegisterAllocator(const InstructionSequence* sequence) {
+  if (FLAG_turbo_fast_register_allocation) return true;
+  return FLAG_turbo_fast_register_allocation_threshold > 0 &&
+         sequence->instructions().size() >=
+             static_cast<size_t>(FLAG_turbo_fast_register_allocation_threshold);
+}
+
 }  // namespace
 
 class PipelineCompilationJob final : public CompilationJob {
@@ -589,6 +602,22 @@ PipelineCompilationJob::Status PipelineCompilationJob::PrepareJobImpl() {
     if (FLAG_turbo_loop_peeling) {
       info()->MarkAsLoopPeelingEnabled();
     }
+    if (FLAG_turbo_loop_unrolling) {
+      info()->MarkAsLoopUnrollingEnabled();
+    }
+    // Hoisted bounds checks deoptimize before the loop is entered, even if
+    // the loop would have exited before going out of bounds. Don't hoist
+    // again once the function deoptimized to avoid deoptimization loops.
+    if (FLAG_turbo_loop_bounds_check_hoisting &&
+        info()->shared_info()->deopt_count() == 0) {
+      info()->MarkAsBoundsCheckHoistingEnabled();
+    }
+    // Vectorized loops deoptimize if the arrays they access overlap. Don't
+    // vectorize again once the function deoptimized for the same reason.
+    if (FLAG_turbo_loop_vectorization && LoopVectorization::IsSupported() &&
+        info()->shared_info()->deopt_count() == 0) {
+      info()->MarkAsLoopVectorizationEnabled();
+    }
   }
   if (info()->is_optimizing_from_bytecode() ||
       !info()->shared_info()->asm_function()) {
@@ -610,6 +639,10 @@ PipelineCompilationJob::Status PipelineCompilationJob::PrepareJobImpl() {
   linkage_ = new (info()->zone())
       Linkage(Linkage::ComputeIncoming(info()->zone(), info()));
 
+  // TODO(turbofan): Graph building, inlining and context specialization read
+  // feedback vectors, maps and the native context, so they run on the main
+  // thread. Moving them to ExecuteJobImpl needs a snapshot of that state. The
+  // V8.CompileOptimizedMainThreadMicroSeconds histogram tracks their cost.
   if (!pipeline_.CreateGraph()) {
     if (isolate()->has_pending_exception()) return FAILED;  // Stack overflowed.
     return AbortOptimization(kGraphBuildingFailed);
@@ -637,6 +670,9 @@ PipelineCompilationJob::Status PipelineCompilationJob::FinalizeJobImpl() {
     info()->context()->native_context()->AddOptimizedCode(*code);
     RegisterWeakObjectsInOptimizedCode(code);
   }
+  if (pipeline_statistics_ != nullptr) {
+    pipeline_statistics_->ReportToEmbedder(info(), "TurboFan");
+  }
   return SUCCEEDED;
 }
 
@@ -972,6 +1008,20 @@ struct EscapeAnalysisPhase {
   }
 };
 
+struct LoopBoundsCheckEliminationPhase {
+  static const char* phase_name() { return "loop bounds check elimination"; }
+
+  void Run(PipelineData* data, Zone* temp_zone) {
+    LoopBoundsCheckElimination::Flags flags =
+        LoopBoundsCheckElimination::kNoFlags;
+    if (data->info()->is_bounds_check_hoisting_enabled()) {
+      flags |= LoopBoundsCheckElimination::kHoistingEnabled;
+    }
+    LoopBoundsCheckElimination elimination(data->jsgraph(), flags, temp_zone);
+    elimination.Run();
+  }
+};
+
 struct SimplifiedLoweringPhase {
   static const char* phase_name() { return "simplified lowering"; }
 
@@ -982,6 +1032,20 @@ struct SimplifiedLoweringPhase {
   }
 };
 
+struct LoopVectorizationPhase {
+  static const char* phase_name() { return "loop vectorization"; }
+
+  void Run(PipelineData* data, Zone* temp_zone) {
+    GraphTrimmer trimmer(temp_zone, data->graph());
+    NodeVector roots(temp_zone);
+    data->jsgraph()->GetCachedNodes(&roots);
+    trimmer.TrimGraph(roots.begin(), roots.end());
+
+    LoopVectorization vectorization(data->jsgraph(), temp_zone);
+    vectorization.Run();
+  }
+};
+
 struct LoopPeelingPhase {
   static const char* phase_name() { return "loop peeling"; }
 
@@ -998,6 +1062,23 @@ struct LoopPeelingPhase {
   }
 };
 
+struct LoopUnrollingPhase {
+  static const char* phase_name() { return "loop unrolling"; }
+
+  void Run(PipelineData* data, Zone* temp_zone) {
+    GraphTrimmer trimmer(temp_zone, data->graph());
+    NodeVector roots(temp_zone);
+    data->jsgraph()->GetCachedNodes(&roots);
+    trimmer.TrimGraph(roots.begin(), roots.end());
+
+    LoopTree* loop_tree =
+        LoopFinder::BuildLoopTree(data->jsgraph()->graph(), temp_zone);
+    LoopPeeler::UnrollInnerLoopsOfTree(data->graph(), data->common(),
+                                       loop_tree, FLAG_turbo_loop_unroll_factor,
+                                       temp_zone);
+  }
+};
+
 struct LoopExitEliminationPhase {
   static const char* phase_name() { return "loop exit elimination"; }
 
@@ -1323,6 +1404,27 @@ struct AllocateFPRegistersPhase {
 };
 
 
+struct FastAllocateGeneralRegistersPhase {
+  static const char* phase_name() { return "fast allocate general registers"; }
+
+  void Run(PipelineData* data, Zone* temp_zone) {
+    FastRegisterAllocator allocator(data->register_allocation_data(),
+                                    GENERAL_REGISTERS, temp_zone);
+    allocator.AllocateRegisters();
+  }
+};
+
+struct FastAllocateFPRegistersPhase {
+  static const char* phase_name() { return "fast allocate f.p. registers"; }
+
+  void Run(PipelineData* data, Zone* temp_zone) {
+    FastRegisterAllocator allocator(data->register_allocation_data(),
+                                    FP_REGISTERS, temp_zone);
+    allocator.AllocateRegisters();
+  }
+};
+
+
 struct MergeSplintersPhase {
   static const char* phase_name() { return "merge splintered ranges"; }
   void Run(PipelineData* pipeline_data, Zone* temp_zone) {
@@ -1562,6 +1664,11 @@ bool PipelineImpl::OptimizeGraph(Linkage* linkage) {
 
   data->BeginPhaseKind("lowering");
 
+  if (data->info()->is_loop_unrolling_enabled()) {
+    Run<LoopUnrollingPhase>();
+    RunPrintAndVerify("Loops unrolled", true);
+  }
+
   if (data->info()->is_loop_peeling_enabled()) {
     Run<LoopPeelingPhase>();
     RunPrintAndVerify("Loops peeled", true);
@@ -1585,6 +1692,11 @@ bool PipelineImpl::OptimizeGraph(Linkage* linkage) {
       }
       RunPrintAndVerify("Escape Analysed");
     }
+
+    if (FLAG_turbo_loop_bounds_check_elimination) {
+      Run<LoopBoundsCheckEliminationPhase>();
+      RunPrintAndVerify("Loop bounds checks eliminated");
+    }
   }
 
   // Perform simplified lowering. This has to run w/o the Typer decorator,
@@ -1593,6 +1705,11 @@ bool PipelineImpl::OptimizeGraph(Linkage* linkage) {
   Run<SimplifiedLoweringPhase>();
   RunPrintAndVerify("Simplified lowering", true);
 
+  if (data->info()->is_loop_vectorization_enabled()) {
+    Run<LoopVectorizationPhase>();
+    RunPrintAndVerify("Loops vectorized", true);
+  }
+
 #ifdef DEBUG
   // From now on it is invalid to look at types on the nodes, because:
   //
@@ -1854,7 +1971,10 @@ bool PipelineImpl::ScheduleAndSelectInstructions(Linkage* linkage,
 
   data->DeleteGraphZone();
 
-  data->BeginPhaseKind("register allocation");
+  // Keep the two allocators apart in --turbo-stats.
+  data->BeginPhaseKind(UseFastRegisterAllocator(data->sequence())
+                           ? "fast register allocation"
+                           : "register allocation");
 
   bool run_verifier = FLAG_turbo_verify_allocation;
 
@@ -1980,14 +2100,28 @@ void PipelineImpl::AllocateRegisters(const RegisterConfiguration* config,
               ->RangesDefinedInDeferredStayInDeferred());
   }
 
-  if (FLAG_turbo_preprocess_ranges) {
+  // The fast allocator does a single pass over the live ranges and skips the
+  // heuristics that only improve the quality of the allocation.
+  bool use_fast_allocator = UseFastRegisterAllocator(data->sequence());
+  bool preprocess_ranges = FLAG_turbo_preprocess_ranges && !use_fast_allocator;
+
+  if (preprocess_ranges) {
     Run<SplinterLiveRangesPhase>();
   }
 
-  Run<AllocateGeneralRegistersPhase<LinearScanAllocator>>();
-  Run<AllocateFPRegistersPhase<LinearScanAllocator>>();
+  if (use_fast_allocator) {
+    Run<FastAllocateGeneralRegistersPhase>();
+    if (kSimpleFPAliasing) {
+      Run<FastAllocateFPRegistersPhase>();
+    } else {
+      Run<AllocateFPRegistersPhase<LinearScanAllocator>>();
+    }
+  } else {
+    Run<AllocateGeneralRegistersPhase<LinearScanAllocator>>();
+    Run<AllocateFPRegistersPhase<LinearScanAllocator>>();
+  }
 
-  if (FLAG_turbo_preprocess_ranges) {
+  if (preprocess_ranges) {
     Run<MergeSplintersPhase>();
   }
 
@@ -1997,7 +2131,7 @@ void PipelineImpl::AllocateRegisters(const RegisterConfiguration* config,
   Run<PopulateReferenceMapsPhase>();
   Run<ConnectRangesPhase>();
   Run<ResolveControlFlowPhase>();
-  if (FLAG_turbo_move_optimization) {
+  if (FLAG_turbo_move_optimization && !use_fast_allocator) {
     Run<OptimizeMovesPhase>();
   }
 
@@ -2722,6 +2722,16 @@ void RegisterAllocator::Spill(LiveRange* range) {
   range->Spill();
 }
 
+void RegisterAllocator::SetLiveRangeAssignedRegister(LiveRange* range,
+                                                     int reg) {
+  data()->MarkAllocated(range->representation(), reg);
+  range->set_assigned_register(reg);
+  range->SetUseHints(reg);
+  if (range->IsTopLevel() && range->TopLevel()->is_phi()) {
+    data()->GetPhiMapValueFor(range->TopLevel())->set_assigned_register(reg);
+  }
+}
+
 const char* RegisterAllocator::RegisterName(int register_code) const {
   if (mode() == GENERAL_REGISTERS) {
     return data()->config()->GetGeneralRegisterName(register_code);
@@ -2849,16 +2859,6 @@ bool LinearScanAllocator::TrySplitAndSpillSplinter(LiveRange* range) {
   return false;
 }
 
-void LinearScanAllocator::SetLiveRangeAssignedRegister(LiveRange* range,
-                                                       int reg) {
-  data()->MarkAllocated(range->representation(), reg);
-  range->set_assigned_register(reg);
-  range->SetUseHints(reg);
-  if (range->IsTopLevel() && range->TopLevel()->is_phi()) {
-    data()->GetPhiMapValueFor(range->TopLevel())->set_assigned_register(reg);
-  }
-}
-
 
 void LinearScanAllocator::AddToActive(LiveRange* range) {
   TRACE("Add live range %d:%d to active\n", range->TopLevel()->vreg(),
@@ -3509,6 +3509,209 @@ void LinearScanAllocator::SpillBetweenUntil(LiveRange* range,
 }
 
 
+FastRegisterAllocator::FastRegisterAllocator(RegisterAllocationData* data,
+                                             RegisterKind kind,
+                                             Zone* local_zone)
+    : RegisterAllocator(data, kind),
+      unhandled_live_ranges_(local_zone),
+      occupants_(num_registers(), nullptr, local_zone),
+      fixed_intervals_(num_registers(), nullptr, local_zone) {
+  DCHECK(kSimpleFPAliasing || mode() == GENERAL_REGISTERS);
+}
+
+
+bool FastRegisterAllocator::UnhandledOrder::operator()(LiveRange* a,
+                                                       LiveRange* b) const {
+  return UnhandledSortHelper(a, b);
+}
+
+
+void FastRegisterAllocator::AllocateRegisters() {
+  DCHECK(unhandled_live_ranges_.empty());
+
+  SplitAndSpillRangesDefinedByMemoryOperand();
+
+  for (TopLevelLiveRange* range : data()->live_ranges()) {
+    if (!CanProcessRange(range)) continue;
+    for (LiveRange* to_add = range; to_add != nullptr;
+         to_add = to_add->next()) {
+      if (!to_add->spilled()) {
+        AddToUnhandled(to_add);
+      }
+    }
+  }
+
+  const ZoneVector<TopLevelLiveRange*>& fixed_ranges =
+      mode() == GENERAL_REGISTERS ? data()->fixed_live_ranges()
+                                  : data()->fixed_double_live_ranges();
+  for (TopLevelLiveRange* current : fixed_ranges) {
+    if (current == nullptr) continue;
+    fixed_intervals_[current->assigned_register()] = current->first_interval();
+  }
+
+  while (!unhandled_live_ranges_.empty()) {
+    LiveRange* current = unhandled_live_ranges_.top();
+    unhandled_live_ranges_.pop();
+    LifetimePosition position = current->Start();
+    TRACE("Processing interval %d:%d start=%d\n", current->TopLevel()->vreg(),
+          current->relative_id(), position.value());
+
+    // Free the registers of ranges that ended and skip the intervals of fixed
+    // ranges that ended.
+    for (int reg = 0; reg < num_registers(); ++reg) {
+      LiveRange* occupant = occupants_[reg];
+      if (occupant != nullptr && occupant->End() <= position) {
+        occupants_[reg] = nullptr;
+      }
+      UseInterval* interval = fixed_intervals_[reg];
+      while (interval != nullptr && interval->end() <= position) {
+        interval = interval->next();
+      }
+      fixed_intervals_[reg] = interval;
+    }
+
+    DCHECK(!current->HasRegisterAssigned() && !current->spilled());
+
+    ProcessCurrentRange(current);
+  }
+}
+
+
+void FastRegisterAllocator::AddToUnhandled(LiveRange* range) {
+  if (range == nullptr || range->IsEmpty()) return;
+  DCHECK(!range->HasRegisterAssigned() && !range->spilled());
+  TRACE("Add live range %d:%d to unhandled\n", range->TopLevel()->vreg(),
+        range->relative_id());
+  unhandled_live_ranges_.push(range);
+}
+
+
+void FastRegisterAllocator::ProcessCurrentRange(LiveRange* current) {
+  LifetimePosition start = current->Start();
+
+  int hint_register;
+  if (current->FirstHintPosition(&hint_register) != nullptr &&
+      FreeUntil(hint_register, start) >= current->End()) {
+    TRACE("Assigning preferred reg %s to live range %d:%d\n",
+          RegisterName(hint_register), current->TopLevel()->vreg(),
+          current->relative_id());
+    AssignRegister(current, hint_register);
+    return;
+  }
+
+  // Find the register which stays free for the longest time.
+  int reg = allocatable_register_codes()[0];
+  LifetimePosition free_until = FreeUntil(reg, start);
+  for (int i = 1; i < num_allocatable_registers(); ++i) {
+    int code = allocatable_register_codes()[i];
+    LifetimePosition pos = FreeUntil(code, start);
+    if (pos > free_until) {
+      reg = code;
+      free_until = pos;
+    }
+  }
+
+  if (free_until > start) {
+    if (free_until < current->End()) {
+      // The register becomes blocked by a fixed range before the range end.
+      AddToUnhandled(SplitRangeAt(current, free_until));
+    }
+    TRACE("Assigning free reg %s to live range %d:%d\n", RegisterName(reg),
+          current->TopLevel()->vreg(), current->relative_id());
+    AssignRegister(current, reg);
+    return;
+  }
+
+  // All registers are taken. Unless the range needs a register right away,
+  // spill it until it does.
+  UsePosition* register_use = current->NextRegisterPosition(start);
+  if (register_use == nullptr) {
+    Spill(current);
+    return;
+  }
+  if (LifetimePosition::ExistsGapPositionBetween(start, register_use->pos())) {
+    SpillUntilNextRegisterUse(current, start);
+    return;
+  }
+
+  // Take the register whose current holder needs it again furthest away.
+  int victim = kUnassignedRegister;
+  LifetimePosition victim_use;
+  for (int i = 0; i < num_allocatable_registers(); ++i) {
+    int code = allocatable_register_codes()[i];
+    LiveRange* occupant = occupants_[code];
+    if (occupant == nullptr || BlockedFrom(code) <= start) continue;
+    if (!occupant->CanBeSpilled(start)) continue;
+    LifetimePosition use =
+        occupant->NextLifetimePositionRegisterIsBeneficial(start);
+    if (victim == kUnassignedRegister || use > victim_use) {
+      victim = code;
+      victim_use = use;
+    }
+  }
+  CHECK_NE(kUnassignedRegister, victim);
+
+  LiveRange* occupant = occupants_[victim];
+  occupants_[victim] = nullptr;
+  SpillUntilNextRegisterUse(occupant, start);
+
+  LifetimePosition blocked_from = BlockedFrom(victim);
+  if (blocked_from < current->End()) {
+    AddToUnhandled(SplitBetween(current, start, blocked_from.Start()));
+  }
+  TRACE("Assigning blocked reg %s to live range %d:%d\n", RegisterName(victim),
+        current->TopLevel()->vreg(), current->relative_id());
+  AssignRegister(current, victim);
+}
+
+
+LifetimePosition FastRegisterAllocator::FreeUntil(int reg,
+                                                  LifetimePosition pos) const {
+  if (occupants_[reg] != nullptr) return pos;
+  return Max(BlockedFrom(reg), pos);
+}
+
+
+LifetimePosition FastRegisterAllocator::BlockedFrom(int reg) const {
+  UseInterval* interval = fixed_intervals_[reg];
+  if (interval == nullptr) return LifetimePosition::MaxPosition();
+  return interval->start();
+}
+
+
+void FastRegisterAllocator::AssignRegister(LiveRange* range, int reg) {
+  DCHECK_NULL(occupants_[reg]);
+  SetLiveRangeAssignedRegister(range, reg);
+  occupants_[reg] = range;
+}
+
+
+void FastRegisterAllocator::SpillUntilNextRegisterUse(LiveRange* range,
+                                                      LifetimePosition start) {
+  LiveRange* second_part = SplitRangeAt(range, start);
+  UsePosition* register_use = second_part->NextRegisterPosition(start);
+  if (register_use == nullptr) {
+    Spill(second_part);
+    return;
+  }
+  LifetimePosition end = register_use->pos();
+  if (second_part->Start() >= end) {
+    // Nothing to spill. Just put it to unhandled as whole.
+    AddToUnhandled(second_part);
+    return;
+  }
+  LifetimePosition third_part_end = end.PrevStart().End();
+  if (data()->IsBlockBoundary(end.Start())) {
+    third_part_end = end.Start();
+  }
+  LiveRange* third_part =
+      SplitBetween(second_part, second_part->Start().End(), third_part_end);
+  DCHECK(third_part != second_part);
+  Spill(second_part);
+  AddToUnhandled(third_part);
+}
+
+
 SpillSlotLocator::SpillSlotLocator(RegisterAllocationData* data)
     : data_(data) {}
 
@@ -1020,6 +1020,8 @@ class RegisterAllocator : public ZoneObject {
 
   void Spill(LiveRange* range);
 
+  void SetLiveRangeAssignedRegister(LiveRange* range, int reg);
+
   // If we are trying to spill a range inside the loop try to
   // hoist spill position out to the point just before the loop.
   LifetimePosition FindOptimalSpillingPos(LiveRange* range,
@@ -1060,8 +1062,6 @@ class LinearScanAllocator final : public RegisterAllocator {
     return inactive_live_ranges_;
   }
 
-  void SetLiveRangeAssignedRegister(LiveRange* range, int reg);
-
   // Helper methods for updating the life range lists.
   void AddToActive(LiveRange* range);
   void AddToInactive(LiveRange* range);
@@ -1113,6 +1113,54 @@ class LinearScanAllocator final : public RegisterAllocator {
   DISALLOW_COPY_AND_ASSIGN(LinearScanAllocator);
 };
 
+// A single pass register allocator for very large functions, which trades
+// the quality of the allocation for a shorter compile time.
+//
+// Live ranges are processed in order of their start position and hold their
+// register from start to end, ignoring lifetime holes, so unlike the linear
+// scan allocator this one never tracks inactive ranges. If no register is
+// free, the current range is spilled up to its next use that requires a
+// register. If it needs a register right away, it takes the register of the
+// range whose next register use is furthest away.
+//
+// Only supports targets with simple floating point register aliasing.
+class FastRegisterAllocator final : public RegisterAllocator {
+ public:
+  FastRegisterAllocator(RegisterAllocationData* data, RegisterKind kind,
+                        Zone* local_zone);
+
+  void AllocateRegisters();
+
+ private:
+  // Orders the unhandled live ranges such that the range to be processed next
+  // is on top.
+  struct UnhandledOrder {
+    bool operator()(LiveRange* a, LiveRange* b) const;
+  };
+
+  void AddToUnhandled(LiveRange* range);
+  void ProcessCurrentRange(LiveRange* current);
+
+  // Returns the position up to which the register is free, which is not after
+  // {pos} if the register is not free at {pos}.
+  LifetimePosition FreeUntil(int reg, LifetimePosition pos) const;
+  LifetimePosition BlockedFrom(int reg) const;
+  void AssignRegister(LiveRange* range, int reg);
+
+  // Spill the given live range from position [start] up to its next use
+  // that requires a register, and put the rest to unhandled.
+  void SpillUntilNextRegisterUse(LiveRange* range, LifetimePosition start);
+
+  ZonePriorityQueue<LiveRange*, UnhandledOrder> unhandled_live_ranges_;
+  // The range that holds each register, indexed by register code.
+  ZoneVector<LiveRange*> occupants_;
+  // The next interval of the fixed range of each register, indexed by
+  // register code.
+  ZoneVector<UseInterval*> fixed_intervals_;
+
+  DISALLOW_COPY_AND_ASSIGN(FastRegisterAllocator);
+};
+
 
 class SpillSlotLocator final : public ZoneObject {
  public:
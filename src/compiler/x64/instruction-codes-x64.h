@@ -132,6 +132,7 @@ namespace compiler {
   V(X64Movq)                       \
   V(X64Movsd)                      \
   V(X64Movss)                      \
+  V(X64Movdqu)                     \
   V(X64BitcastFI)                  \
   V(X64BitcastDL)                  \
   V(X64BitcastIF)                  \
@@ -143,6 +144,11 @@ namespace compiler {
   V(X64Push)                       \
   V(X64Poke)                       \
   V(X64StackCheck)                 \
+  V(X64F32x4Splat)                 \
+  V(X64F32x4ExtractLane)           \
+  V(X64F32x4Add)                   \
+  V(X64F32x4Sub)                   \
+  V(X64F32x4Mul)                   \
   V(X64I32x4Splat)                 \
   V(X64I32x4ExtractLane)           \
   V(X64I32x4ReplaceLane)           \
@@ -119,10 +119,13 @@ int InstructionScheduler::GetTargetInstructionFlags(
     case kX64BitcastDL:
     case kX64BitcastIF:
     case kX64BitcastLD:
-    case kX64Lea32:
-    case kX64Lea:
     case kX64Dec32:
     case kX64Inc32:
+    case kX64F32x4Splat:
+    case kX64F32x4ExtractLane:
+    case kX64F32x4Add:
+    case kX64F32x4Sub:
+    case kX64F32x4Mul:
     case kX64I32x4Splat:
     case kX64I32x4ExtractLane:
     case kX64I32x4ReplaceLane:
@@ -144,6 +147,11 @@ int InstructionScheduler::GetTargetInstructionFlags(
           ? kNoOpcodeFlags
           : kIsLoadOperation | kHasSideEffect;
 
+    case kX64Lea32:
+    case kX64Lea:
+      // The addressing mode only computes the result.
+      return kNoOpcodeFlags;
+
     case kX64Idiv:
     case kX64Idiv32:
     case kX64Udiv:
@@ -181,6 +189,7 @@ int InstructionScheduler::GetTargetInstructionFlags(
     case kX64Movq:
     case kX64Movsd:
     case kX64Movss:
+    case kX64Movdqu:
       return instr->HasOutput() ? kIsLoadOperation : kHasSideEffect;
 
     case kX64StackCheck:
@@ -202,75 +211,206 @@ int InstructionScheduler::GetTargetInstructionFlags(
 }
 
 
+namespace {
+
+// Load-to-use latency of the L1 data cache.
+const int kL1LoadLatency = 4;
+
+// Returns true if the instruction reads or writes a memory operand.
+bool HasMemoryOperand(const Instruction* instr) {
+  switch (instr->arch_opcode()) {
+    case kX64Lea32:
+    case kX64Lea:
+      // Only computes the address.
+      return false;
+    default:
+      return instr->addressing_mode() != kMode_None;
+  }
+}
+
+}  // namespace
+
+
 int InstructionScheduler::GetInstructionLatency(const Instruction* instr) {
-  // Basic latency modeling for x64 instructions. They have been determined
-  // in an empirical way.
+  // Latencies on recent Intel cores (Haswell and later), taken from Agner
+  // Fog's instruction tables. Instructions with a memory operand first load
+  // it from the L1 cache.
+  int latency;
   switch (instr->arch_opcode()) {
-    case kCheckedLoadInt8:
-    case kCheckedLoadUint8:
-    case kCheckedLoadInt16:
-    case kCheckedLoadUint16:
-    case kCheckedLoadWord32:
-    case kCheckedLoadWord64:
-    case kCheckedLoadFloat32:
-    case kCheckedLoadFloat64:
-    case kCheckedStoreWord8:
-    case kCheckedStoreWord16:
-    case kCheckedStoreWord32:
-    case kCheckedStoreWord64:
-    case kCheckedStoreFloat32:
-    case kCheckedStoreFloat64:
-    case kSSEFloat64Mul:
-      return 5;
     case kX64Imul:
     case kX64Imul32:
+    case kX64Lzcnt:
+    case kX64Lzcnt32:
+    case kX64Tzcnt:
+    case kX64Tzcnt32:
+    case kX64Popcnt:
+    case kX64Popcnt32:
+    case kSSEFloat32Cmp:
+    case kSSEFloat64Cmp:
+    case kAVXFloat32Cmp:
+    case kAVXFloat64Cmp:
+    case kX64I32x4Splat:
+    case kX64I32x4ExtractLane:
+    case kX64I32x4ReplaceLane:
+    case kX64F32x4Splat:
+    case kX64F32x4ExtractLane:
+    case kX64S32x4Select:
+    case kSSEFloat64ExtractHighWord32:
+    case kSSEFloat64InsertLowWord32:
+    case kSSEFloat64InsertHighWord32:
+      latency = 3;
+      break;
     case kX64ImulHigh32:
     case kX64UmulHigh32:
-    case kSSEFloat32Cmp:
     case kSSEFloat32Add:
     case kSSEFloat32Sub:
-    case kSSEFloat32Abs:
-    case kSSEFloat32Neg:
-    case kSSEFloat64Cmp:
+    case kSSEFloat32Mul:
     case kSSEFloat64Add:
     case kSSEFloat64Sub:
+    case kSSEFloat64Mul:
+    case kSSEFloat32Max:
     case kSSEFloat64Max:
+    case kSSEFloat32Min:
     case kSSEFloat64Min:
-    case kSSEFloat64Abs:
-    case kSSEFloat64Neg:
-      return 3;
-    case kSSEFloat32Mul:
+    case kSSEFloat64SilenceNaN:
+    case kAVXFloat32Add:
+    case kAVXFloat32Sub:
+    case kAVXFloat32Mul:
+    case kAVXFloat64Add:
+    case kAVXFloat64Sub:
+    case kAVXFloat64Mul:
+    case kX64F32x4Add:
+    case kX64F32x4Sub:
+    case kX64F32x4Mul:
+      latency = 4;
+      break;
     case kSSEFloat32ToFloat64:
     case kSSEFloat64ToFloat32:
-    case kSSEFloat32Round:
-    case kSSEFloat64Round:
+    case kSSEInt32ToFloat64:
+    case kSSEInt32ToFloat32:
+    case kSSEInt64ToFloat32:
+    case kSSEInt64ToFloat64:
+    case kSSEUint32ToFloat64:
+    case kSSEUint32ToFloat32:
+      latency = 5;
+      break;
     case kSSEFloat32ToInt32:
     case kSSEFloat32ToUint32:
     case kSSEFloat64ToInt32:
     case kSSEFloat64ToUint32:
-      return 4;
-    case kX64Idiv:
-      return 49;
-    case kX64Idiv32:
-      return 35;
-    case kX64Udiv:
-      return 38;
-    case kX64Udiv32:
-      return 26;
-    case kSSEFloat32Div:
-    case kSSEFloat64Div:
-    case kSSEFloat32Sqrt:
-    case kSSEFloat64Sqrt:
-      return 13;
+    case kArchTruncateDoubleToI:
+      latency = 6;
+      break;
+    case kSSEFloat32Round:
+    case kSSEFloat64Round:
+      latency = 8;
+      break;
+    case kX64I32x4Mul:
+      latency = 10;
+      break;
     case kSSEFloat32ToInt64:
     case kSSEFloat64ToInt64:
     case kSSEFloat32ToUint64:
     case kSSEFloat64ToUint64:
-      return 10;
+    case kSSEUint64ToFloat32:
+    case kSSEUint64ToFloat64:
+      // Multi-instruction sequences.
+      latency = 10;
+      break;
+    case kSSEFloat32Div:
+    case kAVXFloat32Div:
+      latency = 11;
+      break;
+    case kSSEFloat32Sqrt:
+      latency = 12;
+      break;
+    case kSSEFloat64Div:
+    case kAVXFloat64Div:
+      latency = 14;
+      break;
+    case kSSEFloat64Sqrt:
+      latency = 16;
+      break;
+    case kX64Idiv32:
+    case kX64Udiv32:
+      latency = 26;
+      break;
+    case kX64Udiv:
+      latency = 35;
+      break;
+    case kX64Idiv:
+      latency = 42;
+      break;
     case kSSEFloat64Mod:
-      return 50;
-    case kArchTruncateDoubleToI:
+      // A loop of fprem instructions.
+      latency = 50;
+      break;
+    case kIeee754Float64Acos:
+    case kIeee754Float64Acosh:
+    case kIeee754Float64Asin:
+    case kIeee754Float64Asinh:
+    case kIeee754Float64Atan:
+    case kIeee754Float64Atanh:
+    case kIeee754Float64Atan2:
+    case kIeee754Float64Cbrt:
+    case kIeee754Float64Cos:
+    case kIeee754Float64Cosh:
+    case kIeee754Float64Exp:
+    case kIeee754Float64Expm1:
+    case kIeee754Float64Log:
+    case kIeee754Float64Log1p:
+    case kIeee754Float64Log10:
+    case kIeee754Float64Log2:
+    case kIeee754Float64Pow:
+    case kIeee754Float64Sin:
+    case kIeee754Float64Sinh:
+    case kIeee754Float64Tan:
+    case kIeee754Float64Tanh:
+      // Calls to the C library.
+      latency = 50;
+      break;
+    case kCheckedLoadInt8:
+    case kCheckedLoadUint8:
+    case kCheckedLoadInt16:
+    case kCheckedLoadUint16:
+    case kCheckedLoadWord32:
+    case kCheckedLoadWord64:
+    case kCheckedLoadFloat32:
+    case kCheckedLoadFloat64:
+      // A bounds check followed by a load, without an addressing mode.
+      latency = 1 + kL1LoadLatency;
+      break;
+    default:
+      // Simple integer and bit operations, register moves and stores.
+      latency = 1;
+      break;
+  }
+  if (HasMemoryOperand(instr) && instr->OutputCount() > 0) {
+    latency += kL1LoadLatency;
+  }
+  return latency;
+}
+
+
+int InstructionScheduler::GetInstructionThroughput(const Instruction* instr) {
+  // Reciprocal throughputs of the instructions that are executed by the
+  // unpipelined divider unit. Everything else can start every cycle.
+  switch (instr->arch_opcode()) {
+    case kSSEFloat32Div:
+    case kAVXFloat32Div:
+    case kSSEFloat32Sqrt:
+      return 3;
+    case kSSEFloat64Div:
+    case kAVXFloat64Div:
+      return 4;
+    case kSSEFloat64Sqrt:
+    case kX64Idiv32:
+    case kX64Udiv32:
       return 6;
+    case kX64Udiv:
+      return 21;
+    case kX64Idiv:
+      return 24;
     default:
       return 1;
   }
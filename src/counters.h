@@ -958,6 +958,11 @@ class RuntimeCallTimerScope {
      MICROSECOND)                                                              \
   /* Total compilation time incl. caching/parsing */                           \
   HT(compile_script, V8.CompileScriptMicroSeconds, 1000000, MICROSECOND)       \
+  /* Optimizing compilation time on the main and background threads */         \
+  HT(compile_optimized_main_thread, V8.CompileOptimizedMainThreadMicroSeconds, \
+     1000000, MICROSECOND)                                                     \
+  HT(compile_optimized_background, V8.CompileOptimizedBackgroundMicroSeconds,  \
+     1000000, MICROSECOND)                                                     \
   /* Total JavaScript execution time (including callbacks and runtime calls */ \
   HT(execute, V8.Execute, 1000000, MICROSECOND)                                \
   /* Asm/Wasm */                                                               \
@@ -1065,6 +1070,12 @@ class RuntimeCallTimerScope {
   SC(total_compile_size, V8.TotalCompileSize)                       \
   /* Amount of source code compiled with the full codegen. */       \
   SC(total_full_codegen_source_size, V8.TotalFullCodegenSourceSize) \
+  /* Number of functions whose bytecode was flushed. */             \
+  SC(bytecode_flushed_functions, V8.BytecodeFlushedFunctions)       \
+  /* Amount of bytecode flushed. */                                 \
+  SC(bytecode_flushed_size, V8.BytecodeFlushedSize)                 \
+  /* Number of functions recompiled after bytecode flushing. */     \
+  SC(bytecode_recompilations, V8.BytecodeRecompilations)            \
   /* Number of contexts created from scratch. */                    \
   SC(contexts_created_from_scratch, V8.ContextsCreatedFromScratch)  \
   /* Number of contexts created by partial snapshot. */             \
@@ -1107,8 +1118,10 @@ class RuntimeCallTimerScope {
   SC(negative_lookups, V8.NegativeLookups)                                     \
   SC(negative_lookups_miss, V8.NegativeLookupsMiss)                            \
   SC(megamorphic_stub_cache_probes, V8.MegamorphicStubCacheProbes)             \
+  SC(megamorphic_stub_cache_hits, V8.MegamorphicStubCacheHits)                 \
   SC(megamorphic_stub_cache_misses, V8.MegamorphicStubCacheMisses)             \
   SC(megamorphic_stub_cache_updates, V8.MegamorphicStubCacheUpdates)           \
+  SC(megamorphic_stub_cache_resizes, V8.MegamorphicStubCacheResizes)           \
   SC(enum_cache_hits, V8.EnumCacheHits)                                        \
   SC(enum_cache_misses, V8.EnumCacheMisses)                                    \
   SC(fast_new_closure_total, V8.FastNewClosureTotal)                           \
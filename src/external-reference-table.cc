@@ -406,34 +406,26 @@ void ExternalReferenceTable::AddStubCache(Isolate* isolate) {
   StubCache* load_stub_cache = isolate->load_stub_cache();
 
   // Stub cache tables
-  Add(load_stub_cache->key_reference(StubCache::kPrimary).address(),
-      "Load StubCache::primary_->key");
-  Add(load_stub_cache->value_reference(StubCache::kPrimary).address(),
-      "Load StubCache::primary_->value");
-  Add(load_stub_cache->map_reference(StubCache::kPrimary).address(),
-      "Load StubCache::primary_->map");
-  Add(load_stub_cache->key_reference(StubCache::kSecondary).address(),
-      "Load StubCache::secondary_->key");
-  Add(load_stub_cache->value_reference(StubCache::kSecondary).address(),
-      "Load StubCache::secondary_->value");
-  Add(load_stub_cache->map_reference(StubCache::kSecondary).address(),
-      "Load StubCache::secondary_->map");
+  Add(load_stub_cache->table_reference(StubCache::kPrimary).address(),
+      "Load StubCache::primary_");
+  Add(load_stub_cache->mask_reference(StubCache::kPrimary).address(),
+      "Load StubCache::primary_mask_");
+  Add(load_stub_cache->table_reference(StubCache::kSecondary).address(),
+      "Load StubCache::secondary_");
+  Add(load_stub_cache->mask_reference(StubCache::kSecondary).address(),
+      "Load StubCache::secondary_mask_");
 
   StubCache* store_stub_cache = isolate->store_stub_cache();
 
   // Stub cache tables
-  Add(store_stub_cache->key_reference(StubCache::kPrimary).address(),
-      "Store StubCache::primary_->key");
-  Add(store_stub_cache->value_reference(StubCache::kPrimary).address(),
-      "Store StubCache::primary_->value");
-  Add(store_stub_cache->map_reference(StubCache::kPrimary).address(),
-      "Store StubCache::primary_->map");
-  Add(store_stub_cache->key_reference(StubCache::kSecondary).address(),
-      "Store StubCache::secondary_->key");
-  Add(store_stub_cache->value_reference(StubCache::kSecondary).address(),
-      "Store StubCache::secondary_->value");
-  Add(store_stub_cache->map_reference(StubCache::kSecondary).address(),
-      "Store StubCache::secondary_->map");
+  Add(store_stub_cache->table_reference(StubCache::kPrimary).address(),
+      "Store StubCache::primary_");
+  Add(store_stub_cache->mask_reference(StubCache::kPrimary).address(),
+      "Store StubCache::primary_mask_");
+  Add(store_stub_cache->table_reference(StubCache::kSecondary).address(),
+      "Store StubCache::secondary_");
+  Add(store_stub_cache->mask_reference(StubCache::kSecondary).address(),
+      "Store StubCache::secondary_mask_");
 }
 
 void ExternalReferenceTable::AddDeoptEntries(Isolate* isolate) {
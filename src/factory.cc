@@ -1112,7 +1112,7 @@ Handle<Script> Factory::NewScript(Handle<String> source) {
   script->set_eval_from_position(0);
   script->set_shared_function_infos(*empty_fixed_array(), SKIP_WRITE_BARRIER);
   script->set_flags(0);
-  script->set_preparsed_scope_data(heap->empty_fixed_uint32_array());
+  script->set_preparsed_scope_data(heap->empty_byte_array());
 
   heap->set_script_list(*WeakFixedArray::Add(script_list(), script));
   return script;
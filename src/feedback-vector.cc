@@ -8,6 +8,7 @@
 #include "src/ic/ic-inl.h"
 #include "src/ic/ic-state.h"
 #include "src/objects.h"
+#include "src/snapshot/feedback-serializer.h"
 
 namespace v8 {
 namespace internal {
@@ -267,6 +268,9 @@ Handle<FeedbackVector> FeedbackVector::New(Isolate* isolate,
   }
 
   Handle<FeedbackVector> result = Handle<FeedbackVector>::cast(array);
+  if (!isolate->imported_feedback()->is_empty()) {
+    isolate->imported_feedback()->Apply(*result);
+  }
   if (!isolate->is_best_effort_code_coverage()) {
     AddToCodeCoverageList(isolate, result);
   }
@@ -452,6 +452,11 @@ DEFINE_BOOL(turbo_sp_frame_access, false,
             "use stack pointer-relative access to frame wherever possible")
 DEFINE_BOOL(turbo_preprocess_ranges, true,
             "run pre-register allocation heuristics")
+DEFINE_BOOL(turbo_fast_register_allocation, false,
+            "use the single pass register allocator for all functions")
+DEFINE_INT(turbo_fast_register_allocation_threshold, 0,
+           "use the single pass register allocator for functions with at "
+           "least this many instructions (0 means never)")
 DEFINE_STRING(turbo_filter, "~~", "optimization filter for TurboFan compiler")
 DEFINE_BOOL(trace_turbo, false, "trace generated TurboFan IR")
 DEFINE_BOOL(trace_turbo_graph, false, "trace generated TurboFan graphs")
@@ -501,9 +506,21 @@ DEFINE_BOOL(turbo_move_optimization, true, "optimize gap moves in TurboFan")
 DEFINE_BOOL(turbo_jt, true, "enable jump threading in TurboFan")
 DEFINE_BOOL(turbo_loop_peeling, true, "Turbofan loop peeling")
 DEFINE_BOOL(turbo_loop_variable, true, "Turbofan loop variable optimization")
+DEFINE_BOOL(turbo_loop_unrolling, false, "Turbofan loop unrolling")
+DEFINE_INT(turbo_loop_unroll_factor, 2,
+           "number of copies of the loop body when unrolling loops")
+DEFINE_BOOL(turbo_loop_bounds_check_elimination, true,
+            "Turbofan bounds check elimination for loop induction variables")
+DEFINE_BOOL(turbo_loop_bounds_check_hoisting, true,
+            "hoist bounds checks of loop induction variables into the loop "
+            "preheader")
+DEFINE_BOOL(turbo_loop_vectorization, false,
+            "Turbofan vectorization of loops over typed arrays")
 DEFINE_BOOL(turbo_cf_optimization, true, "optimize control flow in TurboFan")
 DEFINE_BOOL(turbo_frame_elision, true, "elide frames in TurboFan")
 DEFINE_BOOL(turbo_escape, true, "enable escape analysis")
+DEFINE_BOOL(trace_turbo_escape_reasons, false,
+            "trace why allocations escape in escape analysis")
 DEFINE_BOOL(turbo_instruction_scheduling, false,
             "enable instruction scheduling in TurboFan")
 DEFINE_BOOL(turbo_stress_instruction_scheduling, false,
@@ -651,6 +668,10 @@ DEFINE_BOOL(trace_evacuation, false, "report evacuation statistics")
 DEFINE_BOOL(trace_mutator_utilization, false,
             "print mutator utilization, allocation speed, gc speed")
 DEFINE_BOOL(flush_code, true, "flush code that we expect not to use again")
+DEFINE_BOOL(flush_bytecode, false,
+            "flush the bytecode of functions that were not executed for "
+            "several non-incremental mark-compact collections")
+DEFINE_IMPLICATION(flush_bytecode, flush_code)
 DEFINE_BOOL(trace_code_flushing, false, "trace code flushing progress")
 DEFINE_BOOL(age_code, true,
             "track un-executed functions to age code and flush only "
@@ -658,7 +679,14 @@ DEFINE_BOOL(age_code, true,
 DEFINE_BOOL(incremental_marking, true, "use incremental marking")
 DEFINE_BOOL(incremental_marking_wrappers, true,
             "use incremental marking for marking wrappers")
-DEFINE_BOOL(concurrent_marking, false, "use concurrent marking")
+#ifdef V8_CONCURRENT_MARKING
+#define V8_CONCURRENT_MARKING_BOOL true
+#else
+#define V8_CONCURRENT_MARKING_BOOL false
+#endif
+DEFINE_BOOL(concurrent_marking, V8_CONCURRENT_MARKING_BOOL,
+            "use concurrent marking")
+DEFINE_BOOL(trace_concurrent_marking, false, "trace concurrent marking")
 DEFINE_INT(min_progress_during_incremental_marking_finalization, 32,
            "keep finalizing incremental marking as long as we discover at "
            "least this many unmarked objects")
@@ -671,9 +699,20 @@ DEFINE_BOOL(black_allocation, true, "use black allocation")
 DEFINE_BOOL(concurrent_store_buffer, true,
             "use concurrent store buffer processing")
 DEFINE_BOOL(concurrent_sweeping, true, "use concurrent sweeping")
+DEFINE_BOOL(concurrent_array_buffer_freeing, true,
+            "free array buffer backing stores on a background thread")
+DEFINE_INT(array_buffer_freeing_limit_mb, 64,
+           "free array buffer backing stores synchronously once more than "
+           "this many MB are pending")
 DEFINE_BOOL(parallel_compaction, true, "use parallel compaction")
 DEFINE_BOOL(parallel_pointer_update, true,
             "use parallel pointer update during compaction")
+DEFINE_BOOL(parallel_scavenge, false, "use parallel scavenging")
+DEFINE_INT(parallel_scavenge_tasks, 0,
+           "number of parallel scavenge tasks (0 means one per MB of new "
+           "space, capped by the number of cores)")
+DEFINE_BOOL(trace_parallel_scavenge, false,
+            "report statistics of parallel scavenge tasks")
 DEFINE_BOOL(trace_incremental_marking, false,
             "trace progress of the incremental marking")
 DEFINE_BOOL(track_gc_object_stats, false,
@@ -831,6 +870,16 @@ DEFINE_BOOL(cache_prototype_transitions, true, "cache prototype transitions")
 DEFINE_BOOL(compiler_dispatcher, false, "enable compiler dispatcher")
 DEFINE_BOOL(compiler_dispatcher_eager_inner, false,
             "enable background compilation of eager inner functions")
+DEFINE_BOOL(compiler_dispatcher_toplevel_functions, false,
+            "preparse top-level functions that are likely called immediately "
+            "and parse and compile them on the compiler dispatcher")
+DEFINE_IMPLICATION(compiler_dispatcher_toplevel_functions, compiler_dispatcher)
+DEFINE_IMPLICATION(compiler_dispatcher_toplevel_functions, ignition)
+DEFINE_BOOL(compiler_dispatcher_streaming, false,
+            "compile the eagerly parsed functions of streamed scripts on the "
+            "compiler dispatcher")
+DEFINE_IMPLICATION(compiler_dispatcher_streaming, compiler_dispatcher)
+DEFINE_IMPLICATION(compiler_dispatcher_streaming, ignition)
 DEFINE_BOOL(trace_compiler_dispatcher, false,
             "trace compiler dispatcher activity")
 
@@ -894,6 +943,10 @@ DEFINE_BOOL(trace_object_groups, false,
 // heap-snapshot-generator.cc
 DEFINE_BOOL(heap_profiler_trace_objects, false,
             "Dump heap object allocations/movements/size_updates")
+DEFINE_BOOL(parallel_heap_snapshot, false,
+            "scan heap pages in parallel when taking a heap snapshot "
+            "(experimental, entries and edges are still created on the main "
+            "thread)")
 
 
 // sampling-heap-profiler.cc
@@ -910,6 +963,14 @@ DEFINE_BOOL(trace_ic, false, "trace inline cache state transitions")
 DEFINE_IMPLICATION(trace_ic, log_code)
 DEFINE_INT(ic_stats, 0, "inline cache state transitions statistics")
 DEFINE_VALUE_IMPLICATION(trace_ic, ic_stats, 1)
+DEFINE_INT(stub_cache_primary_table_bits, 11,
+           "log2 of the number of entries of the primary megamorphic stub "
+           "cache table (the secondary table is a quarter of it)")
+DEFINE_BOOL(stub_cache_grow, false,
+            "grow the megamorphic stub caches when they thrash")
+DEFINE_INT(stub_cache_max_primary_table_bits, 16,
+           "log2 of the maximum number of entries of a primary megamorphic "
+           "stub cache table grown by --stub-cache-grow")
 DEFINE_BOOL_READONLY(track_constant_fields, false,
                      "enable constant field tracking")
 DEFINE_BOOL_READONLY(modify_map_inplace, false, "enable in-place map updates")
@@ -1290,6 +1351,7 @@ DEFINE_BOOL(single_threaded, false, "disable the use of background tasks")
 DEFINE_NEG_IMPLICATION(single_threaded, concurrent_recompilation)
 DEFINE_NEG_IMPLICATION(single_threaded, concurrent_sweeping)
 DEFINE_NEG_IMPLICATION(single_threaded, parallel_compaction)
+DEFINE_NEG_IMPLICATION(single_threaded, parallel_scavenge)
 DEFINE_NEG_IMPLICATION(single_threaded, concurrent_store_buffer)
 DEFINE_NEG_IMPLICATION(single_threaded, compiler_dispatcher)
 
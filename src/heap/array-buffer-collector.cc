@@ -0,0 +1,105 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/heap/array-buffer-collector.h"
+
+#include "src/base/platform/time.h"
+#include "src/heap/gc-tracer.h"
+#include "src/heap/heap.h"
+#include "src/isolate.h"
+#include "src/v8.h"
+
+namespace v8 {
+namespace internal {
+
+class ArrayBufferCollector::FreeingTask : public v8::Task {
+ public:
+  explicit FreeingTask(ArrayBufferCollector* collector)
+      : collector_(collector) {}
+
+ private:
+  // v8::Task overrides.
+  void Run() override {
+    size_t freed = collector_->PerformFreeAllocations();
+    if (freed > 0) {
+      collector_->heap_->tracer()->AddBackgroundArrayBufferFreeing(freed);
+    }
+    collector_->pending_freeing_tasks_semaphore_.Signal();
+  }
+
+  ArrayBufferCollector* collector_;
+  DISALLOW_COPY_AND_ASSIGN(FreeingTask);
+};
+
+void ArrayBufferCollector::AddGarbageAllocations(
+    std::vector<Allocation>* allocations) {
+  if (allocations->empty()) return;
+  bool free_synchronously = !FLAG_concurrent_array_buffer_freeing;
+  {
+    base::LockGuard<base::Mutex> guard(&allocations_mutex_);
+    for (const Allocation& allocation : *allocations) {
+      pending_bytes_ += allocation.length;
+    }
+    allocations_.insert(allocations_.end(), allocations->begin(),
+                        allocations->end());
+    const size_t limit =
+        static_cast<size_t>(FLAG_array_buffer_freeing_limit_mb) * MB;
+    if (pending_bytes_ > limit) free_synchronously = true;
+  }
+  allocations->clear();
+  if (free_synchronously) PerformFreeAllocations();
+}
+
+void ArrayBufferCollector::FreeAllocationsOnBackgroundThread() {
+  RemoveFinishedFreeingTasks();
+  if (pending_bytes() == 0) return;
+  if (!FLAG_concurrent_array_buffer_freeing) {
+    PerformFreeAllocations();
+    return;
+  }
+  V8::GetCurrentPlatform()->CallOnBackgroundThread(
+      new FreeingTask(this), v8::Platform::kShortRunningTask);
+  freeing_tasks_active_++;
+}
+
+void ArrayBufferCollector::FreeAllocations() { PerformFreeAllocations(); }
+
+void ArrayBufferCollector::WaitForFreeingTasks() {
+  while (freeing_tasks_active_ > 0) {
+    pending_freeing_tasks_semaphore_.Wait();
+    freeing_tasks_active_--;
+  }
+}
+
+void ArrayBufferCollector::RemoveFinishedFreeingTasks() {
+  while (freeing_tasks_active_ > 0 &&
+         pending_freeing_tasks_semaphore_.WaitFor(base::TimeDelta())) {
+    freeing_tasks_active_--;
+  }
+}
+
+void ArrayBufferCollector::TearDown() {
+  WaitForFreeingTasks();
+  PerformFreeAllocations();
+}
+
+size_t ArrayBufferCollector::PerformFreeAllocations() {
+  std::vector<Allocation> allocations;
+  {
+    base::LockGuard<base::Mutex> guard(&allocations_mutex_);
+    allocations.swap(allocations_);
+    pending_bytes_ = 0;
+  }
+  size_t freed = 0;
+  v8::ArrayBuffer::Allocator* allocator =
+      heap_->isolate()->array_buffer_allocator();
+  for (const Allocation& allocation : allocations) {
+    allocator->Free(allocation.data, allocation.length);
+    freed += allocation.length;
+  }
+  return freed;
+}
+
+}  // namespace internal
+}  // namespace v8
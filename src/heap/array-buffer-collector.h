@@ -0,0 +1,87 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_HEAP_ARRAY_BUFFER_COLLECTOR_H_
+#define V8_HEAP_ARRAY_BUFFER_COLLECTOR_H_
+
+#include <vector>
+
+#include "src/base/platform/mutex.h"
+#include "src/base/platform/semaphore.h"
+#include "src/globals.h"
+
+namespace v8 {
+namespace internal {
+
+class Heap;
+
+// Frees the backing stores of dead array buffers.
+//
+// The array buffer trackers hand the backing stores of dead array buffers to
+// the collector in batches during scavenges and sweeping. The backing stores
+// are released on a background thread so that GC pauses do not pay for calls
+// to ArrayBuffer::Allocator::Free. If more than
+// --array-buffer-freeing-limit-mb are pending, backing stores are released
+// synchronously to bound the retained memory.
+class V8_EXPORT_PRIVATE ArrayBufferCollector {
+ public:
+  struct Allocation {
+    void* data;
+    size_t length;
+  };
+
+  explicit ArrayBufferCollector(Heap* heap)
+      : heap_(heap),
+        pending_bytes_(0),
+        pending_freeing_tasks_semaphore_(0),
+        freeing_tasks_active_(0) {}
+
+  // Takes the backing stores of |allocations|, leaving it empty. Thread-safe.
+  void AddGarbageAllocations(std::vector<Allocation>* allocations);
+
+  // Posts a task that frees the pending backing stores. Must be called on
+  // the main thread.
+  void FreeAllocationsOnBackgroundThread();
+
+  // Frees the pending backing stores on the calling thread. Thread-safe.
+  void FreeAllocations();
+
+  // Waits until the posted freeing tasks have finished. Must be called on
+  // the main thread.
+  void WaitForFreeingTasks();
+
+  // Waits for the freeing tasks and frees the remaining backing stores.
+  void TearDown();
+
+  size_t pending_bytes() {
+    base::LockGuard<base::Mutex> guard(&allocations_mutex_);
+    return pending_bytes_;
+  }
+
+ private:
+  class FreeingTask;
+
+  // Returns the number of bytes freed.
+  size_t PerformFreeAllocations();
+
+  // Accounts for the freeing tasks that finished since the last call without
+  // blocking. Must be called on the main thread.
+  void RemoveFinishedFreeingTasks();
+
+  Heap* heap_;
+  base::Mutex allocations_mutex_;
+  std::vector<Allocation> allocations_;
+  size_t pending_bytes_;
+  base::Semaphore pending_freeing_tasks_semaphore_;
+  // Number of posted freeing tasks that were not yet accounted for. Only
+  // accessed on the main thread.
+  int freeing_tasks_active_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArrayBufferCollector);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_HEAP_ARRAY_BUFFER_COLLECTOR_H_
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "src/heap/array-buffer-tracker.h"
+#include "src/heap/array-buffer-collector.h"
 #include "src/heap/array-buffer-tracker-inl.h"
 #include "src/heap/heap.h"
 
@@ -15,6 +16,7 @@ LocalArrayBufferTracker::~LocalArrayBufferTracker() {
 
 template <LocalArrayBufferTracker::FreeMode free_mode>
 void LocalArrayBufferTracker::Free() {
+  std::vector<ArrayBufferCollector::Allocation> garbage;
   size_t freed_memory = 0;
   for (TrackingData::iterator it = array_buffers_.begin();
        it != array_buffers_.end();) {
@@ -24,14 +26,21 @@ void LocalArrayBufferTracker::Free() {
     if ((free_mode == kFreeAll) ||
         ObjectMarking::IsWhite(buffer, MarkingState::Internal(buffer))) {
       const size_t len = it->second;
-      heap_->isolate()->array_buffer_allocator()->Free(buffer->backing_store(),
-                                                       len);
+      if (free_mode == kFreeAll) {
+        heap_->isolate()->array_buffer_allocator()->Free(
+            buffer->backing_store(), len);
+      } else {
+        garbage.push_back({buffer->backing_store(), len});
+      }
       freed_memory += len;
       it = array_buffers_.erase(it);
     } else {
       ++it;
     }
   }
+  if (!garbage.empty()) {
+    heap_->array_buffer_collector()->AddGarbageAllocations(&garbage);
+  }
   if (freed_memory > 0) {
     heap_->update_external_memory_concurrently_freed(
         static_cast<intptr_t>(freed_memory));
@@ -41,6 +50,7 @@ void LocalArrayBufferTracker::Free() {
 template <typename Callback>
 void LocalArrayBufferTracker::Process(Callback callback) {
   JSArrayBuffer* new_buffer = nullptr;
+  std::vector<ArrayBufferCollector::Allocation> garbage;
   size_t freed_memory = 0;
   for (TrackingData::iterator it = array_buffers_.begin();
        it != array_buffers_.end();) {
@@ -64,14 +74,16 @@ void LocalArrayBufferTracker::Process(Callback callback) {
       it = array_buffers_.erase(it);
     } else if (result == kRemoveEntry) {
       const size_t len = it->second;
-      heap_->isolate()->array_buffer_allocator()->Free(
-          it->first->backing_store(), len);
+      garbage.push_back({it->first->backing_store(), len});
       freed_memory += len;
       it = array_buffers_.erase(it);
     } else {
       UNREACHABLE();
     }
   }
+  if (!garbage.empty()) {
+    heap_->array_buffer_collector()->AddGarbageAllocations(&garbage);
+  }
   if (freed_memory > 0) {
     heap_->update_external_memory_concurrently_freed(
         static_cast<intptr_t>(freed_memory));
@@ -4,129 +4,394 @@
 
 #include "src/heap/concurrent-marking.h"
 
-#include <stack>
-#include <unordered_map>
-
 #include "src/heap/heap-inl.h"
 #include "src/heap/heap.h"
+#include "src/heap/mark-compact.h"
 #include "src/heap/marking.h"
+#include "src/heap/objects-visiting.h"
+#include "src/heap/remembered-set.h"
 #include "src/isolate.h"
-#include "src/locked-queue-inl.h"
+#include "src/objects-body-descriptors-inl.h"
+#include "src/utils-inl.h"
 #include "src/v8.h"
 
 namespace v8 {
 namespace internal {
 
-class ConcurrentMarkingMarkbits {
+// Visits grey objects on a background thread. All mark bit transitions are
+// atomic. Live bytes and recorded slots are kept in the task state because
+// the corresponding fields of memory chunks are owned by the main thread.
+class ConcurrentMarkingVisitor final {
  public:
-  ConcurrentMarkingMarkbits() {}
-  ~ConcurrentMarkingMarkbits() {
-    for (auto chunk_bitmap : bitmap_) {
-      FreeBitmap(chunk_bitmap.second);
+  typedef std::unordered_map<MemoryChunk*, intptr_t> LiveBytesMap;
+  typedef std::vector<std::pair<MemoryChunk*, Address>> SlotList;
+
+  ConcurrentMarkingVisitor(Heap* heap,
+                           ConcurrentMarking::MarkingWorklist* shared,
+                           ConcurrentMarking::MarkingWorklist* bailout,
+                           LiveBytesMap* live_bytes, SlotList* slots,
+                           int task_id)
+      : heap_(heap),
+        shared_(shared, task_id),
+        bailout_(bailout, task_id),
+        live_bytes_(live_bytes),
+        slots_(slots) {}
+
+  // Visits the given grey object and returns the number of bytes that were
+  // marked black. Returns 0 if the object was pushed onto the bailout
+  // worklist or if another thread marked it black first.
+  int Visit(HeapObject* object) {
+    // Objects in the young generation may be initialized by optimized code
+    // without a write barrier.
+    if (heap_->InNewSpace(object)) return Bailout(object);
+    Map* map = object->synchronized_map();
+    switch (static_cast<StaticVisitorBase::VisitorId>(map->visitor_id())) {
+      case StaticVisitorBase::kVisitFreeSpace:
+        return 0;
+      case StaticVisitorBase::kVisitSeqOneByteString:
+      case StaticVisitorBase::kVisitSeqTwoByteString:
+      case StaticVisitorBase::kVisitByteArray:
+      case StaticVisitorBase::kVisitFixedDoubleArray:
+      case StaticVisitorBase::kVisitDataObject:
+        return VisitDataObject(map, object);
+      case StaticVisitorBase::kVisitFixedArray:
+        return VisitFixedArray(map, object);
+      case StaticVisitorBase::kVisitShortcutCandidate:
+      case StaticVisitorBase::kVisitConsString:
+      case StaticVisitorBase::kVisitSlicedString:
+      case StaticVisitorBase::kVisitThinString:
+      case StaticVisitorBase::kVisitSymbol:
+      case StaticVisitorBase::kVisitOddball:
+      case StaticVisitorBase::kVisitCell:
+      case StaticVisitorBase::kVisitPropertyCell:
+      case StaticVisitorBase::kVisitStruct:
+      case StaticVisitorBase::kVisitFixedTypedArray:
+      case StaticVisitorBase::kVisitFixedFloat64Array:
+      case StaticVisitorBase::kVisitJSObjectFast:
+      case StaticVisitorBase::kVisitJSObject:
+        return VisitWithSnapshot(map, object);
+      default:
+        // Maps, code, native contexts, and objects with weak or special
+        // fields are visited on the main thread.
+        return Bailout(object);
     }
   }
-  bool Mark(HeapObject* obj) {
-    Address address = obj->address();
-    MemoryChunk* chunk = MemoryChunk::FromAddress(address);
-    if (bitmap_.count(chunk) == 0) {
-      bitmap_[chunk] = AllocateBitmap();
+
+ private:
+  // Records the values of the pointer fields of an object.
+  class SnapshotVisitor final : public ObjectVisitor {
+   public:
+    static const int kMaxSnapshotSize =
+        JSObject::kMaxInstanceSize / kPointerSize;
+
+    SnapshotVisitor() : size_(0), overflow_(false) {}
+
+    void VisitPointers(Object** start, Object** end) override {
+      for (Object** p = start; p < end; p++) {
+        Object* value = LoadRelaxed(p);
+        if (!value->IsHeapObject()) continue;
+        if (size_ == kMaxSnapshotSize) {
+          overflow_ = true;
+          return;
+        }
+        slots_[size_] = p;
+        values_[size_] = HeapObject::cast(value);
+        size_++;
+      }
     }
-    MarkBit mark_bit =
-        bitmap_[chunk]->MarkBitFromIndex(chunk->AddressToMarkbitIndex(address));
-    if (mark_bit.Get()) return false;
-    mark_bit.Set();
-    return true;
-  }
 
-  Bitmap* AllocateBitmap() {
-    return static_cast<Bitmap*>(calloc(1, Bitmap::kSize));
-  }
+    int size() const { return size_; }
+    bool overflow() const { return overflow_; }
+    Object** slot(int i) const { return slots_[i]; }
+    HeapObject* value(int i) const { return values_[i]; }
 
-  void FreeBitmap(Bitmap* bitmap) { free(bitmap); }
+   private:
+    int size_;
+    bool overflow_;
+    Object** slots_[kMaxSnapshotSize];
+    HeapObject* values_[kMaxSnapshotSize];
+  };
 
- private:
-  std::unordered_map<MemoryChunk*, Bitmap*> bitmap_;
-};
+  static Object* LoadRelaxed(Object** slot) {
+    return reinterpret_cast<Object*>(
+        base::NoBarrier_Load(reinterpret_cast<base::AtomicWord*>(slot)));
+  }
 
-class ConcurrentMarkingVisitor : public ObjectVisitor {
- public:
-  ConcurrentMarkingVisitor() {}
+  int Bailout(HeapObject* object) {
+    bailout_.Push(object);
+    return 0;
+  }
 
-  void VisitPointers(Object** start, Object** end) override {
+  int VisitDataObject(Map* map, HeapObject* object) {
+    if (object->IsFiller()) return 0;
+    int size = object->SizeFromMap(map);
+    if (!GreyToBlack(object)) return 0;
+    MarkObject(map);
+    IncrementLiveBytes(object, size);
+    return size;
+  }
+
+  int VisitFixedArray(Map* map, HeapObject* object) {
+    // Large arrays are scanned incrementally using the progress bar of their
+    // page which is owned by the main thread.
+    if (MemoryChunk::FromAddress(object->address())
+            ->IsFlagSet(MemoryChunk::HAS_PROGRESS_BAR)) {
+      return Bailout(object);
+    }
+    // Stores into the elements are covered by the write barrier and right
+    // trimming leaves a valid filler behind, so the array can be visited
+    // in place after it was marked black.
+    if (!GreyToBlack(object)) return 0;
+    int length = FixedArray::cast(object)->synchronized_length();
+    int size = FixedArray::SizeFor(length);
+    MarkObject(map);
+    Object** start = HeapObject::RawField(object, FixedArray::kHeaderSize);
+    Object** end = HeapObject::RawField(object, size);
     for (Object** p = start; p < end; p++) {
-      if (!(*p)->IsHeapObject()) continue;
-      MarkObject(HeapObject::cast(*p));
+      Object* value = LoadRelaxed(p);
+      if (value->IsHeapObject()) {
+        MarkObjectAndRecordSlot(object, p, HeapObject::cast(value));
+      }
     }
+    IncrementLiveBytes(object, size);
+    return size;
   }
 
-  void MarkObject(HeapObject* obj) {
-    if (markbits_.Mark(obj)) {
-      marking_stack_.push(obj);
+  int VisitWithSnapshot(Map* map, HeapObject* object) {
+    int size = object->SizeFromMap(map);
+    SnapshotVisitor snapshot;
+    object->IterateBodyFast(map->instance_type(), size, &snapshot);
+    if (snapshot.overflow()) return Bailout(object);
+    // The snapshot is only valid if the layout of the object did not change
+    // before the object was marked black.
+    if (!GreyToBlack(object)) return 0;
+    MarkObject(map);
+    for (int i = 0; i < snapshot.size(); i++) {
+      MarkObjectAndRecordSlot(object, snapshot.slot(i), snapshot.value(i));
     }
+    IncrementLiveBytes(object, size);
+    return size;
+  }
+
+  bool GreyToBlack(HeapObject* object) {
+    return Marking::GreyToBlack<MarkBit::ATOMIC>(
+        ObjectMarking::MarkBitFrom(object, MarkingState::Internal(object)));
   }
 
-  void MarkTransitively() {
-    while (!marking_stack_.empty()) {
-      HeapObject* obj = marking_stack_.top();
-      marking_stack_.pop();
-      obj->Iterate(this);
+  void MarkObject(HeapObject* object) {
+    if (Marking::WhiteToGrey<MarkBit::ATOMIC>(ObjectMarking::MarkBitFrom(
+            object, MarkingState::Internal(object)))) {
+      shared_.Push(object);
     }
   }
 
- private:
-  std::stack<HeapObject*> marking_stack_;
-  ConcurrentMarkingMarkbits markbits_;
+  void MarkObjectAndRecordSlot(HeapObject* host, Object** slot,
+                               HeapObject* target) {
+    MarkObject(target);
+    MemoryChunk* source_page = MemoryChunk::FromAddress(host->address());
+    if (Page::FromAddress(target->address())->IsEvacuationCandidate() &&
+        !source_page->ShouldSkipEvacuationSlotRecording()) {
+      slots_->push_back(
+          std::make_pair(source_page, reinterpret_cast<Address>(slot)));
+    }
+  }
+
+  void IncrementLiveBytes(HeapObject* object, int size) {
+    (*live_bytes_)[MemoryChunk::FromAddress(object->address())] += size;
+  }
+
+  Heap* heap_;
+  ConcurrentMarking::MarkingWorklist::View shared_;
+  ConcurrentMarking::MarkingWorklist::View bailout_;
+  LiveBytesMap* live_bytes_;
+  SlotList* slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentMarkingVisitor);
 };
 
 class ConcurrentMarking::Task : public CancelableTask {
  public:
-  Task(Heap* heap, std::vector<HeapObject*>* root_set,
-       base::Semaphore* on_finish)
-      : CancelableTask(heap->isolate()),
-        heap_(heap),
-        on_finish_(on_finish),
-        root_set_(root_set) {}
+  Task(Isolate* isolate, ConcurrentMarking* concurrent_marking,
+       TaskState* task_state, int task_id)
+      : CancelableTask(isolate),
+        concurrent_marking_(concurrent_marking),
+        task_state_(task_state),
+        task_id_(task_id) {}
 
   virtual ~Task() {}
 
  private:
   // v8::internal::CancelableTask overrides.
   void RunInternal() override {
-    USE(heap_);
-    for (HeapObject* obj : *root_set_) {
-      marking_visitor_.MarkObject(obj);
-    }
-    marking_visitor_.MarkTransitively();
-    on_finish_->Signal();
+    concurrent_marking_->Run(task_id_, task_state_);
   }
 
-  Heap* heap_;
-  base::Semaphore* on_finish_;
-  ConcurrentMarkingVisitor marking_visitor_;
-  std::vector<HeapObject*>* root_set_;
+  ConcurrentMarking* concurrent_marking_;
+  TaskState* task_state_;
+  int task_id_;
   DISALLOW_COPY_AND_ASSIGN(Task);
 };
 
 ConcurrentMarking::ConcurrentMarking(Heap* heap)
-    : heap_(heap), pending_task_(0) {}
+    : heap_(heap),
+      shared_(kMaxTasks + 1),
+      bailout_(kMaxTasks + 1),
+      pending_task_count_(0) {
+  preemption_request_.SetValue(false);
+  for (int i = 0; i <= kMaxTasks; i++) {
+    is_pending_[i] = false;
+    cancelable_id_[i] = 0;
+  }
+}
 
-ConcurrentMarking::~ConcurrentMarking() {}
+ConcurrentMarking::~ConcurrentMarking() {
+  DCHECK_EQ(0, pending_task_count_);
+  // Marking may be aborted by the isolate tear down.
+  ClearWorklists();
+}
 
-void ConcurrentMarking::AddRoot(HeapObject* object) {
-  root_set_.push_back(object);
+void ConcurrentMarking::Run(int task_id, TaskState* task_state) {
+  // Preemption requests are checked after this many bytes or objects.
+  const size_t kBytesUntilInterruptCheck = 64 * KB;
+  const int kObjectsUntilInterruptCheck = 1000;
+  ConcurrentMarkingVisitor visitor(heap_, &shared_, &bailout_,
+                                   &task_state->live_bytes, &task_state->slots,
+                                   task_id);
+  double time_ms;
+  size_t marked_bytes = 0;
+  if (FLAG_trace_concurrent_marking) {
+    heap_->isolate()->PrintWithTimestamp(
+        "Starting concurrent marking task %d\n", task_id);
+  }
+  {
+    TimedScope scope(&time_ms);
+    bool done = false;
+    while (!done) {
+      size_t current_marked_bytes = 0;
+      int objects_processed = 0;
+      while (current_marked_bytes < kBytesUntilInterruptCheck &&
+             objects_processed < kObjectsUntilInterruptCheck) {
+        HeapObject* object;
+        if (!shared_.Pop(task_id, &object)) {
+          done = true;
+          break;
+        }
+        objects_processed++;
+        current_marked_bytes += visitor.Visit(object);
+      }
+      marked_bytes += current_marked_bytes;
+      if (preemption_request_.Value()) break;
+    }
+    shared_.FlushToGlobal(task_id);
+    bailout_.FlushToGlobal(task_id);
+  }
+  total_marked_bytes_.Increment(marked_bytes);
+  if (FLAG_trace_concurrent_marking) {
+    heap_->isolate()->PrintWithTimestamp(
+        "Task %d concurrently marked %dKB in %.2fms\n", task_id,
+        static_cast<int>(marked_bytes / KB), time_ms);
+  }
+  {
+    base::LockGuard<base::Mutex> guard(&pending_lock_);
+    is_pending_[task_id] = false;
+    --pending_task_count_;
+    pending_condition_.NotifyAll();
+  }
 }
 
-void ConcurrentMarking::StartMarkingTask() {
+void ConcurrentMarking::ScheduleTasks() {
   if (!FLAG_concurrent_marking) return;
+  base::LockGuard<base::Mutex> guard(&pending_lock_);
+  if (pending_task_count_ < kMaxTasks) {
+    // Task id 0 is for the main thread.
+    const int num_tasks = Max(
+        1, Min(kMaxTasks,
+               static_cast<int>(V8::GetCurrentPlatform()
+                                    ->NumberOfAvailableBackgroundThreads())));
+    for (int i = 1; i <= num_tasks; i++) {
+      if (!is_pending_[i]) {
+        if (FLAG_trace_concurrent_marking) {
+          heap_->isolate()->PrintWithTimestamp(
+              "Scheduling concurrent marking task %d\n", i);
+        }
+        is_pending_[i] = true;
+        ++pending_task_count_;
+        Task* task = new Task(heap_->isolate(), this, &task_state_[i], i);
+        cancelable_id_[i] = task->id();
+        V8::GetCurrentPlatform()->CallOnBackgroundThread(
+            task, v8::Platform::kShortRunningTask);
+      }
+    }
+  }
+}
 
-  V8::GetCurrentPlatform()->CallOnBackgroundThread(
-      new Task(heap_, &root_set_, &pending_task_),
-      v8::Platform::kShortRunningTask);
+void ConcurrentMarking::RescheduleTasksIfNeeded() {
+  if (!FLAG_concurrent_marking) return;
+  if (!shared_.IsGlobalPoolEmpty()) {
+    ScheduleTasks();
+  }
 }
 
-void ConcurrentMarking::WaitForTaskToComplete() {
+void ConcurrentMarking::Stop() {
   if (!FLAG_concurrent_marking) return;
-  pending_task_.Wait();
+  preemption_request_.SetValue(true);
+  {
+    base::LockGuard<base::Mutex> guard(&pending_lock_);
+    for (int i = 1; i <= kMaxTasks; i++) {
+      if (is_pending_[i] &&
+          heap_->isolate()->cancelable_task_manager()->TryAbort(
+              cancelable_id_[i]) == CancelableTaskManager::kTaskAborted) {
+        is_pending_[i] = false;
+        --pending_task_count_;
+      }
+    }
+    while (pending_task_count_ > 0) {
+      pending_condition_.Wait(&pending_lock_);
+    }
+  }
+  preemption_request_.SetValue(false);
+  FlushTaskStates();
+}
+
+void ConcurrentMarking::RunForTesting(int task_id) {
+  DCHECK_LT(kMainThread, task_id);
+  DCHECK_LE(task_id, kMaxTasks);
+  {
+    base::LockGuard<base::Mutex> guard(&pending_lock_);
+    DCHECK(!is_pending_[task_id]);
+    is_pending_[task_id] = true;
+    ++pending_task_count_;
+  }
+  Run(task_id, &task_state_[task_id]);
+  FlushTaskStates();
+}
+
+void ConcurrentMarking::FlushTaskStates() {
+  for (int i = 1; i <= kMaxTasks; i++) {
+    TaskState& state = task_state_[i];
+    for (auto& pair : state.live_bytes) {
+      MarkingState::Internal(pair.first).IncrementLiveBytes(pair.second);
+    }
+    state.live_bytes.clear();
+    for (auto& pair : state.slots) {
+      RememberedSet<OLD_TO_OLD>::Insert(pair.first, pair.second);
+    }
+    state.slots.clear();
+  }
+}
+
+bool ConcurrentMarking::HasPendingWork() {
+  {
+    base::LockGuard<base::Mutex> guard(&pending_lock_);
+    if (pending_task_count_ > 0) return true;
+  }
+  return !shared_.IsGlobalPoolEmpty() || !bailout_.IsGlobalPoolEmpty();
+}
+
+void ConcurrentMarking::ClearWorklists() {
+  DCHECK_EQ(0, pending_task_count_);
+  shared_.Clear();
+  bailout_.Clear();
 }
 
 }  // namespace internal
@@ -5,10 +5,16 @@
 #ifndef V8_HEAP_CONCURRENT_MARKING_
 #define V8_HEAP_CONCURRENT_MARKING_
 
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "src/allocation.h"
+#include "src/base/atomic-utils.h"
+#include "src/base/platform/condition-variable.h"
+#include "src/base/platform/mutex.h"
 #include "src/cancelable-task.h"
+#include "src/heap/worklist.h"
 #include "src/utils.h"
 #include "src/v8.h"
 
@@ -16,26 +22,96 @@ namespace v8 {
 namespace internal {
 
 class Heap;
-class Isolate;
+class HeapObject;
+class MemoryChunk;
 
+// Marks the old generation on background threads while JavaScript is running.
+//
+// The concurrent marker shares the mark bits with the incremental marker on
+// the main thread and transitions colors with atomic operations. Objects are
+// exchanged through two segmented worklists:
+// - the shared worklist contains grey objects that any thread may visit,
+// - the bailout worklist contains grey objects that the concurrent marker
+//   cannot visit safely (e.g. maps, code, objects with weak fields, young
+//   objects). They are visited by the incremental marker on the main thread.
+//
+// Objects whose layout may change while they are visited are copied into a
+// local snapshot before they are marked black. If the mutator changes the
+// layout of an object it calls Heap::NotifyObjectLayoutChange first, which
+// marks the object black and pushes it onto the main thread marking deque. In
+// that case the black transition of the concurrent marker fails and the
+// snapshot is discarded.
 class ConcurrentMarking {
  public:
+  typedef Worklist<HeapObject*, 64> MarkingWorklist;
+
+  // Task id used by the main thread to access the worklists.
+  static const int kMainThread = 0;
+  static const int kMaxTasks = 4;
+  STATIC_ASSERT(kMaxTasks < MarkingWorklist::kMaxNumTasks);
+
   explicit ConcurrentMarking(Heap* heap);
   ~ConcurrentMarking();
 
-  void AddRoot(HeapObject* object);
+  // Schedules marking tasks for all task slots that are not running.
+  void ScheduleTasks();
+  // Schedules tasks for idle task slots if there is work left in the shared
+  // worklist.
+  void RescheduleTasksIfNeeded();
+  // Preempts running tasks, cancels tasks that have not started yet and waits
+  // until all tasks have finished. Live bytes and recorded slots of the tasks
+  // are transferred to the heap afterwards. Must be called before the heap is
+  // mutated without the write barrier, e.g. at the start of a GC.
+  void Stop();
+
+  // Returns true if there are running tasks or work left in the worklists.
+  // Work in the private segments of the main thread is not considered.
+  bool HasPendingWork();
+
+  // Removes all entries from the worklists. Only allowed after Stop().
+  void ClearWorklists();
+
+  // Number of bytes marked by the concurrent marker since the isolate was
+  // created. The counter is updated when a task finishes.
+  size_t TotalMarkedBytes() { return total_marked_bytes_.Value(); }
+
+  // Runs the marking task with the given id on the calling thread and
+  // flushes its state. Works independently of --concurrent-marking.
+  void RunForTesting(int task_id);
 
-  void StartMarkingTask();
-  void WaitForTaskToComplete();
+  MarkingWorklist* shared() { return &shared_; }
+  MarkingWorklist* bailout() { return &bailout_; }
 
  private:
+  // Live bytes and recorded slots of a single task. They are written by the
+  // task and flushed on the main thread after the task has finished.
+  struct TaskState {
+    std::unordered_map<MemoryChunk*, intptr_t> live_bytes;
+    std::vector<std::pair<MemoryChunk*, Address>> slots;
+  };
+
   class Task;
+
+  void Run(int task_id, TaskState* task_state);
+  void FlushTaskStates();
+
   Heap* heap_;
-  base::Semaphore pending_task_;
-  std::vector<HeapObject*> root_set_;
+  MarkingWorklist shared_;
+  MarkingWorklist bailout_;
+  TaskState task_state_[kMaxTasks + 1];
+  base::AtomicValue<bool> preemption_request_;
+  base::AtomicNumber<size_t> total_marked_bytes_;
+
+  base::Mutex pending_lock_;
+  base::ConditionVariable pending_condition_;
+  int pending_task_count_;
+  bool is_pending_[kMaxTasks + 1];
+  uint32_t cancelable_id_[kMaxTasks + 1];
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentMarking);
 };
 
 }  // namespace internal
 }  // namespace v8
 
-#endif  // V8_HEAP_PAGE_PARALLEL_JOB_
+#endif  // V8_HEAP_CONCURRENT_MARKING_
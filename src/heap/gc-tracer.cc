@@ -76,7 +76,8 @@ GCTracer::Event::Event(Type type, GarbageCollectionReason gc_reason,
       new_space_object_size(0),
       survived_new_space_object_size(0),
       incremental_marking_bytes(0),
-      incremental_marking_duration(0.0) {
+      incremental_marking_duration(0.0),
+      background_freed_array_buffer_bytes(0) {
   for (int i = 0; i < Scope::NUMBER_OF_SCOPES; i++) {
     scopes[i] = 0;
   }
@@ -240,6 +241,8 @@ void GCTracer::Stop(GarbageCollector collector) {
   current_.end_memory_size = heap_->memory_allocator()->Size();
   current_.end_holes_size = CountTotalHolesSize(heap_);
   current_.survived_new_space_object_size = heap_->SurvivedNewSpaceObjectSize();
+  current_.background_freed_array_buffer_bytes =
+      BackgroundFreedArrayBufferBytes();
 
   AddAllocation(current_.end_time);
 
@@ -369,6 +372,10 @@ void GCTracer::AddSurvivalRatio(double promotion_ratio) {
   recorded_survival_ratios_.Push(promotion_ratio);
 }
 
+void GCTracer::AddBackgroundArrayBufferFreeing(size_t bytes) {
+  background_freed_array_buffer_bytes_.Increment(bytes);
+}
+
 void GCTracer::AddIncrementalMarkingStep(double duration, size_t bytes) {
   if (bytes > 0) {
     incremental_marking_bytes_ += bytes;
@@ -438,6 +445,9 @@ void GCTracer::PrintNVP() const {
       current_.start_object_size - previous_.end_object_size;
 
   double incremental_walltime_duration = 0;
+  const size_t background_freed_bytes =
+      current_.background_freed_array_buffer_bytes -
+      previous_.background_freed_array_buffer_bytes;
 
   if (current_.type == Event::INCREMENTAL_MARK_COMPACTOR) {
     incremental_walltime_duration =
@@ -458,6 +468,8 @@ void GCTracer::PrintNVP() const {
           "heap.external.epilogue=%.2f "
           "heap.external_weak_global_handles=%.2f "
           "scavenge=%.2f "
+          "scavenge.parallel=%.2f "
+          "scavenge.finalize=%.2f "
           "evacuate=%.2f "
           "old_new=%.2f "
           "weak=%.2f "
@@ -489,7 +501,8 @@ void GCTracer::PrintNVP() const {
           "promotion_rate=%.1f%% "
           "semi_space_copy_rate=%.1f%% "
           "new_space_allocation_throughput=%.1f "
-          "context_disposal_rate=%.1f\n",
+          "context_disposal_rate=%.1f "
+          "array_buffers_freed_in_background=%" PRIuS "\n",
           duration, spent_in_mutator, current_.TypeName(true),
           current_.reduce_memory, current_.scopes[Scope::HEAP_PROLOGUE],
           current_.scopes[Scope::HEAP_EPILOGUE],
@@ -498,6 +511,8 @@ void GCTracer::PrintNVP() const {
           current_.scopes[Scope::HEAP_EXTERNAL_EPILOGUE],
           current_.scopes[Scope::HEAP_EXTERNAL_WEAK_GLOBAL_HANDLES],
           current_.scopes[Scope::SCAVENGER_SCAVENGE],
+          current_.scopes[Scope::SCAVENGER_SCAVENGE_PARALLEL],
+          current_.scopes[Scope::SCAVENGER_SCAVENGE_FINALIZE],
           current_.scopes[Scope::SCAVENGER_EVACUATE],
           current_.scopes[Scope::SCAVENGER_OLD_TO_NEW_POINTERS],
           current_.scopes[Scope::SCAVENGER_WEAK],
@@ -517,7 +532,7 @@ void GCTracer::PrintNVP() const {
           AverageSurvivalRatio(), heap_->promotion_rate_,
           heap_->semi_space_copied_rate_,
           NewSpaceAllocationThroughputInBytesPerMillisecond(),
-          ContextDisposalRateInMilliseconds());
+          ContextDisposalRateInMilliseconds(), background_freed_bytes);
       break;
     case Event::MINOR_MARK_COMPACTOR:
       heap_->isolate()->PrintWithTimestamp(
@@ -624,7 +639,8 @@ void GCTracer::PrintNVP() const {
           "semi_space_copy_rate=%.1f%% "
           "new_space_allocation_throughput=%.1f "
           "context_disposal_rate=%.1f "
-          "compaction_speed=%.f\n",
+          "compaction_speed=%.f "
+          "array_buffers_freed_in_background=%" PRIuS "\n",
           duration, spent_in_mutator, current_.TypeName(true),
           current_.reduce_memory, current_.scopes[Scope::HEAP_PROLOGUE],
           current_.scopes[Scope::HEAP_EPILOGUE],
@@ -702,7 +718,7 @@ void GCTracer::PrintNVP() const {
           heap_->semi_space_copied_rate_,
           NewSpaceAllocationThroughputInBytesPerMillisecond(),
           ContextDisposalRateInMilliseconds(),
-          CompactionSpeedInBytesPerMillisecond());
+          CompactionSpeedInBytesPerMillisecond(), background_freed_bytes);
       break;
     case Event::START:
       break;
@@ -5,6 +5,7 @@
 #ifndef V8_HEAP_GC_TRACER_H_
 #define V8_HEAP_GC_TRACER_H_
 
+#include "src/base/atomic-utils.h"
 #include "src/base/compiler-specific.h"
 #include "src/base/platform/platform.h"
 #include "src/base/ring-buffer.h"
@@ -94,6 +95,8 @@ enum ScavengeSpeedMode { kForAllObjects, kForSurvivedObjects };
   F(SCAVENGER_OLD_TO_NEW_POINTERS)            \
   F(SCAVENGER_ROOTS)                          \
   F(SCAVENGER_SCAVENGE)                       \
+  F(SCAVENGER_SCAVENGE_FINALIZE)              \
+  F(SCAVENGER_SCAVENGE_PARALLEL)              \
   F(SCAVENGER_SEMISPACE)                      \
   F(SCAVENGER_WEAK)
 
@@ -220,6 +223,10 @@ class V8_EXPORT_PRIVATE GCTracer {
     // Duration of incremental marking steps for INCREMENTAL_MARK_COMPACTOR.
     double incremental_marking_duration;
 
+    // Array buffer backing store bytes freed on background threads since the
+    // isolate was created, sampled at the end of the GC.
+    size_t background_freed_array_buffer_bytes;
+
     // Amounts of time spent in different scopes during GC.
     double scopes[Scope::NUMBER_OF_SCOPES];
 
@@ -255,6 +262,16 @@ class V8_EXPORT_PRIVATE GCTracer {
 
   void AddSurvivalRatio(double survival_ratio);
 
+  // Log array buffer backing stores freed on a background thread. This
+  // method may be called from any thread.
+  void AddBackgroundArrayBufferFreeing(size_t bytes);
+
+  // Returns the array buffer backing store bytes freed on background threads
+  // since the isolate was created.
+  size_t BackgroundFreedArrayBufferBytes() {
+    return background_freed_array_buffer_bytes_.Value();
+  }
+
   // Log an incremental marking step.
   void AddIncrementalMarkingStep(double duration, size_t bytes);
 
@@ -396,6 +413,10 @@ class V8_EXPORT_PRIVATE GCTracer {
   // the last mark compact GC.
   size_t incremental_marking_bytes_;
 
+  // Array buffer backing store bytes freed by background tasks. Written
+  // concurrently by the tasks of the ArrayBufferCollector.
+  base::AtomicNumber<size_t> background_freed_array_buffer_bytes_;
+
   // Duration of incremental marking steps since the end of the last mark-
   // compact event.
   double incremental_marking_duration_;
@@ -20,6 +20,7 @@
 #include "src/deoptimizer.h"
 #include "src/feedback-vector.h"
 #include "src/global-handles.h"
+#include "src/heap/array-buffer-collector.h"
 #include "src/heap/array-buffer-tracker-inl.h"
 #include "src/heap/code-stats.h"
 #include "src/heap/concurrent-marking.h"
@@ -125,6 +126,7 @@ Heap::Heap()
       semi_space_copied_object_size_(0),
       previous_semi_space_copied_object_size_(0),
       semi_space_copied_rate_(0),
+      parallel_scavenge_active_tasks_(0),
       nodes_died_in_new_space_(0),
       nodes_copied_in_new_space_(0),
       nodes_promoted_(0),
@@ -143,6 +145,7 @@ Heap::Heap()
       live_object_stats_(nullptr),
       dead_object_stats_(nullptr),
       scavenge_job_(nullptr),
+      array_buffer_collector_(nullptr),
       idle_scavenge_observer_(nullptr),
       new_space_allocation_counter_(0),
       old_generation_allocation_counter_at_last_gc_(0),
@@ -753,6 +756,9 @@ void Heap::GarbageCollectionEpilogue() {
     TRACE_GC(tracer(), GCTracer::Scope::HEAP_EPILOGUE_REDUCE_NEW_SPACE);
     ReduceNewSpaceSize();
   }
+
+  // Release the backing stores of array buffers that died during this GC.
+  array_buffer_collector_->FreeAllocationsOnBackgroundThread();
 }
 
 
@@ -1009,6 +1015,9 @@ bool Heap::CollectGarbage(GarbageCollector collector,
     tracer()->Start(collector, gc_reason, collector_reason);
     DCHECK(AllowHeapAllocation::IsAllowed());
     DisallowHeapAllocation no_allocation_during_gc;
+    // Concurrent marking tasks must not observe the heap while it is moved.
+    // They are rescheduled by the next incremental marking step.
+    concurrent_marking()->Stop();
     GarbageCollectionPrologue();
 
     {
@@ -1709,11 +1718,50 @@ void Heap::Scavenge() {
   Address new_space_front = new_space_->ToSpaceStart();
   promotion_queue_.Initialize();
 
-  ScavengeVisitor scavenge_visitor(this);
-
   isolate()->global_handles()->IdentifyWeakUnmodifiedObjects(
       &IsUnmodifiedHeapObject);
 
+  if (scavenge_collector_->CanScavengeInParallel()) {
+    ScavengeInParallel();
+    new_space_front = new_space_->top();
+  } else {
+    new_space_front = ScavengeSequentially(new_space_front);
+  }
+
+  UpdateNewSpaceReferencesInExternalStringTable(
+      &UpdateNewSpaceReferenceInExternalStringTableEntry);
+
+  promotion_queue_.Destroy();
+
+  incremental_marking()->UpdateMarkingDequeAfterScavenge();
+
+  ScavengeWeakObjectRetainer weak_object_retainer(this);
+  ProcessYoungWeakReferences(&weak_object_retainer);
+
+  DCHECK(new_space_front == new_space_->top());
+
+  // Set age mark.
+  new_space_->set_age_mark(new_space_->top());
+
+  ArrayBufferTracker::FreeDeadInNewSpace(this);
+
+  // Update how much has survived scavenge.
+  DCHECK_GE(PromotedSpaceSizeOfObjects(), survived_watermark);
+  IncrementYoungSurvivorsCounter(PromotedSpaceSizeOfObjects() +
+                                 new_space_->Size() - survived_watermark);
+
+  // Scavenger may find new wrappers by iterating objects promoted onto a black
+  // page.
+  local_embedder_heap_tracer()->RegisterWrappersWithRemoteTracer();
+
+  LOG(isolate_, ResourceEvent("scavenge", "end"));
+
+  SetGCState(NOT_IN_GC);
+}
+
+Address Heap::ScavengeSequentially(Address new_space_front) {
+  ScavengeVisitor scavenge_visitor(this);
+
   {
     // Copy roots.
     TRACE_GC(tracer(), GCTracer::Scope::SCAVENGER_ROOTS);
@@ -1768,36 +1816,60 @@ void Heap::Scavenge() {
       ->IterateNewSpaceWeakUnmodifiedRoots<
           GlobalHandles::HANDLE_PHANTOM_NODES_VISIT_OTHERS>(&scavenge_visitor);
   new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+  return new_space_front;
+}
 
-  UpdateNewSpaceReferencesInExternalStringTable(
-      &UpdateNewSpaceReferenceInExternalStringTableEntry);
-
-  promotion_queue_.Destroy();
-
-  incremental_marking()->UpdateMarkingDequeAfterScavenge();
+void Heap::ScavengeInParallel() {
+  ParallelScavenger scavenger(
+      this, scavenge_collector_->parallel_scavenge_semaphore());
+  ObjectVisitor* root_visitor = scavenger.root_visitor();
 
-  ScavengeWeakObjectRetainer weak_object_retainer(this);
-  ProcessYoungWeakReferences(&weak_object_retainer);
+  {
+    // Copy roots.
+    TRACE_GC(tracer(), GCTracer::Scope::SCAVENGER_ROOTS);
+    IterateRoots(root_visitor, VISIT_ALL_IN_SCAVENGE);
+  }
 
-  DCHECK(new_space_front == new_space_->top());
+  {
+    // Copy objects reachable from code objects in the old generation. The
+    // untyped old-to-new slots are processed by the parallel tasks.
+    TRACE_GC(tracer(), GCTracer::Scope::SCAVENGER_OLD_TO_NEW_POINTERS);
+    scavenger.ScavengeTypedOldToNewSlots();
+  }
 
-  // Set age mark.
-  new_space_->set_age_mark(new_space_->top());
+  {
+    TRACE_GC(tracer(), GCTracer::Scope::SCAVENGER_WEAK);
+    // Copy objects reachable from the encountered weak collections list.
+    root_visitor->VisitPointer(&encountered_weak_collections_);
+  }
 
-  ArrayBufferTracker::FreeDeadInNewSpace(this);
+  {
+    // Copy objects reachable from the code flushing candidates list.
+    TRACE_GC(tracer(), GCTracer::Scope::SCAVENGER_CODE_FLUSH_CANDIDATES);
+    MarkCompactCollector* collector = mark_compact_collector();
+    if (collector->is_code_flushing_enabled()) {
+      collector->code_flusher()->IteratePointersToFromSpace(root_visitor);
+    }
+  }
 
-  // Update how much has survived scavenge.
-  DCHECK_GE(PromotedSpaceSizeOfObjects(), survived_watermark);
-  IncrementYoungSurvivorsCounter(PromotedSpaceSizeOfObjects() +
-                                 new_space_->Size() - survived_watermark);
+  {
+    TRACE_GC(tracer(), GCTracer::Scope::SCAVENGER_SCAVENGE_PARALLEL);
+    scavenger.ScavengeInParallel();
+  }
 
-  // Scavenger may find new wrappers by iterating objects promoted onto a black
-  // page.
-  local_embedder_heap_tracer()->RegisterWrappersWithRemoteTracer();
+  isolate()->global_handles()->MarkNewSpaceWeakUnmodifiedObjectsPending(
+      &IsUnscavengedHeapObject);
 
-  LOG(isolate_, ResourceEvent("scavenge", "end"));
+  isolate()
+      ->global_handles()
+      ->IterateNewSpaceWeakUnmodifiedRoots<
+          GlobalHandles::HANDLE_PHANTOM_NODES_VISIT_OTHERS>(root_visitor);
+  scavenger.ScavengeOnMainThread();
 
-  SetGCState(NOT_IN_GC);
+  {
+    TRACE_GC(tracer(), GCTracer::Scope::SCAVENGER_SCAVENGE_FINALIZE);
+    scavenger.Finalize();
+  }
 }
 
 void Heap::ComputeFastPromotionMode(double survival_rate) {
@@ -3146,6 +3218,11 @@ bool Heap::CanMoveObjectStart(HeapObject* object) {
 
   if (lo_space()->Contains(object)) return false;
 
+  // The concurrent marker may hold a reference to the old object start.
+  if (FLAG_concurrent_marking && incremental_marking()->IsMarking()) {
+    return false;
+  }
+
   // We can move the object start if the page was already swept.
   return Page::FromAddress(address)->SweepingDone();
 }
@@ -4290,7 +4367,14 @@ void Heap::RegisterReservationsForBlackAllocation(Reservation* reservations) {
 void Heap::NotifyObjectLayoutChange(HeapObject* object,
                                     const DisallowHeapAllocation&) {
   if (FLAG_incremental_marking && incremental_marking()->IsMarking()) {
-    incremental_marking()->MarkGrey(this, object);
+    if (FLAG_concurrent_marking) {
+      // The concurrent marker may be visiting the object right now. Marking
+      // it black makes the concurrent marker discard its snapshot and the
+      // main thread rescans the object after the layout change.
+      incremental_marking()->MarkBlackAndPush(object);
+    } else {
+      incremental_marking()->MarkGrey(this, object);
+    }
   }
 #ifdef VERIFY_HEAP
   DCHECK(pending_layout_change_object_ == nullptr);
@@ -5567,6 +5651,7 @@ bool Heap::SetUp() {
     dead_object_stats_ = new ObjectStats(this);
   }
   scavenge_job_ = new ScavengeJob();
+  array_buffer_collector_ = new ArrayBufferCollector(this);
   local_embedder_heap_tracer_ = new LocalEmbedderHeapTracer();
 
   LOG(isolate_, IntPtrTEvent("heap-capacity", Capacity()));
@@ -5705,6 +5790,12 @@ void Heap::TearDown() {
     minor_mark_compact_collector_ = nullptr;
   }
 
+  if (array_buffer_collector_ != nullptr) {
+    array_buffer_collector_->TearDown();
+    delete array_buffer_collector_;
+    array_buffer_collector_ = nullptr;
+  }
+
   delete incremental_marking_;
   incremental_marking_ = nullptr;
 
@@ -312,6 +312,7 @@ using v8::MemoryPressureLevel;
 
 // Forward declarations.
 class AllocationObserver;
+class ArrayBufferCollector;
 class ArrayBufferTracker;
 class ConcurrentMarking;
 class GCIdleTimeAction;
@@ -828,6 +829,12 @@ class Heap {
   // return NULL;
   template <FindMementoMode mode>
   inline AllocationMemento* FindAllocationMemento(HeapObject* object);
+  // Same as above but uses the given {map} instead of reading it from the
+  // object, whose map word may already have been overwritten by a concurrent
+  // scavenger task.
+  template <FindMementoMode mode>
+  inline AllocationMemento* FindAllocationMemento(Map* map,
+                                                  HeapObject* object);
 
   // Returns false if not able to reserve.
   bool ReserveSpace(Reservation* reservations, List<Address>* maps);
@@ -1239,6 +1246,12 @@ class Heap {
 
   IncrementalMarking* incremental_marking() { return incremental_marking_; }
 
+  ConcurrentMarking* concurrent_marking() { return concurrent_marking_; }
+
+  ArrayBufferCollector* array_buffer_collector() {
+    return array_buffer_collector_;
+  }
+
   // The runtime uses this function to notify potentially unsafe object layout
   // changes that require special synchronization with the concurrent marker.
   // A layout change is unsafe if
@@ -1393,6 +1406,15 @@ class Heap {
     return promoted_objects_size_ + semi_space_copied_object_size_;
   }
 
+  // Number of tasks that copied or promoted objects in the last parallel
+  // scavenge.
+  inline void set_parallel_scavenge_active_tasks(int tasks) {
+    parallel_scavenge_active_tasks_ = tasks;
+  }
+  inline int parallel_scavenge_active_tasks() {
+    return parallel_scavenge_active_tasks_;
+  }
+
   inline void IncrementNodesDiedInNewSpace() { nodes_died_in_new_space_++; }
 
   inline void IncrementNodesCopiedInNewSpace() { nodes_copied_in_new_space_++; }
@@ -1495,6 +1517,9 @@ class Heap {
   template <UpdateAllocationSiteMode mode>
   inline void UpdateAllocationSite(HeapObject* object,
                                    base::HashMap* pretenuring_feedback);
+  template <UpdateAllocationSiteMode mode>
+  inline void UpdateAllocationSite(Map* map, HeapObject* object,
+                                   base::HashMap* pretenuring_feedback);
 
   // Removes an entry from the global pretenuring storage.
   inline void RemoveAllocationSitePretenuringFeedback(AllocationSite* site);
@@ -1820,6 +1845,10 @@ class Heap {
 
   // Performs a minor collection in new generation.
   void Scavenge();
+  // Copying phases of a scavenge, performed either on the main thread only or
+  // by multiple tasks when --parallel-scavenge is enabled.
+  Address ScavengeSequentially(Address new_space_front);
+  void ScavengeInParallel();
   void EvacuateYoungGeneration();
 
   Address DoScavenge(ObjectVisitor* scavenge_visitor, Address new_space_front);
@@ -2263,6 +2292,7 @@ class Heap {
   size_t semi_space_copied_object_size_;
   size_t previous_semi_space_copied_object_size_;
   double semi_space_copied_rate_;
+  int parallel_scavenge_active_tasks_;
   int nodes_died_in_new_space_;
   int nodes_copied_in_new_space_;
   int nodes_promoted_;
@@ -2303,6 +2333,8 @@ class Heap {
 
   ScavengeJob* scavenge_job_;
 
+  ArrayBufferCollector* array_buffer_collector_;
+
   AllocationObserver* idle_scavenge_observer_;
 
   // This counter is increased before each GC and never reset.
@@ -7,6 +7,7 @@
 #include "src/code-stubs.h"
 #include "src/compilation-cache.h"
 #include "src/conversions.h"
+#include "src/heap/concurrent-marking.h"
 #include "src/heap/gc-idle-time-handler.h"
 #include "src/heap/gc-tracer.h"
 #include "src/heap/heap-inl.h"
@@ -25,6 +26,7 @@ IncrementalMarking::IncrementalMarking(Heap* heap)
       state_(STOPPED),
       initial_old_generation_size_(0),
       bytes_marked_ahead_of_schedule_(0),
+      bytes_marked_concurrently_(0),
       unscanned_bytes_of_large_object_(0),
       idle_marking_delay_counter_(0),
       incremental_marking_finalization_rounds_(0),
@@ -43,15 +45,22 @@ bool IncrementalMarking::BaseRecordWrite(HeapObject* obj, Object* value) {
   DCHECK(!ObjectMarking::IsImpossible(value_heap_obj,
                                       MarkingState::Internal(value_heap_obj)));
   DCHECK(!ObjectMarking::IsImpossible(obj, MarkingState::Internal(obj)));
-  const bool is_black =
-      ObjectMarking::IsBlack(obj, MarkingState::Internal(obj));
-
-  if (is_black && ObjectMarking::IsWhite(
-                      value_heap_obj, MarkingState::Internal(value_heap_obj))) {
-    WhiteToGreyAndPush(value_heap_obj);
+  // With concurrent marking a grey object may be visited by a background
+  // thread right now, so values written into grey objects are marked, too.
+  const bool need_recording =
+      FLAG_concurrent_marking
+          ? ObjectMarking::IsBlackOrGrey<kAtomicity>(
+                obj, MarkingState::Internal(obj))
+          : ObjectMarking::IsBlack<kAtomicity>(obj,
+                                               MarkingState::Internal(obj));
+
+  if (need_recording &&
+      ObjectMarking::IsWhite<kAtomicity>(
+          value_heap_obj, MarkingState::Internal(value_heap_obj)) &&
+      WhiteToGreyAndPush(value_heap_obj)) {
     RestartIfNotMarking();
   }
-  return is_compacting_ && is_black;
+  return is_compacting_ && need_recording;
 }
 
 
@@ -119,9 +128,29 @@ void IncrementalMarking::RecordWriteIntoCodeSlow(Code* host, RelocInfo* rinfo,
   }
 }
 
-void IncrementalMarking::WhiteToGreyAndPush(HeapObject* obj) {
-  ObjectMarking::WhiteToGrey(obj, MarkingState::Internal(obj));
-  heap_->mark_compact_collector()->marking_deque()->Push(obj);
+bool IncrementalMarking::WhiteToGreyAndPush(HeapObject* obj) {
+  if (ObjectMarking::WhiteToGrey<kAtomicity>(obj,
+                                             MarkingState::Internal(obj))) {
+    heap_->mark_compact_collector()->marking_deque()->Push(obj);
+    return true;
+  }
+  return false;
+}
+
+void IncrementalMarking::MarkBlackAndPush(HeapObject* obj) {
+  // Color the object black and push it onto the marking deque. The object
+  // may already be black if the concurrent marker visited it before.
+  if (ObjectMarking::IsWhite<kAtomicity>(obj, MarkingState::Internal(obj))) {
+    ObjectMarking::WhiteToGrey<kAtomicity>(obj, MarkingState::Internal(obj));
+  }
+  if (ObjectMarking::IsGrey<kAtomicity>(obj, MarkingState::Internal(obj))) {
+    ObjectMarking::GreyToBlack<kAtomicity>(obj, MarkingState::Internal(obj));
+  }
+  if (!heap_->mark_compact_collector()->marking_deque()->Push(obj)) {
+    // The deque overflowed. The grey object is found by the heap rescan in
+    // the final pause.
+    ObjectMarking::BlackToGrey<kAtomicity>(obj, MarkingState::Internal(obj));
+  }
 }
 
 void IncrementalMarking::TransferMark(Heap* heap, HeapObject* from,
@@ -143,10 +172,10 @@ void IncrementalMarking::TransferMark(Heap* heap, HeapObject* from,
   MarkBit old_mark_bit =
       ObjectMarking::MarkBitFrom(from, MarkingState::Internal(from));
 
-  if (Marking::IsBlack(old_mark_bit)) {
-    Marking::MarkBlack(new_mark_bit);
-  } else if (Marking::IsGrey(old_mark_bit)) {
-    Marking::WhiteToGrey(new_mark_bit);
+  if (Marking::IsBlack<kAtomicity>(old_mark_bit)) {
+    Marking::MarkBlack<kAtomicity>(new_mark_bit);
+  } else if (Marking::IsGrey<kAtomicity>(old_mark_bit)) {
+    Marking::WhiteToGrey<kAtomicity>(new_mark_bit);
     heap->mark_compact_collector()->marking_deque()->Push(to);
     heap->incremental_marking()->RestartIfNotMarking();
   }
@@ -217,10 +246,10 @@ class IncrementalMarkingMarkingVisitor
         HeapObject* heap_obj = HeapObject::cast(cache);
         // Mark the object grey if it is white, do not enque it into the marking
         // deque.
-        if (ObjectMarking::IsWhite(heap_obj,
-                                   MarkingState::Internal(heap_obj))) {
-          ObjectMarking::WhiteToGrey(heap_obj,
-                                     MarkingState::Internal(heap_obj));
+        if (ObjectMarking::IsWhite<IncrementalMarking::kAtomicity>(
+                heap_obj, MarkingState::Internal(heap_obj))) {
+          ObjectMarking::WhiteToGrey<IncrementalMarking::kAtomicity>(
+              heap_obj, MarkingState::Internal(heap_obj));
         }
       }
     }
@@ -255,19 +284,18 @@ class IncrementalMarkingMarkingVisitor
   // Returns true if object needed marking and false otherwise.
   INLINE(static bool MarkObjectWithoutPush(Heap* heap, Object* obj)) {
     HeapObject* heap_object = HeapObject::cast(obj);
-    if (ObjectMarking::IsWhite(heap_object,
-                               MarkingState::Internal(heap_object))) {
-      ObjectMarking::WhiteToBlack(heap_object,
-                                  MarkingState::Internal(heap_object));
-      return true;
+    if (ObjectMarking::IsWhite<IncrementalMarking::kAtomicity>(
+            heap_object, MarkingState::Internal(heap_object))) {
+      return ObjectMarking::WhiteToBlack<IncrementalMarking::kAtomicity>(
+          heap_object, MarkingState::Internal(heap_object));
     }
     return false;
   }
 };
 
 void IncrementalMarking::IterateBlackObject(HeapObject* object) {
-  if (IsMarking() &&
-      ObjectMarking::IsBlack(object, MarkingState::Internal(object))) {
+  if (IsMarking() && ObjectMarking::IsBlack<IncrementalMarking::kAtomicity>(
+                         object, MarkingState::Internal(object))) {
     Page* page = Page::FromAddress(object->address());
     if ((page->owner() != nullptr) && (page->owner()->identity() == LO_SPACE)) {
       // IterateBlackObject requires us to visit the whole object.
@@ -545,6 +573,12 @@ void IncrementalMarking::StartMarking() {
   IncrementalMarkingRootMarkingVisitor visitor(this);
   heap_->IterateStrongRoots(&visitor, VISIT_ONLY_STRONG);
 
+  if (FLAG_concurrent_marking) {
+    bytes_marked_concurrently_ =
+        heap_->concurrent_marking()->TotalMarkedBytes();
+    ShareWorkWithConcurrentMarking();
+  }
+
   // Ready to start incremental marking.
   if (FLAG_trace_incremental_marking) {
     heap()->isolate()->PrintWithTimestamp("[IncrementalMarking] Running\n");
@@ -778,14 +812,19 @@ void IncrementalMarking::UpdateMarkingDequeAfterScavenge() {
       // them.
       if (map_word.IsForwardingAddress()) {
         HeapObject* dest = map_word.ToForwardingAddress();
-        if (ObjectMarking::IsBlack(dest, MarkingState::Internal(dest)))
+        // With concurrent marking black objects on the deque have to be
+        // rescanned, see MarkBlackAndPush.
+        if (!FLAG_concurrent_marking &&
+            ObjectMarking::IsBlack(dest, MarkingState::Internal(dest)))
           continue;
         array[new_top] = dest;
         new_top = ((new_top + 1) & mask);
         DCHECK(new_top != marking_deque->bottom());
         DCHECK(ObjectMarking::IsGrey(obj, MarkingState::Internal(obj)) ||
                (obj->IsFiller() &&
-                ObjectMarking::IsWhite(obj, MarkingState::Internal(obj))));
+                ObjectMarking::IsWhite(obj, MarkingState::Internal(obj))) ||
+               (FLAG_concurrent_marking &&
+                ObjectMarking::IsBlack(obj, MarkingState::Internal(obj))));
       }
     } else if (obj->map() != filler_map) {
       // Skip one word filler objects that appear on the
@@ -796,12 +835,89 @@ void IncrementalMarking::UpdateMarkingDequeAfterScavenge() {
       DCHECK(ObjectMarking::IsGrey(obj, MarkingState::Internal(obj)) ||
              (obj->IsFiller() &&
               ObjectMarking::IsWhite(obj, MarkingState::Internal(obj))) ||
-             (MemoryChunk::FromAddress(obj->address())
-                  ->IsFlagSet(MemoryChunk::HAS_PROGRESS_BAR) &&
+             ((FLAG_concurrent_marking ||
+               MemoryChunk::FromAddress(obj->address())
+                   ->IsFlagSet(MemoryChunk::HAS_PROGRESS_BAR)) &&
               ObjectMarking::IsBlack(obj, MarkingState::Internal(obj))));
     }
   }
   marking_deque->set_top(new_top);
+
+  if (FLAG_concurrent_marking) {
+    UpdateConcurrentMarkingWorklistsAfterScavenge();
+  }
+}
+
+void IncrementalMarking::UpdateConcurrentMarkingWorklistsAfterScavenge() {
+  Map* filler_map = heap_->one_pointer_filler_map();
+  auto update = [this, filler_map](HeapObject* obj, HeapObject** out) {
+    if (heap_->InFromSpace(obj)) {
+      MapWord map_word = obj->map_word();
+      // Dead objects are not forwarded and can be discarded.
+      if (!map_word.IsForwardingAddress()) return false;
+      HeapObject* dest = map_word.ToForwardingAddress();
+      if (ObjectMarking::IsBlack(dest, MarkingState::Internal(dest))) {
+        return false;
+      }
+      *out = dest;
+      return true;
+    }
+    if (obj->map() == filler_map) return false;
+    *out = obj;
+    return true;
+  };
+  heap_->concurrent_marking()->shared()->Update(update);
+  heap_->concurrent_marking()->bailout()->Update(update);
+}
+
+void IncrementalMarking::ShareWorkWithConcurrentMarking() {
+  MarkingDeque* marking_deque =
+      heap_->mark_compact_collector()->marking_deque();
+  ConcurrentMarking::MarkingWorklist::View shared(
+      heap_->concurrent_marking()->shared(), ConcurrentMarking::kMainThread);
+  int current = marking_deque->bottom();
+  int mask = marking_deque->mask();
+  int limit = marking_deque->top();
+  HeapObject** array = marking_deque->array();
+  int new_top = current;
+
+  while (current != limit) {
+    HeapObject* obj = array[current];
+    current = ((current + 1) & mask);
+    if (obj->IsFiller()) continue;
+    // Black objects are rescanned on the main thread and large arrays are
+    // scanned using the progress bar of their page.
+    if (ObjectMarking::IsGrey<kAtomicity>(obj, MarkingState::Internal(obj)) &&
+        !MemoryChunk::FromAddress(obj->address())
+             ->IsFlagSet(MemoryChunk::HAS_PROGRESS_BAR)) {
+      shared.Push(obj);
+    } else {
+      array[new_top] = obj;
+      new_top = ((new_top + 1) & mask);
+    }
+  }
+  marking_deque->set_top(new_top);
+  shared.FlushToGlobal();
+  heap_->concurrent_marking()->RescheduleTasksIfNeeded();
+}
+
+void IncrementalMarking::TakeWorkFromConcurrentMarking(bool include_shared) {
+  ConcurrentMarking* concurrent_marking = heap_->concurrent_marking();
+  MarkingDeque* marking_deque =
+      heap_->mark_compact_collector()->marking_deque();
+  HeapObject* obj;
+  ConcurrentMarking::MarkingWorklist::View bailout(
+      concurrent_marking->bailout(), ConcurrentMarking::kMainThread);
+  while (bailout.Pop(&obj)) {
+    marking_deque->Push(obj);
+  }
+  if (include_shared) {
+    ConcurrentMarking::MarkingWorklist::View shared(
+        concurrent_marking->shared(), ConcurrentMarking::kMainThread);
+    while (shared.Pop(&obj)) {
+      marking_deque->Push(obj);
+    }
+  }
 }
 
 
@@ -815,21 +931,25 @@ void IncrementalMarking::VisitObject(Map* map, HeapObject* obj, int size) {
       ObjectMarking::MarkBitFrom(obj, MarkingState::Internal(obj));
   MemoryChunk* chunk = MemoryChunk::FromAddress(obj->address());
   SLOW_DCHECK(Marking::IsGrey(mark_bit) ||
-              (chunk->IsFlagSet(MemoryChunk::HAS_PROGRESS_BAR) &&
+              ((FLAG_concurrent_marking ||
+                chunk->IsFlagSet(MemoryChunk::HAS_PROGRESS_BAR)) &&
                Marking::IsBlack(mark_bit)));
 #endif
   MarkBlack(obj, size);
 }
 
 void IncrementalMarking::MarkGrey(Heap* heap, HeapObject* object) {
-  if (ObjectMarking::IsWhite(object, MarkingState::Internal(object))) {
+  if (ObjectMarking::IsWhite<kAtomicity>(object,
+                                         MarkingState::Internal(object))) {
     heap->incremental_marking()->WhiteToGreyAndPush(object);
   }
 }
 
 void IncrementalMarking::MarkBlack(HeapObject* obj, int size) {
-  if (ObjectMarking::IsBlack(obj, MarkingState::Internal(obj))) return;
-  ObjectMarking::GreyToBlack(obj, MarkingState::Internal(obj));
+  if (ObjectMarking::IsBlack<kAtomicity>(obj, MarkingState::Internal(obj))) {
+    return;
+  }
+  ObjectMarking::GreyToBlack<kAtomicity>(obj, MarkingState::Internal(obj));
 }
 
 intptr_t IncrementalMarking::ProcessMarkingDeque(
@@ -869,6 +989,10 @@ void IncrementalMarking::Hurry() {
   // forced e.g. in tests. It should not happen when COMPLETE was set when
   // incremental marking finished and a regular GC was triggered after that
   // because should_hurry_ will force a full GC.
+  if (FLAG_concurrent_marking) {
+    // Concurrent marking tasks are stopped at this point.
+    TakeWorkFromConcurrentMarking(true);
+  }
   if (!heap_->mark_compact_collector()->marking_deque()->IsEmpty()) {
     double start = 0.0;
     if (FLAG_trace_incremental_marking) {
@@ -899,8 +1023,10 @@ void IncrementalMarking::Hurry() {
     HeapObject* cache = HeapObject::cast(
         Context::cast(context)->get(Context::NORMALIZED_MAP_CACHE_INDEX));
     if (!cache->IsUndefined(heap_->isolate())) {
-      if (ObjectMarking::IsGrey(cache, MarkingState::Internal(cache))) {
-        ObjectMarking::GreyToBlack(cache, MarkingState::Internal(cache));
+      if (ObjectMarking::IsGrey<kAtomicity>(cache,
+                                            MarkingState::Internal(cache))) {
+        ObjectMarking::GreyToBlack<kAtomicity>(cache,
+                                               MarkingState::Internal(cache));
       }
     }
     context = Context::cast(context)->next_context_link();
@@ -1093,6 +1219,17 @@ void IncrementalMarking::AdvanceIncrementalMarkingOnAllocation() {
         heap()->tracer()->IncrementalMarkingSpeedInBytesPerMillisecond());
     bytes_to_process = Min(bytes_to_process, max_step_size);
 
+    if (FLAG_concurrent_marking) {
+      // Bytes marked by the concurrent marker put us ahead of schedule.
+      size_t current_bytes_marked_concurrently =
+          heap_->concurrent_marking()->TotalMarkedBytes();
+      if (current_bytes_marked_concurrently > bytes_marked_concurrently_) {
+        bytes_marked_ahead_of_schedule_ +=
+            current_bytes_marked_concurrently - bytes_marked_concurrently_;
+        bytes_marked_concurrently_ = current_bytes_marked_concurrently;
+      }
+    }
+
     size_t bytes_processed = 0;
     if (bytes_marked_ahead_of_schedule_ >= bytes_to_process) {
       // Steps performed in tasks have put us ahead of schedule.
@@ -1125,12 +1262,20 @@ size_t IncrementalMarking::Step(size_t bytes_to_process,
 
   size_t bytes_processed = 0;
   if (state_ == MARKING) {
+    if (FLAG_concurrent_marking) {
+      TakeWorkFromConcurrentMarking(false);
+    }
     bytes_processed = ProcessMarkingDeque(bytes_to_process);
+    if (FLAG_concurrent_marking) {
+      ShareWorkWithConcurrentMarking();
+    }
     if (step_origin == StepOrigin::kTask) {
       bytes_marked_ahead_of_schedule_ += bytes_processed;
     }
 
-    if (heap_->mark_compact_collector()->marking_deque()->IsEmpty()) {
+    if (heap_->mark_compact_collector()->marking_deque()->IsEmpty() &&
+        (!FLAG_concurrent_marking ||
+         !heap_->concurrent_marking()->HasPendingWork())) {
       if (heap_->local_embedder_heap_tracer()
               ->ShouldFinalizeIncrementalMarking()) {
         if (completion == FORCE_COMPLETION ||
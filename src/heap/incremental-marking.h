@@ -32,6 +32,12 @@ class V8_EXPORT_PRIVATE IncrementalMarking {
 
   enum GCRequestType { NONE, COMPLETE_MARKING, FINALIZATION };
 
+#ifdef V8_CONCURRENT_MARKING
+  static const MarkBit::AccessMode kAtomicity = MarkBit::ATOMIC;
+#else
+  static const MarkBit::AccessMode kAtomicity = MarkBit::NON_ATOMIC;
+#endif
+
   explicit IncrementalMarking(Heap* heap);
 
   static void Initialize();
@@ -157,7 +163,14 @@ class V8_EXPORT_PRIVATE IncrementalMarking {
   void RecordCodeTargetPatch(Code* host, Address pc, HeapObject* value);
   void RecordCodeTargetPatch(Address pc, HeapObject* value);
 
-  void WhiteToGreyAndPush(HeapObject* obj);
+  // Returns true if the function succeeds in transitioning the object
+  // from white to grey.
+  bool WhiteToGreyAndPush(HeapObject* obj);
+
+  // Marks the object black and pushes it on the marking deque so that the
+  // main thread visits it again. Used for objects whose layout changes while
+  // the concurrent marker may be visiting them.
+  void MarkBlackAndPush(HeapObject* obj);
 
   inline void SetOldSpacePageFlags(MemoryChunk* chunk) {
     SetOldSpacePageFlags(chunk, IsMarking(), IsCompacting());
@@ -186,16 +199,18 @@ class V8_EXPORT_PRIVATE IncrementalMarking {
   static void TransferMark(Heap* heap, HeapObject* from, HeapObject* to);
 
   V8_INLINE static void TransferColor(HeapObject* from, HeapObject* to) {
-    if (ObjectMarking::IsBlack(to, MarkingState::Internal(to))) {
+    if (ObjectMarking::IsBlack<kAtomicity>(to, MarkingState::Internal(to))) {
       DCHECK(to->GetHeap()->incremental_marking()->black_allocation());
       return;
     }
 
-    DCHECK(ObjectMarking::IsWhite(to, MarkingState::Internal(to)));
-    if (ObjectMarking::IsGrey(from, MarkingState::Internal(from))) {
-      ObjectMarking::WhiteToGrey(to, MarkingState::Internal(to));
-    } else if (ObjectMarking::IsBlack(from, MarkingState::Internal(from))) {
-      ObjectMarking::WhiteToBlack(to, MarkingState::Internal(to));
+    DCHECK(ObjectMarking::IsWhite<kAtomicity>(to, MarkingState::Internal(to)));
+    if (ObjectMarking::IsGrey<kAtomicity>(from,
+                                          MarkingState::Internal(from))) {
+      ObjectMarking::WhiteToGrey<kAtomicity>(to, MarkingState::Internal(to));
+    } else if (ObjectMarking::IsBlack<kAtomicity>(
+                   from, MarkingState::Internal(from))) {
+      ObjectMarking::WhiteToBlack<kAtomicity>(to, MarkingState::Internal(to));
     }
   }
 
@@ -262,6 +277,14 @@ class V8_EXPORT_PRIVATE IncrementalMarking {
 
   INLINE(void VisitObject(Map* map, HeapObject* obj, int size));
 
+  // Moves grey objects from the marking deque to the shared worklist of the
+  // concurrent marker and schedules concurrent marking tasks if needed.
+  void ShareWorkWithConcurrentMarking();
+  // Moves objects that the concurrent marker could not visit onto the marking
+  // deque. If |include_shared| is set, the shared worklist is drained, too.
+  void TakeWorkFromConcurrentMarking(bool include_shared);
+  void UpdateConcurrentMarkingWorklistsAfterScavenge();
+
   void IncrementIdleMarkingDelayCounter();
 
   void AdvanceIncrementalMarkingOnAllocation();
@@ -278,6 +301,7 @@ class V8_EXPORT_PRIVATE IncrementalMarking {
   size_t old_generation_allocation_counter_;
   size_t bytes_allocated_;
   size_t bytes_marked_ahead_of_schedule_;
+  size_t bytes_marked_concurrently_;
   size_t unscanned_bytes_of_large_object_;
 
   int idle_marking_delay_counter_;
@@ -77,6 +77,12 @@ void CodeFlusher::AddCandidate(SharedFunctionInfo* shared_info) {
 }
 
 
+void CodeFlusher::AddBytecodeCandidate(SharedFunctionInfo* shared_info) {
+  DCHECK(shared_info->HasBytecodeArray());
+  bytecode_candidates_.push_back(shared_info);
+}
+
+
 void CodeFlusher::AddCandidate(JSFunction* function) {
   DCHECK(function->code() == function->shared()->code());
   if (function->next_function_link()->IsUndefined(isolate_)) {
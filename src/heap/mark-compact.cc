@@ -14,7 +14,9 @@
 #include "src/frames-inl.h"
 #include "src/gdb-jit.h"
 #include "src/global-handles.h"
+#include "src/heap/array-buffer-collector.h"
 #include "src/heap/array-buffer-tracker.h"
+#include "src/heap/concurrent-marking.h"
 #include "src/heap/gc-tracer.h"
 #include "src/heap/incremental-marking.h"
 #include "src/heap/mark-compact-inl.h"
@@ -592,6 +594,8 @@ void MarkCompactCollector::EnsureSweepingCompleted() {
 
   if (heap()->memory_allocator()->unmapper()->has_delayed_chunks())
     heap()->memory_allocator()->unmapper()->FreeQueuedChunks();
+
+  heap()->array_buffer_collector()->FreeAllocationsOnBackgroundThread();
 }
 
 bool MarkCompactCollector::Sweeper::AreSweeperTasksRunning() {
@@ -841,6 +845,7 @@ void MarkCompactCollector::Prepare() {
     AbortCompaction();
     heap_->local_embedder_heap_tracer()->AbortTracing();
     marking_deque()->Clear();
+    heap()->concurrent_marking()->ClearWorklists();
     was_marked_incrementally_ = false;
   }
 
@@ -1031,6 +1036,43 @@ void CodeFlusher::ProcessSharedFunctionInfoCandidates() {
 }
 
 
+void CodeFlusher::ProcessBytecodeCandidates() {
+  Code* lazy_compile = isolate_->builtins()->builtin(Builtins::kCompileLazy);
+  Counters* counters = isolate_->counters();
+  for (SharedFunctionInfo* candidate : bytecode_candidates_) {
+    BytecodeArray* bytecode = candidate->bytecode_array();
+    if (ObjectMarking::IsWhite(bytecode, MarkingState::Internal(bytecode))) {
+      if (FLAG_trace_code_flushing) {
+        PrintF("[code-flushing clears bytecode: ");
+        candidate->ShortPrint();
+        PrintF(" - age: %d]\n", bytecode->bytecode_age());
+      }
+      counters->bytecode_flushed_functions()->Increment();
+      counters->bytecode_flushed_size()->Increment(bytecode->Size());
+      // Always flush the optimized code map if there is one.
+      if (!candidate->OptimizedCodeMapIsCleared()) {
+        candidate->ClearOptimizedCodeMap();
+      }
+      candidate->ClearBytecodeArray();
+      candidate->set_code(lazy_compile);
+      candidate->set_bytecode_flushed(true);
+    }
+
+    // The function data slot was not recorded when the candidate was visited.
+    Object** function_data_slot = HeapObject::RawField(
+        candidate, SharedFunctionInfo::kFunctionDataOffset);
+    isolate_->heap()->mark_compact_collector()->RecordSlot(
+        candidate, function_data_slot, *function_data_slot);
+    Object** code_slot =
+        HeapObject::RawField(candidate, SharedFunctionInfo::kCodeOffset);
+    isolate_->heap()->mark_compact_collector()->RecordSlot(candidate, code_slot,
+                                                           *code_slot);
+  }
+
+  bytecode_candidates_.clear();
+}
+
+
 void CodeFlusher::EvictCandidate(SharedFunctionInfo* shared_info) {
   // Make sure previous flushing decisions are revisited.
   isolate_->heap()->incremental_marking()->IterateBlackObject(shared_info);
@@ -1344,6 +1386,9 @@ class SharedFunctionInfoMarkingVisitor : public ObjectVisitor {
     if (obj->IsSharedFunctionInfo()) {
       SharedFunctionInfo* shared = reinterpret_cast<SharedFunctionInfo*>(obj);
       collector_->MarkObject(shared->code());
+      if (shared->HasBytecodeArray()) {
+        collector_->MarkObject(shared->bytecode_array());
+      }
       collector_->MarkObject(shared);
     }
   }
@@ -1367,6 +1412,11 @@ void MarkCompactCollector::PrepareThreadForCodeFlushing(Isolate* isolate,
       Code* optimized_code = frame->LookupCode();
       MarkObject(optimized_code);
     }
+    if (frame->is_interpreted()) {
+      InterpretedFrame* interpreted_frame =
+          reinterpret_cast<InterpretedFrame*>(frame);
+      MarkObject(interpreted_frame->GetBytecodeArray());
+    }
   }
 }
 
@@ -6,6 +6,7 @@
 #define V8_HEAP_MARK_COMPACT_H_
 
 #include <deque>
+#include <vector>
 
 #include "src/base/bits.h"
 #include "src/base/platform/condition-variable.h"
@@ -257,6 +258,10 @@ class MarkingDeque {
 // We are not allowed to flush unoptimized code for functions that got
 // optimized or inlined into optimized code, because we might bailout
 // into the unoptimized code again during deoptimization.
+//
+// Interpreted functions all share the interpreter entry trampoline, so for
+// them it is the BytecodeArray referenced from the SharedFunctionInfo that is
+// flushed if nothing else keeps it alive.
 class CodeFlusher {
  public:
   explicit CodeFlusher(Isolate* isolate)
@@ -266,11 +271,13 @@ class CodeFlusher {
 
   inline void AddCandidate(SharedFunctionInfo* shared_info);
   inline void AddCandidate(JSFunction* function);
+  inline void AddBytecodeCandidate(SharedFunctionInfo* shared_info);
 
   void EvictCandidate(SharedFunctionInfo* shared_info);
   void EvictCandidate(JSFunction* function);
 
   void ProcessCandidates() {
+    ProcessBytecodeCandidates();
     ProcessSharedFunctionInfoCandidates();
     ProcessJSFunctionCandidates();
   }
@@ -280,6 +287,7 @@ class CodeFlusher {
  private:
   void ProcessJSFunctionCandidates();
   void ProcessSharedFunctionInfoCandidates();
+  void ProcessBytecodeCandidates();
 
   static inline JSFunction** GetNextCandidateSlot(JSFunction* candidate);
   static inline JSFunction* GetNextCandidate(JSFunction* candidate);
@@ -297,6 +305,10 @@ class CodeFlusher {
   Isolate* isolate_;
   JSFunction* jsfunction_candidates_head_;
   SharedFunctionInfo* shared_function_info_candidates_head_;
+  // Bytecode candidates can't be linked through their code object, which is
+  // shared. They are only collected during non-incremental marking, i.e.
+  // while no objects move.
+  std::vector<SharedFunctionInfo*> bytecode_candidates_;
 
   DISALLOW_COPY_AND_ASSIGN(CodeFlusher);
 };
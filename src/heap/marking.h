@@ -51,7 +51,6 @@ class MarkBit {
   base::Atomic32 mask_;
 
   friend class IncrementalMarking;
-  friend class ConcurrentMarkingMarkbits;
   friend class Marking;
 };
 
@@ -163,7 +162,33 @@ class Bitmap {
     for (int i = 0; i < CellsCount(); i++) cells()[i] = 0;
   }
 
-  // Sets all bits in the range [start_index, end_index).
+  // Sets the bits in the given mask of a cell. The boundary cells of a range
+  // may be shared with objects that are concurrently marked, so they are
+  // updated atomically.
+  void SetBitsInCell(uint32_t cell_index, MarkBit::CellType mask) {
+    base::Atomic32* cell = reinterpret_cast<base::Atomic32*>(cells()) +
+                           cell_index;
+    base::Atomic32 old_value;
+    do {
+      old_value = base::NoBarrier_Load(cell);
+    } while (base::Release_CompareAndSwap(cell, old_value,
+                                          old_value | mask) != old_value);
+  }
+
+  // Clears the bits in the given mask of a cell atomically.
+  void ClearBitsInCell(uint32_t cell_index, MarkBit::CellType mask) {
+    base::Atomic32* cell = reinterpret_cast<base::Atomic32*>(cells()) +
+                           cell_index;
+    base::Atomic32 old_value;
+    do {
+      old_value = base::NoBarrier_Load(cell);
+    } while (base::Release_CompareAndSwap(cell, old_value,
+                                          old_value & ~mask) != old_value);
+  }
+
+  // Sets all bits in the range [start_index, end_index). Only the boundary
+  // cells are updated atomically; the cells in between must not be accessed
+  // concurrently.
   void SetRange(uint32_t start_index, uint32_t end_index) {
     unsigned int start_cell_index = start_index >> Bitmap::kBitsPerCellLog2;
     MarkBit::CellType start_index_mask = 1u << Bitmap::IndexInCell(start_index);
@@ -174,15 +199,15 @@ class Bitmap {
     if (start_cell_index != end_cell_index) {
       // Firstly, fill all bits from the start address to the end of the first
       // cell with 1s.
-      cells()[start_cell_index] |= ~(start_index_mask - 1);
+      SetBitsInCell(start_cell_index, ~(start_index_mask - 1));
       // Then fill all in between cells with 1s.
       for (unsigned int i = start_cell_index + 1; i < end_cell_index; i++) {
         cells()[i] = ~0u;
       }
       // Finally, fill all bits until the end address in the last cell with 1s.
-      cells()[end_cell_index] |= (end_index_mask - 1);
+      SetBitsInCell(end_cell_index, end_index_mask - 1);
     } else {
-      cells()[start_cell_index] |= end_index_mask - start_index_mask;
+      SetBitsInCell(start_cell_index, end_index_mask - start_index_mask);
     }
   }
 
@@ -197,15 +222,15 @@ class Bitmap {
     if (start_cell_index != end_cell_index) {
       // Firstly, fill all bits from the start address to the end of the first
       // cell with 0s.
-      cells()[start_cell_index] &= (start_index_mask - 1);
+      ClearBitsInCell(start_cell_index, ~(start_index_mask - 1));
       // Then fill all in between cells with 0s.
       for (unsigned int i = start_cell_index + 1; i < end_cell_index; i++) {
         cells()[i] = 0;
       }
       // Finally, set all bits until the end address in the last cell with 0s.
-      cells()[end_cell_index] &= ~(end_index_mask - 1);
+      ClearBitsInCell(end_cell_index, end_index_mask - 1);
     } else {
-      cells()[start_cell_index] &= ~(end_index_mask - start_index_mask);
+      ClearBitsInCell(start_cell_index, end_index_mask - start_index_mask);
     }
   }
 
@@ -395,8 +420,7 @@ class Marking : public AllStatic {
 
   template <MarkBit::AccessMode mode = MarkBit::NON_ATOMIC>
   INLINE(static bool BlackToGrey(MarkBit markbit)) {
-    STATIC_ASSERT(mode == MarkBit::NON_ATOMIC);
-    DCHECK(IsBlack(markbit));
+    DCHECK(mode == MarkBit::ATOMIC || IsBlack(markbit));
     return markbit.Next().Clear<mode>();
   }
 
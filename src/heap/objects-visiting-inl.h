@@ -410,6 +410,10 @@ void StaticMarkingVisitor<StaticVisitor>::VisitCode(Map* map,
   if (FLAG_age_code && !heap->isolate()->serializer_enabled()) {
     code->MakeOlder();
   }
+  if (FLAG_flush_bytecode && code->kind() == Code::OPTIMIZED_FUNCTION &&
+      heap->mark_compact_collector()->is_code_flushing_enabled()) {
+    MarkDeoptimizationBytecode(heap, code);
+  }
   CodeBodyVisitor::Visit(map, object);
 }
 
@@ -436,6 +440,15 @@ void StaticMarkingVisitor<StaticVisitor>::VisitSharedFunctionInfo(
       VisitSharedFunctionInfoWeakCode(map, object);
       return;
     }
+    if (IsBytecodeFlushable(heap, shared)) {
+      // The bytecode is flushed unless it is reached from elsewhere, e.g.
+      // from an interpreter frame, a closure that is not a candidate or
+      // optimized code that inlines the function.
+      collector->code_flusher()->AddBytecodeCandidate(shared);
+      // Treat the reference to the bytecode array weakly.
+      VisitSharedFunctionInfoWeakBytecode(map, object);
+      return;
+    }
   }
   VisitSharedFunctionInfoStrongCode(map, object);
 }
@@ -459,9 +472,20 @@ void StaticMarkingVisitor<StaticVisitor>::VisitJSFunction(Map* map,
       // Treat the reference to the code object weakly.
       VisitJSFunctionWeakCode(map, object);
       return;
-    } else {
-      // Visit all unoptimized code objects to prevent flushing them.
-      StaticVisitor::MarkObject(heap, function->shared()->code());
+    }
+    SharedFunctionInfo* shared = function->shared();
+    if (function->code() == shared->code() &&
+        IsBytecodeFlushable(heap, shared)) {
+      // The closure is reset to lazy compilation together with its shared
+      // function info if the bytecode gets flushed.
+      collector->code_flusher()->AddCandidate(function);
+      VisitJSFunctionWeakCode(map, object);
+      return;
+    }
+    // Visit all unoptimized code objects to prevent flushing them.
+    StaticVisitor::MarkObject(heap, shared->code());
+    if (FLAG_flush_bytecode && shared->HasBytecodeArray()) {
+      StaticVisitor::MarkObject(heap, shared->bytecode_array());
     }
   }
   VisitJSFunctionStrongCode(map, object);
@@ -602,6 +626,71 @@ bool StaticMarkingVisitor<StaticVisitor>::IsFlushable(
   return true;
 }
 
+template <typename StaticVisitor>
+bool StaticMarkingVisitor<StaticVisitor>::IsBytecodeFlushable(
+    Heap* heap, SharedFunctionInfo* shared_info) {
+  if (!FLAG_flush_bytecode) return false;
+
+  // Closures that are created while marking incrementally might not be
+  // visited before the bytecode is flushed, so only flush bytecode when the
+  // whole marking happens in one pause.
+  if (heap->incremental_marking()->IsMarking()) return false;
+
+  // The function must be interpreted and have the source code available, to
+  // be able to recompile it in case we need the function again.
+  if (!shared_info->IsInterpreted() || !shared_info->HasBytecodeArray() ||
+      !HasSourceCode(heap, shared_info)) {
+    return false;
+  }
+
+  // Function must be lazy compilable.
+  if (!shared_info->allows_lazy_compilation()) return false;
+
+  // We don't know if generators and async functions have live activations
+  // (generator objects) on the heap.
+  if (IsResumableFunction(shared_info->kind())) return false;
+
+  // Scripts and non-user code are never flushed.
+  if (shared_info->is_toplevel() || !shared_info->IsUserJavaScript()) {
+    return false;
+  }
+
+  // The debugger keeps break points in a copy of the bytecode.
+  if (shared_info->HasDebugInfo()) return false;
+
+  if (shared_info->dont_flush() ||
+      shared_info->has_concurrent_optimization_job()) {
+    return false;
+  }
+
+  // The interpreter entry trampoline resets the age of the bytecode, so the
+  // function wasn't executed for several collections if it is old.
+  return shared_info->bytecode_array()->IsOld();
+}
+
+template <typename StaticVisitor>
+void StaticMarkingVisitor<StaticVisitor>::MarkDeoptimizationBytecode(
+    Heap* heap, Code* code) {
+  DCHECK_EQ(Code::OPTIMIZED_FUNCTION, code->kind());
+  DeoptimizationInputData* const data =
+      DeoptimizationInputData::cast(code->deoptimization_data());
+  if (data->length() == 0) return;
+  Object* shared = data->SharedFunctionInfo();
+  if (shared->IsSharedFunctionInfo() &&
+      SharedFunctionInfo::cast(shared)->HasBytecodeArray()) {
+    StaticVisitor::MarkObject(
+        heap, SharedFunctionInfo::cast(shared)->bytecode_array());
+  }
+  FixedArray* const literals = data->LiteralArray();
+  int const inlined_count = data->InlinedFunctionCount()->value();
+  for (int i = 0; i < inlined_count; ++i) {
+    SharedFunctionInfo* inlined = SharedFunctionInfo::cast(literals->get(i));
+    if (inlined->HasBytecodeArray()) {
+      StaticVisitor::MarkObject(heap, inlined->bytecode_array());
+    }
+  }
+}
+
 template <typename StaticVisitor>
 void StaticMarkingVisitor<StaticVisitor>::VisitSharedFunctionInfoStrongCode(
     Map* map, HeapObject* object) {
@@ -629,6 +718,23 @@ void StaticMarkingVisitor<StaticVisitor>::VisitJSFunctionStrongCode(
 }
 
 
+template <typename StaticVisitor>
+void StaticMarkingVisitor<StaticVisitor>::VisitSharedFunctionInfoWeakBytecode(
+    Map* map, HeapObject* object) {
+  // Skip visiting kFunctionDataOffset as it is treated weakly here.
+  Heap* heap = map->GetHeap();
+  StaticVisitor::VisitPointers(
+      heap, object,
+      HeapObject::RawField(object, SharedFunctionInfo::kCodeOffset),
+      HeapObject::RawField(object, SharedFunctionInfo::kFunctionDataOffset));
+  StaticVisitor::VisitPointers(
+      heap, object,
+      HeapObject::RawField(object, SharedFunctionInfo::kScriptOffset),
+      HeapObject::RawField(object,
+                           SharedFunctionInfo::kLastPointerFieldOffset +
+                               kPointerSize));
+}
+
 template <typename StaticVisitor>
 void StaticMarkingVisitor<StaticVisitor>::VisitJSFunctionWeakCode(
     Map* map, HeapObject* object) {
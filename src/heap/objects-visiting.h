@@ -296,11 +296,18 @@ class StaticMarkingVisitor : public StaticVisitorBase {
   // Code flushing support.
   INLINE(static bool IsFlushable(Heap* heap, JSFunction* function));
   INLINE(static bool IsFlushable(Heap* heap, SharedFunctionInfo* shared_info));
+  INLINE(static bool IsBytecodeFlushable(Heap* heap,
+                                         SharedFunctionInfo* shared_info));
+
+  // Marks the bytecode of the functions that optimized code deoptimizes to.
+  static void MarkDeoptimizationBytecode(Heap* heap, Code* code);
 
   // Helpers used by code flushing support that visit pointer fields and treat
   // references to code objects either strongly or weakly.
   static void VisitSharedFunctionInfoStrongCode(Map* map, HeapObject* object);
   static void VisitSharedFunctionInfoWeakCode(Map* map, HeapObject* object);
+  static void VisitSharedFunctionInfoWeakBytecode(Map* map,
+                                                  HeapObject* object);
   static void VisitJSFunctionStrongCode(Map* map, HeapObject* object);
   static void VisitJSFunctionWeakCode(Map* map, HeapObject* object);
 
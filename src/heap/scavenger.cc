@@ -4,14 +4,20 @@
 
 #include "src/heap/scavenger.h"
 
+#include <vector>
+
+#include "src/cancelable-task.h"
 #include "src/contexts.h"
 #include "src/heap/heap-inl.h"
 #include "src/heap/incremental-marking.h"
+#include "src/heap/mark-compact-inl.h"
 #include "src/heap/objects-visiting-inl.h"
+#include "src/heap/remembered-set.h"
 #include "src/heap/scavenger-inl.h"
 #include "src/isolate.h"
 #include "src/log.h"
 #include "src/profiler/heap-profiler.h"
+#include "src/v8.h"
 
 namespace v8 {
 namespace internal {
@@ -412,12 +418,22 @@ void Scavenger::ScavengeObjectSlow(HeapObject** p, HeapObject* object) {
 }
 
 
+bool Scavenger::IsLoggingOrProfiling() {
+  return FLAG_verify_predictable || isolate()->logger()->is_logging() ||
+         isolate()->is_profiling() ||
+         (isolate()->heap_profiler() != NULL &&
+          isolate()->heap_profiler()->is_tracking_object_moves());
+}
+
+
+bool Scavenger::CanScavengeInParallel() {
+  return FLAG_parallel_scavenge && !heap()->incremental_marking()->IsMarking() &&
+         !IsLoggingOrProfiling();
+}
+
+
 void Scavenger::SelectScavengingVisitorsTable() {
-  bool logging_and_profiling =
-      FLAG_verify_predictable || isolate()->logger()->is_logging() ||
-      isolate()->is_profiling() ||
-      (isolate()->heap_profiler() != NULL &&
-       isolate()->heap_profiler()->is_tracking_object_moves());
+  bool logging_and_profiling = IsLoggingOrProfiling();
 
   if (!heap()->incremental_marking()->IsMarking()) {
     if (!logging_and_profiling) {
@@ -478,5 +494,473 @@ void ScavengeVisitor::ScavengePointer(Object** p) {
                             reinterpret_cast<HeapObject*>(object));
 }
 
+// Task-local state of a parallel scavenge. Everything that is mutated while
+// copying objects is owned by a single task and merged back into the heap on
+// the main thread in {Finalize}.
+class LocalScavenger : public Malloced {
+ public:
+  static const int kLabSize = 4 * KB;
+  static const int kMaxLabObjectSize = 256;
+  static const int kInitialLocalPretenuringFeedbackCapacity = 256;
+
+  LocalScavenger(Heap* heap, ParallelScavenger::ScavengeWorklist* worklist,
+                 int task_id)
+      : heap_(heap),
+        worklist_(worklist, task_id),
+        task_id_(task_id),
+        compaction_spaces_(heap),
+        buffer_(LocalAllocationBuffer::InvalidBuffer()),
+        local_pretenuring_feedback_(kInitialLocalPretenuringFeedbackCapacity),
+        copied_size_(0),
+        promoted_size_(0),
+        duration_(0.0) {}
+
+  // Scavenges the object referenced from |slot| if it resides in from space.
+  inline void ScavengePointer(Object** slot) {
+    Object* object = *slot;
+    if (!heap_->InFromSpace(object)) return;
+    ScavengeObject(reinterpret_cast<HeapObject**>(slot),
+                   reinterpret_cast<HeapObject*>(object));
+  }
+
+  // Same as {Scavenger::CheckAndScavengeObject}.
+  inline SlotCallbackResult CheckAndScavengeObject(Address slot_address) {
+    Object** slot = reinterpret_cast<Object**>(slot_address);
+    Object* object = *slot;
+    if (heap_->InFromSpace(object)) {
+      ScavengeObject(reinterpret_cast<HeapObject**>(slot),
+                     reinterpret_cast<HeapObject*>(object));
+      if (heap_->InToSpace(*slot)) return KEEP_SLOT;
+    }
+    return REMOVE_SLOT;
+  }
+
+  // Scavenges all objects referenced from the untyped old-to-new remembered
+  // set of |chunk|. The chunk is owned by the calling task.
+  void ScavengePage(MemoryChunk* chunk) {
+    RememberedSet<OLD_TO_NEW>::Iterate(chunk, [this](Address addr) {
+      return CheckAndScavengeObject(addr);
+    });
+  }
+
+  // Scans copied and promoted objects until neither this task nor the global
+  // pool of the worklist has any work left.
+  void Process() {
+    HeapObject* object = nullptr;
+    while (worklist_.Pop(&object)) {
+      IterateAndScavengeObject(object);
+    }
+  }
+
+  // Makes all privately held work available to other tasks.
+  void Publish() { worklist_.FlushToGlobal(); }
+
+  // Records a slot of a promoted object pointing into new space. The slots
+  // are added to the remembered set sequentially in {Finalize}.
+  inline void RecordOldToNewSlot(Address slot) { promoted_slots_.Add(slot); }
+
+  void AddDuration(double duration) { duration_ += duration; }
+
+  // Merges back task-local state. Needs to be called on the main thread.
+  void Finalize();
+
+  // Closes the local allocation buffer and returns its unused area.
+  AllocationInfo CloseLAB() { return buffer_.Close(); }
+
+  int task_id() const { return task_id_; }
+  size_t copied_size() const { return copied_size_; }
+  size_t promoted_size() const { return promoted_size_; }
+  double duration() const { return duration_; }
+
+ private:
+  static inline AllocationAlignment AlignmentFromMap(Map* map) {
+    switch (map->instance_type()) {
+      case FIXED_DOUBLE_ARRAY_TYPE:
+      case FIXED_FLOAT64_ARRAY_TYPE:
+        return kDoubleAligned;
+      default:
+        return kWordAligned;
+    }
+  }
+
+  static inline bool ContainsOnlyData(Map* map) {
+    switch (static_cast<StaticVisitorBase::VisitorId>(map->visitor_id())) {
+      case StaticVisitorBase::kVisitSeqOneByteString:
+      case StaticVisitorBase::kVisitSeqTwoByteString:
+      case StaticVisitorBase::kVisitByteArray:
+      case StaticVisitorBase::kVisitFixedDoubleArray:
+      case StaticVisitorBase::kVisitDataObject:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  inline void ScavengeObject(HeapObject** slot, HeapObject* object);
+  inline void EvacuateObject(HeapObject** slot, Map* map, HeapObject* source);
+  inline bool SemiSpaceCopyObject(HeapObject** slot, Map* map,
+                                  HeapObject* source, int size);
+  inline bool PromoteObject(HeapObject** slot, Map* map, HeapObject* source,
+                            int size);
+  inline bool MigrateObject(Map* map, HeapObject* source, HeapObject* target,
+                            int size);
+  inline AllocationResult AllocateInNewSpace(int size,
+                                             AllocationAlignment alignment);
+  inline void IterateAndScavengeObject(HeapObject* target);
+
+  Heap* heap_;
+  ParallelScavenger::ScavengeWorklist::View worklist_;
+  const int task_id_;
+  CompactionSpaceCollection compaction_spaces_;
+  LocalAllocationBuffer buffer_;
+  base::HashMap local_pretenuring_feedback_;
+  List<Address> promoted_slots_;
+  size_t copied_size_;
+  size_t promoted_size_;
+  double duration_;
+};
+
+// Visits the body of a copied or promoted object. Slots of promoted objects
+// that still point into new space are recorded for the remembered set.
+class ScavengeBodyVisitor final : public ObjectVisitor {
+ public:
+  ScavengeBodyVisitor(Heap* heap, LocalScavenger* scavenger, bool record_slots)
+      : heap_(heap), scavenger_(scavenger), record_slots_(record_slots) {}
+
+  inline void VisitPointers(Object** start, Object** end) override {
+    for (Object** slot = start; slot < end; ++slot) {
+      scavenger_->ScavengePointer(slot);
+      if (record_slots_ && heap_->InNewSpace(*slot)) {
+        SLOW_DCHECK(heap_->InToSpace(*slot));
+        scavenger_->RecordOldToNewSlot(reinterpret_cast<Address>(slot));
+      }
+    }
+  }
+
+ private:
+  Heap* heap_;
+  LocalScavenger* scavenger_;
+  bool record_slots_;
+};
+
+void LocalScavenger::ScavengeObject(HeapObject** slot, HeapObject* object) {
+  DCHECK(heap_->InFromSpace(object));
+  // The map word is either the map of the object or, if another task has
+  // already copied the object, the forwarding address.
+  MapWord first_word = object->synchronized_map_word();
+  if (first_word.IsForwardingAddress()) {
+    *slot = first_word.ToForwardingAddress();
+    return;
+  }
+  EvacuateObject(slot, first_word.ToMap(), object);
+}
+
+void LocalScavenger::EvacuateObject(HeapObject** slot, Map* map,
+                                    HeapObject* source) {
+  // AllocationMementos are unrooted and shouldn't survive a scavenge.
+  DCHECK_NE(map, heap_->allocation_memento_map());
+  int size = source->SizeFromMap(map);
+  SLOW_DCHECK(size <= Page::kAllocatableMemory);
+
+  if (!heap_->ShouldBePromoted(source->address(), size)) {
+    // A semi-space copy may fail due to fragmentation. In that case, we
+    // try to promote the object.
+    if (SemiSpaceCopyObject(slot, map, source, size)) return;
+  }
+
+  if (PromoteObject(slot, map, source, size)) return;
+
+  // If promotion failed, we try to copy the object to the other semi-space.
+  if (SemiSpaceCopyObject(slot, map, source, size)) return;
+
+  FatalProcessOutOfMemory("Scavenger: semi-space copy\n");
+}
+
+bool LocalScavenger::MigrateObject(Map* map, HeapObject* source,
+                                   HeapObject* target, int size) {
+  heap_->CopyBlock(target->address(), source->address(), size);
+  target->set_map_word(MapWord::FromMap(map));
+  // Installing the forwarding address races with other tasks that reached
+  // the same object through a different slot. Only the winner may use its
+  // copy.
+  if (!source->release_compare_and_swap_map_word(
+          MapWord::FromMap(map), MapWord::FromForwardingAddress(target))) {
+    heap_->CreateFillerObjectAt(target->address(), size,
+                                ClearRecordedSlots::kNo);
+    return false;
+  }
+  heap_->UpdateAllocationSite<Heap::kCached>(map, source,
+                                             &local_pretenuring_feedback_);
+  return true;
+}
+
+AllocationResult LocalScavenger::AllocateInNewSpace(
+    int size, AllocationAlignment alignment) {
+  if (size > kMaxLabObjectSize) {
+    return heap_->new_space()->AllocateRawSynchronized(size, alignment);
+  }
+  AllocationResult allocation = buffer_.AllocateRawAligned(size, alignment);
+  if (allocation.IsRetry()) {
+    LocalAllocationBuffer saved_buffer = buffer_;
+    buffer_ = LocalAllocationBuffer::FromResult(
+        heap_,
+        heap_->new_space()->AllocateRawSynchronized(kLabSize, kWordAligned),
+        kLabSize);
+    if (!buffer_.IsValid()) return AllocationResult::Retry(NEW_SPACE);
+    buffer_.TryMerge(&saved_buffer);
+    allocation = buffer_.AllocateRawAligned(size, alignment);
+  }
+  return allocation;
+}
+
+bool LocalScavenger::SemiSpaceCopyObject(HeapObject** slot, Map* map,
+                                         HeapObject* source, int size) {
+  HeapObject* target = nullptr;
+  if (!AllocateInNewSpace(size, AlignmentFromMap(map)).To(&target)) {
+    return false;
+  }
+  if (!MigrateObject(map, source, target, size)) {
+    *slot = source->synchronized_map_word().ToForwardingAddress();
+    return true;
+  }
+  *slot = target;
+  copied_size_ += size;
+  if (!ContainsOnlyData(map)) worklist_.Push(target);
+  return true;
+}
+
+bool LocalScavenger::PromoteObject(HeapObject** slot, Map* map,
+                                   HeapObject* source, int size) {
+  HeapObject* target = nullptr;
+  if (!compaction_spaces_.Get(OLD_SPACE)
+           ->AllocateRaw(size, AlignmentFromMap(map))
+           .To(&target)) {
+    return false;
+  }
+  if (!MigrateObject(map, source, target, size)) {
+    *slot = source->synchronized_map_word().ToForwardingAddress();
+    return true;
+  }
+  // Update slot to new target using CAS. A concurrent sweeper thread may
+  // filter the slot concurrently.
+  HeapObject* old = *slot;
+  base::Release_CompareAndSwap(reinterpret_cast<base::AtomicWord*>(slot),
+                               reinterpret_cast<base::AtomicWord>(old),
+                               reinterpret_cast<base::AtomicWord>(target));
+  promoted_size_ += size;
+  if (!ContainsOnlyData(map)) worklist_.Push(target);
+  return true;
+}
+
+void LocalScavenger::IterateAndScavengeObject(HeapObject* target) {
+  // Promoted objects may point to objects that stay in new space and thus
+  // need old-to-new remembered set entries.
+  const bool record_slots = !heap_->InNewSpace(target);
+  ScavengeBodyVisitor visitor(heap_, this, record_slots);
+  Map* map = target->map();
+  int size = target->SizeFromMap(map);
+  if (map->instance_type() == JS_FUNCTION_TYPE) {
+    // JSFunctions reachable through kNextFunctionLinkOffset are weak. Slots for
+    // this links are recorded during processing of weak lists.
+    JSFunction::BodyDescriptorWeakCode::IterateBody(target, size, &visitor);
+  } else {
+    target->IterateBody(map->instance_type(), size, &visitor);
+  }
+}
+
+void LocalScavenger::Finalize() {
+  heap_->old_space()->MergeCompactionSpace(compaction_spaces_.Get(OLD_SPACE));
+  heap_->code_space()->MergeCompactionSpace(
+      compaction_spaces_.Get(CODE_SPACE));
+  for (int i = 0; i < promoted_slots_.length(); i++) {
+    Address slot = promoted_slots_[i];
+    RememberedSet<OLD_TO_NEW>::Insert(Page::FromAddress(slot), slot);
+  }
+  promoted_slots_.Clear();
+  heap_->IncrementSemiSpaceCopiedObjectSize(copied_size_);
+  heap_->IncrementPromotedObjectsSize(promoted_size_);
+  heap_->MergeAllocationSitePretenuringFeedback(local_pretenuring_feedback_);
+}
+
+class ParallelScavenger::RootScavengeVisitor final : public ObjectVisitor {
+ public:
+  explicit RootScavengeVisitor(LocalScavenger* scavenger)
+      : scavenger_(scavenger) {}
+
+  void VisitPointer(Object** p) override { scavenger_->ScavengePointer(p); }
+
+  void VisitPointers(Object** start, Object** end) override {
+    for (Object** p = start; p < end; p++) scavenger_->ScavengePointer(p);
+  }
+
+ private:
+  LocalScavenger* scavenger_;
+};
+
+class ParallelScavenger::ScavengingTask : public CancelableTask {
+ public:
+  ScavengingTask(Isolate* isolate, LocalScavenger* scavenger,
+                 std::vector<MemoryChunk*>* chunks,
+                 base::AtomicNumber<size_t>* next_chunk,
+                 base::Semaphore* on_finish)
+      : CancelableTask(isolate),
+        scavenger_(scavenger),
+        chunks_(chunks),
+        next_chunk_(next_chunk),
+        on_finish_(on_finish) {}
+
+  virtual ~ScavengingTask() {}
+
+  // Runs the task on the calling thread without signaling completion.
+  void RunOnMainThread() { Scavenge(); }
+
+ private:
+  // v8::internal::CancelableTask overrides.
+  void RunInternal() override {
+    Scavenge();
+    on_finish_->Signal();
+  }
+
+  void Scavenge() {
+    double start = base::OS::TimeCurrentMillis();
+    // Chunks are claimed one by one. Local work is drained after each chunk
+    // to keep the worklist small and to publish work early.
+    size_t index;
+    while ((index = next_chunk_->Increment(1) - 1) < chunks_->size()) {
+      scavenger_->ScavengePage((*chunks_)[index]);
+      scavenger_->Process();
+    }
+    scavenger_->Process();
+    scavenger_->AddDuration(base::OS::TimeCurrentMillis() - start);
+  }
+
+  LocalScavenger* scavenger_;
+  std::vector<MemoryChunk*>* chunks_;
+  base::AtomicNumber<size_t>* next_chunk_;
+  base::Semaphore* on_finish_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScavengingTask);
+};
+
+STATIC_ASSERT(ParallelScavenger::kMaxScavengerTasks <=
+              ParallelScavenger::ScavengeWorklist::kMaxNumTasks);
+
+// static
+int ParallelScavenger::NumberOfScavengeTasks(Heap* heap) {
+  if (FLAG_parallel_scavenge_tasks > 0) {
+    return Min(FLAG_parallel_scavenge_tasks, kMaxScavengerTasks);
+  }
+  // Use one task per MB of new space capacity, capped by the number of
+  // available cores.
+  const int num_scavenge_tasks =
+      static_cast<int>(heap->new_space()->TotalCapacity()) / MB;
+  const int available_cores = Max(
+      1, static_cast<int>(
+             V8::GetCurrentPlatform()->NumberOfAvailableBackgroundThreads()));
+  return Max(1, Min(Min(num_scavenge_tasks, kMaxScavengerTasks),
+                    available_cores));
+}
+
+ParallelScavenger::ParallelScavenger(Heap* heap,
+                                     base::Semaphore* pending_tasks)
+    : heap_(heap),
+      pending_tasks_(pending_tasks),
+      num_tasks_(NumberOfScavengeTasks(heap)),
+      worklist_(num_tasks_) {
+  for (int i = 0; i < num_tasks_; i++) {
+    scavengers_[i] = new LocalScavenger(heap, &worklist_, i);
+  }
+  root_visitor_ = new RootScavengeVisitor(scavengers_[0]);
+}
+
+ParallelScavenger::~ParallelScavenger() {
+  delete root_visitor_;
+  for (int i = 0; i < num_tasks_; i++) {
+    delete scavengers_[i];
+  }
+}
+
+ObjectVisitor* ParallelScavenger::root_visitor() { return root_visitor_; }
+
+void ParallelScavenger::ScavengeTypedOldToNewSlots() {
+  LocalScavenger* scavenger = scavengers_[0];
+  Isolate* isolate = heap_->isolate();
+  RememberedSet<OLD_TO_NEW>::IterateTyped(
+      heap_, [isolate, scavenger](SlotType type, Address host_addr,
+                                  Address addr) {
+        return UpdateTypedSlotHelper::UpdateTypedSlot(
+            isolate, type, addr, [scavenger](Object** addr) {
+              return scavenger->CheckAndScavengeObject(
+                  reinterpret_cast<Address>(addr));
+            });
+      });
+}
+
+void ParallelScavenger::ScavengeInParallel() {
+  std::vector<MemoryChunk*> chunks;
+  RememberedSet<OLD_TO_NEW>::IterateMemoryChunks(
+      heap_, [&chunks](MemoryChunk* chunk) {
+        if (chunk->slot_set<OLD_TO_NEW>() != nullptr) chunks.push_back(chunk);
+      });
+  base::AtomicNumber<size_t> next_chunk(0);
+
+  // Work found while scavenging roots is only available to the main thread
+  // until it is published.
+  scavengers_[0]->Publish();
+
+  Isolate* isolate = heap_->isolate();
+  uint32_t task_ids[kMaxScavengerTasks];
+  for (int i = 1; i < num_tasks_; i++) {
+    ScavengingTask* task = new ScavengingTask(
+        isolate, scavengers_[i], &chunks, &next_chunk, pending_tasks_);
+    task_ids[i] = task->id();
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        task, v8::Platform::kShortRunningTask);
+  }
+  // Contribute on main thread.
+  ScavengingTask main_task(isolate, scavengers_[0], &chunks, &next_chunk,
+                           pending_tasks_);
+  main_task.RunOnMainThread();
+  // Wait for background tasks. A task that was aborted before it started has
+  // neither claimed chunks nor discovered work.
+  for (int i = 1; i < num_tasks_; i++) {
+    if (isolate->cancelable_task_manager()->TryAbort(task_ids[i]) !=
+        CancelableTaskManager::kTaskAborted) {
+      pending_tasks_->Wait();
+    }
+  }
+  DCHECK(worklist_.IsGlobalEmpty());
+}
+
+void ParallelScavenger::ScavengeOnMainThread() { scavengers_[0]->Process(); }
+
+void ParallelScavenger::Finalize() {
+  DCHECK(worklist_.IsGlobalEmpty());
+  const Address top = heap_->new_space()->top();
+  int active_tasks = 0;
+  for (int i = 0; i < num_tasks_; i++) {
+    LocalScavenger* scavenger = scavengers_[i];
+    if (scavenger->copied_size() + scavenger->promoted_size() > 0) {
+      active_tasks++;
+    }
+    scavenger->Finalize();
+    // Try to find the last LAB that was used for new space allocation. If it
+    // was adjacent to the current top, move top back.
+    const AllocationInfo info = scavenger->CloseLAB();
+    if (info.limit() != nullptr && info.limit() == top) {
+      DCHECK_NOT_NULL(info.top());
+      *heap_->new_space()->allocation_top_address() = info.top();
+    }
+    if (FLAG_trace_parallel_scavenge) {
+      PrintIsolate(heap_->isolate(),
+                   "parallel-scavenge[%d/%d]: copied=%" PRIuS
+                   " promoted=%" PRIuS " time=%.2f\n",
+                   scavenger->task_id(), num_tasks_, scavenger->copied_size(),
+                   scavenger->promoted_size(), scavenger->duration());
+    }
+  }
+  heap_->set_parallel_scavenge_active_tasks(active_tasks);
+}
+
 }  // namespace internal
 }  // namespace v8
@@ -5,8 +5,10 @@
 #ifndef V8_HEAP_SCAVENGER_H_
 #define V8_HEAP_SCAVENGER_H_
 
+#include "src/base/platform/semaphore.h"
 #include "src/heap/objects-visiting.h"
 #include "src/heap/slot-set.h"
+#include "src/heap/worklist.h"
 
 namespace v8 {
 namespace internal {
@@ -16,7 +18,8 @@ typedef void (*ScavengingCallback)(Map* map, HeapObject** slot,
 
 class Scavenger {
  public:
-  explicit Scavenger(Heap* heap) : heap_(heap) {}
+  explicit Scavenger(Heap* heap)
+      : heap_(heap), parallel_scavenge_semaphore_(0) {}
 
   // Initializes static visitor dispatch tables.
   static void Initialize();
@@ -36,12 +39,82 @@ class Scavenger {
   // of the heap (i.e. incremental marking, logging and profiling).
   void SelectScavengingVisitorsTable();
 
+  // Returns true if the upcoming scavenge can be performed by the
+  // {ParallelScavenger}. Parallel scavenging does not support transferring
+  // marks to incremental marking and does not report object moves to loggers
+  // and profilers.
+  bool CanScavengeInParallel();
+
+  // Semaphore used by the tasks of a parallel scavenge. Its lifetime has to
+  // match the lifetime of the isolate, see {PageParallelJob}.
+  base::Semaphore* parallel_scavenge_semaphore() {
+    return &parallel_scavenge_semaphore_;
+  }
+
   Isolate* isolate();
   Heap* heap() { return heap_; }
 
  private:
+  bool IsLoggingOrProfiling();
+
   Heap* heap_;
   VisitorDispatchTable<ScavengingCallback> scavenging_visitors_table_;
+  base::Semaphore parallel_scavenge_semaphore_;
+};
+
+class LocalScavenger;
+
+// Performs the copying part of a scavenge with multiple tasks. Roots are
+// scavenged on the main thread. Afterwards the old-to-new remembered set and
+// the transitive closure of all copied and promoted objects are processed by
+// up to {kMaxScavengerTasks} tasks. Each task allocates into its own local
+// allocation buffer in to-space and its own compaction space in old space.
+// Objects that still need to be scanned are kept on a shared worklist from
+// which idle tasks steal segments of work.
+class ParallelScavenger {
+ public:
+  static const int kMaxScavengerTasks = 8;
+  static const int kWorklistSegmentSize = 64;
+
+  typedef Worklist<HeapObject*, kWorklistSegmentSize> ScavengeWorklist;
+
+  ParallelScavenger(Heap* heap, base::Semaphore* pending_tasks);
+  ~ParallelScavenger();
+
+  // Visitor that scavenges strong and weak roots on the main thread.
+  ObjectVisitor* root_visitor();
+
+  // Scavenges the typed old-to-new slots of code objects on the main thread.
+  void ScavengeTypedOldToNewSlots();
+
+  // Scavenges the untyped old-to-new remembered set and all objects that are
+  // reachable from already scavenged objects using parallel tasks. Blocks
+  // until all tasks have finished.
+  void ScavengeInParallel();
+
+  // Scavenges all objects reachable from already scavenged objects on the
+  // main thread.
+  void ScavengeOnMainThread();
+
+  // Merges task-local allocation state, statistics, pretenuring feedback and
+  // remembered set entries back into the heap. Needs to be called on the main
+  // thread after all objects have been scavenged.
+  void Finalize();
+
+ private:
+  class RootScavengeVisitor;
+  class ScavengingTask;
+
+  static int NumberOfScavengeTasks(Heap* heap);
+
+  Heap* heap_;
+  base::Semaphore* pending_tasks_;
+  const int num_tasks_;
+  ScavengeWorklist worklist_;
+  LocalScavenger* scavengers_[kMaxScavengerTasks];
+  RootScavengeVisitor* root_visitor_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavenger);
 };
 
 
@@ -0,0 +1,300 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_HEAP_WORKLIST_
+#define V8_HEAP_WORKLIST_
+
+#include <cstddef>
+
+#include "src/base/logging.h"
+#include "src/base/macros.h"
+#include "src/base/platform/mutex.h"
+
+namespace v8 {
+namespace internal {
+
+// A concurrent worklist based on segments. Each task gets two private
+// segments, one for pushing and one for popping. Full push segments are
+// published to a global pool of segments from which other tasks can steal
+// work once their private segments run dry.
+//
+// Work stealing happens at segment granularity which keeps synchronization off
+// the fast path: Push and Pop only touch the global pool (and take its lock)
+// when a private segment runs full or empty.
+template <typename EntryType, int SEGMENT_SIZE>
+class Worklist {
+ public:
+  // A view of a worklist that is bound to a given task id.
+  class View {
+   public:
+    View(Worklist<EntryType, SEGMENT_SIZE>* worklist, int task_id)
+        : worklist_(worklist), task_id_(task_id) {}
+
+    // Pushes an entry onto the worklist.
+    bool Push(EntryType entry) { return worklist_->Push(task_id_, entry); }
+
+    // Pops an entry from the worklist.
+    bool Pop(EntryType* entry) { return worklist_->Pop(task_id_, entry); }
+
+    // Returns true if the local portion of the worklist is empty.
+    bool IsLocalEmpty() { return worklist_->IsLocalEmpty(task_id_); }
+
+    // Returns true if the worklist is empty. Can only be used from the main
+    // thread without concurrent access.
+    bool IsGlobalEmpty() { return worklist_->IsGlobalEmpty(); }
+
+    bool IsGlobalPoolEmpty() { return worklist_->IsGlobalPoolEmpty(); }
+
+    // Publishes the private segments of this task to the global pool.
+    void FlushToGlobal() { worklist_->FlushToGlobal(task_id_); }
+
+   private:
+    Worklist<EntryType, SEGMENT_SIZE>* worklist_;
+    int task_id_;
+  };
+
+  static const int kMaxNumTasks = 8;
+  static const int kSegmentCapacity = SEGMENT_SIZE;
+
+  Worklist() : Worklist(kMaxNumTasks) {}
+
+  explicit Worklist(int num_tasks) : num_tasks_(num_tasks), top_(nullptr) {
+    CHECK_LE(num_tasks, kMaxNumTasks);
+    for (int i = 0; i < num_tasks_; i++) {
+      private_push_segment(i) = new Segment();
+      private_pop_segment(i) = new Segment();
+    }
+  }
+
+  ~Worklist() {
+    CHECK(IsGlobalEmpty());
+    for (int i = 0; i < num_tasks_; i++) {
+      DCHECK_NOT_NULL(private_push_segment(i));
+      DCHECK_NOT_NULL(private_pop_segment(i));
+      delete private_push_segment(i);
+      delete private_pop_segment(i);
+    }
+  }
+
+  bool Push(int task_id, EntryType entry) {
+    DCHECK_LT(task_id, num_tasks_);
+    DCHECK_NOT_NULL(private_push_segment(task_id));
+    if (!private_push_segment(task_id)->Push(entry)) {
+      PublishPushSegmentToGlobal(task_id);
+      bool success = private_push_segment(task_id)->Push(entry);
+      USE(success);
+      DCHECK(success);
+    }
+    return true;
+  }
+
+  bool Pop(int task_id, EntryType* entry) {
+    DCHECK_LT(task_id, num_tasks_);
+    DCHECK_NOT_NULL(private_pop_segment(task_id));
+    if (!private_pop_segment(task_id)->Pop(entry)) {
+      if (!private_push_segment(task_id)->IsEmpty()) {
+        Segment* tmp = private_pop_segment(task_id);
+        private_pop_segment(task_id) = private_push_segment(task_id);
+        private_push_segment(task_id) = tmp;
+      } else if (!StealPopSegmentFromGlobal(task_id)) {
+        return false;
+      }
+      bool success = private_pop_segment(task_id)->Pop(entry);
+      USE(success);
+      DCHECK(success);
+    }
+    return true;
+  }
+
+  bool IsLocalEmpty(int task_id) {
+    return private_pop_segment(task_id)->IsEmpty() &&
+           private_push_segment(task_id)->IsEmpty();
+  }
+
+  bool IsGlobalPoolEmpty() {
+    base::LockGuard<base::Mutex> guard(&lock_);
+    return top_ == nullptr;
+  }
+
+  bool IsGlobalEmpty() {
+    for (int i = 0; i < num_tasks_; i++) {
+      if (!IsLocalEmpty(i)) return false;
+    }
+    return IsGlobalPoolEmpty();
+  }
+
+  size_t LocalSize(int task_id) {
+    return private_pop_segment(task_id)->Size() +
+           private_push_segment(task_id)->Size();
+  }
+
+  // Clearing of the worklist is not thread-safe. Can only be used from the
+  // main thread without concurrent access.
+  void Clear() {
+    for (int i = 0; i < num_tasks_; i++) {
+      private_pop_segment(i)->Clear();
+      private_push_segment(i)->Clear();
+    }
+    base::LockGuard<base::Mutex> guard(&lock_);
+    Segment* current = top_;
+    while (current != nullptr) {
+      Segment* tmp = current;
+      current = current->next();
+      delete tmp;
+    }
+    top_ = nullptr;
+  }
+
+  void FlushToGlobal(int task_id) {
+    PublishPushSegmentToGlobal(task_id);
+    PublishPopSegmentToGlobal(task_id);
+  }
+
+  // Calls the specified callback on each element of the worklist and replaces
+  // the element with the result of the callback.
+  // The signature of the callback is
+  //   bool Callback(EntryType old, EntryType* new).
+  // If the callback returns |false| then the element is removed from the
+  // worklist. Otherwise the |new| entry is updated.
+  //
+  // Updating is not thread-safe. Can only be used from the main thread
+  // without concurrent access.
+  template <typename Callback>
+  void Update(Callback callback) {
+    for (int i = 0; i < num_tasks_; i++) {
+      private_pop_segment(i)->Update(callback);
+      private_push_segment(i)->Update(callback);
+    }
+    base::LockGuard<base::Mutex> guard(&lock_);
+    Segment* prev = nullptr;
+    Segment* current = top_;
+    while (current != nullptr) {
+      current->Update(callback);
+      if (current->IsEmpty()) {
+        if (prev == nullptr) {
+          top_ = current->next();
+        } else {
+          prev->set_next(current->next());
+        }
+        Segment* tmp = current;
+        current = current->next();
+        delete tmp;
+      } else {
+        prev = current;
+        current = current->next();
+      }
+    }
+  }
+
+ private:
+  class Segment {
+   public:
+    static const int kCapacity = kSegmentCapacity;
+
+    Segment() : index_(0), next_(nullptr) {}
+
+    bool Push(EntryType entry) {
+      if (IsFull()) return false;
+      entries_[index_++] = entry;
+      return true;
+    }
+
+    bool Pop(EntryType* entry) {
+      if (IsEmpty()) return false;
+      *entry = entries_[--index_];
+      return true;
+    }
+
+    size_t Size() const { return index_; }
+    bool IsEmpty() const { return index_ == 0; }
+    bool IsFull() const { return index_ == kCapacity; }
+    void Clear() { index_ = 0; }
+
+    template <typename Callback>
+    void Update(Callback callback) {
+      size_t new_index = 0;
+      for (size_t i = 0; i < index_; i++) {
+        if (callback(entries_[i], &entries_[new_index])) {
+          new_index++;
+        }
+      }
+      index_ = new_index;
+    }
+
+    Segment* next() const { return next_; }
+    void set_next(Segment* segment) { next_ = segment; }
+
+   private:
+    size_t index_;
+    Segment* next_;
+    EntryType entries_[kCapacity];
+  };
+
+  // Keeps the private segments of different tasks on different cache lines.
+  struct PrivateSegmentHolder {
+    Segment* private_push_segment;
+    Segment* private_pop_segment;
+    char cache_line_padding[64];
+  };
+
+  Segment*& private_push_segment(int task_id) {
+    return private_segments_[task_id].private_push_segment;
+  }
+
+  Segment*& private_pop_segment(int task_id) {
+    return private_segments_[task_id].private_pop_segment;
+  }
+
+  void PublishPushSegmentToGlobal(int task_id) {
+    if (!private_push_segment(task_id)->IsEmpty()) {
+      Push(private_push_segment(task_id));
+      private_push_segment(task_id) = new Segment();
+    }
+  }
+
+  void PublishPopSegmentToGlobal(int task_id) {
+    if (!private_pop_segment(task_id)->IsEmpty()) {
+      Push(private_pop_segment(task_id));
+      private_pop_segment(task_id) = new Segment();
+    }
+  }
+
+  bool StealPopSegmentFromGlobal(int task_id) {
+    Segment* new_segment = nullptr;
+    if (Pop(&new_segment)) {
+      delete private_pop_segment(task_id);
+      private_pop_segment(task_id) = new_segment;
+      return true;
+    }
+    return false;
+  }
+
+  void Push(Segment* segment) {
+    base::LockGuard<base::Mutex> guard(&lock_);
+    segment->set_next(top_);
+    top_ = segment;
+  }
+
+  bool Pop(Segment** segment) {
+    base::LockGuard<base::Mutex> guard(&lock_);
+    if (top_ != nullptr) {
+      *segment = top_;
+      top_ = top_->next();
+      return true;
+    }
+    return false;
+  }
+
+  PrivateSegmentHolder private_segments_[kMaxNumTasks];
+  int num_tasks_;
+  base::Mutex lock_;
+  Segment* top_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worklist);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_HEAP_WORKLIST_
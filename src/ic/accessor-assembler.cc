@@ -1606,7 +1606,17 @@ enum AccessorAssembler::StubCacheTable : int {
   kSecondary = static_cast<int>(StubCache::kSecondary)
 };
 
-Node* AccessorAssembler::StubCachePrimaryOffset(Node* name, Node* map) {
+Node* AccessorAssembler::StubCacheTableMask(StubCache* stub_cache,
+                                            StubCacheTable table_id) {
+  // The tables can be resized at runtime, so the mask is not a constant.
+  StubCache::Table table = static_cast<StubCache::Table>(table_id);
+  return Load(MachineType::Uint32(),
+              ExternalConstant(
+                  ExternalReference(stub_cache->mask_reference(table))));
+}
+
+Node* AccessorAssembler::StubCachePrimaryOffset(StubCache* stub_cache,
+                                                Node* name, Node* map) {
   // See v8::internal::StubCache::PrimaryOffset().
   STATIC_ASSERT(StubCache::kCacheIndexShift == Name::kHashShift);
   // Compute the hash of the name (use entire hash field).
@@ -1623,21 +1633,20 @@ Node* AccessorAssembler::StubCachePrimaryOffset(Node* name, Node* map) {
   Node* hash = Int32Add(hash_field, map32);
   // Base the offset on a simple combination of name and map.
   hash = Word32Xor(hash, Int32Constant(StubCache::kPrimaryMagic));
-  uint32_t mask = (StubCache::kPrimaryTableSize - 1)
-                  << StubCache::kCacheIndexShift;
-  return ChangeUint32ToWord(Word32And(hash, Int32Constant(mask)));
+  Node* mask = StubCacheTableMask(stub_cache, kPrimary);
+  return ChangeUint32ToWord(Word32And(hash, mask));
 }
 
-Node* AccessorAssembler::StubCacheSecondaryOffset(Node* name, Node* seed) {
+Node* AccessorAssembler::StubCacheSecondaryOffset(StubCache* stub_cache,
+                                                  Node* name, Node* seed) {
   // See v8::internal::StubCache::SecondaryOffset().
 
   // Use the seed from the primary cache in the secondary cache.
   Node* name32 = TruncateWordToWord32(BitcastTaggedToWord(name));
   Node* hash = Int32Sub(TruncateWordToWord32(seed), name32);
   hash = Int32Add(hash, Int32Constant(StubCache::kSecondaryMagic));
-  int32_t mask = (StubCache::kSecondaryTableSize - 1)
-                 << StubCache::kCacheIndexShift;
-  return ChangeUint32ToWord(Word32And(hash, Int32Constant(mask)));
+  Node* mask = StubCacheTableMask(stub_cache, kSecondary);
+  return ChangeUint32ToWord(Word32And(hash, mask));
 }
 
 void AccessorAssembler::TryProbeStubCacheTable(StubCache* stub_cache,
@@ -1662,21 +1671,21 @@ void AccessorAssembler::TryProbeStubCacheTable(StubCache* stub_cache,
   entry_offset = IntPtrMul(entry_offset, IntPtrConstant(kMultiplier));
 
   // Check that the key in the entry matches the name.
-  Node* key_base =
-      ExternalConstant(ExternalReference(stub_cache->key_reference(table)));
+  Node* key_base = Load(
+      MachineType::Pointer(),
+      ExternalConstant(ExternalReference(stub_cache->table_reference(table))));
+  STATIC_ASSERT(offsetof(StubCache::Entry, key) == 0);
   Node* entry_key = Load(MachineType::Pointer(), key_base, entry_offset);
   GotoIf(WordNotEqual(name, entry_key), if_miss);
 
   // Get the map entry from the cache.
-  DCHECK_EQ(kPointerSize * 2, stub_cache->map_reference(table).address() -
-                                  stub_cache->key_reference(table).address());
+  STATIC_ASSERT(offsetof(StubCache::Entry, map) == kPointerSize * 2);
   Node* entry_map =
       Load(MachineType::Pointer(), key_base,
            IntPtrAdd(entry_offset, IntPtrConstant(kPointerSize * 2)));
   GotoIf(WordNotEqual(map, entry_map), if_miss);
 
-  DCHECK_EQ(kPointerSize, stub_cache->value_reference(table).address() -
-                              stub_cache->key_reference(table).address());
+  STATIC_ASSERT(offsetof(StubCache::Entry, value) == kPointerSize);
   Node* handler = Load(MachineType::TaggedPointer(), key_base,
                        IntPtrAdd(entry_offset, IntPtrConstant(kPointerSize)));
 
@@ -1689,7 +1698,7 @@ void AccessorAssembler::TryProbeStubCache(StubCache* stub_cache, Node* receiver,
                                           Node* name, Label* if_handler,
                                           Variable* var_handler,
                                           Label* if_miss) {
-  Label try_secondary(this), miss(this);
+  Label try_secondary(this), hit(this, var_handler), miss(this);
 
   Counters* counters = isolate()->counters();
   IncrementCounter(counters->megamorphic_stub_cache_probes(), 1);
@@ -1700,16 +1709,24 @@ void AccessorAssembler::TryProbeStubCache(StubCache* stub_cache, Node* receiver,
   Node* receiver_map = LoadMap(receiver);
 
   // Probe the primary table.
-  Node* primary_offset = StubCachePrimaryOffset(name, receiver_map);
+  Node* primary_offset =
+      StubCachePrimaryOffset(stub_cache, name, receiver_map);
   TryProbeStubCacheTable(stub_cache, kPrimary, primary_offset, name,
-                         receiver_map, if_handler, var_handler, &try_secondary);
+                         receiver_map, &hit, var_handler, &try_secondary);
 
   Bind(&try_secondary);
   {
     // Probe the secondary table.
-    Node* secondary_offset = StubCacheSecondaryOffset(name, primary_offset);
+    Node* secondary_offset =
+        StubCacheSecondaryOffset(stub_cache, name, primary_offset);
     TryProbeStubCacheTable(stub_cache, kSecondary, secondary_offset, name,
-                           receiver_map, if_handler, var_handler, &miss);
+                           receiver_map, &hit, var_handler, &miss);
+  }
+
+  Bind(&hit);
+  {
+    IncrementCounter(counters->megamorphic_stub_cache_hits(), 1);
+    Goto(if_handler);
   }
 
   Bind(&miss);
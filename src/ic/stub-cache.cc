@@ -9,24 +9,53 @@
 #include "src/counters.h"
 #include "src/heap/heap.h"
 #include "src/ic/ic-inl.h"
+#include "src/log.h"
 #include "src/type-info.h"
 
 namespace v8 {
 namespace internal {
 
-StubCache::StubCache(Isolate* isolate, Code::Kind ic_kind)
-    : isolate_(isolate), ic_kind_(ic_kind) {
+StubCache::StubCache(Isolate* isolate, Code::Kind ic_kind,
+                     int primary_table_bits)
+    : primary_(nullptr),
+      secondary_(nullptr),
+      primary_mask_(0),
+      secondary_mask_(0),
+      primary_table_bits_(0),
+      updates_since_clear_(0),
+      isolate_(isolate),
+      ic_kind_(ic_kind) {
   // Ensure the nullptr (aka Smi::kZero) which StubCache::Get() returns
   // when the entry is not found is not considered as a handler.
   DCHECK(!IC::IsHandler(nullptr));
+  if (primary_table_bits == 0) {
+    primary_table_bits = FLAG_stub_cache_primary_table_bits;
+  }
+  AllocateTables(Max(kMinPrimaryTableBits,
+                     Min(kMaxPrimaryTableBits, primary_table_bits)));
+}
+
+StubCache::~StubCache() {
+  delete[] primary_;
+  delete[] secondary_;
 }
 
 void StubCache::Initialize() {
-  DCHECK(base::bits::IsPowerOfTwo32(kPrimaryTableSize));
-  DCHECK(base::bits::IsPowerOfTwo32(kSecondaryTableSize));
+  DCHECK(base::bits::IsPowerOfTwo32(primary_table_size()));
+  DCHECK(base::bits::IsPowerOfTwo32(secondary_table_size()));
   Clear();
 }
 
+void StubCache::AllocateTables(int primary_table_bits) {
+  delete[] primary_;
+  delete[] secondary_;
+  primary_table_bits_ = primary_table_bits;
+  primary_ = new Entry[primary_table_size()];
+  secondary_ = new Entry[secondary_table_size()];
+  primary_mask_ = (primary_table_size() - 1) << kCacheIndexShift;
+  secondary_mask_ = (secondary_table_size() - 1) << kCacheIndexShift;
+}
+
 #ifdef DEBUG
 namespace {
 
@@ -77,6 +106,7 @@ Object* StubCache::Set(Name* name, Map* map, Object* handler) {
   primary->key = name;
   primary->value = handler;
   primary->map = map;
+  updates_since_clear_++;
   isolate()->counters()->megamorphic_stub_cache_updates()->Increment();
   return handler;
 }
@@ -98,13 +128,31 @@ Object* StubCache::Get(Name* name, Map* map) {
 
 
 void StubCache::Clear() {
+  // The cache is thrashing if it was refilled several times since the last
+  // clear, i.e. the megamorphic accesses miss too often. Grow the tables
+  // while they are empty anyway.
+  const size_t kThrashingRefills = 4;
+  int old_size = primary_table_size();
+  if (FLAG_stub_cache_grow &&
+      primary_table_bits_ < FLAG_stub_cache_max_primary_table_bits &&
+      primary_table_bits_ < kMaxPrimaryTableBits &&
+      updates_since_clear_ > kThrashingRefills * primary_table_size()) {
+    AllocateTables(primary_table_bits_ + 1);
+    isolate()->counters()->megamorphic_stub_cache_resizes()->Increment();
+  }
+  if (updates_since_clear_ > 0) {
+    LOG(isolate(), StubCacheEvent(Code::Kind2String(ic_kind_), old_size,
+                                  primary_table_size(), updates_since_clear_));
+  }
+  updates_since_clear_ = 0;
+
   Code* empty = isolate_->builtins()->builtin(Builtins::kIllegal);
-  for (int i = 0; i < kPrimaryTableSize; i++) {
+  for (int i = 0; i < primary_table_size(); i++) {
     primary_[i].key = isolate()->heap()->empty_string();
     primary_[i].map = nullptr;
     primary_[i].value = empty;
   }
-  for (int j = 0; j < kSecondaryTableSize; j++) {
+  for (int j = 0; j < secondary_table_size(); j++) {
     secondary_[j].key = isolate()->heap()->empty_string();
     secondary_[j].map = nullptr;
     secondary_[j].value = empty;
@@ -115,7 +163,7 @@ void StubCache::Clear() {
 void StubCache::CollectMatchingMaps(SmallMapList* types, Handle<Name> name,
                                     Handle<Context> native_context,
                                     Zone* zone) {
-  for (int i = 0; i < kPrimaryTableSize; i++) {
+  for (int i = 0; i < primary_table_size(); i++) {
     if (primary_[i].key == *name) {
       Map* map = primary_[i].map;
       // Map can be nullptr, if the stub is constant function call
@@ -130,7 +178,7 @@ void StubCache::CollectMatchingMaps(SmallMapList* types, Handle<Name> name,
     }
   }
 
-  for (int i = 0; i < kSecondaryTableSize; i++) {
+  for (int i = 0; i < secondary_table_size(); i++) {
     if (secondary_[i].key == *name) {
       Map* map = secondary_[i].map;
       // Map can be nullptr, if the stub is constant function call
@@ -31,6 +31,7 @@
 #include "src/elements.h"
 #include "src/external-reference-table.h"
 #include "src/frames-inl.h"
+#include "src/heap/concurrent-marking.h"
 #include "src/ic/access-compiler-data.h"
 #include "src/ic/stub-cache.h"
 #include "src/interface-descriptors.h"
@@ -46,6 +47,7 @@
 #include "src/runtime-profiler.h"
 #include "src/simulator.h"
 #include "src/snapshot/deserializer.h"
+#include "src/snapshot/feedback-serializer.h"
 #include "src/tracing/tracing-category-observer.h"
 #include "src/v8.h"
 #include "src/version.h"
@@ -2265,8 +2267,13 @@ class VerboseAccountingAllocator : public AccountingAllocator {
         "\"time\": %f, "
         "\"allocated\": %" PRIuS
         ","
-        "\"pooled\": %" PRIuS "}\n",
-        reinterpret_cast<void*>(heap_->isolate()), time, malloced, pooled);
+        "\"pooled\": %" PRIuS
+        ","
+        "\"pool_hits\": %" PRIuS
+        ","
+        "\"pool_misses\": %" PRIuS "}\n",
+        reinterpret_cast<void*>(heap_->isolate()), time, malloced, pooled,
+        GetPoolHitCount(), GetPoolMissCount());
   }
 
   Heap* heap_;
@@ -2337,6 +2344,7 @@ Isolate::Isolate(bool enable_serializer)
       use_counter_callback_(NULL),
       basic_block_profiler_(NULL),
       cancelable_task_manager_(new CancelableTaskManager()),
+      imported_feedback_(new ImportedFeedback()),
       abort_on_uncaught_exception_callback_(NULL),
       total_regexp_code_generated_(0) {
   {
@@ -2436,6 +2444,7 @@ void Isolate::Deinit() {
   }
 
   heap_.mark_compact_collector()->EnsureSweepingCompleted();
+  heap_.concurrent_marking()->Stop();
 
   DumpAndResetStats();
 
@@ -2582,6 +2591,9 @@ Isolate::~Isolate() {
   delete cancelable_task_manager_;
   cancelable_task_manager_ = nullptr;
 
+  delete imported_feedback_;
+  imported_feedback_ = nullptr;
+
   delete allocator_;
   allocator_ = nullptr;
 
@@ -2679,8 +2691,10 @@ bool Isolate::Init(Deserializer* des) {
   eternal_handles_ = new EternalHandles();
   bootstrapper_ = new Bootstrapper(this);
   handle_scope_implementer_ = new HandleScopeImplementer(this);
-  load_stub_cache_ = new StubCache(this, Code::LOAD_IC);
-  store_stub_cache_ = new StubCache(this, Code::STORE_IC);
+  load_stub_cache_ =
+      new StubCache(this, Code::LOAD_IC, stub_cache_primary_table_bits_);
+  store_stub_cache_ =
+      new StubCache(this, Code::STORE_IC, stub_cache_primary_table_bits_);
   materialized_object_store_ = new MaterializedObjectStore(this);
   regexp_stack_ = new RegExpStack();
   regexp_stack_->isolate_ = this;
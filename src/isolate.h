@@ -66,6 +66,7 @@ class HeapObjectToIndexHashMap;
 class HeapProfiler;
 class HStatistics;
 class HTracer;
+class ImportedFeedback;
 class InlineRuntimeFunctionsTable;
 class InnerPointerToCodeCache;
 class Logger;
@@ -394,6 +395,7 @@ typedef List<HeapObject*> DebugObjectCache;
   V(FatalErrorCallback, exception_behavior, nullptr)                          \
   V(OOMErrorCallback, oom_behavior, nullptr)                                  \
   V(LogEventCallback, event_logger, nullptr)                                  \
+  V(CompilationStatisticsCallback, compilation_statistics_callback, nullptr) \
   V(AllowCodeGenerationFromStringsCallback, allow_code_gen_callback, nullptr) \
   V(ExtensionCallback, wasm_module_callback, &NoExtension)                    \
   V(ExtensionCallback, wasm_instance_callback, &NoExtension)                  \
@@ -1185,6 +1187,8 @@ class Isolate {
     return cancelable_task_manager_;
   }
 
+  ImportedFeedback* imported_feedback() { return imported_feedback_; }
+
   const AstStringConstants* ast_string_constants() const {
     return ast_string_constants_;
   }
@@ -1226,6 +1230,12 @@ class Isolate {
   void set_allow_atomics_wait(bool set) { allow_atomics_wait_ = set; }
   bool allow_atomics_wait() { return allow_atomics_wait_; }
 
+  // Must be set before the isolate is initialized. 0 selects the default.
+  void set_stub_cache_primary_table_bits(int bits) {
+    DCHECK_NULL(load_stub_cache_);
+    stub_cache_primary_table_bits_ = bits;
+  }
+
   // List of native heap values allocated by the runtime as part of its
   // implementation that must be freed at isolate deinit.
   class ManagedObjectFinalizer final {
@@ -1532,6 +1542,8 @@ class Isolate {
 
   CancelableTaskManager* cancelable_task_manager_;
 
+  ImportedFeedback* imported_feedback_;
+
   v8::Isolate::AbortOnUncaughtExceptionCallback
       abort_on_uncaught_exception_callback_;
 
@@ -1541,6 +1553,8 @@ class Isolate {
 
   bool allow_atomics_wait_;
 
+  int stub_cache_primary_table_bits_ = 0;
+
   ManagedObjectFinalizer managed_object_finalizers_list_;
 
   size_t total_regexp_code_generated_;
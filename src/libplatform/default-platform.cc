@@ -49,6 +49,12 @@ void RunIdleTasks(v8::Platform* platform, v8::Isolate* isolate,
       isolate, idle_time_in_seconds);
 }
 
+void GetBackgroundTaskQueueStatistics(
+    v8::Platform* platform, BackgroundTaskQueueStatistics* statistics) {
+  reinterpret_cast<DefaultPlatform*>(platform)
+      ->GetBackgroundTaskQueueStatistics(statistics);
+}
+
 void SetTracingController(
     v8::Platform* platform,
     v8::platform::tracing::TracingController* tracing_controller) {
@@ -200,7 +206,14 @@ void DefaultPlatform::RunIdleTasks(v8::Isolate* isolate,
 void DefaultPlatform::CallOnBackgroundThread(Task* task,
                                              ExpectedRuntime expected_runtime) {
   EnsureInitialized();
-  queue_.Append(task);
+  queue_.Append(task, expected_runtime == kShortRunningTask
+                          ? TaskQueue::kShortRunningLane
+                          : TaskQueue::kLongRunningLane);
+}
+
+void DefaultPlatform::GetBackgroundTaskQueueStatistics(
+    BackgroundTaskQueueStatistics* statistics) {
+  queue_.GetStatistics(statistics);
 }
 
 
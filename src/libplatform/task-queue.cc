@@ -4,6 +4,8 @@
 
 #include "src/libplatform/task-queue.h"
 
+#include <algorithm>
+
 #include "src/base/logging.h"
 #include "src/base/platform/platform.h"
 #include "src/base/platform/time.h"
@@ -11,20 +13,37 @@
 namespace v8 {
 namespace platform {
 
-TaskQueue::TaskQueue() : process_queue_semaphore_(0), terminated_(false) {}
+namespace {
+
+int64_t NowInMicroseconds() {
+  return base::TimeTicks::HighResolutionNow().ToInternalValue();
+}
+
+}  // namespace
+
+TaskQueue::TaskQueue()
+    : process_queue_semaphore_(0),
+      terminated_(false),
+      total_queue_time_us_(0),
+      max_queue_time_us_(0) {
+  for (int lane = 0; lane < kNumberOfLanes; lane++) tasks_run_[lane] = 0;
+}
 
 
 TaskQueue::~TaskQueue() {
   base::LockGuard<base::Mutex> guard(&lock_);
   DCHECK(terminated_);
-  DCHECK(task_queue_.empty());
+  for (int lane = 0; lane < kNumberOfLanes; lane++) {
+    DCHECK(lanes_[lane].empty());
+  }
 }
 
 
-void TaskQueue::Append(Task* task) {
+void TaskQueue::Append(Task* task, Lane lane) {
+  DCHECK_LT(lane, kNumberOfLanes);
   base::LockGuard<base::Mutex> guard(&lock_);
   DCHECK(!terminated_);
-  task_queue_.push(task);
+  lanes_[lane].push({task, NowInMicroseconds()});
   process_queue_semaphore_.Signal();
 }
 
@@ -33,10 +52,17 @@ Task* TaskQueue::GetNext() {
   for (;;) {
     {
       base::LockGuard<base::Mutex> guard(&lock_);
-      if (!task_queue_.empty()) {
-        Task* result = task_queue_.front();
-        task_queue_.pop();
-        return result;
+      for (int lane = 0; lane < kNumberOfLanes; lane++) {
+        std::queue<Entry>& queue = lanes_[lane];
+        if (queue.empty()) continue;
+        Entry entry = queue.front();
+        queue.pop();
+        int64_t queue_time_us =
+            std::max<int64_t>(0, NowInMicroseconds() - entry.enqueue_time_us);
+        tasks_run_[lane]++;
+        total_queue_time_us_ += queue_time_us;
+        max_queue_time_us_ = std::max(max_queue_time_us_, queue_time_us);
+        return entry.task;
       }
       if (terminated_) {
         process_queue_semaphore_.Signal();
@@ -55,11 +81,30 @@ void TaskQueue::Terminate() {
   process_queue_semaphore_.Signal();
 }
 
+
+void TaskQueue::GetStatistics(BackgroundTaskQueueStatistics* statistics) {
+  base::LockGuard<base::Mutex> guard(&lock_);
+  *statistics = BackgroundTaskQueueStatistics();
+  statistics->short_running_tasks_run = tasks_run_[kShortRunningLane];
+  statistics->long_running_tasks_run = tasks_run_[kLongRunningLane];
+  statistics->total_queue_time_in_seconds =
+      static_cast<double>(total_queue_time_us_) /
+      base::Time::kMicrosecondsPerSecond;
+  statistics->max_queue_time_in_seconds =
+      static_cast<double>(max_queue_time_us_) /
+      base::Time::kMicrosecondsPerSecond;
+}
+
+
 void TaskQueue::BlockUntilQueueEmptyForTesting() {
   for (;;) {
     {
       base::LockGuard<base::Mutex> guard(&lock_);
-      if (task_queue_.empty()) return;
+      bool empty = true;
+      for (int lane = 0; lane < kNumberOfLanes; lane++) {
+        if (!lanes_[lane].empty()) empty = false;
+      }
+      if (empty) return;
     }
     base::OS::Sleep(base::TimeDelta::FromMilliseconds(5));
   }
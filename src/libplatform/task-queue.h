@@ -8,6 +8,7 @@
 #include <queue>
 
 #include "include/libplatform/libplatform-export.h"
+#include "include/libplatform/libplatform.h"
 #include "src/base/macros.h"
 #include "src/base/platform/mutex.h"
 #include "src/base/platform/semaphore.h"
@@ -19,13 +20,20 @@ class Task;
 
 namespace platform {
 
+// A task queue for a pool of worker threads.
+//
+// Tasks are queued in one of two lanes. Short running tasks (e.g. GC jobs)
+// are taken before long running tasks (e.g. compile jobs), so they never
+// queue behind them. Within a lane, tasks are taken in FIFO order.
 class V8_PLATFORM_EXPORT TaskQueue {
  public:
+  enum Lane { kShortRunningLane, kLongRunningLane, kNumberOfLanes };
+
   TaskQueue();
   ~TaskQueue();
 
   // Appends a task to the queue. The queue takes ownership of |task|.
-  void Append(Task* task);
+  void Append(Task* task, Lane lane = kLongRunningLane);
 
   // Returns the next task to process. Blocks if no task is available. Returns
   // NULL if the queue is terminated.
@@ -34,15 +42,26 @@ class V8_PLATFORM_EXPORT TaskQueue {
   // Terminate the queue.
   void Terminate();
 
+  void GetStatistics(BackgroundTaskQueueStatistics* statistics);
+
  private:
   FRIEND_TEST(WorkerThreadTest, PostSingleTask);
 
+  struct Entry {
+    Task* task;
+    int64_t enqueue_time_us;
+  };
+
   void BlockUntilQueueEmptyForTesting();
 
   base::Semaphore process_queue_semaphore_;
   base::Mutex lock_;
-  std::queue<Task*> task_queue_;
+  std::queue<Entry> lanes_[kNumberOfLanes];
   bool terminated_;
+  // Statistics of the tasks taken from the queue.
+  size_t tasks_run_[kNumberOfLanes];
+  int64_t total_queue_time_us_;
+  int64_t max_queue_time_us_;
 
   DISALLOW_COPY_AND_ASSIGN(TaskQueue);
 };
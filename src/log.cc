@@ -9,6 +9,7 @@
 #include <sstream>
 
 #include "src/bailout-reason.h"
+#include "src/base/format-macros.h"
 #include "src/base/platform/platform.h"
 #include "src/bootstrapper.h"
 #include "src/code-stubs.h"
@@ -1420,6 +1421,15 @@ void Logger::PatchIC(const Address pc, const Address test, int delta) {
   msg.WriteToLogFile();
 }
 
+void Logger::StubCacheEvent(const char* ic_kind, int old_size, int new_size,
+                            size_t updates) {
+  if (!log_->IsEnabled() || !FLAG_trace_ic) return;
+  Log::MessageBuilder msg(log_);
+  msg.Append("StubCache,%s,%d,%d,%" PRIuS, ic_kind, old_size, new_size,
+             updates);
+  msg.WriteToLogFile();
+}
+
 void Logger::StopProfiler() {
   if (!log_->IsEnabled()) return;
   if (profiler_ != NULL) {
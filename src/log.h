@@ -202,6 +202,10 @@ class Logger : public CodeEventListener {
   void ToBooleanIC(const Address pc, int line, int column, Code* stub,
                    const char* old_state, const char* new_state);
   void PatchIC(const Address pc, const Address test, int delta);
+  // Logged when a megamorphic stub cache is cleared; |updates| is the number
+  // of misses that updated it since it was last cleared.
+  void StubCacheEvent(const char* ic_kind, int old_size, int new_size,
+                      size_t updates);
 
   // ==== Events logged by --log-gc. ====
   // Heap sampling events: start, end, and individual types.
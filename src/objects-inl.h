@@ -1525,6 +1525,16 @@ void HeapObject::synchronized_set_map_word(MapWord map_word) {
 }
 
 
+bool HeapObject::release_compare_and_swap_map_word(MapWord old_map_word,
+                                                   MapWord new_map_word) {
+  base::AtomicWord result = base::Release_CompareAndSwap(
+      reinterpret_cast<base::AtomicWord*>(FIELD_ADDR(this, kMapOffset)),
+      static_cast<base::AtomicWord>(old_map_word.value_),
+      static_cast<base::AtomicWord>(new_map_word.value_));
+  return result == static_cast<base::AtomicWord>(old_map_word.value_);
+}
+
+
 int HeapObject::Size() {
   return SizeFromMap(map());
 }
@@ -5733,8 +5743,7 @@ ACCESSORS(Script, source_url, Object, kSourceUrlOffset)
 ACCESSORS(Script, source_mapping_url, Object, kSourceMappingUrlOffset)
 ACCESSORS_CHECKED(Script, wasm_compiled_module, Object, kEvalFromSharedOffset,
                   this->type() == TYPE_WASM)
-ACCESSORS(Script, preparsed_scope_data, FixedTypedArrayBase,
-          kPreParsedScopeDataOffset)
+ACCESSORS(Script, preparsed_scope_data, ByteArray, kPreParsedScopeDataOffset)
 
 Script::CompilationType Script::compilation_type() {
   return BooleanBit::get(flags(), kCompilationTypeBit) ?
@@ -5945,6 +5954,8 @@ BOOL_ACCESSORS(SharedFunctionInfo, compiler_hints, force_inline, kForceInline)
 BOOL_ACCESSORS(SharedFunctionInfo, compiler_hints, must_use_ignition_turbo,
                kMustUseIgnitionTurbo)
 BOOL_ACCESSORS(SharedFunctionInfo, compiler_hints, dont_flush, kDontFlush)
+BOOL_ACCESSORS(SharedFunctionInfo, compiler_hints, bytecode_flushed,
+               kBytecodeFlushed)
 BOOL_ACCESSORS(SharedFunctionInfo, compiler_hints, is_asm_wasm_broken,
                kIsAsmWasmBroken)
 
@@ -2513,6 +2513,11 @@ bool String::MakeExternal(v8::String::ExternalStringResource* resource) {
 
   // Byte size of the external String object.
   int new_size = this->SizeFromMap(new_map);
+  if (has_pointers) {
+    // Tagged fields of the indirect string are overwritten below.
+    DisallowHeapAllocation no_allocation;
+    heap->NotifyObjectLayoutChange(this, no_allocation);
+  }
   heap->CreateFillerObjectAt(this->address() + new_size, size - new_size,
                              ClearRecordedSlots::kNo);
   if (has_pointers) {
@@ -2579,6 +2584,11 @@ bool String::MakeExternal(v8::String::ExternalOneByteStringResource* resource) {
 
   // Byte size of the external String object.
   int new_size = this->SizeFromMap(new_map);
+  if (has_pointers) {
+    // Tagged fields of the indirect string are overwritten below.
+    DisallowHeapAllocation no_allocation;
+    heap->NotifyObjectLayoutChange(this, no_allocation);
+  }
   heap->CreateFillerObjectAt(this->address() + new_size, size - new_size,
                              ClearRecordedSlots::kNo);
   if (has_pointers) {
@@ -13352,9 +13362,8 @@ bool Script::HasPreparsedScopeData() const {
   return preparsed_scope_data()->length() > 0;
 }
 
-Handle<FixedUint32Array> Script::GetPreparsedScopeData() const {
-  return Handle<FixedUint32Array>::cast(
-      Handle<FixedTypedArrayBase>(preparsed_scope_data()));
+Handle<ByteArray> Script::GetPreparsedScopeData() const {
+  return handle(preparsed_scope_data());
 }
 
 SharedFunctionInfo::ScriptIterator::ScriptIterator(Handle<Script> script)
@@ -17484,6 +17493,7 @@ Handle<String> StringTable::LookupString(Isolate* isolate,
                             : isolate->factory()->thin_string_map();
       int old_size = string->Size();
       DCHECK(old_size >= ThinString::kSize);
+      isolate->heap()->NotifyObjectLayoutChange(*string, no_gc);
       string->synchronized_set_map(*map);
       Handle<ThinString> thin = Handle<ThinString>::cast(string);
       thin->set_actual(*result);
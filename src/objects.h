@@ -1664,6 +1664,11 @@ class HeapObject: public Object {
   inline void synchronized_set_map_no_write_barrier(Map* value);
   inline void synchronized_set_map_word(MapWord map_word);
 
+  // Compare-and-swaps the map word using release semantics. Returns true if
+  // the map word was equal to |old_map_word| and has been replaced.
+  inline bool release_compare_and_swap_map_word(MapWord old_map_word,
+                                                MapWord new_map_word);
+
   // During garbage collection, the map word of a heap object does not
   // necessarily contain a map pointer.
   inline MapWord map_word() const;
@@ -6403,7 +6408,7 @@ class Script: public Struct {
   // This must only be called if the type of this script is TYPE_WASM.
   DECL_ACCESSORS(wasm_compiled_module, Object)
 
-  DECL_ACCESSORS(preparsed_scope_data, FixedTypedArrayBase)
+  DECL_ACCESSORS(preparsed_scope_data, ByteArray)
 
   // [compilation_type]: how the the script was compiled. Encoded in the
   // 'flags' field.
@@ -6492,7 +6497,7 @@ class Script: public Struct {
   };
 
   bool HasPreparsedScopeData() const;
-  Handle<FixedUint32Array> GetPreparsedScopeData() const;
+  Handle<ByteArray> GetPreparsedScopeData() const;
 
   // Dispatched behavior.
   DECLARE_PRINTER(Script)
@@ -7031,6 +7036,10 @@ class SharedFunctionInfo: public HeapObject {
   // Indicates that code for this function cannot be flushed.
   DECL_BOOLEAN_ACCESSORS(dont_flush)
 
+  // Indicates that the bytecode of this function was flushed, i.e. that the
+  // next compilation of the function is a recompilation.
+  DECL_BOOLEAN_ACCESSORS(bytecode_flushed)
+
   // Indicates that this function is an asm function.
   DECL_BOOLEAN_ACCESSORS(asm_function)
 
@@ -7326,8 +7335,7 @@ class SharedFunctionInfo: public HeapObject {
     kIsDeclaration,
     kIsAsmWasmBroken,
     kHasConcurrentOptimizationJob,
-
-    kUnused1,  // Unused fields.
+    kBytecodeFlushed,
 
     // byte 2
     kFunctionKind,
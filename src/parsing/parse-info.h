@@ -6,6 +6,7 @@
 #define V8_PARSING_PARSE_INFO_H_
 
 #include <memory>
+#include <vector>
 
 #include "include/v8.h"
 #include "src/globals.h"
@@ -120,6 +121,16 @@ class V8_EXPORT_PRIVATE ParseInfo {
 
   PreParsedScopeData* preparsed_scope_data() { return &preparsed_scope_data_; }
 
+  // Top-level functions that are likely called immediately, but were only
+  // preparsed so that they can be parsed and compiled on the compiler
+  // dispatcher in parallel, see --compiler-dispatcher-toplevel-functions.
+  const std::vector<FunctionLiteral*>& dispatched_literals() const {
+    return dispatched_literals_;
+  }
+  void set_dispatched_literals(std::vector<FunctionLiteral*>* literals) {
+    dispatched_literals_.swap(*literals);
+  }
+
   ScriptCompiler::CompileOptions compile_options() const {
     return compile_options_;
   }
@@ -305,6 +316,7 @@ class V8_EXPORT_PRIVATE ParseInfo {
 
   //----------- Output of parsing and scope analysis ------------------------
   FunctionLiteral* literal_;
+  std::vector<FunctionLiteral*> dispatched_literals_;
   std::shared_ptr<DeferredHandles> deferred_handles_;
 
   void SetFlag(Flag f) { flags_ |= f; }
@@ -513,6 +513,7 @@ Parser::Parser(ParseInfo* info)
       total_preparse_skipped_(0),
       temp_zoned_(false),
       log_(nullptr),
+      dispatch_toplevel_functions_(false),
       preparsed_scope_data_(info->preparsed_scope_data()),
       parameters_end_pos_(info->parameters_end_pos()) {
   // Even though we were passed ParseInfo, we should not store it in
@@ -539,6 +540,16 @@ Parser::Parser(ParseInfo* info)
                                      : FunctionLiteral::kShouldEagerCompile);
   allow_lazy_ = FLAG_lazy && info->allow_lazy_parsing() && !info->is_native() &&
                 info->extension() == nullptr && can_compile_lazily;
+  // Functions compiled on the compiler dispatcher are not part of the code
+  // cache, and the debugger needs them to be compiled eagerly. Streamed
+  // scripts are already parsed in the background while they load, so their
+  // eager functions are compiled from the full AST instead.
+  dispatch_toplevel_functions_ =
+      FLAG_compiler_dispatcher_toplevel_functions && allow_lazy_ &&
+      info->is_toplevel() && !info->is_eval() && !info->is_module() &&
+      !info->will_serialize() &&
+      !(FLAG_compiler_dispatcher_streaming &&
+        info->source_stream() != nullptr);
   set_allow_natives(FLAG_allow_natives_syntax || info->is_native());
   set_allow_tailcalls(FLAG_harmony_tailcalls && !info->is_native() &&
                       info->is_tail_call_elimination_enabled());
@@ -769,6 +780,7 @@ FunctionLiteral* Parser::DoParseProgram(ParseInfo* info) {
   }
 
   info->set_max_function_literal_id(GetLastFunctionLiteralId());
+  info->set_dispatched_literals(&dispatched_literals_);
 
   // Make sure the target stack is empty.
   DCHECK(target_stack_ == NULL);
@@ -2603,6 +2615,18 @@ FunctionLiteral* Parser::ParseFunctionLiteral(
   DCHECK_IMPLIES(parse_lazily(), allow_lazy_);
   DCHECK_IMPLIES(parse_lazily(), extension_ == nullptr);
 
+  // Top-level functions that are likely called immediately are eagerly
+  // compiled. If they can be parsed and compiled on the compiler dispatcher,
+  // only preparse them here to find their end, and let the dispatcher do the
+  // full parse in parallel with the rest of the script.
+  bool dispatch_to_compiler =
+      dispatch_toplevel_functions_ && parse_lazily() &&
+      function_state_->next_function_is_likely_called() &&
+      impl()->AllowsLazyParsingWithoutUnresolvedVariables();
+  if (dispatch_to_compiler) {
+    eager_compile_hint = FunctionLiteral::kShouldLazyCompile;
+  }
+
   bool can_preparse = parse_lazily() &&
                       eager_compile_hint == FunctionLiteral::kShouldLazyCompile;
 
@@ -2709,6 +2733,7 @@ FunctionLiteral* Parser::ParseFunctionLiteral(
         // used once.
         eager_compile_hint = FunctionLiteral::kShouldEagerCompile;
         should_be_used_once_hint = true;
+        dispatch_to_compiler = false;
         scope->ResetAfterPreparsing(ast_value_factory(), true);
         zone_scope.Reset();
         use_temp_zone = false;
@@ -2781,6 +2806,7 @@ FunctionLiteral* Parser::ParseFunctionLiteral(
   function_literal->set_function_token_position(function_token_pos);
   if (should_be_used_once_hint)
     function_literal->set_should_be_used_once_hint();
+  if (dispatch_to_compiler) dispatched_literals_.push_back(function_literal);
 
   if (should_infer_name) {
     DCHECK_NOT_NULL(fni_);
@@ -1182,6 +1182,11 @@ class V8_EXPORT_PRIVATE Parser : public NON_EXPORTED_BASE(ParserBase<Parser>) {
   bool temp_zoned_;
   ParserLogger* log_;
 
+  // Whether top-level functions that are likely called immediately are
+  // preparsed and left to the compiler dispatcher, and those functions.
+  bool dispatch_toplevel_functions_;
+  std::vector<FunctionLiteral*> dispatched_literals_;
+
   PreParsedScopeData* preparsed_scope_data_;
 
   // If not kNoSourcePosition, indicates that the first function literal
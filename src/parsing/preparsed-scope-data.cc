@@ -4,6 +4,8 @@
 
 #include "src/parsing/preparsed-scope-data.h"
 
+#include <algorithm>
+
 #include "src/ast/scopes.h"
 #include "src/ast/variables.h"
 #include "src/handles.h"
@@ -20,7 +22,15 @@ class VariableMaybeAssignedField
 class VariableContextAllocatedField
     : public BitField16<bool, VariableMaybeAssignedField::kNext, 1> {};
 
+// Serialized format, see PreParsedScopeData::Serialize.
+const int kFunctionCountOffset = 0;
+const int kFunctionIndexOffset = kFunctionCountOffset + kInt32Size;
 const int kFunctionDataSize = 3;
+const int kFunctionEntrySize = kFunctionDataSize * kInt32Size;
+
+int BackingStoreOffset(int function_count) {
+  return kFunctionIndexOffset + function_count * kFunctionEntrySize;
+}
 
 }  // namespace
 
@@ -31,7 +41,7 @@ const int kFunctionDataSize = 3;
   ------------------------------------
   | scope type << only in debug      |
   | inner_scope_calls_eval_          |
-  | data end index                   |
+  | data end index (4 bytes)         |
   | ----------------------           |
   | | data for variables |           |
   | | ...                |           |
@@ -69,7 +79,7 @@ void PreParsedScopeData::SaveData(Scope* scope) {
   // index is needed for skipping over data for a function scope when we skip
   // parsing of the corresponding function.
   size_t data_end_index = backing_store_.size();
-  backing_store_.push_back(-1);
+  PushUint32(0);
 
   if (!scope->is_hidden()) {
     for (Variable* var : *scope->locals()) {
@@ -81,7 +91,7 @@ void PreParsedScopeData::SaveData(Scope* scope) {
 
   SaveDataForInnerScopes(scope);
 
-  backing_store_[data_end_index] = backing_store_.size();
+  SetUint32(data_end_index, static_cast<uint32_t>(backing_store_.size()));
 }
 
 void PreParsedScopeData::RestoreData(DeclarationScope* scope) const {
@@ -122,16 +132,20 @@ void PreParsedScopeData::RestoreData(Scope* scope, int* index_ptr) const {
     // This scope is a function scope representing a function we want to
     // skip. So just skip over its data.
     DCHECK(!scope->must_use_preparsed_scope_data());
-    index = backing_store_[index + 2];
+#ifdef DEBUG
+    index++;  // Skip the scope type.
+#endif
+    index = Uint32At(index + 1);
     return;
   }
 
-  DCHECK_EQ(backing_store_[index++], scope->scope_type());
+  DCHECK_EQ(ByteAt(index++), scope->scope_type());
 
-  if (backing_store_[index++]) {
+  if (ByteAt(index++)) {
     scope->RecordEvalCall();
   }
-  int data_end_index = backing_store_[index++];
+  int data_end_index = Uint32At(index);
+  index += kInt32Size;
   USE(data_end_index);
 
   if (!scope->is_hidden()) {
@@ -147,53 +161,71 @@ void PreParsedScopeData::RestoreData(Scope* scope, int* index_ptr) const {
   DCHECK_EQ(data_end_index, index);
 }
 
-FixedUint32Array* PreParsedScopeData::Serialize(Isolate* isolate) const {
-  // FIXME(marja): save space by using a byte array and converting
-  // function_index_ to bytes.
-  Handle<JSTypedArray> js_array = isolate->factory()->NewJSTypedArray(
-      UINT32_ELEMENTS,
-      function_index_.size() * kFunctionDataSize + backing_store_.size() + 1);
-  FixedUint32Array* array = FixedUint32Array::cast(js_array->elements());
-
-  array->set(0, static_cast<uint32_t>(function_index_.size()));
-  int i = 1;
-  for (const auto& item : function_index_) {
-    array->set(i++, item.first);
-    array->set(i++, item.second.first);
-    array->set(i++, item.second.second);
-  }
+/*
+
+  Serialized format:
+
+  ------------------------------------
+  | function count                   |
+  ------------------------------------
+  | start position                   |
+  | end position                     |
+  | data index                       |
+  ------------------------------------
+  ... one entry per function, sorted by start position
+  ------------------------------------
+  | backing store (see above)        |
+  ------------------------------------
 
-  for (size_t j = 0; j < backing_store_.size(); ++j) {
-    array->set(i++, static_cast<uint32_t>(backing_store_[j]));
+  The consumer reads the data in place: functions are found by a binary search
+  over the entries, and nothing is copied out of the ByteArray. This keeps the
+  cost of lazily compiling a function independent of the size of the script.
+ */
+
+ByteArray* PreParsedScopeData::Serialize(Isolate* isolate) const {
+  DCHECK(!has_data_);
+  std::vector<std::pair<uint32_t, std::pair<uint32_t, uint32_t>>> functions(
+      function_index_.begin(), function_index_.end());
+  std::sort(functions.begin(), functions.end());
+
+  int function_count = static_cast<int>(functions.size());
+  int backing_store_offset = BackingStoreOffset(function_count);
+  Handle<ByteArray> array = isolate->factory()->NewByteArray(
+      backing_store_offset + static_cast<int>(backing_store_.size()), TENURED);
+
+  array->set_int(kFunctionCountOffset / kInt32Size, function_count);
+  int i = kFunctionIndexOffset / kInt32Size;
+  for (const auto& item : functions) {
+    array->set_int(i++, item.first);
+    array->set_int(i++, item.second.first);
+    array->set_int(i++, item.second.second);
   }
-  return array;
+  if (!backing_store_.empty()) {
+    array->copy_in(backing_store_offset, backing_store_.data(),
+                   static_cast<int>(backing_store_.size()));
+  }
+  return *array;
 }
 
-void PreParsedScopeData::Deserialize(Handle<FixedUint32Array> array) {
-  has_data_ = true;
+void PreParsedScopeData::Deserialize(Handle<ByteArray> array) {
   DCHECK(!array.is_null());
+  has_data_ = true;
   if (array->length() == 0) {
+    function_count_ = 0;
     return;
   }
-  int function_count = array->get_scalar(0);
-  CHECK(array->length() > function_count * kFunctionDataSize);
-  if (function_count == 0) {
-    return;
-  }
-  int i = 1;
-  for (; i < function_count * kFunctionDataSize + 1; i += kFunctionDataSize) {
-    function_index_[array->get_scalar(i)] =
-        std::make_pair(array->get_scalar(i + 1), array->get_scalar(i + 2));
-  }
-  CHECK_EQ(function_index_.size(), function_count);
-
-  backing_store_.reserve(array->length() - i);
-  for (; i < array->length(); ++i) {
-    backing_store_.push_back(array->get_scalar(i));
-  }
+  data_ = array;
+  function_count_ = array->get_int(kFunctionCountOffset / kInt32Size);
+  CHECK_LE(BackingStoreOffset(function_count_), array->length());
 }
 
 bool PreParsedScopeData::FindFunctionEnd(int start_pos, int* end_pos) const {
+  if (has_data_) {
+    int entry = FindEntry(start_pos);
+    if (entry < 0) return false;
+    *end_pos = data_->get_int(entry + 1);
+    return true;
+  }
   auto it = function_index_.find(start_pos);
   if (it == function_index_.end()) {
     return false;
@@ -207,7 +239,7 @@ void PreParsedScopeData::SaveDataForVariable(Variable* var) {
   // Store the variable name in debug mode; this way we can check that we
   // restore data to the correct variable.
   const AstRawString* name = var->raw_name();
-  backing_store_.push_back(name->length());
+  PushUint32(name->length());
   for (int i = 0; i < name->length(); ++i) {
     backing_store_.push_back(name->raw_data()[i]);
   }
@@ -227,12 +259,13 @@ void PreParsedScopeData::RestoreDataForVariable(Variable* var,
   int& index = *index_ptr;
 #ifdef DEBUG
   const AstRawString* name = var->raw_name();
-  DCHECK_EQ(backing_store_[index++], name->length());
+  DCHECK_EQ(Uint32At(index), static_cast<uint32_t>(name->length()));
+  index += kInt32Size;
   for (int i = 0; i < name->length(); ++i) {
-    DCHECK_EQ(backing_store_[index++], name->raw_data()[i]);
+    DCHECK_EQ(ByteAt(index++), name->raw_data()[i]);
   }
 #endif
-  byte variable_data = backing_store_[index++];
+  byte variable_data = ByteAt(index++);
   if (VariableIsUsedField::decode(variable_data)) {
     var->set_is_used();
   }
@@ -271,6 +304,12 @@ void PreParsedScopeData::RestoreDataForInnerScopes(Scope* scope,
 }
 
 bool PreParsedScopeData::FindFunctionData(int start_pos, int* index) const {
+  if (has_data_) {
+    int entry = FindEntry(start_pos);
+    if (entry < 0) return false;
+    *index = data_->get_int(entry + 2);
+    return true;
+  }
   auto it = function_index_.find(start_pos);
   if (it == function_index_.end()) {
     return false;
@@ -279,6 +318,49 @@ bool PreParsedScopeData::FindFunctionData(int start_pos, int* index) const {
   return true;
 }
 
+int PreParsedScopeData::FindEntry(int start_pos) const {
+  DCHECK(has_data_);
+  int low = 0;
+  int high = function_count_;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    int entry = kFunctionIndexOffset / kInt32Size + mid * kFunctionDataSize;
+    int pos = data_->get_int(entry);
+    if (pos == start_pos) return entry;
+    if (pos < start_pos) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return -1;
+}
+
+byte PreParsedScopeData::ByteAt(int index) const {
+  if (!has_data_) return backing_store_[index];
+  return data_->get(BackingStoreOffset(function_count_) + index);
+}
+
+uint32_t PreParsedScopeData::Uint32At(int index) const {
+  uint32_t value = 0;
+  for (int i = 0; i < kInt32Size; ++i) {
+    value |= static_cast<uint32_t>(ByteAt(index + i)) << (i * kBitsPerByte);
+  }
+  return value;
+}
+
+void PreParsedScopeData::PushUint32(uint32_t value) {
+  for (int i = 0; i < kInt32Size; ++i) {
+    backing_store_.push_back(static_cast<byte>(value >> (i * kBitsPerByte)));
+  }
+}
+
+void PreParsedScopeData::SetUint32(size_t index, uint32_t value) {
+  for (int i = 0; i < kInt32Size; ++i) {
+    backing_store_[index + i] = static_cast<byte>(value >> (i * kBitsPerByte));
+  }
+}
+
 bool PreParsedScopeData::ScopeNeedsData(Scope* scope) {
   if (scope->scope_type() == ScopeType::FUNCTION_SCOPE) {
     return true;
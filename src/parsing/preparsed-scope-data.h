@@ -9,14 +9,12 @@
 #include <vector>
 
 #include "src/globals.h"
+#include "src/handles.h"
 #include "src/objects.h"
 
 namespace v8 {
 namespace internal {
 
-template <typename T>
-class Handle;
-
 /*
 
   Skipping inner functions.
@@ -53,6 +51,10 @@ class Handle;
 
   PreParsedScopeData implements storing and restoring the above mentioned data.
 
+  The data of a script is kept on the Script as a compact ByteArray, so it is
+  persisted together with the code cache. When consuming, the ByteArray is
+  read in place.
+
  */
 
 class PreParsedScopeData {
@@ -69,8 +71,8 @@ class PreParsedScopeData {
   void RestoreData(Scope* scope, int* index_ptr) const;
   void RestoreData(DeclarationScope* scope) const;
 
-  FixedUint32Array* Serialize(Isolate* isolate) const;
-  void Deserialize(Handle<FixedUint32Array> array);
+  ByteArray* Serialize(Isolate* isolate) const;
+  void Deserialize(Handle<ByteArray> array);
 
   bool Consuming() const { return has_data_; }
 
@@ -86,16 +88,27 @@ class PreParsedScopeData {
   void SaveDataForInnerScopes(Scope* scope);
   void RestoreDataForInnerScopes(Scope* scope, int* index_ptr) const;
   bool FindFunctionData(int start_pos, int* index) const;
+  // Returns the index of the entry for the function starting at |start_pos|
+  // in the serialized data, or -1.
+  int FindEntry(int start_pos) const;
+
+  byte ByteAt(int index) const;
+  uint32_t Uint32At(int index) const;
+  void PushUint32(uint32_t value);
+  void SetUint32(size_t index, uint32_t value);
 
   static bool ScopeNeedsData(Scope* scope);
   static bool IsSkippedFunctionScope(Scope* scope);
 
-  // TODO(marja): Make the backing store more efficient once we know exactly
-  // what data is needed.
+  // Used when producing.
   std::vector<byte> backing_store_;
   // Start pos -> (end pos, index in data)
   std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> function_index_;
 
+  // Used when consuming.
+  Handle<ByteArray> data_;
+  int function_count_ = 0;
+
   bool has_data_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(PreParsedScopeData);
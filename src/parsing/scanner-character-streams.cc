@@ -4,6 +4,8 @@
 
 #include "src/parsing/scanner-character-streams.h"
 
+#include <algorithm>
+
 #include "include/v8.h"
 #include "src/counters.h"
 #include "src/globals.h"
@@ -17,6 +19,10 @@ namespace internal {
 
 namespace {
 const unibrow::uchar kUtf8Bom = 0xfeff;
+
+inline bool IsAscii(uint8_t byte) {
+  return byte <= unibrow::Utf8::kMaxOneByteChar;
+}
 }  // namespace
 
 // ----------------------------------------------------------------------------
@@ -265,6 +271,14 @@ bool Utf8ExternalStreamingStream::SkipToPosition(size_t position) {
   size_t it = current_.pos.bytes - chunk.start.bytes;
   size_t chars = chunk.start.chars;
   while (it < chunk.length && chars < position) {
+    if (incomplete_char == 0 && IsAscii(chunk.data[it])) {
+      // Skip a run of ASCII characters without decoding them.
+      size_t run_end = std::min(chunk.length, it + (position - chars));
+      size_t run_start = it;
+      while (it < run_end && IsAscii(chunk.data[it])) it++;
+      chars += it - run_start;
+      continue;
+    }
     unibrow::uchar t =
         unibrow::Utf8::ValueOfIncremental(chunk.data[it], &incomplete_char);
     if (t == kUtf8Bom && current_.pos.chars == 0) {
@@ -312,15 +326,26 @@ void Utf8ExternalStreamingStream::FillBufferFromCurrentChunk() {
 
   unibrow::Utf8::Utf8IncrementalBuffer incomplete_char =
       current_.pos.incomplete_char;
-  size_t it;
-  for (it = current_.pos.bytes - chunk.start.bytes;
-       it < chunk.length && cursor + 1 < buffer_start_ + kBufferSize; it++) {
+  // Leave room for a surrogate pair at the end of the buffer.
+  const uint16_t* buffer_limit = buffer_start_ + kBufferSize - 1;
+  size_t it = current_.pos.bytes - chunk.start.bytes;
+  while (it < chunk.length && cursor < buffer_limit) {
+    if (incomplete_char == 0 && IsAscii(chunk.data[it])) {
+      // Copy a run of ASCII characters, which is by far the most frequent
+      // case, without going through the UTF-8 decoder.
+      size_t room = static_cast<size_t>(buffer_limit - cursor);
+      size_t run_end = std::min(chunk.length, it + room);
+      while (it < run_end && IsAscii(chunk.data[it])) {
+        *(cursor++) = static_cast<uc16>(chunk.data[it++]);
+      }
+      continue;
+    }
     unibrow::uchar t =
-        unibrow::Utf8::ValueOfIncremental(chunk.data[it], &incomplete_char);
+        unibrow::Utf8::ValueOfIncremental(chunk.data[it++], &incomplete_char);
     if (t == unibrow::Utf8::kIncomplete) continue;
     if (V8_LIKELY(t < kUtf8Bom)) {
-      *(cursor++) = static_cast<uc16>(t);  // The by most frequent case.
-    } else if (t == kUtf8Bom && current_.pos.bytes + it == 2) {
+      *(cursor++) = static_cast<uc16>(t);
+    } else if (t == kUtf8Bom && current_.pos.bytes + it == 3) {
       // BOM detected at beginning of the stream. Don't copy it.
     } else if (t <= unibrow::Utf16::kMaxNonSurrogateCharCode) {
       *(cursor++) = static_cast<uc16>(t);
@@ -496,9 +496,7 @@ Token::Value Scanner::SkipSingleLineComment() {
   // separately by the lexical grammar and becomes part of the
   // stream of input elements for the syntactic grammar (see
   // ECMA-262, section 7.4).
-  while (c0_ != kEndOfInput && !unicode_cache_->IsLineTerminator(c0_)) {
-    Advance();
-  }
+  AdvanceUntil([this](uc32 c) { return unicode_cache_->IsLineTerminator(c); });
 
   return Token::WHITESPACE;
 }
@@ -506,9 +504,7 @@ Token::Value Scanner::SkipSingleLineComment() {
 
 Token::Value Scanner::SkipSourceURLComment() {
   TryToParseSourceURLComment();
-  while (c0_ != kEndOfInput && !unicode_cache_->IsLineTerminator(c0_)) {
-    Advance();
-  }
+  AdvanceUntil([this](uc32 c) { return unicode_cache_->IsLineTerminator(c); });
 
   return Token::WHITESPACE;
 }
@@ -1517,23 +1513,21 @@ Token::Value Scanner::ScanIdentifierOrKeyword() {
   DCHECK(unicode_cache_->IsIdentifierStart(c0_));
   LiteralScope literal(this);
   if (IsInRange(c0_, 'a', 'z') || c0_ == '_') {
-    do {
-      char first_char = static_cast<char>(c0_);
-      Advance<false, false>();
-      AddLiteralChar(first_char);
-    } while (IsInRange(c0_, 'a', 'z') || c0_ == '_');
+    // Collect the ASCII characters directly from the source buffer.
+    AdvanceUntil([this](uc32 c) {
+      if (!IsInRange(c, 'a', 'z') && c != '_') return true;
+      AddLiteralChar(static_cast<char>(c));
+      return false;
+    });
 
     if (IsDecimalDigit(c0_) || IsInRange(c0_, 'A', 'Z') || c0_ == '_' ||
         c0_ == '$') {
       // Identifier starting with lowercase.
-      char first_char = static_cast<char>(c0_);
-      Advance<false, false>();
-      AddLiteralChar(first_char);
-      while (IsAsciiIdentifier(c0_)) {
-        char first_char = static_cast<char>(c0_);
-        Advance<false, false>();
-        AddLiteralChar(first_char);
-      }
+      AdvanceUntil([this](uc32 c) {
+        if (!IsAsciiIdentifier(c)) return true;
+        AddLiteralChar(static_cast<char>(c));
+        return false;
+      });
       if (c0_ <= kMaxAscii && c0_ != '\\') {
         literal.Complete();
         return Token::IDENTIFIER;
@@ -1552,11 +1546,11 @@ Token::Value Scanner::ScanIdentifierOrKeyword() {
 
     HandleLeadSurrogate();
   } else if (IsInRange(c0_, 'A', 'Z') || c0_ == '_' || c0_ == '$') {
-    do {
-      char first_char = static_cast<char>(c0_);
-      Advance<false, false>();
-      AddLiteralChar(first_char);
-    } while (IsAsciiIdentifier(c0_));
+    AdvanceUntil([this](uc32 c) {
+      if (!IsAsciiIdentifier(c)) return true;
+      AddLiteralChar(static_cast<char>(c));
+      return false;
+    });
 
     if (c0_ <= kMaxAscii && c0_ != '\\') {
       literal.Complete();
@@ -7,6 +7,8 @@
 #ifndef V8_PARSING_SCANNER_H_
 #define V8_PARSING_SCANNER_H_
 
+#include <algorithm>
+
 #include "src/allocation.h"
 #include "src/base/logging.h"
 #include "src/char-predicates.h"
@@ -55,6 +57,30 @@ class Utf16CharacterStream {
     }
   }
 
+  // Advances past all code units for which |check| returns false and returns
+  // the first code unit for which it returns true, or kEndOfInput. The
+  // buffer is scanned in a tight loop, and |check| is called exactly once
+  // for each code unit in order.
+  template <typename FunctionType>
+  inline uc32 AdvanceUntil(FunctionType check) {
+    while (true) {
+      const uint16_t* next =
+          std::find_if(buffer_cursor_, buffer_end_, [&check](uint16_t c) {
+            return check(static_cast<uc32>(c));
+          });
+      if (V8_LIKELY(next < buffer_end_)) {
+        buffer_cursor_ = next + 1;
+        return static_cast<uc32>(*next);
+      }
+      buffer_cursor_ = buffer_end_;
+      if (!ReadBlock()) {
+        // See Advance() for why the cursor is moved past the end.
+        buffer_cursor_++;
+        return kEndOfInput;
+      }
+    }
+  }
+
   // Go back one by one character in the input stream.
   // This undoes the most recent Advance().
   inline void Back() {
@@ -576,6 +602,16 @@ class Scanner {
     if (check_surrogate) HandleLeadSurrogate();
   }
 
+  // Advances to the first character for which |check| returns true, or to
+  // the end of the input. |check| is called once for each character,
+  // starting with c0_, but sees surrogate pairs as separate code units.
+  template <typename FunctionType>
+  void AdvanceUntil(FunctionType check) {
+    if (c0_ == kEndOfInput || check(c0_)) return;
+    c0_ = source_->AdvanceUntil(check);
+    HandleLeadSurrogate();
+  }
+
   void HandleLeadSurrogate() {
     if (unibrow::Utf16::IsLeadSurrogate(c0_)) {
       uc32 c1 = source_->Advance();
@@ -298,16 +298,20 @@ void CpuProfiler::CollectSample() {
   }
 }
 
-void CpuProfiler::StartProfiling(const char* title, bool record_samples) {
-  if (profiles_->StartProfiling(title, record_samples)) {
-    StartProcessorIfNotStarted();
-  }
+bool CpuProfiler::StartProfiling(const char* title, bool record_samples,
+                                 v8::OutputStream* stream) {
+  if (!profiles_->StartProfiling(title, record_samples, stream)) return false;
+  StartProcessorIfNotStarted();
+  return true;
 }
 
 
-void CpuProfiler::StartProfiling(String* title, bool record_samples) {
-  StartProfiling(profiles_->GetName(title), record_samples);
+bool CpuProfiler::StartProfiling(String* title, bool record_samples,
+                                 v8::OutputStream* stream) {
+  bool started =
+      StartProfiling(profiles_->GetName(title), record_samples, stream);
   isolate_->debug()->feature_tracker()->Track(DebugFeatureTracker::kProfiler);
+  return started;
 }
 
 
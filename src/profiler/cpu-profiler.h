@@ -197,8 +197,10 @@ class CpuProfiler : public CodeEventObserver {
 
   void set_sampling_interval(base::TimeDelta value);
   void CollectSample();
-  void StartProfiling(const char* title, bool record_samples = false);
-  void StartProfiling(String* title, bool record_samples);
+  bool StartProfiling(const char* title, bool record_samples = false,
+                      v8::OutputStream* stream = nullptr);
+  bool StartProfiling(String* title, bool record_samples,
+                      v8::OutputStream* stream = nullptr);
   CpuProfile* StopProfiling(const char* title);
   CpuProfile* StopProfiling(String* title);
   int GetProfilesCount();
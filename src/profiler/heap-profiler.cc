@@ -18,6 +18,7 @@ HeapProfiler::HeapProfiler(Heap* heap)
     : ids_(new HeapObjectsMap(heap)),
       names_(new StringsStorage(heap)),
       is_tracking_object_moves_(false),
+      parallel_snapshot_semaphore_(0),
       get_retainer_infos_callback_(nullptr) {}
 
 static void DeleteHeapSnapshot(HeapSnapshot** snapshot_ptr) {
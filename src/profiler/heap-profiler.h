@@ -78,6 +78,10 @@ class HeapProfiler {
 
   Isolate* isolate() const { return heap()->isolate(); }
 
+  base::Semaphore* parallel_snapshot_semaphore() {
+    return &parallel_snapshot_semaphore_;
+  }
+
  private:
   Heap* heap() const;
 
@@ -89,6 +93,9 @@ class HeapProfiler {
   std::unique_ptr<AllocationTracker> allocation_tracker_;
   bool is_tracking_object_moves_;
   base::Mutex profiler_mutex_;
+  // Used by the page parallel jobs of snapshot generation. It must live as
+  // long as the isolate, see PageParallelJob.
+  base::Semaphore parallel_snapshot_semaphore_;
   std::unique_ptr<SamplingHeapProfiler> sampling_heap_profiler_;
   v8::HeapProfiler::GetRetainerInfosCallback get_retainer_infos_callback_;
 
@@ -10,6 +10,7 @@
 #include "src/code-stubs.h"
 #include "src/conversions.h"
 #include "src/debug/debug.h"
+#include "src/heap/page-parallel-job.h"
 #include "src/layout-descriptor.h"
 #include "src/objects-body-descriptors.h"
 #include "src/objects-inl.h"
@@ -1790,39 +1791,198 @@ bool V8HeapExplorer::IterateAndExtractReferences(
 }
 
 
+namespace {
+
+// Records the fields of an object in the order in which they are visited.
+class FieldsRecorder : public ObjectVisitor {
+ public:
+  FieldsRecorder(HeapObject* parent_obj,
+                 std::vector<HeapSnapshotPage::Field>* fields)
+      : parent_start_(HeapObject::RawField(parent_obj, 0)),
+        parent_end_(HeapObject::RawField(parent_obj, parent_obj->Size())),
+        fields_(fields) {}
+  void VisitCodeEntry(Address entry_address) override {
+    HeapSnapshotPage::Field field = {
+        HeapSnapshotPage::kCodeEntryField,
+        Code::GetObjectFromEntryAddress(entry_address)};
+    fields_->push_back(field);
+  }
+  void VisitPointers(Object** start, Object** end) override {
+    for (Object** p = start; p < end; p++) {
+      HeapSnapshotPage::Field field = {
+          p >= parent_start_ && p < parent_end_
+              ? static_cast<int>(p - parent_start_)
+              : HeapSnapshotPage::kOutOfObjectField,
+          *p};
+      fields_->push_back(field);
+    }
+  }
+
+ private:
+  Object** parent_start_;
+  Object** parent_end_;
+  std::vector<HeapSnapshotPage::Field>* fields_;
+};
+
+// Fields are recorded for the objects that are visited on a pass (FixedArrays
+// are only visited on the second pass). Large objects are visited directly on
+// the main thread to bound the memory needed for the recorded fields.
+bool HasRecordedFields(HeapObject* obj, bool fixed_arrays) {
+  return obj->IsFixedArray() == fixed_arrays &&
+         obj->Size() <= kMaxRegularHeapObjectSize;
+}
+
+class RecordFieldsJobTraits {
+ public:
+  struct PerTaskData {
+    SnapshottingProgressReportingInterface* progress;
+    bool fixed_arrays;
+  };
+  typedef HeapSnapshotPage* PerPageData;
+
+  static bool ProcessPageInParallel(Heap* heap, PerTaskData task_data,
+                                    MemoryChunk* chunk, PerPageData page) {
+    page->fields_end.reserve(page->objects.size());
+    for (HeapObject* obj : page->objects) {
+      if (HasRecordedFields(obj, task_data.fixed_arrays)) {
+        FieldsRecorder recorder(obj, &page->fields);
+        obj->Iterate(&recorder);
+      }
+      page->fields_end.push_back(page->fields.size());
+      task_data.progress->ProgressStep();
+    }
+    return true;
+  }
+
+  static const bool NeedSequentialFinalization = false;
+  static void FinalizePageSequentially(Heap*, MemoryChunk*, bool,
+                                       PerPageData) {}
+};
+
+// Maximum number of heap pages whose fields are recorded at once.
+const size_t kPagesPerParallelBatch = 32;
+
+}  // namespace
+
 template<V8HeapExplorer::ExtractReferencesMethod extractor>
 bool V8HeapExplorer::IterateAndExtractSinglePass() {
+  // FixedArrays are processed on the second pass.
+  const bool fixed_arrays =
+      extractor == &V8HeapExplorer::ExtractReferencesPass2;
   // Now iterate the whole heap.
   bool interrupted = false;
+  std::vector<std::unique_ptr<HeapSnapshotPage>> pages;
   HeapIterator iterator(heap_, HeapIterator::kFilterUnreachable);
   // Heap iteration with filtering must be finished in any case.
-  for (HeapObject* obj = iterator.next();
-       obj != NULL;
-       obj = iterator.next(), progress_->ProgressStep()) {
+  for (HeapObject* obj = iterator.next(); obj != NULL; obj = iterator.next()) {
     if (interrupted) continue;
 
-    size_t max_pointer = obj->Size() / kPointerSize;
-    if (max_pointer > marks_.size()) {
-      // Clear the current bits.
-      std::vector<bool>().swap(marks_);
-      // Reallocate to right size.
-      marks_.resize(max_pointer, false);
+    if (!FLAG_parallel_heap_snapshot) {
+      ExtractObjectReferences<extractor>(obj, nullptr, nullptr);
+      progress_->ProgressStep();
+      if (!progress_->ProgressReport(false)) interrupted = true;
+      continue;
+    }
+
+    // Group the objects by page and process the pages in batches.
+    MemoryChunk* chunk = MemoryChunk::FromAddress(obj->address());
+    if (pages.empty() || pages.back()->chunk != chunk) {
+      if (pages.size() == kPagesPerParallelBatch) {
+        interrupted = ExtractPagesInParallel<extractor>(&pages, fixed_arrays);
+        pages.clear();
+        if (interrupted) continue;
+      }
+      pages.emplace_back(new HeapSnapshotPage(chunk));
+    }
+    pages.back()->objects.push_back(obj);
+  }
+  if (!interrupted && !pages.empty()) {
+    interrupted = ExtractPagesInParallel<extractor>(&pages, fixed_arrays);
+  }
+  return interrupted;
+}
+
+
+template <V8HeapExplorer::ExtractReferencesMethod extractor>
+bool V8HeapExplorer::ExtractPagesInParallel(
+    std::vector<std::unique_ptr<HeapSnapshotPage>>* pages, bool fixed_arrays) {
+  PageParallelJob<RecordFieldsJobTraits> job(
+      heap_, heap_->isolate()->cancelable_task_manager(),
+      snapshot_->profiler()->parallel_snapshot_semaphore());
+  for (auto& page : *pages) job.AddPage(page->chunk, page.get());
+  RecordFieldsJobTraits::PerTaskData task_data = {progress_, fixed_arrays};
+  job.Run(job.NumberOfPages(), [task_data](int i) { return task_data; });
+
+  // Entries and edges are added on the main thread in page order, so the
+  // snapshot is the same as the one of a sequential pass.
+  for (auto& page : *pages) {
+    const HeapSnapshotPage::Field* fields = page->fields.data();
+    size_t fields_start = 0;
+    for (size_t i = 0; i < page->objects.size(); i++) {
+      size_t fields_end = page->fields_end[i];
+      ExtractObjectReferences<extractor>(page->objects[i],
+                                         fields + fields_start,
+                                         fields + fields_end);
+      fields_start = fields_end;
+      progress_->ProgressStep();
+      if (!progress_->ProgressReport(false)) return true;
     }
+  }
+  return false;
+}
 
-    HeapEntry* heap_entry = GetEntry(obj);
-    int entry = heap_entry->index();
-    if ((this->*extractor)(entry, obj)) {
-      SetInternalReference(obj, entry,
-                           "map", obj->map(), HeapObject::kMapOffset);
-      // Extract unvisited fields as hidden references and restore tags
-      // of visited fields.
+
+template <V8HeapExplorer::ExtractReferencesMethod extractor>
+void V8HeapExplorer::ExtractObjectReferences(
+    HeapObject* obj, const HeapSnapshotPage::Field* fields,
+    const HeapSnapshotPage::Field* fields_end) {
+  size_t max_pointer = obj->Size() / kPointerSize;
+  if (max_pointer > marks_.size()) {
+    // Clear the current bits.
+    std::vector<bool>().swap(marks_);
+    // Reallocate to right size.
+    marks_.resize(max_pointer, false);
+  }
+
+  HeapEntry* heap_entry = GetEntry(obj);
+  int entry = heap_entry->index();
+  if ((this->*extractor)(entry, obj)) {
+    SetInternalReference(obj, entry,
+                         "map", obj->map(), HeapObject::kMapOffset);
+    // Extract unvisited fields as hidden references and restore tags
+    // of visited fields.
+    if (fields != nullptr && obj->Size() <= kMaxRegularHeapObjectSize) {
+      ExtractRecordedHiddenReferences(obj, entry, fields, fields_end);
+    } else {
       IndexedReferencesExtractor refs_extractor(this, obj, entry);
       obj->Iterate(&refs_extractor);
     }
+  }
+}
+
 
-    if (!progress_->ProgressReport(false)) interrupted = true;
+void V8HeapExplorer::ExtractRecordedHiddenReferences(
+    HeapObject* obj, int entry, const HeapSnapshotPage::Field* fields,
+    const HeapSnapshotPage::Field* fields_end) {
+  // Mirrors IndexedReferencesExtractor on the recorded fields.
+  int next_index = 0;
+  for (const HeapSnapshotPage::Field* field = fields; field < fields_end;
+       field++) {
+    if (field->index == HeapSnapshotPage::kCodeEntryField) {
+      Code* code = Code::cast(field->value);
+      SetInternalReference(obj, entry, "code", code);
+      TagCodeObject(code);
+      continue;
+    }
+    ++next_index;
+    if (field->index != HeapSnapshotPage::kOutOfObjectField &&
+        marks_[field->index]) {
+      marks_[field->index] = false;
+      continue;
+    }
+    SetHiddenReference(obj, entry, next_index, field->value,
+                       field->index * kPointerSize);
   }
-  return interrupted;
 }
 
 
@@ -2493,6 +2653,8 @@ HeapSnapshotGenerator::HeapSnapshotGenerator(
       control_(control),
       v8_heap_explorer_(snapshot_, this, resolver),
       dom_explorer_(snapshot_, this),
+      progress_total_(0),
+      next_progress_report_(0),
       heap_(heap) {
 }
 
@@ -2532,7 +2694,8 @@ bool HeapSnapshotGenerator::GenerateSnapshot() {
   }
 #endif
 
-  SetProgressTotal(2);  // 2 passes.
+  // 2 passes, each preceded by a parallel scan of the heap pages.
+  SetProgressTotal(FLAG_parallel_heap_snapshot ? 4 : 2);
 
 #ifdef VERIFY_HEAP
   if (FLAG_verify_heap) {
@@ -2547,26 +2710,27 @@ bool HeapSnapshotGenerator::GenerateSnapshot() {
   snapshot_->FillChildren();
   snapshot_->RememberLastJSObjectId();
 
-  progress_counter_ = progress_total_;
+  progress_counter_.SetValue(progress_total_);
   if (!ProgressReport(true)) return false;
   return true;
 }
 
 
 void HeapSnapshotGenerator::ProgressStep() {
-  ++progress_counter_;
+  progress_counter_.Increment(1);
 }
 
 
 bool HeapSnapshotGenerator::ProgressReport(bool force) {
   const int kProgressReportGranularity = 10000;
-  if (control_ != NULL
-      && (force || progress_counter_ % kProgressReportGranularity == 0)) {
-      return
-          control_->ReportProgressValue(progress_counter_, progress_total_) ==
-          v8::ActivityControl::kContinue;
-  }
-  return true;
+  if (control_ == NULL) return true;
+  // Background tasks advance the counter concurrently, so report whenever
+  // the counter moved by at least the granularity.
+  int progress = progress_counter_.Value();
+  if (!force && progress < next_progress_report_) return true;
+  next_progress_report_ = progress + kProgressReportGranularity;
+  return control_->ReportProgressValue(progress, progress_total_) ==
+         v8::ActivityControl::kContinue;
 }
 
 
@@ -2576,7 +2740,8 @@ void HeapSnapshotGenerator::SetProgressTotal(int iterations_count) {
   progress_total_ = iterations_count * (
       v8_heap_explorer_.EstimateObjectsCount(&iterator) +
       dom_explorer_.EstimateObjectsCount());
-  progress_counter_ = 0;
+  progress_counter_.SetValue(0);
+  next_progress_report_ = 0;
 }
 
 
@@ -2633,6 +2798,32 @@ class OutputStreamWriter {
     }
   }
   void AddNumber(unsigned n) { AddNumberImpl<unsigned>(n, "%u"); }
+  // Binary output, used by HeapSnapshotBinarySerializer.
+  void AddByte(uint8_t b) {
+    DCHECK(chunk_pos_ < chunk_size_);
+    chunk_[chunk_pos_++] = static_cast<char>(b);
+    MaybeWriteChunk();
+  }
+  void AddBytes(const char* s, int n) {
+    const char* s_end = s + n;
+    while (s < s_end) {
+      int s_chunk_size =
+          Min(chunk_size_ - chunk_pos_, static_cast<int>(s_end - s));
+      DCHECK(s_chunk_size > 0);
+      MemCopy(chunk_.start() + chunk_pos_, s, s_chunk_size);
+      s += s_chunk_size;
+      chunk_pos_ += s_chunk_size;
+      MaybeWriteChunk();
+    }
+  }
+  // Unsigned LEB128 encoding.
+  void AddVarint(uint64_t n) {
+    while (n >= 0x80) {
+      AddByte(static_cast<uint8_t>(n | 0x80));
+      n >>= 7;
+    }
+    AddByte(static_cast<uint8_t>(n));
+  }
   void Finalize() {
     if (aborted_) return;
     DCHECK(chunk_pos_ < chunk_size_);
@@ -2793,42 +2984,36 @@ static int utoa(T value, const Vector<char>& buffer, int buffer_pos) {
 }
 
 
-void HeapSnapshotJSONSerializer::SerializeEdge(HeapGraphEdge* edge,
-                                               bool first_edge) {
+// The JSON records are written by the functions below, which are shared by
+// HeapSnapshotJSONSerializer and HeapSnapshotBinaryConverter so that both
+// produce the same output.
+
+static void WriteEdgeJSON(OutputStreamWriter* writer, bool first_edge,
+                          unsigned type, unsigned name_or_index,
+                          unsigned to_node) {
   // The buffer needs space for 3 unsigned ints, 3 commas, \n and \0
   static const int kBufferSize =
       MaxDecimalDigitsIn<sizeof(unsigned)>::kUnsigned * 3 + 3 + 2;  // NOLINT
   EmbeddedVector<char, kBufferSize> buffer;
-  int edge_name_or_index = edge->type() == HeapGraphEdge::kElement
-      || edge->type() == HeapGraphEdge::kHidden
-      ? edge->index() : GetStringId(edge->name());
   int buffer_pos = 0;
   if (!first_edge) {
     buffer[buffer_pos++] = ',';
   }
-  buffer_pos = utoa(edge->type(), buffer, buffer_pos);
+  buffer_pos = utoa(type, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
-  buffer_pos = utoa(edge_name_or_index, buffer, buffer_pos);
+  buffer_pos = utoa(name_or_index, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
-  buffer_pos = utoa(entry_index(edge->to()), buffer, buffer_pos);
+  buffer_pos = utoa(to_node, buffer, buffer_pos);
   buffer[buffer_pos++] = '\n';
   buffer[buffer_pos++] = '\0';
-  writer_->AddString(buffer.start());
-}
-
-
-void HeapSnapshotJSONSerializer::SerializeEdges() {
-  std::deque<HeapGraphEdge*>& edges = snapshot_->children();
-  for (size_t i = 0; i < edges.size(); ++i) {
-    DCHECK(i == 0 ||
-           edges[i - 1]->from()->index() <= edges[i]->from()->index());
-    SerializeEdge(edges[i], i == 0);
-    if (writer_->aborted()) return;
-  }
+  writer->AddString(buffer.start());
 }
 
 
-void HeapSnapshotJSONSerializer::SerializeNode(HeapEntry* entry) {
+static void WriteNodeJSON(OutputStreamWriter* writer, bool first_node,
+                          unsigned type, unsigned name, unsigned id,
+                          size_t self_size, unsigned edge_count,
+                          unsigned trace_node_id) {
   // The buffer needs space for 4 unsigned ints, 1 size_t, 5 commas, \n and \0
   static const int kBufferSize =
       5 * MaxDecimalDigitsIn<sizeof(unsigned)>::kUnsigned  // NOLINT
@@ -2836,43 +3021,36 @@ void HeapSnapshotJSONSerializer::SerializeNode(HeapEntry* entry) {
       + 6 + 1 + 1;
   EmbeddedVector<char, kBufferSize> buffer;
   int buffer_pos = 0;
-  if (entry_index(entry) != 0) {
+  if (!first_node) {
     buffer[buffer_pos++] = ',';
   }
-  buffer_pos = utoa(entry->type(), buffer, buffer_pos);
+  buffer_pos = utoa(type, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
-  buffer_pos = utoa(GetStringId(entry->name()), buffer, buffer_pos);
+  buffer_pos = utoa(name, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
-  buffer_pos = utoa(entry->id(), buffer, buffer_pos);
+  buffer_pos = utoa(id, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
-  buffer_pos = utoa(entry->self_size(), buffer, buffer_pos);
+  buffer_pos = utoa(self_size, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
-  buffer_pos = utoa(entry->children_count(), buffer, buffer_pos);
+  buffer_pos = utoa(edge_count, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
-  buffer_pos = utoa(entry->trace_node_id(), buffer, buffer_pos);
+  buffer_pos = utoa(trace_node_id, buffer, buffer_pos);
   buffer[buffer_pos++] = '\n';
   buffer[buffer_pos++] = '\0';
-  writer_->AddString(buffer.start());
-}
-
-
-void HeapSnapshotJSONSerializer::SerializeNodes() {
-  List<HeapEntry>& entries = snapshot_->entries();
-  for (int i = 0; i < entries.length(); ++i) {
-    SerializeNode(&entries[i]);
-    if (writer_->aborted()) return;
-  }
+  writer->AddString(buffer.start());
 }
 
 
-void HeapSnapshotJSONSerializer::SerializeSnapshot() {
-  writer_->AddString("\"meta\":");
+static void WriteSnapshotJSON(OutputStreamWriter* writer, unsigned node_count,
+                              unsigned edge_count,
+                              unsigned trace_function_count) {
+  writer->AddString("\"meta\":");
   // The object describing node serialization layout.
   // We use a set of macros to improve readability.
 #define JSON_A(s) "[" s "]"
 #define JSON_O(s) "{" s "}"
 #define JSON_S(s) "\"" s "\""
-  writer_->AddString(JSON_O(
+  writer->AddString(JSON_O(
     JSON_S("node_fields") ":" JSON_A(
         JSON_S("type") ","
         JSON_S("name") ","
@@ -2934,17 +3112,12 @@ void HeapSnapshotJSONSerializer::SerializeSnapshot() {
 #undef JSON_S
 #undef JSON_O
 #undef JSON_A
-  writer_->AddString(",\"node_count\":");
-  writer_->AddNumber(snapshot_->entries().length());
-  writer_->AddString(",\"edge_count\":");
-  writer_->AddNumber(static_cast<double>(snapshot_->edges().size()));
-  writer_->AddString(",\"trace_function_count\":");
-  uint32_t count = 0;
-  AllocationTracker* tracker = snapshot_->profiler()->allocation_tracker();
-  if (tracker) {
-    count = tracker->function_info_list().length();
-  }
-  writer_->AddNumber(count);
+  writer->AddString(",\"node_count\":");
+  writer->AddNumber(node_count);
+  writer->AddString(",\"edge_count\":");
+  writer->AddNumber(edge_count);
+  writer->AddString(",\"trace_function_count\":");
+  writer->AddNumber(trace_function_count);
 }
 
 
@@ -2958,168 +3131,241 @@ static void WriteUChar(OutputStreamWriter* w, unibrow::uchar u) {
 }
 
 
-void HeapSnapshotJSONSerializer::SerializeTraceTree() {
-  AllocationTracker* tracker = snapshot_->profiler()->allocation_tracker();
-  if (!tracker) return;
-  AllocationTraceTree* traces = tracker->trace_tree();
-  SerializeTraceNode(traces->root());
-}
-
-
-void HeapSnapshotJSONSerializer::SerializeTraceNode(AllocationTraceNode* node) {
+// Writes the head of a trace node, the children follow and are closed by ']'.
+static void WriteTraceNodeJSON(OutputStreamWriter* writer, unsigned id,
+                               unsigned function_info_index, unsigned count,
+                               unsigned size) {
   // The buffer needs space for 4 unsigned ints, 4 commas, [ and \0
   const int kBufferSize =
       4 * MaxDecimalDigitsIn<sizeof(unsigned)>::kUnsigned  // NOLINT
       + 4 + 1 + 1;
   EmbeddedVector<char, kBufferSize> buffer;
   int buffer_pos = 0;
-  buffer_pos = utoa(node->id(), buffer, buffer_pos);
+  buffer_pos = utoa(id, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
-  buffer_pos = utoa(node->function_info_index(), buffer, buffer_pos);
+  buffer_pos = utoa(function_info_index, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
-  buffer_pos = utoa(node->allocation_count(), buffer, buffer_pos);
+  buffer_pos = utoa(count, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
-  buffer_pos = utoa(node->allocation_size(), buffer, buffer_pos);
+  buffer_pos = utoa(size, buffer, buffer_pos);
   buffer[buffer_pos++] = ',';
   buffer[buffer_pos++] = '[';
   buffer[buffer_pos++] = '\0';
-  writer_->AddString(buffer.start());
-
-  Vector<AllocationTraceNode*> children = node->children();
-  for (int i = 0; i < children.length(); i++) {
-    if (i > 0) {
-      writer_->AddCharacter(',');
-    }
-    SerializeTraceNode(children[i]);
-  }
-  writer_->AddCharacter(']');
+  writer->AddString(buffer.start());
 }
 
 
 // 0-based position is converted to 1-based during the serialization.
-static int SerializePosition(int position, const Vector<char>& buffer,
-                             int buffer_pos) {
-  if (position == -1) {
-    buffer[buffer_pos++] = '0';
-  } else {
-    DCHECK(position >= 0);
-    buffer_pos = utoa(static_cast<unsigned>(position + 1), buffer, buffer_pos);
-  }
-  return buffer_pos;
+static unsigned SerializePosition(int position) {
+  if (position == -1) return 0;
+  DCHECK(position >= 0);
+  return static_cast<unsigned>(position + 1);
 }
 
 
-void HeapSnapshotJSONSerializer::SerializeTraceNodeInfos() {
-  AllocationTracker* tracker = snapshot_->profiler()->allocation_tracker();
-  if (!tracker) return;
+static void WriteTraceFunctionInfoJSON(OutputStreamWriter* writer, bool first,
+                                       unsigned function_id, unsigned name,
+                                       unsigned script_name, unsigned script_id,
+                                       unsigned line, unsigned column) {
   // The buffer needs space for 6 unsigned ints, 6 commas, \n and \0
   const int kBufferSize =
       6 * MaxDecimalDigitsIn<sizeof(unsigned)>::kUnsigned  // NOLINT
       + 6 + 1 + 1;
   EmbeddedVector<char, kBufferSize> buffer;
-  const List<AllocationTracker::FunctionInfo*>& list =
-      tracker->function_info_list();
-  for (int i = 0; i < list.length(); i++) {
-    AllocationTracker::FunctionInfo* info = list[i];
-    int buffer_pos = 0;
-    if (i > 0) {
-      buffer[buffer_pos++] = ',';
-    }
-    buffer_pos = utoa(info->function_id, buffer, buffer_pos);
-    buffer[buffer_pos++] = ',';
-    buffer_pos = utoa(GetStringId(info->name), buffer, buffer_pos);
-    buffer[buffer_pos++] = ',';
-    buffer_pos = utoa(GetStringId(info->script_name), buffer, buffer_pos);
-    buffer[buffer_pos++] = ',';
-    // The cast is safe because script id is a non-negative Smi.
-    buffer_pos = utoa(static_cast<unsigned>(info->script_id), buffer,
-        buffer_pos);
-    buffer[buffer_pos++] = ',';
-    buffer_pos = SerializePosition(info->line, buffer, buffer_pos);
+  int buffer_pos = 0;
+  if (!first) {
     buffer[buffer_pos++] = ',';
-    buffer_pos = SerializePosition(info->column, buffer, buffer_pos);
-    buffer[buffer_pos++] = '\n';
-    buffer[buffer_pos++] = '\0';
-    writer_->AddString(buffer.start());
   }
+  buffer_pos = utoa(function_id, buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(name, buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(script_name, buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(script_id, buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(line, buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(column, buffer, buffer_pos);
+  buffer[buffer_pos++] = '\n';
+  buffer[buffer_pos++] = '\0';
+  writer->AddString(buffer.start());
 }
 
 
-void HeapSnapshotJSONSerializer::SerializeSamples() {
-  const List<HeapObjectsMap::TimeInterval>& samples =
-      snapshot_->profiler()->heap_object_map()->samples();
-  if (samples.is_empty()) return;
-  base::TimeTicks start_time = samples[0].timestamp;
+static void WriteSampleJSON(OutputStreamWriter* writer, bool first,
+                            uint64_t timestamp_us, unsigned last_assigned_id) {
   // The buffer needs space for 2 unsigned ints, 2 commas, \n and \0
-  const int kBufferSize = MaxDecimalDigitsIn<sizeof(
-                              base::TimeDelta().InMicroseconds())>::kUnsigned +
-                          MaxDecimalDigitsIn<sizeof(samples[0].id)>::kUnsigned +
+  const int kBufferSize = MaxDecimalDigitsIn<sizeof(timestamp_us)>::kUnsigned +
+                          MaxDecimalDigitsIn<sizeof(unsigned)>::kUnsigned +
                           2 + 1 + 1;
   EmbeddedVector<char, kBufferSize> buffer;
-  for (int i = 0; i < samples.length(); i++) {
-    HeapObjectsMap::TimeInterval& sample = samples[i];
-    int buffer_pos = 0;
-    if (i > 0) {
-      buffer[buffer_pos++] = ',';
-    }
-    base::TimeDelta time_delta = sample.timestamp - start_time;
-    buffer_pos = utoa(time_delta.InMicroseconds(), buffer, buffer_pos);
+  int buffer_pos = 0;
+  if (!first) {
     buffer[buffer_pos++] = ',';
-    buffer_pos = utoa(sample.last_assigned_id(), buffer, buffer_pos);
-    buffer[buffer_pos++] = '\n';
-    buffer[buffer_pos++] = '\0';
-    writer_->AddString(buffer.start());
   }
+  buffer_pos = utoa(timestamp_us, buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(last_assigned_id, buffer, buffer_pos);
+  buffer[buffer_pos++] = '\n';
+  buffer[buffer_pos++] = '\0';
+  writer->AddString(buffer.start());
 }
 
 
-void HeapSnapshotJSONSerializer::SerializeString(const unsigned char* s) {
-  writer_->AddCharacter('\n');
-  writer_->AddCharacter('\"');
+static void WriteStringJSON(OutputStreamWriter* writer,
+                            const unsigned char* s) {
+  writer->AddCharacter('\n');
+  writer->AddCharacter('\"');
   for ( ; *s != '\0'; ++s) {
     switch (*s) {
       case '\b':
-        writer_->AddString("\\b");
+        writer->AddString("\\b");
         continue;
       case '\f':
-        writer_->AddString("\\f");
+        writer->AddString("\\f");
         continue;
       case '\n':
-        writer_->AddString("\\n");
+        writer->AddString("\\n");
         continue;
       case '\r':
-        writer_->AddString("\\r");
+        writer->AddString("\\r");
         continue;
       case '\t':
-        writer_->AddString("\\t");
+        writer->AddString("\\t");
         continue;
       case '\"':
       case '\\':
-        writer_->AddCharacter('\\');
-        writer_->AddCharacter(*s);
+        writer->AddCharacter('\\');
+        writer->AddCharacter(*s);
         continue;
       default:
         if (*s > 31 && *s < 128) {
-          writer_->AddCharacter(*s);
+          writer->AddCharacter(*s);
         } else if (*s <= 31) {
           // Special character with no dedicated literal.
-          WriteUChar(writer_, *s);
+          WriteUChar(writer, *s);
         } else {
           // Convert UTF-8 into \u UTF-16 literal.
           size_t length = 1, cursor = 0;
           for ( ; length <= 4 && *(s + length) != '\0'; ++length) { }
           unibrow::uchar c = unibrow::Utf8::CalculateValue(s, length, &cursor);
           if (c != unibrow::Utf8::kBadChar) {
-            WriteUChar(writer_, c);
+            WriteUChar(writer, c);
             DCHECK(cursor != 0);
             s += cursor - 1;
           } else {
-            writer_->AddCharacter('?');
+            writer->AddCharacter('?');
           }
         }
     }
   }
-  writer_->AddCharacter('\"');
+  writer->AddCharacter('\"');
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeEdge(HeapGraphEdge* edge,
+                                               bool first_edge) {
+  int edge_name_or_index = edge->type() == HeapGraphEdge::kElement
+      || edge->type() == HeapGraphEdge::kHidden
+      ? edge->index() : GetStringId(edge->name());
+  WriteEdgeJSON(writer_, first_edge, edge->type(), edge_name_or_index,
+                entry_index(edge->to()));
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeEdges() {
+  std::deque<HeapGraphEdge*>& edges = snapshot_->children();
+  for (size_t i = 0; i < edges.size(); ++i) {
+    DCHECK(i == 0 ||
+           edges[i - 1]->from()->index() <= edges[i]->from()->index());
+    SerializeEdge(edges[i], i == 0);
+    if (writer_->aborted()) return;
+  }
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeNode(HeapEntry* entry) {
+  WriteNodeJSON(writer_, entry_index(entry) == 0, entry->type(),
+                GetStringId(entry->name()), entry->id(), entry->self_size(),
+                entry->children_count(), entry->trace_node_id());
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeNodes() {
+  List<HeapEntry>& entries = snapshot_->entries();
+  for (int i = 0; i < entries.length(); ++i) {
+    SerializeNode(&entries[i]);
+    if (writer_->aborted()) return;
+  }
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeSnapshot() {
+  uint32_t count = 0;
+  AllocationTracker* tracker = snapshot_->profiler()->allocation_tracker();
+  if (tracker) {
+    count = tracker->function_info_list().length();
+  }
+  WriteSnapshotJSON(writer_, snapshot_->entries().length(),
+                    static_cast<unsigned>(snapshot_->edges().size()), count);
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeTraceTree() {
+  AllocationTracker* tracker = snapshot_->profiler()->allocation_tracker();
+  if (!tracker) return;
+  AllocationTraceTree* traces = tracker->trace_tree();
+  SerializeTraceNode(traces->root());
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeTraceNode(AllocationTraceNode* node) {
+  WriteTraceNodeJSON(writer_, node->id(), node->function_info_index(),
+                     node->allocation_count(), node->allocation_size());
+  Vector<AllocationTraceNode*> children = node->children();
+  for (int i = 0; i < children.length(); i++) {
+    if (i > 0) {
+      writer_->AddCharacter(',');
+    }
+    SerializeTraceNode(children[i]);
+  }
+  writer_->AddCharacter(']');
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeTraceNodeInfos() {
+  AllocationTracker* tracker = snapshot_->profiler()->allocation_tracker();
+  if (!tracker) return;
+  const List<AllocationTracker::FunctionInfo*>& list =
+      tracker->function_info_list();
+  for (int i = 0; i < list.length(); i++) {
+    AllocationTracker::FunctionInfo* info = list[i];
+    // The cast is safe because script id is a non-negative Smi.
+    WriteTraceFunctionInfoJSON(
+        writer_, i == 0, info->function_id, GetStringId(info->name),
+        GetStringId(info->script_name), static_cast<unsigned>(info->script_id),
+        SerializePosition(info->line), SerializePosition(info->column));
+  }
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeSamples() {
+  const List<HeapObjectsMap::TimeInterval>& samples =
+      snapshot_->profiler()->heap_object_map()->samples();
+  if (samples.is_empty()) return;
+  base::TimeTicks start_time = samples[0].timestamp;
+  for (int i = 0; i < samples.length(); i++) {
+    HeapObjectsMap::TimeInterval& sample = samples[i];
+    base::TimeDelta time_delta = sample.timestamp - start_time;
+    WriteSampleJSON(writer_, i == 0, time_delta.InMicroseconds(),
+                    sample.last_assigned_id());
+  }
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeString(const unsigned char* s) {
+  WriteStringJSON(writer_, s);
 }
 
 
@@ -3140,5 +3386,324 @@ void HeapSnapshotJSONSerializer::SerializeStrings() {
 }
 
 
+const char HeapSnapshotBinarySerializer::kMagic[] = "V8HS";
+
+
+namespace {
+
+uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+}  // namespace
+
+
+void HeapSnapshotBinarySerializer::Serialize(v8::OutputStream* stream) {
+  if (AllocationTracker* allocation_tracker =
+      snapshot_->profiler()->allocation_tracker()) {
+    allocation_tracker->PrepareForSerialization();
+  }
+  DCHECK(writer_ == NULL);
+  writer_ = new OutputStreamWriter(stream);
+  SerializeImpl();
+  delete writer_;
+  writer_ = NULL;
+}
+
+
+void HeapSnapshotBinarySerializer::SerializeImpl() {
+  DCHECK(0 == snapshot_->root()->index());
+  writer_->AddBytes(kMagic, StrLength(kMagic));
+  writer_->AddVarint(kVersion);
+  AllocationTracker* tracker = snapshot_->profiler()->allocation_tracker();
+  writer_->AddVarint(snapshot_->entries().length());
+  writer_->AddVarint(snapshot_->edges().size());
+  writer_->AddVarint(tracker ? tracker->function_info_list().length() : 0);
+  SerializeNodes();
+  if (writer_->aborted()) return;
+  SerializeEdges();
+  if (writer_->aborted()) return;
+  SerializeTraceNodeInfos();
+  if (writer_->aborted()) return;
+  writer_->AddVarint(tracker ? 1 : 0);
+  if (tracker) SerializeTraceNode(tracker->trace_tree()->root());
+  if (writer_->aborted()) return;
+  SerializeSamples();
+  if (writer_->aborted()) return;
+  SerializeStrings();
+  writer_->Finalize();
+}
+
+
+int HeapSnapshotBinarySerializer::GetStringId(const char* s) {
+  base::HashMap::Entry* cache_entry =
+      strings_.LookupOrInsert(const_cast<char*>(s), StringHash(s));
+  if (cache_entry->value == NULL) {
+    cache_entry->value = reinterpret_cast<void*>(next_string_id_++);
+  }
+  return static_cast<int>(reinterpret_cast<intptr_t>(cache_entry->value));
+}
+
+
+void HeapSnapshotBinarySerializer::SerializeNodes() {
+  List<HeapEntry>& entries = snapshot_->entries();
+  int64_t previous_id = 0;
+  for (int i = 0; i < entries.length(); ++i) {
+    HeapEntry* entry = &entries[i];
+    writer_->AddVarint(entry->type());
+    writer_->AddVarint(GetStringId(entry->name()));
+    writer_->AddVarint(ZigZagEncode(entry->id() - previous_id));
+    previous_id = entry->id();
+    writer_->AddVarint(entry->self_size());
+    writer_->AddVarint(entry->children_count());
+    writer_->AddVarint(entry->trace_node_id());
+    if (writer_->aborted()) return;
+  }
+}
+
+
+void HeapSnapshotBinarySerializer::SerializeEdges() {
+  std::deque<HeapGraphEdge*>& edges = snapshot_->children();
+  for (size_t i = 0; i < edges.size(); ++i) {
+    HeapGraphEdge* edge = edges[i];
+    int edge_name_or_index = edge->type() == HeapGraphEdge::kElement
+        || edge->type() == HeapGraphEdge::kHidden
+        ? edge->index() : GetStringId(edge->name());
+    writer_->AddVarint(edge->type());
+    writer_->AddVarint(static_cast<unsigned>(edge_name_or_index));
+    writer_->AddVarint(edge->to()->index());
+    if (writer_->aborted()) return;
+  }
+}
+
+
+void HeapSnapshotBinarySerializer::SerializeTraceNodeInfos() {
+  AllocationTracker* tracker = snapshot_->profiler()->allocation_tracker();
+  if (!tracker) return;
+  const List<AllocationTracker::FunctionInfo*>& list =
+      tracker->function_info_list();
+  for (int i = 0; i < list.length(); i++) {
+    AllocationTracker::FunctionInfo* info = list[i];
+    writer_->AddVarint(info->function_id);
+    writer_->AddVarint(GetStringId(info->name));
+    writer_->AddVarint(GetStringId(info->script_name));
+    writer_->AddVarint(static_cast<unsigned>(info->script_id));
+    writer_->AddVarint(SerializePosition(info->line));
+    writer_->AddVarint(SerializePosition(info->column));
+  }
+}
+
+
+void HeapSnapshotBinarySerializer::SerializeTraceNode(
+    AllocationTraceNode* node) {
+  writer_->AddVarint(node->id());
+  writer_->AddVarint(node->function_info_index());
+  writer_->AddVarint(node->allocation_count());
+  writer_->AddVarint(node->allocation_size());
+  Vector<AllocationTraceNode*> children = node->children();
+  writer_->AddVarint(children.length());
+  for (int i = 0; i < children.length(); i++) {
+    SerializeTraceNode(children[i]);
+  }
+}
+
+
+void HeapSnapshotBinarySerializer::SerializeSamples() {
+  const List<HeapObjectsMap::TimeInterval>& samples =
+      snapshot_->profiler()->heap_object_map()->samples();
+  writer_->AddVarint(samples.length());
+  if (samples.is_empty()) return;
+  base::TimeTicks start_time = samples[0].timestamp;
+  for (int i = 0; i < samples.length(); i++) {
+    HeapObjectsMap::TimeInterval& sample = samples[i];
+    base::TimeDelta time_delta = sample.timestamp - start_time;
+    writer_->AddVarint(time_delta.InMicroseconds());
+    writer_->AddVarint(sample.last_assigned_id());
+  }
+}
+
+
+void HeapSnapshotBinarySerializer::SerializeStrings() {
+  ScopedVector<const char*> sorted_strings(strings_.occupancy() + 1);
+  for (base::HashMap::Entry* entry = strings_.Start(); entry != NULL;
+       entry = strings_.Next(entry)) {
+    int index = static_cast<int>(reinterpret_cast<uintptr_t>(entry->value));
+    sorted_strings[index] = reinterpret_cast<const char*>(entry->key);
+  }
+  writer_->AddVarint(sorted_strings.length() - 1);
+  for (int i = 1; i < sorted_strings.length(); ++i) {
+    int length = StrLength(sorted_strings[i]);
+    writer_->AddVarint(length);
+    writer_->AddBytes(sorted_strings[i], length);
+    if (writer_->aborted()) return;
+  }
+}
+
+
+bool HeapSnapshotBinaryConverter::ReadVarint(uint64_t* result) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (pos_ == end_) return false;
+    uint8_t byte = *pos_++;
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *result = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+bool HeapSnapshotBinaryConverter::ReadUnsigned(unsigned* result) {
+  uint64_t value;
+  if (!ReadVarint(&value) || value > kMaxUInt32) return false;
+  *result = static_cast<unsigned>(value);
+  return true;
+}
+
+
+bool HeapSnapshotBinaryConverter::ConvertToJSON(v8::OutputStream* stream) {
+  DCHECK(writer_ == NULL);
+  writer_ = new OutputStreamWriter(stream);
+  bool result = ConvertImpl();
+  if (result) writer_->Finalize();
+  delete writer_;
+  writer_ = NULL;
+  return result;
+}
+
+
+bool HeapSnapshotBinaryConverter::ConvertImpl() {
+  size_t magic_length = strlen(HeapSnapshotBinarySerializer::kMagic);
+  if (static_cast<size_t>(end_ - pos_) < magic_length ||
+      memcmp(pos_, HeapSnapshotBinarySerializer::kMagic, magic_length) != 0) {
+    return false;
+  }
+  pos_ += magic_length;
+  unsigned version, node_count, edge_count, trace_function_count;
+  if (!ReadUnsigned(&version) ||
+      version != HeapSnapshotBinarySerializer::kVersion ||
+      !ReadUnsigned(&node_count) || !ReadUnsigned(&edge_count) ||
+      !ReadUnsigned(&trace_function_count)) {
+    return false;
+  }
+
+  writer_->AddCharacter('{');
+  writer_->AddString("\"snapshot\":{");
+  WriteSnapshotJSON(writer_, node_count, edge_count, trace_function_count);
+  writer_->AddString("},\n");
+
+  writer_->AddString("\"nodes\":[");
+  int64_t id = 0;
+  for (unsigned i = 0; i < node_count; i++) {
+    unsigned type, name, edges, trace_node_id;
+    uint64_t id_delta, self_size;
+    if (!ReadUnsigned(&type) || !ReadUnsigned(&name) ||
+        !ReadVarint(&id_delta) || !ReadVarint(&self_size) ||
+        !ReadUnsigned(&edges) || !ReadUnsigned(&trace_node_id)) {
+      return false;
+    }
+    id += ZigZagDecode(id_delta);
+    WriteNodeJSON(writer_, i == 0, type, name, static_cast<unsigned>(id),
+                  static_cast<size_t>(self_size), edges, trace_node_id);
+    if (writer_->aborted()) return false;
+  }
+  writer_->AddString("],\n");
+
+  writer_->AddString("\"edges\":[");
+  for (unsigned i = 0; i < edge_count; i++) {
+    unsigned type, name_or_index, to_node;
+    if (!ReadUnsigned(&type) || !ReadUnsigned(&name_or_index) ||
+        !ReadUnsigned(&to_node) || to_node >= node_count) {
+      return false;
+    }
+    WriteEdgeJSON(writer_, i == 0, type, name_or_index,
+                  to_node * HeapSnapshotJSONSerializer::kNodeFieldsCount);
+    if (writer_->aborted()) return false;
+  }
+  writer_->AddString("],\n");
+
+  writer_->AddString("\"trace_function_infos\":[");
+  for (unsigned i = 0; i < trace_function_count; i++) {
+    unsigned fields[6];
+    for (unsigned& field : fields) {
+      if (!ReadUnsigned(&field)) return false;
+    }
+    WriteTraceFunctionInfoJSON(writer_, i == 0, fields[0], fields[1],
+                               fields[2], fields[3], fields[4], fields[5]);
+  }
+  writer_->AddString("],\n");
+
+  writer_->AddString("\"trace_tree\":[");
+  unsigned has_trace_tree;
+  if (!ReadUnsigned(&has_trace_tree)) return false;
+  if (has_trace_tree && !ConvertTraceNode(0)) return false;
+  writer_->AddString("],\n");
+
+  writer_->AddString("\"samples\":[");
+  unsigned sample_count;
+  if (!ReadUnsigned(&sample_count)) return false;
+  for (unsigned i = 0; i < sample_count; i++) {
+    uint64_t timestamp_us;
+    unsigned last_assigned_id;
+    if (!ReadVarint(&timestamp_us) || !ReadUnsigned(&last_assigned_id)) {
+      return false;
+    }
+    WriteSampleJSON(writer_, i == 0, timestamp_us, last_assigned_id);
+  }
+  writer_->AddString("],\n");
+
+  writer_->AddString("\"strings\":[");
+  writer_->AddString("\"<dummy>\"");
+  unsigned string_count;
+  if (!ReadUnsigned(&string_count)) return false;
+  std::vector<unsigned char> string;
+  for (unsigned i = 0; i < string_count; i++) {
+    unsigned length;
+    if (!ReadUnsigned(&length) ||
+        static_cast<size_t>(end_ - pos_) < length) {
+      return false;
+    }
+    string.assign(pos_, pos_ + length);
+    string.push_back('\0');
+    pos_ += length;
+    writer_->AddCharacter(',');
+    WriteStringJSON(writer_, string.data());
+    if (writer_->aborted()) return false;
+  }
+  writer_->AddCharacter(']');
+  writer_->AddCharacter('}');
+  return pos_ == end_;
+}
+
+
+bool HeapSnapshotBinaryConverter::ConvertTraceNode(int depth) {
+  // Allocation traces are limited in length, so deeper trees are malformed.
+  static const int kMaxDepth = 1024;
+  if (depth > kMaxDepth) return false;
+  unsigned id, function_info_index, count, size, children;
+  if (!ReadUnsigned(&id) || !ReadUnsigned(&function_info_index) ||
+      !ReadUnsigned(&count) || !ReadUnsigned(&size) ||
+      !ReadUnsigned(&children)) {
+    return false;
+  }
+  WriteTraceNodeJSON(writer_, id, function_info_index, count, size);
+  for (unsigned i = 0; i < children; i++) {
+    if (i > 0) {
+      writer_->AddCharacter(',');
+    }
+    if (!ConvertTraceNode(depth + 1)) return false;
+  }
+  writer_->AddCharacter(']');
+  return true;
+}
+
+
 }  // namespace internal
 }  // namespace v8
@@ -6,9 +6,12 @@
 #define V8_PROFILER_HEAP_SNAPSHOT_GENERATOR_H_
 
 #include <deque>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "include/v8-profiler.h"
+#include "src/base/atomic-utils.h"
 #include "src/base/platform/time.h"
 #include "src/objects.h"
 #include "src/profiler/strings-storage.h"
@@ -22,6 +25,7 @@ class HeapEntry;
 class HeapIterator;
 class HeapProfiler;
 class HeapSnapshot;
+class MemoryChunk;
 class SnapshotFiller;
 
 class HeapGraphEdge BASE_EMBEDDED {
@@ -327,11 +331,37 @@ class HeapObjectsSet {
 class SnapshottingProgressReportingInterface {
  public:
   virtual ~SnapshottingProgressReportingInterface() { }
+  // May be called from background threads.
   virtual void ProgressStep() = 0;
+  // Must only be called on the main thread.
   virtual bool ProgressReport(bool force) = 0;
 };
 
 
+// The pointer fields of the objects on a heap page in visiting order. They
+// are recorded by background tasks during parallel snapshot generation and
+// replayed on the main thread, which owns the entries and the names.
+struct HeapSnapshotPage {
+  struct Field {
+    int index;
+    Object* value;
+  };
+
+  // Field indices for pointers that are visited outside of the object (e.g.
+  // in the RelocInfo of code objects) and for code entries.
+  static const int kOutOfObjectField = -1;
+  static const int kCodeEntryField = -2;
+
+  explicit HeapSnapshotPage(MemoryChunk* chunk) : chunk(chunk) {}
+
+  MemoryChunk* chunk;
+  std::vector<HeapObject*> objects;
+  // The fields of objects[i] end at fields[fields_end[i]].
+  std::vector<size_t> fields_end;
+  std::vector<Field> fields;
+};
+
+
 // An implementation of V8 heap graph extractor.
 class V8HeapExplorer : public HeapEntriesAllocator {
  public:
@@ -367,6 +397,21 @@ class V8HeapExplorer : public HeapEntriesAllocator {
 
   template<V8HeapExplorer::ExtractReferencesMethod extractor>
   bool IterateAndExtractSinglePass();
+  // Records the fields of |pages| in parallel and extracts the references of
+  // their objects in page order. Returns true if interrupted.
+  template <V8HeapExplorer::ExtractReferencesMethod extractor>
+  bool ExtractPagesInParallel(
+      std::vector<std::unique_ptr<HeapSnapshotPage>>* pages,
+      bool fixed_arrays);
+  // Extracts the references of |obj|. The hidden references are taken from
+  // the recorded |fields| if given, otherwise |obj| is visited directly.
+  template <V8HeapExplorer::ExtractReferencesMethod extractor>
+  void ExtractObjectReferences(HeapObject* obj,
+                               const HeapSnapshotPage::Field* fields,
+                               const HeapSnapshotPage::Field* fields_end);
+  void ExtractRecordedHiddenReferences(
+      HeapObject* obj, int entry, const HeapSnapshotPage::Field* fields,
+      const HeapSnapshotPage::Field* fields_end);
 
   bool ExtractReferencesPass1(int entry, HeapObject* obj);
   bool ExtractReferencesPass2(int entry, HeapObject* obj);
@@ -560,9 +605,11 @@ class HeapSnapshotGenerator : public SnapshottingProgressReportingInterface {
   NativeObjectsExplorer dom_explorer_;
   // Mapping from HeapThing pointers to HeapEntry* pointers.
   HeapEntriesMap entries_;
-  // Used during snapshot generation.
-  int progress_counter_;
+  // Used during snapshot generation. The counter is also advanced by the
+  // background tasks of a parallel snapshot.
+  base::AtomicNumber<int> progress_counter_;
   int progress_total_;
+  int next_progress_report_;
   Heap* heap_;
 
   DISALLOW_COPY_AND_ASSIGN(HeapSnapshotGenerator);
@@ -618,6 +665,7 @@ class HeapSnapshotJSONSerializer {
   int next_string_id_;
   OutputStreamWriter* writer_;
 
+  friend class HeapSnapshotBinaryConverter;
   friend class HeapSnapshotJSONSerializerEnumerator;
   friend class HeapSnapshotJSONSerializerIterator;
 
@@ -625,6 +673,98 @@ class HeapSnapshotJSONSerializer {
 };
 
 
+// Serializes a snapshot into a compact binary format. The binary format has
+// the same sections as the JSON format, but all numbers are varint encoded,
+// node ids are delta encoded and edges refer to node indices instead of
+// offsets into the nodes array. String ids are assigned in the same order as
+// by HeapSnapshotJSONSerializer, so HeapSnapshotBinaryConverter can turn the
+// binary format into the JSON format in a single pass over the input.
+//
+// Like the JSON serializer, it runs on the fully built HeapSnapshot, so the
+// binary format reduces the output size and the serialization time but not
+// the peak memory used while taking a snapshot.
+//
+// Layout (all numbers are unsigned LEB128 varints):
+//   magic "V8HS", version,
+//   node_count, edge_count, trace_function_count,
+//   nodes: type, name, id delta (zigzag), self_size, edge_count,
+//          trace_node_id,
+//   edges: type, name_or_index, to_node index,
+//   trace function infos: function_id, name, script_name, script_id, line,
+//                         column,
+//   has_trace_tree [, trace tree: id, function_info_index, count, size,
+//                    children count, children...],
+//   sample_count, samples: timestamp_us, last_assigned_id,
+//   string_count, strings: length, UTF-8 bytes.
+class HeapSnapshotBinarySerializer {
+ public:
+  static const char kMagic[];
+  static const int kVersion = 1;
+
+  explicit HeapSnapshotBinarySerializer(HeapSnapshot* snapshot)
+      : snapshot_(snapshot),
+        strings_(StringsMatch),
+        next_string_id_(1),
+        writer_(NULL) {}
+  void Serialize(v8::OutputStream* stream);
+
+ private:
+  INLINE(static bool StringsMatch(void* key1, void* key2)) {
+    return strcmp(reinterpret_cast<char*>(key1),
+                  reinterpret_cast<char*>(key2)) == 0;
+  }
+
+  INLINE(static uint32_t StringHash(const void* string)) {
+    const char* s = reinterpret_cast<const char*>(string);
+    int len = static_cast<int>(strlen(s));
+    return StringHasher::HashSequentialString(
+        s, len, v8::internal::kZeroHashSeed);
+  }
+
+  int GetStringId(const char* s);
+  void SerializeImpl();
+  void SerializeNodes();
+  void SerializeEdges();
+  void SerializeTraceNodeInfos();
+  void SerializeTraceNode(AllocationTraceNode* node);
+  void SerializeSamples();
+  void SerializeStrings();
+
+  HeapSnapshot* snapshot_;
+  base::CustomMatcherHashMap strings_;
+  int next_string_id_;
+  OutputStreamWriter* writer_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotBinarySerializer);
+};
+
+
+// Converts a snapshot in the format of HeapSnapshotBinarySerializer into the
+// JSON format of HeapSnapshotJSONSerializer.
+class HeapSnapshotBinaryConverter {
+ public:
+  HeapSnapshotBinaryConverter(const char* data, size_t length)
+      : pos_(reinterpret_cast<const uint8_t*>(data)),
+        end_(pos_ + length),
+        writer_(NULL) {}
+  // Returns false if the input is malformed or the stream aborted the
+  // conversion. EndOfStream is only called if the conversion succeeded.
+  bool ConvertToJSON(v8::OutputStream* stream);
+
+ private:
+  bool ConvertImpl();
+  bool ConvertTraceNode(int depth);
+  bool ReadVarint(uint64_t* result);
+  bool ReadUnsigned(unsigned* result);
+
+  const uint8_t* pos_;
+  const uint8_t* end_;
+  OutputStreamWriter* writer_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotBinaryConverter);
+};
+
+
 }  // namespace internal
 }  // namespace v8
 
@@ -4,6 +4,8 @@
 
 #include "src/profiler/profile-generator.h"
 
+#include <algorithm>
+
 #include "src/base/adapters.h"
 #include "src/debug/debug.h"
 #include "src/deoptimizer.h"
@@ -389,16 +391,25 @@ void ProfileTree::TraverseDepthFirst(Callback* callback) {
 using v8::tracing::TracedValue;
 
 CpuProfile::CpuProfile(CpuProfiler* profiler, const char* title,
-                       bool record_samples)
+                       bool record_samples, v8::OutputStream* stream)
     : title_(title),
-      record_samples_(record_samples),
+      record_samples_(record_samples || stream),
       start_time_(base::TimeTicks::HighResolutionNow()),
       top_down_(profiler->isolate()),
       profiler_(profiler),
-      streaming_next_sample_(0) {
+      streaming_next_sample_(0),
+      last_streamed_timestamp_(start_time_),
+      stream_(stream),
+      stream_chunk_size_(stream ? stream->GetChunkSize() : 0) {
+  DCHECK(!stream_ || stream_chunk_size_ > 0);
   auto value = TracedValue::Create();
   value->SetDouble("startTime",
                    (start_time_ - base::TimeTicks()).InMicroseconds());
+  if (stream_) {
+    std::string json;
+    value->AppendAsTraceFormat(&json);
+    AppendToStream(json);
+  }
   TRACE_EVENT_SAMPLE_WITH_ID1(TRACE_DISABLED_BY_DEFAULT("v8.cpu_profiler"),
                               "Profile", this, "data", std::move(value));
 }
@@ -406,6 +417,9 @@ CpuProfile::CpuProfile(CpuProfiler* profiler, const char* title,
 void CpuProfile::AddPath(base::TimeTicks timestamp,
                          const std::vector<CodeEntry*>& path, int src_line,
                          bool update_stats) {
+  // The embedder is no longer interested in the profile. Stop collecting
+  // samples, as they would only be dropped again.
+  if (stream_aborted_.Value()) record_samples_ = false;
   ProfileNode* top_frame_node =
       top_down_.AddPathFromEnd(path, src_line, update_stats);
   if (record_samples_ && !timestamp.IsNull()) {
@@ -476,9 +490,7 @@ void CpuProfile::StreamPendingTraceEvents() {
   }
   if (streaming_next_sample_ != samples_.length()) {
     value->BeginArray("timeDeltas");
-    base::TimeTicks lastTimestamp =
-        streaming_next_sample_ ? timestamps_[streaming_next_sample_ - 1]
-                               : start_time();
+    base::TimeTicks lastTimestamp = last_streamed_timestamp_;
     for (int i = streaming_next_sample_; i < timestamps_.length(); ++i) {
       value->AppendInteger(
           static_cast<int>((timestamps_[i] - lastTimestamp).InMicroseconds()));
@@ -486,9 +498,20 @@ void CpuProfile::StreamPendingTraceEvents() {
     }
     value->EndArray();
     DCHECK(samples_.length() == timestamps_.length());
+    last_streamed_timestamp_ = lastTimestamp;
     streaming_next_sample_ = samples_.length();
   }
 
+  if (stream_) {
+    std::string json;
+    value->AppendAsTraceFormat(&json);
+    AppendToStream(json);
+    // Streamed samples are not kept to bound the memory of long sessions.
+    samples_.Rewind(0);
+    timestamps_.Rewind(0);
+    streaming_next_sample_ = 0;
+  }
+
   TRACE_EVENT_SAMPLE_WITH_ID1(TRACE_DISABLED_BY_DEFAULT("v8.cpu_profiler"),
                               "ProfileChunk", this, "data", std::move(value));
 }
@@ -498,10 +521,43 @@ void CpuProfile::FinishProfile() {
   StreamPendingTraceEvents();
   auto value = TracedValue::Create();
   value->SetDouble("endTime", (end_time_ - base::TimeTicks()).InMicroseconds());
+  if (stream_) {
+    std::string json;
+    value->AppendAsTraceFormat(&json);
+    AppendToStream(json);
+    WriteToStream(TakePendingStreamData());
+    if (!stream_aborted_.Value()) stream_->EndOfStream();
+    stream_ = nullptr;
+  }
   TRACE_EVENT_SAMPLE_WITH_ID1(TRACE_DISABLED_BY_DEFAULT("v8.cpu_profiler"),
                               "ProfileChunk", this, "data", std::move(value));
 }
 
+void CpuProfile::AppendToStream(const std::string& json) {
+  if (stream_aborted_.Value()) return;
+  pending_stream_data_ += json;
+  pending_stream_data_ += '\n';
+}
+
+std::string CpuProfile::TakePendingStreamData() {
+  std::string data;
+  data.swap(pending_stream_data_);
+  return data;
+}
+
+void CpuProfile::WriteToStream(std::string data) {
+  if (!stream_ || stream_aborted_.Value()) return;
+  for (size_t pos = 0; pos < data.length(); pos += stream_chunk_size_) {
+    int size = static_cast<int>(
+        std::min(data.length() - pos, static_cast<size_t>(stream_chunk_size_)));
+    if (stream_->WriteAsciiChunk(&data[pos], size) ==
+        v8::OutputStream::kAbort) {
+      stream_aborted_.SetValue(true);
+      return;
+    }
+  }
+}
+
 void CpuProfile::Print() {
   base::OS::Print("[Top down]:\n");
   top_down_.Print();
@@ -509,41 +565,119 @@ void CpuProfile::Print() {
 
 void CodeMap::AddCode(Address addr, CodeEntry* entry, unsigned size) {
   DeleteAllCoveredCode(addr, addr + size);
-  code_map_.insert({addr, CodeEntryInfo(entry, size)});
+  pending_code_.insert({addr, CodeEntryInfo(entry, size)});
+  if (pending_code_.size() > kMinPendingCodeToMerge &&
+      pending_code_.size() > code_ranges_.size() / kPendingCodeMergeRatio) {
+    MergePendingCode();
+  }
 }
 
 void CodeMap::DeleteAllCoveredCode(Address start, Address end) {
-  auto left = code_map_.upper_bound(start);
-  if (left != code_map_.begin()) {
+  // Invalidate the covered ranges of the array in place. They are dropped
+  // when the pending code is merged.
+  auto range = std::upper_bound(
+      code_ranges_.begin(), code_ranges_.end(), start,
+      [](Address addr, const CodeRange& range) { return addr < range.start; });
+  if (range != code_ranges_.begin() && (range - 1)->end() > start) --range;
+  for (; range != code_ranges_.end() && range->start < end; ++range) {
+    range->entry = nullptr;
+  }
+
+  auto left = pending_code_.upper_bound(start);
+  if (left != pending_code_.begin()) {
     --left;
     if (left->first + left->second.size <= start) ++left;
   }
   auto right = left;
-  while (right != code_map_.end() && right->first < end) ++right;
-  code_map_.erase(left, right);
+  while (right != pending_code_.end() && right->first < end) ++right;
+  pending_code_.erase(left, right);
+}
+
+void CodeMap::MergePendingCode() {
+  if (pending_code_.empty()) return;
+  // Pending code never overlaps valid ranges of the array, so a single merge
+  // of the two sorted sequences yields the new array.
+  std::vector<CodeRange> merged;
+  merged.reserve(code_ranges_.size() + pending_code_.size());
+  auto pending = pending_code_.begin();
+  for (const CodeRange& range : code_ranges_) {
+    if (range.entry == nullptr) continue;
+    for (; pending != pending_code_.end() && pending->first < range.start;
+         ++pending) {
+      merged.push_back(
+          {pending->first, pending->second.entry, pending->second.size});
+    }
+    merged.push_back(range);
+  }
+  for (; pending != pending_code_.end(); ++pending) {
+    merged.push_back(
+        {pending->first, pending->second.entry, pending->second.size});
+  }
+  code_ranges_.swap(merged);
+  pending_code_.clear();
+  merge_count_++;
 }
 
-CodeEntry* CodeMap::FindEntry(Address addr) {
-  auto it = code_map_.upper_bound(addr);
-  if (it == code_map_.begin()) return nullptr;
+CodeMap::RangeIterator CodeMap::FindRange(RangeIterator begin,
+                                          RangeIterator end, Address addr) {
+  auto range = std::upper_bound(
+      begin, end, addr,
+      [](Address addr, const CodeRange& range) { return addr < range.start; });
+  if (range == begin) return end;
+  --range;
+  return addr < range->end() ? range : end;
+}
+
+CodeEntry* CodeMap::FindPendingEntry(Address addr) {
+  auto it = pending_code_.upper_bound(addr);
+  if (it == pending_code_.begin()) return nullptr;
   --it;
-  Address end_address = it->first + it->second.size;
-  return addr < end_address ? it->second.entry : nullptr;
+  return addr < it->first + it->second.size ? it->second.entry : nullptr;
+}
+
+CodeEntry* CodeMap::FindEntry(Address addr) {
+  // Pending code never overlaps valid ranges of the array, so at most one of
+  // the two lookups finds an entry.
+  auto range = FindRange(code_ranges_.begin(), code_ranges_.end(), addr);
+  if (range != code_ranges_.end() && range->entry != nullptr) {
+    return range->entry;
+  }
+  return FindPendingEntry(addr);
+}
+
+void CodeMap::FindEntries(const Address* addresses, size_t count,
+                          CodeEntry** entries) {
+  for (size_t i = 0; i < count; ++i) entries[i] = FindEntry(addresses[i]);
 }
 
 void CodeMap::MoveCode(Address from, Address to) {
   if (from == to) return;
-  auto it = code_map_.find(from);
-  if (it == code_map_.end()) return;
-  CodeEntryInfo info = it->second;
-  code_map_.erase(it);
-  AddCode(to, info.entry, info.size);
+  CodeEntry* entry;
+  unsigned size;
+  auto it = pending_code_.find(from);
+  if (it != pending_code_.end()) {
+    entry = it->second.entry;
+    size = it->second.size;
+    pending_code_.erase(it);
+  } else {
+    auto range = FindRange(code_ranges_.begin(), code_ranges_.end(), from);
+    if (range == code_ranges_.end() || range->start != from ||
+        range->entry == nullptr) {
+      return;
+    }
+    entry = range->entry;
+    size = range->size;
+    range->entry = nullptr;
+  }
+  AddCode(to, entry, size);
 }
 
 void CodeMap::Print() {
-  for (auto it = code_map_.begin(); it != code_map_.end(); ++it) {
-    base::OS::Print("%p %5d %s\n", static_cast<void*>(it->first),
-                    it->second.size, it->second.entry->name());
+  MergePendingCode();
+  for (const CodeRange& range : code_ranges_) {
+    if (range.entry == nullptr) continue;
+    base::OS::Print("%p %5d %s\n", static_cast<void*>(range.start),
+                    range.size, range.entry->name());
   }
 }
 
@@ -564,7 +698,8 @@ CpuProfilesCollection::~CpuProfilesCollection() {
 
 
 bool CpuProfilesCollection::StartProfiling(const char* title,
-                                           bool record_samples) {
+                                           bool record_samples,
+                                           v8::OutputStream* stream) {
   current_profiles_semaphore_.Wait();
   if (current_profiles_.length() >= kMaxSimultaneousProfiles) {
     current_profiles_semaphore_.Signal();
@@ -574,11 +709,13 @@ bool CpuProfilesCollection::StartProfiling(const char* title,
     if (strcmp(current_profiles_[i]->title(), title) == 0) {
       // Ignore attempts to start profile with the same title...
       current_profiles_semaphore_.Signal();
-      // ... though return true to force it collect a sample.
-      return true;
+      // ... though return true to force it collect a sample. The stream of a
+      // streaming profile would never receive data, so reject those.
+      return stream == nullptr;
     }
   }
-  current_profiles_.Add(new CpuProfile(profiler_, title, record_samples));
+  current_profiles_.Add(
+      new CpuProfile(profiler_, title, record_samples, stream));
   current_profiles_semaphore_.Signal();
   return true;
 }
@@ -597,7 +734,10 @@ CpuProfile* CpuProfilesCollection::StopProfiling(const char* title) {
   current_profiles_semaphore_.Signal();
 
   if (!profile) return nullptr;
-  profile->FinishProfile();
+  {
+    base::LockGuard<base::Mutex> guard(&stream_mutex_);
+    profile->FinishProfile();
+  }
   finished_profiles_.Add(profile);
   return profile;
 }
@@ -629,11 +769,25 @@ void CpuProfilesCollection::AddPathToCurrentProfiles(
   // As starting / stopping profiles is rare relatively to this
   // method, we don't bother minimizing the duration of lock holding,
   // e.g. copying contents of the list to a local vector.
+  std::vector<std::pair<CpuProfile*, std::string>> stream_data;
   current_profiles_semaphore_.Wait();
   for (int i = 0; i < current_profiles_.length(); ++i) {
-    current_profiles_[i]->AddPath(timestamp, path, src_line, update_stats);
+    CpuProfile* profile = current_profiles_[i];
+    profile->AddPath(timestamp, path, src_line, update_stats);
+    std::string data = profile->TakePendingStreamData();
+    if (!data.empty()) stream_data.push_back({profile, std::move(data)});
+  }
+  if (stream_data.empty()) {
+    current_profiles_semaphore_.Signal();
+    return;
   }
+  // Embedder callbacks must not run under the semaphore. They can take long
+  // and would block the VM thread from starting and stopping profiles.
+  base::LockGuard<base::Mutex> guard(&stream_mutex_);
   current_profiles_semaphore_.Signal();
+  for (auto& entry : stream_data) {
+    entry.first->WriteToStream(std::move(entry.second));
+  }
 }
 
 ProfileGenerator::ProfileGenerator(CpuProfilesCollection* profiles)
@@ -696,9 +850,17 @@ void ProfileGenerator::RecordTickSample(const TickSample& sample) {
       }
     }
 
+    // Symbolize all frames of the sample in one pass over the code map.
+    Address stack[TickSample::kMaxFramesCount];
+    CodeEntry* stack_entries[TickSample::kMaxFramesCount];
+    for (unsigned i = 0; i < sample.frames_count; ++i) {
+      stack[i] = reinterpret_cast<Address>(sample.stack[i]);
+    }
+    code_map_.FindEntries(stack, sample.frames_count, stack_entries);
+
     for (unsigned i = 0; i < sample.frames_count; ++i) {
-      Address stack_pos = reinterpret_cast<Address>(sample.stack[i]);
-      CodeEntry* entry = FindEntry(stack_pos);
+      Address stack_pos = stack[i];
+      CodeEntry* entry = stack_entries[i];
       if (entry) {
         // Find out if the entry has an inlining stack associated.
         int pc_offset =
@@ -6,8 +6,12 @@
 #define V8_PROFILER_PROFILE_GENERATOR_H_
 
 #include <map>
+#include <string>
+#include <vector>
 #include "src/allocation.h"
+#include "src/base/atomic-utils.h"
 #include "src/base/hashmap.h"
+#include "src/base/platform/mutex.h"
 #include "src/log.h"
 #include "src/profiler/strings-storage.h"
 #include "src/source-position.h"
@@ -268,13 +272,23 @@ class ProfileTree {
 
 class CpuProfile {
  public:
-  CpuProfile(CpuProfiler* profiler, const char* title, bool record_samples);
+  // If a |stream| is given, the profile is streamed as newline-separated JSON
+  // chunks and samples are dropped once they have been written.
+  CpuProfile(CpuProfiler* profiler, const char* title, bool record_samples,
+             v8::OutputStream* stream = nullptr);
 
   // Add pc -> ... -> main() call path to the profile.
   void AddPath(base::TimeTicks timestamp, const std::vector<CodeEntry*>& path,
                int src_line, bool update_stats);
+  // Writes the remaining data of a streaming profile and ends the stream.
   void FinishProfile();
 
+  // The JSON chunks of a streaming profile are buffered until they are taken
+  // and written to the stream. This allows to write them without holding the
+  // lock of the profiles collection.
+  std::string TakePendingStreamData();
+  void WriteToStream(std::string data);
+
   const char* title() const { return title_; }
   const ProfileTree* top_down() const { return &top_down_; }
 
@@ -294,6 +308,7 @@ class CpuProfile {
 
  private:
   void StreamPendingTraceEvents();
+  void AppendToStream(const std::string& json);
 
   const char* title_;
   bool record_samples_;
@@ -304,19 +319,38 @@ class CpuProfile {
   ProfileTree top_down_;
   CpuProfiler* const profiler_;
   int streaming_next_sample_;
+  base::TimeTicks last_streamed_timestamp_;
+  v8::OutputStream* stream_;
+  int stream_chunk_size_;
+  std::string pending_stream_data_;
+  // Set by the thread writing to the stream if the embedder aborted it.
+  base::AtomicValue<bool> stream_aborted_;
 
   DISALLOW_COPY_AND_ASSIGN(CpuProfile);
 };
 
+// Maps code addresses to code entries.
+//
+// Lookups are done on a sorted array of disjoint code ranges. Code that is
+// added or moved is collected in a small pending map first and merged into
+// the array on the next lookup, so bursts of code events (e.g. code moves
+// during a GC) do not shift the array on every event.
 class CodeMap {
  public:
-  CodeMap() {}
+  CodeMap() : merge_count_(0) {}
 
   void AddCode(Address addr, CodeEntry* entry, unsigned size);
   void MoveCode(Address from, Address to);
   CodeEntry* FindEntry(Address addr);
+  // Looks up |count| addresses and stores the results in |entries|.
+  void FindEntries(const Address* addresses, size_t count,
+                   CodeEntry** entries);
   void Print();
 
+  // The number of times that newly added code was merged into the sorted
+  // array. Exposed for testing.
+  int merge_count() const { return merge_count_; }
+
  private:
   struct CodeEntryInfo {
     CodeEntryInfo(CodeEntry* an_entry, unsigned a_size)
@@ -325,9 +359,36 @@ class CodeMap {
     unsigned size;
   };
 
+  // Newly added code is kept in |pending_code_| and merged into the sorted
+  // array in batches, so that interleaved code events and lookups don't
+  // rebuild the array every time.
+  static const size_t kMinPendingCodeToMerge = 64;
+  // Merge once the pending code exceeds this fraction of the array.
+  static const size_t kPendingCodeMergeRatio = 16;
+
+  // A code range of the sorted array. Ranges that are covered by newer code
+  // or that were moved away have a null |entry| until the next merge.
+  struct CodeRange {
+    Address start;
+    CodeEntry* entry;
+    unsigned size;
+
+    Address end() const { return start + size; }
+  };
+
+  typedef std::vector<CodeRange>::iterator RangeIterator;
+
   void DeleteAllCoveredCode(Address start, Address end);
+  void MergePendingCode();
+  CodeEntry* FindPendingEntry(Address addr);
+  // Returns the range containing |addr| or |end| if there is none. Only
+  // ranges in [|begin|, |end|) are considered.
+  RangeIterator FindRange(RangeIterator begin, RangeIterator end,
+                          Address addr);
 
-  std::map<Address, CodeEntryInfo> code_map_;
+  std::vector<CodeRange> code_ranges_;
+  std::map<Address, CodeEntryInfo> pending_code_;
+  int merge_count_;
 
   DISALLOW_COPY_AND_ASSIGN(CodeMap);
 };
@@ -338,7 +399,10 @@ class CpuProfilesCollection {
   ~CpuProfilesCollection();
 
   void set_cpu_profiler(CpuProfiler* profiler) { profiler_ = profiler; }
-  bool StartProfiling(const char* title, bool record_samples);
+  // Returns false if too many profiles are running, or if |stream| is given
+  // and a profile with the same title is already running.
+  bool StartProfiling(const char* title, bool record_samples,
+                      v8::OutputStream* stream = nullptr);
   CpuProfile* StopProfiling(const char* title);
   List<CpuProfile*>* profiles() { return &finished_profiles_; }
   const char* GetName(Name* name) { return resource_names_.GetName(name); }
@@ -361,6 +425,10 @@ class CpuProfilesCollection {
   // Accessed by VM thread and profile generator thread.
   List<CpuProfile*> current_profiles_;
   base::Semaphore current_profiles_semaphore_;
+  // Held while writing to the streams of profiles. It is acquired before
+  // current_profiles_semaphore_ is released, so a stopped profile is not
+  // finished while the profile generator thread still writes to its stream.
+  base::Mutex stream_mutex_;
 
   DISALLOW_COPY_AND_ASSIGN(CpuProfilesCollection);
 };
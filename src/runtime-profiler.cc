@@ -15,6 +15,7 @@
 #include "src/full-codegen/full-codegen.h"
 #include "src/global-handles.h"
 #include "src/interpreter/interpreter.h"
+#include "src/snapshot/feedback-serializer.h"
 
 namespace v8 {
 namespace internal {
@@ -63,7 +64,8 @@ static const int kMaxSizeOptIgnition = 250 * 1024;
   V(DoNotOptimize, "do not optimize")                          \
   V(HotAndStable, "hot and stable")                            \
   V(HotWithoutMuchTypeInfo, "not much type info but very hot") \
-  V(SmallFunction, "small function")
+  V(SmallFunction, "small function")                           \
+  V(HotInPreviousRun, "hot in a previous run")
 
 enum class OptimizationReason : uint8_t {
 #define OPTIMIZATION_REASON_CONSTANTS(Constant, message) k##Constant,
@@ -260,6 +262,11 @@ void RuntimeProfiler::MaybeOptimizeFullCodegen(JSFunction* function,
   }
   if (frame->is_optimized()) return;
 
+  if (WasOptimizedInPreviousRun(shared)) {
+    Optimize(function, OptimizationReason::kHotInPreviousRun);
+    return;
+  }
+
   int ticks = shared_code->profiler_ticks();
 
   if (ticks >= kProfilerTicksBeforeOptimization) {
@@ -300,6 +307,14 @@ void RuntimeProfiler::MaybeOptimizeFullCodegen(JSFunction* function,
   }
 }
 
+bool RuntimeProfiler::WasOptimizedInPreviousRun(SharedFunctionInfo* shared) {
+  // Only the first optimization is taken from the imported feedback, later
+  // ones follow the usual heuristics of this run.
+  return shared->opt_count() == 0 &&
+         !isolate_->imported_feedback()->is_empty() &&
+         isolate_->imported_feedback()->WasOptimized(shared);
+}
+
 void RuntimeProfiler::MaybeOptimizeIgnition(JSFunction* function,
                                             JavaScriptFrame* frame) {
   if (function->IsInOptimizationQueue()) {
@@ -376,6 +391,10 @@ OptimizationReason RuntimeProfiler::ShouldOptimizeIgnition(
     return OptimizationReason::kDoNotOptimize;
   }
 
+  if (WasOptimizedInPreviousRun(shared)) {
+    return OptimizationReason::kHotInPreviousRun;
+  }
+
   if (ticks >= kProfilerTicksBeforeOptimization) {
     int typeinfo, generic, total, type_percentage, generic_percentage;
     GetICCounts(function, &typeinfo, &generic, &total, &type_percentage,
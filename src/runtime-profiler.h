@@ -13,6 +13,7 @@ namespace internal {
 class Isolate;
 class JavaScriptFrame;
 class JSFunction;
+class SharedFunctionInfo;
 enum class OptimizationReason : uint8_t;
 
 class RuntimeProfiler {
@@ -36,6 +37,9 @@ class RuntimeProfiler {
   bool MaybeOSRIgnition(JSFunction* function, JavaScriptFrame* frame);
   OptimizationReason ShouldOptimizeIgnition(JSFunction* function,
                                             JavaScriptFrame* frame);
+  // Returns true if the feedback imported for |shared| says that it was
+  // optimized in the run that recorded the feedback.
+  bool WasOptimizedInPreviousRun(SharedFunctionInfo* shared);
   void Optimize(JSFunction* function, OptimizationReason reason);
   void Baseline(JSFunction* function, OptimizationReason reason);
 
@@ -12,6 +12,7 @@
 #include "src/macro-assembler.h"
 #include "src/objects-inl.h"
 #include "src/snapshot/deserializer.h"
+#include "src/snapshot/feedback-serializer.h"
 #include "src/snapshot/snapshot.h"
 #include "src/version.h"
 #include "src/wasm/wasm-module.h"
@@ -219,6 +220,17 @@ MaybeHandle<SharedFunctionInfo> CodeSerializer::Deserialize(
   }
   result->set_deserialized(true);
 
+  Vector<const byte> recipe = scd.Recipe();
+  if (recipe.length() > 0) {
+    // The recipe is checked on its own. A stale recipe doesn't invalidate the
+    // code, the functions are then optimized as usual. The script was just
+    // deserialized, so none of its closures exist yet.
+    ScriptData recipe_data(recipe.start(), recipe.length());
+    Handle<Script> script(Script::cast(result->script()), isolate);
+    FeedbackSerializer::Deserialize(isolate, &recipe_data, script, source,
+                                    true, false);
+  }
+
   if (isolate->logger()->is_logging_code_events() || isolate->is_profiling()) {
     String* name = isolate->heap()->empty_string();
     if (result->script()->IsScript()) {
@@ -231,6 +243,25 @@ MaybeHandle<SharedFunctionInfo> CodeSerializer::Deserialize(
   return scope.CloseAndEscape(result);
 }
 
+ScriptData* CodeSerializer::AttachOptimizationRecipe(Isolate* isolate,
+                                                     ScriptData* cached_data,
+                                                     Handle<Script> script,
+                                                     Handle<String> source) {
+  SerializedCodeData::SanityCheckResult sanity_check_result =
+      SerializedCodeData::CHECK_SUCCESS;
+  const SerializedCodeData scd = SerializedCodeData::FromCachedData(
+      isolate, cached_data, SerializedCodeData::SourceHash(source),
+      &sanity_check_result);
+  if (sanity_check_result != SerializedCodeData::CHECK_SUCCESS) {
+    return nullptr;
+  }
+  std::unique_ptr<ScriptData> recipe(
+      FeedbackSerializer::Serialize(isolate, script, source));
+  SerializedCodeData data(
+      scd, Vector<const byte>(recipe->data(), recipe->length()));
+  return data.GetScriptData();
+}
+
 WasmCompiledModuleSerializer::WasmCompiledModuleSerializer(
     Isolate* isolate, uint32_t source_hash, Handle<Context> native_context,
     Handle<SeqOneByteString> module_bytes)
@@ -319,45 +350,6 @@ bool WasmCompiledModuleSerializer::ElideObject(Object* obj) {
   return obj->IsWeakCell() || obj->IsForeign() || obj->IsBreakPointInfo();
 }
 
-class Checksum {
- public:
-  explicit Checksum(Vector<const byte> payload) {
-#ifdef MEMORY_SANITIZER
-    // Computing the checksum includes padding bytes for objects like strings.
-    // Mark every object as initialized in the code serializer.
-    MSAN_MEMORY_IS_INITIALIZED(payload.start(), payload.length());
-#endif  // MEMORY_SANITIZER
-    // Fletcher's checksum. Modified to reduce 64-bit sums to 32-bit.
-    uintptr_t a = 1;
-    uintptr_t b = 0;
-    const uintptr_t* cur = reinterpret_cast<const uintptr_t*>(payload.start());
-    DCHECK(IsAligned(payload.length(), kIntptrSize));
-    const uintptr_t* end = cur + payload.length() / kIntptrSize;
-    while (cur < end) {
-      // Unsigned overflow expected and intended.
-      a += *cur++;
-      b += a;
-    }
-#if V8_HOST_ARCH_64_BIT
-    a ^= a >> 32;
-    b ^= b >> 32;
-#endif  // V8_HOST_ARCH_64_BIT
-    a_ = static_cast<uint32_t>(a);
-    b_ = static_cast<uint32_t>(b);
-  }
-
-  bool Check(uint32_t a, uint32_t b) const { return a == a_ && b == b_; }
-
-  uint32_t a() const { return a_; }
-  uint32_t b() const { return b_; }
-
- private:
-  uint32_t a_;
-  uint32_t b_;
-
-  DISALLOW_COPY_AND_ASSIGN(Checksum);
-};
-
 SerializedCodeData::SerializedCodeData(const List<byte>* payload,
                                        const CodeSerializer* cs) {
   DisallowHeapAllocation no_gc;
@@ -387,6 +379,7 @@ SerializedCodeData::SerializedCodeData(const List<byte>* payload,
   SetHeaderValue(kNumReservationsOffset, reservations.length());
   SetHeaderValue(kNumCodeStubKeysOffset, num_stub_keys);
   SetHeaderValue(kPayloadLengthOffset, payload->length());
+  SetHeaderValue(kRecipeLengthOffset, 0);
 
   // Zero out any padding in the header.
   memset(data_ + kUnalignedHeaderSize, 0, kHeaderSize - kUnalignedHeaderSize);
@@ -424,6 +417,7 @@ SerializedCodeData::SanityCheckResult SerializedCodeData::SanityCheck(
   uint32_t cpu_features = GetHeaderValue(kCpuFeaturesOffset);
   uint32_t flags_hash = GetHeaderValue(kFlagHashOffset);
   uint32_t payload_length = GetHeaderValue(kPayloadLengthOffset);
+  uint32_t recipe_length = GetHeaderValue(kRecipeLengthOffset);
   uint32_t c1 = GetHeaderValue(kChecksum1Offset);
   uint32_t c2 = GetHeaderValue(kChecksum2Offset);
   if (version_hash != Version::Hash()) return VERSION_MISMATCH;
@@ -438,6 +432,10 @@ SerializedCodeData::SanityCheckResult SerializedCodeData::SanityCheck(
                          GetHeaderValue(kNumReservationsOffset) * kInt32Size +
                          GetHeaderValue(kNumCodeStubKeysOffset) * kInt32Size);
   if (payload_length > max_payload_length) return LENGTH_MISMATCH;
+  if (recipe_length > max_payload_length - payload_length ||
+      !IsAligned(payload_length, kPointerAlignment)) {
+    return LENGTH_MISMATCH;
+  }
   if (!Checksum(DataWithoutHeader()).Check(c1, c2)) return CHECKSUM_MISMATCH;
   return CHECK_SUCCESS;
 }
@@ -471,10 +469,38 @@ Vector<const byte> SerializedCodeData::Payload() const {
   const byte* payload = data_ + padded_payload_offset;
   DCHECK(IsAligned(reinterpret_cast<intptr_t>(payload), kPointerAlignment));
   int length = GetHeaderValue(kPayloadLengthOffset);
-  DCHECK_EQ(data_ + size_, payload + length);
+  DCHECK_EQ(data_ + size_,
+            payload + length + GetHeaderValue(kRecipeLengthOffset));
   return Vector<const byte>(payload, length);
 }
 
+Vector<const byte> SerializedCodeData::Recipe() const {
+  Vector<const byte> payload = Payload();
+  const byte* recipe = payload.start() + payload.length();
+  DCHECK(IsAligned(reinterpret_cast<intptr_t>(recipe), kPointerAlignment));
+  return Vector<const byte>(recipe, GetHeaderValue(kRecipeLengthOffset));
+}
+
+SerializedCodeData::SerializedCodeData(const SerializedCodeData& code,
+                                       Vector<const byte> recipe) {
+  DisallowHeapAllocation no_gc;
+  DCHECK(IsAligned(recipe.length(), kPointerAlignment));
+  Vector<const byte> payload = code.Payload();
+  int code_size = static_cast<int>(payload.start() + payload.length() -
+                                   code.data_);
+  AllocateData(code_size + recipe.length());
+
+  // Copy the code without any previous recipe and append the new one.
+  CopyBytes(data_, code.data_, static_cast<size_t>(code_size));
+  CopyBytes(data_ + code_size, recipe.start(),
+            static_cast<size_t>(recipe.length()));
+  SetHeaderValue(kRecipeLengthOffset, recipe.length());
+
+  Checksum checksum(DataWithoutHeader());
+  SetHeaderValue(kChecksum1Offset, checksum.a());
+  SetHeaderValue(kChecksum2Offset, checksum.b());
+}
+
 Vector<const uint32_t> SerializedCodeData::CodeStubKeys() const {
   int reservations_size = GetHeaderValue(kNumReservationsOffset) * kInt32Size;
   const byte* start = data_ + kHeaderSize + reservations_size;
@@ -22,6 +22,14 @@ class CodeSerializer : public Serializer {
   MUST_USE_RESULT static MaybeHandle<SharedFunctionInfo> Deserialize(
       Isolate* isolate, ScriptData* cached_data, Handle<String> source);
 
+  // Returns a copy of the code cache |cached_data| for |script| that carries
+  // the feedback collected for the script so far as a recipe for optimizing
+  // its functions. Returns nullptr if |cached_data| was rejected.
+  static ScriptData* AttachOptimizationRecipe(Isolate* isolate,
+                                              ScriptData* cached_data,
+                                              Handle<Script> script,
+                                              Handle<String> source);
+
   const List<uint32_t>* stub_keys() const { return &stub_keys_; }
 
   uint32_t source_hash() const { return source_hash_; }
@@ -99,18 +107,21 @@ class SerializedCodeData : public SerializedData {
   // [6] number of code stub keys
   // [7] number of reservation size entries
   // [8] payload length
-  // [9] payload checksum part 1
-  // [10] payload checksum part 2
+  // [9] optimization recipe length
+  // [10] payload checksum part 1
+  // [11] payload checksum part 2
   // ...  reservations
   // ...  code stub keys
   // ...  serialized payload
+  // ...  optimization recipe, see FeedbackSerializer
   static const int kSourceHashOffset = kVersionHashOffset + kInt32Size;
   static const int kCpuFeaturesOffset = kSourceHashOffset + kInt32Size;
   static const int kFlagHashOffset = kCpuFeaturesOffset + kInt32Size;
   static const int kNumReservationsOffset = kFlagHashOffset + kInt32Size;
   static const int kNumCodeStubKeysOffset = kNumReservationsOffset + kInt32Size;
   static const int kPayloadLengthOffset = kNumCodeStubKeysOffset + kInt32Size;
-  static const int kChecksum1Offset = kPayloadLengthOffset + kInt32Size;
+  static const int kRecipeLengthOffset = kPayloadLengthOffset + kInt32Size;
+  static const int kChecksum1Offset = kRecipeLengthOffset + kInt32Size;
   static const int kChecksum2Offset = kChecksum1Offset + kInt32Size;
   static const int kUnalignedHeaderSize = kChecksum2Offset + kInt32Size;
   static const int kHeaderSize = POINTER_SIZE_ALIGN(kUnalignedHeaderSize);
@@ -124,11 +135,15 @@ class SerializedCodeData : public SerializedData {
   // Used when producing.
   SerializedCodeData(const List<byte>* payload, const CodeSerializer* cs);
 
+  // Used when attaching an optimization recipe.
+  SerializedCodeData(const SerializedCodeData& code, Vector<const byte> recipe);
+
   // Return ScriptData object and relinquish ownership over it to the caller.
   ScriptData* GetScriptData();
 
   Vector<const Reservation> Reservations() const;
   Vector<const byte> Payload() const;
+  Vector<const byte> Recipe() const;
 
   Vector<const uint32_t> CodeStubKeys() const;
 
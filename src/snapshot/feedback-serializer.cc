@@ -0,0 +1,473 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/snapshot/feedback-serializer.h"
+
+#include "src/feedback-vector-inl.h"
+#include "src/heap/heap.h"
+#include "src/objects-inl.h"
+#include "src/version.h"
+
+namespace v8 {
+namespace internal {
+
+namespace {
+
+// Every function is serialized as a record of uint32_t-sized entries:
+// [0] start position
+// [1] end position
+// [2] feedback slot count
+// [3] invocation count
+// [4] deoptimization count
+// [5] optimization state, see below
+// [6] number of slot entries
+// ...  slot entries, two words each: the slot header and the value
+enum FunctionRecord {
+  kStartPositionIndex,
+  kEndPositionIndex,
+  kSlotCountIndex,
+  kInvocationCountIndex,
+  kDeoptCountIndex,
+  kOptimizationStateIndex,
+  kNumEntriesIndex,
+  kFunctionRecordSize
+};
+
+class WasOptimizedBit : public BitField<bool, 0, 1> {};
+class OptimizationDisabledBit : public BitField<bool, 1, 1> {};
+class DisableReasonBits : public BitField<int, 2, 16> {};
+class SelfContainedBit : public BitField<bool, 18, 1> {};
+
+class EntrySlotBits : public BitField<int, 0, 23> {};
+class EntryKindBits : public BitField<FeedbackSlotKind, 23, 8> {};
+class EntryMegamorphicBit : public BitField<bool, 31, 1> {};
+
+static const int kEntrySize = 2;
+
+void AddEntry(List<uint32_t>* payload, FeedbackSlot slot,
+              FeedbackSlotKind kind, bool megamorphic, int value) {
+  payload->Add(EntrySlotBits::encode(slot.ToInt()) |
+               EntryKindBits::encode(kind) |
+               EntryMegamorphicBit::encode(megamorphic));
+  payload->Add(static_cast<uint32_t>(value));
+}
+
+int SmiValueOf(Object* value) {
+  return value->IsSmi() ? Smi::cast(value)->value() : 0;
+}
+
+// Appends the persistable feedback of |vector| to |payload| and returns the
+// number of entries. Clears |self_contained| if some of the collected
+// feedback can't be persisted.
+int SerializeSlots(Isolate* isolate, FeedbackVector* vector,
+                   List<uint32_t>* payload, bool* self_contained) {
+  int num_entries = 0;
+  *self_contained = true;
+  for (int i = 0; i < vector->slot_count();) {
+    FeedbackSlot slot(i);
+    FeedbackSlotKind kind = vector->GetKind(slot);
+    switch (kind) {
+      case FeedbackSlotKind::kBinaryOp:
+      case FeedbackSlotKind::kCompareOp:
+      case FeedbackSlotKind::kToBoolean: {
+        int hint = SmiValueOf(vector->Get(slot));
+        if (hint != 0) {
+          AddEntry(payload, slot, kind, false, hint);
+          num_entries++;
+        }
+        break;
+      }
+      case FeedbackSlotKind::kCall: {
+        bool megamorphic =
+            vector->Get(slot) == isolate->heap()->megamorphic_symbol();
+        int count = SmiValueOf(vector->Get(FeedbackSlot(i + 1)));
+        if (megamorphic || count > 0) {
+          AddEntry(payload, slot, kind, megamorphic, count);
+          num_entries++;
+        }
+        break;
+      }
+      case FeedbackSlotKind::kLoadProperty:
+      case FeedbackSlotKind::kLoadKeyed:
+      case FeedbackSlotKind::kStoreNamedSloppy:
+      case FeedbackSlotKind::kStoreNamedStrict:
+      case FeedbackSlotKind::kStoreOwnNamed:
+      case FeedbackSlotKind::kStoreKeyedSloppy:
+      case FeedbackSlotKind::kStoreKeyedStrict:
+      case FeedbackSlotKind::kStoreDataPropertyInLiteral:
+      case FeedbackSlotKind::kGeneral:
+        // Property access feedback refers to maps, which can't be persisted.
+        // Optimized code would deoptimize on such accesses without it.
+        if (vector->Get(slot) != isolate->heap()->uninitialized_symbol()) {
+          *self_contained = false;
+        }
+        break;
+      default:
+        // Global accesses, literals and closures don't need feedback to be
+        // optimized.
+        break;
+    }
+    i += FeedbackMetadata::GetSlotSize(kind);
+  }
+  return num_entries;
+}
+
+// Unlike SerializedCodeData::SourceHash, which only covers the length of
+// the source, this hashes all characters. Feedback is keyed by source
+// positions, so it must not be applied to a different source of the same
+// length.
+uint32_t SourceHash(Handle<String> source) {
+  source = String::Flatten(source);
+  DisallowHeapAllocation no_gc;
+  String::FlatContent content = source->GetFlatContent();
+  uint32_t hash = static_cast<uint32_t>(source->length());
+  if (content.IsOneByte()) {
+    Vector<const uint8_t> chars = content.ToOneByteVector();
+    hash = StringHasher::ComputeRunningHashOneByte(
+        hash, reinterpret_cast<const char*>(chars.start()), chars.length());
+  } else {
+    Vector<const uc16> chars = content.ToUC16Vector();
+    hash = StringHasher::ComputeRunningHash(hash, chars.start(),
+                                            chars.length());
+  }
+  return StringHasher::GetHashCore(hash);
+}
+
+}  // namespace
+
+ScriptData* FeedbackSerializer::Serialize(Isolate* isolate,
+                                          Handle<Script> script,
+                                          Handle<String> source) {
+  base::ElapsedTimer timer;
+  if (FLAG_profile_deserialization) timer.Start();
+
+  uint32_t source_hash = SourceHash(source);
+  HeapIterator iterator(isolate->heap());
+  DisallowHeapAllocation no_gc;
+
+  // Pick one closure per function. The one that was invoked most often has
+  // the most representative feedback.
+  std::map<int, JSFunction*> functions;
+  for (HeapObject* obj = iterator.next(); obj != NULL; obj = iterator.next()) {
+    if (!obj->IsJSFunction()) continue;
+    JSFunction* function = JSFunction::cast(obj);
+    if (function->shared()->script() != *script) continue;
+    if (!function->has_feedback_vector()) continue;
+    int position = function->shared()->start_position();
+    auto it = functions.find(position);
+    if (it == functions.end() ||
+        it->second->feedback_vector()->invocation_count() <
+            function->feedback_vector()->invocation_count()) {
+      functions[position] = function;
+    }
+  }
+
+  List<uint32_t> payload;
+  for (auto const& entry : functions) {
+    JSFunction* function = entry.second;
+    SharedFunctionInfo* shared = function->shared();
+    FeedbackVector* vector = function->feedback_vector();
+    bool was_optimized = function->IsOptimized() || shared->opt_count() > 0;
+    bool self_contained = false;
+    payload.Add(shared->start_position());
+    payload.Add(shared->end_position());
+    payload.Add(vector->slot_count());
+    payload.Add(vector->invocation_count());
+    payload.Add(shared->deopt_count());
+    payload.Add(WasOptimizedBit::encode(was_optimized) |
+                OptimizationDisabledBit::encode(
+                    shared->optimization_disabled()) |
+                DisableReasonBits::encode(
+                    shared->optimization_disabled()
+                        ? shared->disable_optimization_reason()
+                        : kNoReason));
+    int state_index = payload.length() - 1;
+    int num_entries_index = payload.length();
+    payload.Add(0);
+    payload[num_entries_index] =
+        SerializeSlots(isolate, vector, &payload, &self_contained);
+    payload[state_index] |= SelfContainedBit::encode(self_contained);
+  }
+
+  SerializedFeedbackData data(isolate, source_hash,
+                              static_cast<int>(functions.size()), &payload);
+  ScriptData* result = data.GetScriptData();
+
+  if (FLAG_profile_deserialization) {
+    double ms = timer.Elapsed().InMillisecondsF();
+    PrintF("[Serializing feedback of %d functions to %d bytes took %0.3f ms]\n",
+           static_cast<int>(functions.size()), result->length(), ms);
+  }
+  return result;
+}
+
+bool FeedbackSerializer::Deserialize(Isolate* isolate, ScriptData* cached_data,
+                                     Handle<Script> script,
+                                     Handle<String> source,
+                                     bool optimize_on_first_call,
+                                     bool seed_closures) {
+  base::ElapsedTimer timer;
+  if (FLAG_profile_deserialization) timer.Start();
+
+  uint32_t source_hash = SourceHash(source);
+  ImportedFeedback::Functions functions;
+  {
+    SerializedFeedbackData data(cached_data);
+    SerializedFeedbackData::SanityCheckResult sanity_check_result =
+        data.SanityCheck(isolate, source_hash);
+    Vector<const uint32_t> payload = data.Payload();
+    int index = 0;
+    for (int i = 0;
+         sanity_check_result == SerializedFeedbackData::CHECK_SUCCESS &&
+         i < data.NumFunctions();
+         i++) {
+      if (index + kFunctionRecordSize > payload.length()) {
+        sanity_check_result = SerializedFeedbackData::LENGTH_MISMATCH;
+        break;
+      }
+      const uint32_t* record = &payload[index];
+      uint32_t num_entries = record[kNumEntriesIndex];
+      if (num_entries > static_cast<uint32_t>(payload.length() - index -
+                                              kFunctionRecordSize) /
+                            kEntrySize) {
+        sanity_check_result = SerializedFeedbackData::LENGTH_MISMATCH;
+        break;
+      }
+      int record_size =
+          kFunctionRecordSize + static_cast<int>(num_entries) * kEntrySize;
+      uint32_t state = record[kOptimizationStateIndex];
+      ImportedFeedback::Function& function =
+          functions[record[kStartPositionIndex]];
+      function.end_position = record[kEndPositionIndex];
+      function.slot_count = record[kSlotCountIndex];
+      function.invocation_count = record[kInvocationCountIndex];
+      function.deopt_count = record[kDeoptCountIndex];
+      function.was_optimized = WasOptimizedBit::decode(state);
+      function.self_contained = SelfContainedBit::decode(state);
+      function.optimization_disabled = OptimizationDisabledBit::decode(state);
+      function.disable_reason = DisableReasonBits::decode(state);
+      if (function.disable_reason >= kLastErrorMessage) {
+        sanity_check_result = SerializedFeedbackData::INVALID_HEADER;
+        break;
+      }
+      function.entries.assign(record + kFunctionRecordSize,
+                              record + record_size);
+      index += record_size;
+    }
+    if (sanity_check_result != SerializedFeedbackData::CHECK_SUCCESS) {
+      if (FLAG_profile_deserialization) {
+        PrintF("[Rejecting feedback cache, reason: %d]\n",
+               sanity_check_result);
+      }
+      cached_data->Reject();
+      return false;
+    }
+  }
+
+  int num_functions = static_cast<int>(functions.size());
+  ImportedFeedback* imported_feedback = isolate->imported_feedback();
+  imported_feedback->Add(script->id(), &functions, optimize_on_first_call);
+
+  // Seed the closures of the script that already have a feedback vector.
+  std::vector<Handle<FeedbackVector>> vectors;
+  if (seed_closures) {
+    HeapIterator iterator(isolate->heap());
+    DisallowHeapAllocation no_gc;
+    for (HeapObject* obj = iterator.next(); obj != NULL;
+         obj = iterator.next()) {
+      if (!obj->IsJSFunction()) continue;
+      JSFunction* function = JSFunction::cast(obj);
+      if (function->shared()->script() != *script) continue;
+      if (!function->has_feedback_vector()) continue;
+      vectors.push_back(handle(function->feedback_vector(), isolate));
+    }
+  }
+  for (Handle<FeedbackVector> vector : vectors) {
+    imported_feedback->Apply(*vector);
+  }
+
+  if (FLAG_profile_deserialization) {
+    double ms = timer.Elapsed().InMillisecondsF();
+    PrintF("[Importing feedback of %d functions took %0.3f ms]\n",
+           num_functions, ms);
+  }
+  return true;
+}
+
+void ImportedFeedback::Add(int script_id, Functions* functions,
+                           bool optimize_on_first_call) {
+  ScriptFeedback& script = scripts_[script_id];
+  script.functions.swap(*functions);
+  script.optimize_on_first_call = optimize_on_first_call;
+}
+
+const ImportedFeedback::ScriptFeedback* ImportedFeedback::LookupScript(
+    SharedFunctionInfo* shared) const {
+  if (!shared->script()->IsScript()) return nullptr;
+  auto script = scripts_.find(Script::cast(shared->script())->id());
+  if (script == scripts_.end()) return nullptr;
+  return &script->second;
+}
+
+const ImportedFeedback::Function* ImportedFeedback::Lookup(
+    SharedFunctionInfo* shared) const {
+  const ScriptFeedback* script = LookupScript(shared);
+  if (script == nullptr) return nullptr;
+  auto function = script->functions.find(shared->start_position());
+  if (function == script->functions.end()) return nullptr;
+  if (function->second.end_position != shared->end_position()) return nullptr;
+  return &function->second;
+}
+
+bool ImportedFeedback::WasOptimized(SharedFunctionInfo* shared) const {
+  const Function* function = Lookup(shared);
+  return function != nullptr && function->was_optimized &&
+         function->self_contained;
+}
+
+bool ImportedFeedback::ShouldOptimizeOnFirstCall(
+    SharedFunctionInfo* shared) const {
+  const ScriptFeedback* script = LookupScript(shared);
+  if (script == nullptr || !script->optimize_on_first_call) return false;
+  const Function* function = Lookup(shared);
+  return function != nullptr && function->was_optimized &&
+         function->self_contained;
+}
+
+void ImportedFeedback::Apply(FeedbackVector* vector) {
+  SharedFunctionInfo* shared = vector->shared_function_info();
+  const Function* function = Lookup(shared);
+  if (function == nullptr) return;
+  // The function was changed since the feedback was recorded.
+  if (function->slot_count != vector->slot_count()) return;
+
+  // Feedback only ever moves towards more general states, so the imported
+  // state is merged into the state that was already collected.
+  if (function->invocation_count > vector->invocation_count()) {
+    vector->set(FeedbackVector::kInvocationCountIndex,
+                Smi::FromInt(function->invocation_count));
+  }
+  for (size_t i = 0; i < function->entries.size(); i += kEntrySize) {
+    uint32_t header = function->entries[i];
+    int value = static_cast<int>(function->entries[i + 1]);
+    FeedbackSlot slot(EntrySlotBits::decode(header));
+    FeedbackSlotKind kind = EntryKindBits::decode(header);
+    if (slot.ToInt() >= vector->slot_count() || vector->GetKind(slot) != kind) {
+      continue;
+    }
+    switch (kind) {
+      case FeedbackSlotKind::kBinaryOp:
+      case FeedbackSlotKind::kCompareOp:
+      case FeedbackSlotKind::kToBoolean:
+        vector->Set(slot, Smi::FromInt(SmiValueOf(vector->Get(slot)) | value),
+                    SKIP_WRITE_BARRIER);
+        break;
+      case FeedbackSlotKind::kCall: {
+        FeedbackSlot count_slot(slot.ToInt() + 1);
+        if (value > SmiValueOf(vector->Get(count_slot))) {
+          vector->Set(count_slot, Smi::FromInt(value), SKIP_WRITE_BARRIER);
+        }
+        if (EntryMegamorphicBit::decode(header)) {
+          vector->Set(slot, vector->GetHeap()->megamorphic_symbol(),
+                      SKIP_WRITE_BARRIER);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  if (function->deopt_count > shared->deopt_count()) {
+    shared->set_deopt_count(function->deopt_count);
+  }
+  if (function->optimization_disabled && !shared->optimization_disabled()) {
+    shared->DisableOptimization(
+        static_cast<BailoutReason>(function->disable_reason));
+  }
+}
+
+SerializedFeedbackData::SerializedFeedbackData(ScriptData* data)
+    : SerializedData(const_cast<byte*>(data->data()), data->length()) {}
+
+SerializedFeedbackData::SerializedFeedbackData(Isolate* isolate,
+                                               uint32_t source_hash,
+                                               int num_functions,
+                                               const List<uint32_t>* payload) {
+  DisallowHeapAllocation no_gc;
+  int payload_length = payload->length() * kInt32Size;
+  int padded_payload_length = POINTER_SIZE_ALIGN(payload_length);
+  int size = kHeaderSize + padded_payload_length;
+
+  // Allocate backing store and create result data.
+  AllocateData(size);
+
+  // Set header values.
+  SetMagicNumber(isolate);
+  SetHeaderValue(kVersionHashOffset, Version::Hash());
+  SetHeaderValue(kSourceHashOffset, source_hash);
+  SetHeaderValue(kFlagHashOffset, FlagList::Hash());
+  SetHeaderValue(kNumFunctionsOffset, num_functions);
+  SetHeaderValue(kPayloadLengthOffset, payload_length);
+
+  // Zero out any padding in the header and after the payload.
+  memset(data_ + kUnalignedHeaderSize, 0, kHeaderSize - kUnalignedHeaderSize);
+  memset(data_ + kHeaderSize + payload_length, 0,
+         padded_payload_length - payload_length);
+
+  // Copy serialized data.
+  CopyBytes(data_ + kHeaderSize,
+            reinterpret_cast<const byte*>(payload->begin()),
+            static_cast<size_t>(payload_length));
+
+  Checksum checksum(DataWithoutHeader());
+  SetHeaderValue(kChecksum1Offset, checksum.a());
+  SetHeaderValue(kChecksum2Offset, checksum.b());
+}
+
+SerializedFeedbackData::SanityCheckResult SerializedFeedbackData::SanityCheck(
+    Isolate* isolate, uint32_t expected_source_hash) const {
+  if (this->size_ < kHeaderSize) return INVALID_HEADER;
+  if (!IsAligned(this->size_, kPointerAlignment)) return INVALID_HEADER;
+  uint32_t magic_number = GetMagicNumber();
+  if (magic_number != ComputeMagicNumber(isolate)) return MAGIC_NUMBER_MISMATCH;
+  if (GetExtraReferences() > GetExtraReferences(isolate)) {
+    return MAGIC_NUMBER_MISMATCH;
+  }
+  uint32_t version_hash = GetHeaderValue(kVersionHashOffset);
+  uint32_t source_hash = GetHeaderValue(kSourceHashOffset);
+  uint32_t flags_hash = GetHeaderValue(kFlagHashOffset);
+  uint32_t payload_length = GetHeaderValue(kPayloadLengthOffset);
+  uint32_t c1 = GetHeaderValue(kChecksum1Offset);
+  uint32_t c2 = GetHeaderValue(kChecksum2Offset);
+  if (version_hash != Version::Hash()) return VERSION_MISMATCH;
+  if (source_hash != expected_source_hash) return SOURCE_MISMATCH;
+  if (flags_hash != FlagList::Hash()) return FLAGS_MISMATCH;
+  if (payload_length > static_cast<uint32_t>(this->size_ - kHeaderSize) ||
+      !IsAligned(payload_length, kInt32Size)) {
+    return LENGTH_MISMATCH;
+  }
+  if (!Checksum(DataWithoutHeader()).Check(c1, c2)) return CHECKSUM_MISMATCH;
+  return CHECK_SUCCESS;
+}
+
+// Return ScriptData object and relinquish ownership over it to the caller.
+ScriptData* SerializedFeedbackData::GetScriptData() {
+  DCHECK(owns_data_);
+  ScriptData* result = new ScriptData(data_, size_);
+  result->AcquireDataOwnership();
+  owns_data_ = false;
+  data_ = NULL;
+  return result;
+}
+
+Vector<const uint32_t> SerializedFeedbackData::Payload() const {
+  if (this->size_ < kHeaderSize) return Vector<const uint32_t>();
+  return Vector<const uint32_t>(
+      reinterpret_cast<const uint32_t*>(data_ + kHeaderSize),
+      GetHeaderValue(kPayloadLengthOffset) / kInt32Size);
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,175 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_SNAPSHOT_FEEDBACK_SERIALIZER_H_
+#define V8_SNAPSHOT_FEEDBACK_SERIALIZER_H_
+
+#include <map>
+#include <vector>
+
+#include "src/handles.h"
+#include "src/parsing/preparse-data.h"
+#include "src/snapshot/serializer-common.h"
+
+namespace v8 {
+namespace internal {
+
+class FeedbackVector;
+class Script;
+class SharedFunctionInfo;
+
+// Serializes the type feedback, invocation counts and optimization decisions
+// that were collected for the functions of a script, so that they can be
+// imported when the same script runs again in another process. Functions are
+// keyed by their source position.
+//
+// Only feedback that does not refer to heap objects is persisted, i.e. the
+// binary operation, compare operation and to-boolean hints, call counts and
+// megamorphic call sites. Maps, weak cells and allocation sites are dropped.
+class FeedbackSerializer {
+ public:
+  static ScriptData* Serialize(Isolate* isolate, Handle<Script> script,
+                               Handle<String> source);
+
+  // Imports the feedback in |cached_data| for |script|. Returns false and
+  // rejects |cached_data| if it was produced for a different source, V8
+  // version or flags. If |optimize_on_first_call| is set, the functions that
+  // were optimized based on persisted feedback only are optimized on their
+  // first call, see ImportedFeedback::ShouldOptimizeOnFirstCall. If
+  // |seed_closures| is set, the heap is searched for closures of |script|
+  // that already have a feedback vector, which is only needed if the script
+  // may have run before.
+  static bool Deserialize(Isolate* isolate, ScriptData* cached_data,
+                          Handle<Script> script, Handle<String> source,
+                          bool optimize_on_first_call, bool seed_closures);
+};
+
+// The feedback imported for the functions of scripts, which is applied to
+// their feedback vectors as they are created.
+class ImportedFeedback {
+ public:
+  // The imported state of a single function.
+  struct Function {
+    Function()
+        : end_position(0),
+          slot_count(0),
+          invocation_count(0),
+          deopt_count(0),
+          was_optimized(false),
+          self_contained(false),
+          optimization_disabled(false),
+          disable_reason(0) {}
+
+    int end_position;
+    int slot_count;
+    int invocation_count;
+    int deopt_count;
+    bool was_optimized;
+    // True if all feedback of the function was persisted, i.e. optimized code
+    // that is built from the imported feedback doesn't depend on maps or
+    // other objects of the heap.
+    bool self_contained;
+    bool optimization_disabled;
+    int disable_reason;
+    // Encoded slot entries, see FeedbackSerializer.
+    std::vector<uint32_t> entries;
+  };
+
+  typedef std::map<int, Function> Functions;
+
+  ImportedFeedback() {}
+
+  bool is_empty() const { return scripts_.empty(); }
+
+  // Replaces the imported feedback for the script with the given id.
+  void Add(int script_id, Functions* functions, bool optimize_on_first_call);
+
+  // Seeds |vector| with the feedback imported for its function, if any.
+  void Apply(FeedbackVector* vector);
+
+  // Returns true if |shared| was optimized in the run that recorded its
+  // feedback and all of that feedback could be imported. Optimizing other
+  // functions early would only lead to deoptimizations.
+  bool WasOptimized(SharedFunctionInfo* shared) const;
+
+  // Returns true if closures of |shared| should be optimized on their first
+  // call. This is the case for self-contained functions that were optimized
+  // in the recorded run, if the feedback was imported as the optimization
+  // recipe of a code cache.
+  bool ShouldOptimizeOnFirstCall(SharedFunctionInfo* shared) const;
+
+ private:
+  struct ScriptFeedback {
+    ScriptFeedback() : optimize_on_first_call(false) {}
+
+    Functions functions;
+    bool optimize_on_first_call;
+  };
+
+  const ScriptFeedback* LookupScript(SharedFunctionInfo* shared) const;
+  const Function* Lookup(SharedFunctionInfo* shared) const;
+
+  std::map<int, ScriptFeedback> scripts_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImportedFeedback);
+};
+
+class SerializedFeedbackData : public SerializedData {
+ public:
+  enum SanityCheckResult {
+    CHECK_SUCCESS = 0,
+    MAGIC_NUMBER_MISMATCH = 1,
+    VERSION_MISMATCH = 2,
+    SOURCE_MISMATCH = 3,
+    FLAGS_MISMATCH = 4,
+    CHECKSUM_MISMATCH = 5,
+    INVALID_HEADER = 6,
+    LENGTH_MISMATCH = 7
+  };
+
+  // The data header consists of uint32_t-sized entries:
+  // [0] magic number and (internally provided) external reference count
+  // [1] extra (API-provided) external reference count
+  // [2] version hash
+  // [3] source hash
+  // [4] flag hash
+  // [5] number of functions
+  // [6] payload length in bytes
+  // [7] payload checksum part 1
+  // [8] payload checksum part 2
+  // ...  serialized payload
+  static const int kSourceHashOffset = kVersionHashOffset + kInt32Size;
+  static const int kFlagHashOffset = kSourceHashOffset + kInt32Size;
+  static const int kNumFunctionsOffset = kFlagHashOffset + kInt32Size;
+  static const int kPayloadLengthOffset = kNumFunctionsOffset + kInt32Size;
+  static const int kChecksum1Offset = kPayloadLengthOffset + kInt32Size;
+  static const int kChecksum2Offset = kChecksum1Offset + kInt32Size;
+  static const int kUnalignedHeaderSize = kChecksum2Offset + kInt32Size;
+  static const int kHeaderSize = POINTER_SIZE_ALIGN(kUnalignedHeaderSize);
+
+  // Used when consuming.
+  explicit SerializedFeedbackData(ScriptData* data);
+  SanityCheckResult SanityCheck(Isolate* isolate,
+                                uint32_t expected_source_hash) const;
+
+  // Used when producing.
+  SerializedFeedbackData(Isolate* isolate, uint32_t source_hash,
+                         int num_functions, const List<uint32_t>* payload);
+
+  // Return ScriptData object and relinquish ownership over it to the caller.
+  ScriptData* GetScriptData();
+
+  int NumFunctions() const { return GetHeaderValue(kNumFunctionsOffset); }
+  Vector<const uint32_t> Payload() const;
+
+ private:
+  Vector<const byte> DataWithoutHeader() const {
+    return Vector<const byte>(data_ + kHeaderSize, size_ - kHeaderSize);
+  }
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_SNAPSHOT_FEEDBACK_SERIALIZER_H_
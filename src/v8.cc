@@ -61,6 +61,12 @@ void V8::InitializeOncePerProcessImpl() {
     FLAG_random_seed = 12347;
   }
 
+#ifndef V8_CONCURRENT_MARKING
+  // Without the build flag the main thread uses non-atomic mark bit
+  // operations that race with concurrent marking tasks.
+  FLAG_concurrent_marking = false;
+#endif
+
   if (FLAG_stress_compaction) {
     FLAG_force_marking_deque_overflows = true;
     FLAG_gc_global = true;
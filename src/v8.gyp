@@ -690,10 +690,14 @@
         'compiler/load-elimination.h',
         'compiler/loop-analysis.cc',
         'compiler/loop-analysis.h',
+        'compiler/loop-bounds-check-elimination.cc',
+        'compiler/loop-bounds-check-elimination.h',
         'compiler/loop-peeling.cc',
         'compiler/loop-peeling.h',
         'compiler/loop-variable-optimizer.cc',
         'compiler/loop-variable-optimizer.h',
+        'compiler/loop-vectorization.cc',
+        'compiler/loop-vectorization.h',
         'compiler/machine-operator-reducer.cc',
         'compiler/machine-operator-reducer.h',
         'compiler/machine-operator.cc',
@@ -948,6 +952,8 @@
         'handles.cc',
         'handles.h',
         'heap-symbols.h',
+        'heap/array-buffer-collector.cc',
+        'heap/array-buffer-collector.h',
         'heap/array-buffer-tracker-inl.h',
         'heap/array-buffer-tracker.cc',
         'heap/array-buffer-tracker.h',
@@ -993,6 +999,7 @@
         'heap/spaces.h',
         'heap/store-buffer.cc',
         'heap/store-buffer.h',
+        'heap/worklist.h',
         'i18n.cc',
         'i18n.h',
         'icu_util.cc',
@@ -1265,6 +1272,8 @@
         'snapshot/code-serializer.h',
         'snapshot/deserializer.cc',
         'snapshot/deserializer.h',
+        'snapshot/feedback-serializer.cc',
+        'snapshot/feedback-serializer.h',
         'snapshot/natives.h',
         'snapshot/natives-common.cc',
         'snapshot/partial-serializer.cc',
@@ -30,8 +30,10 @@ void AccountingAllocator::MemoryPressureNotification(
     MemoryPressureLevel level) {
   memory_pressure_level_.SetValue(level);
 
-  if (level != MemoryPressureLevel::kNone) {
+  if (level == MemoryPressureLevel::kCritical) {
     ClearPool();
+  } else if (level == MemoryPressureLevel::kModerate) {
+    TrimPool();
   }
 }
 
@@ -62,15 +64,25 @@ void AccountingAllocator::ConfigureSegmentPool(const size_t max_pool_size) {
     if (total_size + (size_t(1) << (power + kMinSegmentSizePower)) <=
         max_pool_size) {
       unused_segments_max_sizes_[power] = fits_fully + 1;
-      total_size += size_t(1) << power;
+      total_size += size_t(1) << (power + kMinSegmentSizePower);
     } else {
       unused_segments_max_sizes_[power] = fits_fully;
     }
   }
 }
 
+size_t AccountingAllocator::RoundUpToSegmentSizeClass(size_t bytes) {
+  if (bytes > (static_cast<size_t>(1) << kMaxSegmentSizePower)) return bytes;
+  size_t power = kMinSegmentSizePower;
+  while (bytes > (static_cast<size_t>(1) << power)) power++;
+  return static_cast<size_t>(1) << power;
+}
+
 Segment* AccountingAllocator::GetSegment(size_t bytes) {
   Segment* result = GetSegmentFromPool(bytes);
+  if (bytes <= (static_cast<size_t>(1) << kMaxSegmentSizePower)) {
+    base::NoBarrier_AtomicIncrement(result ? &pool_hits_ : &pool_misses_, 1);
+  }
   if (result == nullptr) {
     result = AllocateSegment(bytes);
     if (result != nullptr) {
@@ -97,9 +109,7 @@ Segment* AccountingAllocator::AllocateSegment(size_t bytes) {
 void AccountingAllocator::ReturnSegment(Segment* segment) {
   segment->ZapContents();
 
-  if (memory_pressure_level_.Value() != MemoryPressureLevel::kNone) {
-    FreeSegment(segment);
-  } else if (!AddSegmentToPool(segment)) {
+  if (!AddSegmentToPool(segment)) {
     FreeSegment(segment);
   }
 }
@@ -123,6 +133,27 @@ size_t AccountingAllocator::GetCurrentPoolSize() const {
   return base::NoBarrier_Load(&current_pool_size_);
 }
 
+size_t AccountingAllocator::GetPoolHitCount() const {
+  return base::NoBarrier_Load(&pool_hits_);
+}
+
+size_t AccountingAllocator::GetPoolMissCount() const {
+  return base::NoBarrier_Load(&pool_misses_);
+}
+
+size_t AccountingAllocator::BucketCapacity(size_t bucket) const {
+  switch (memory_pressure_level_.Value()) {
+    case MemoryPressureLevel::kNone:
+      return unused_segments_max_sizes_[bucket];
+    case MemoryPressureLevel::kModerate:
+      return unused_segments_max_sizes_[bucket] / 2;
+    case MemoryPressureLevel::kCritical:
+      return 0;
+  }
+  UNREACHABLE();
+  return 0;
+}
+
 Segment* AccountingAllocator::GetSegmentFromPool(size_t requested_size) {
   if (requested_size > (1 << kMaxSegmentSizePower)) {
     return nullptr;
@@ -173,7 +204,7 @@ bool AccountingAllocator::AddSegmentToPool(Segment* segment) {
   {
     base::LockGuard<base::Mutex> lock_guard(&unused_segments_mutex_);
 
-    if (unused_segments_sizes_[power] >= unused_segments_max_sizes_[power]) {
+    if (unused_segments_sizes_[power] >= BucketCapacity(power)) {
       return false;
     }
 
@@ -186,6 +217,22 @@ bool AccountingAllocator::AddSegmentToPool(Segment* segment) {
   return true;
 }
 
+void AccountingAllocator::TrimPool() {
+  base::LockGuard<base::Mutex> lock_guard(&unused_segments_mutex_);
+
+  for (size_t power = 0; power < kNumberBuckets; power++) {
+    size_t capacity = BucketCapacity(power);
+    while (unused_segments_sizes_[power] > capacity) {
+      Segment* segment = unused_segments_heads_[power];
+      unused_segments_heads_[power] = segment->next();
+      unused_segments_sizes_[power]--;
+      base::NoBarrier_AtomicIncrement(
+          &current_pool_size_, -static_cast<base::AtomicWord>(segment->size()));
+      FreeSegment(segment);
+    }
+  }
+}
+
 void AccountingAllocator::ClearPool() {
   base::LockGuard<base::Mutex> lock_guard(&unused_segments_mutex_);
 
@@ -194,10 +241,13 @@ void AccountingAllocator::ClearPool() {
     Segment* current = unused_segments_heads_[power];
     while (current) {
       Segment* next = current->next();
+      base::NoBarrier_AtomicIncrement(
+          &current_pool_size_, -static_cast<base::AtomicWord>(current->size()));
       FreeSegment(current);
       current = next;
     }
     unused_segments_heads_[power] = nullptr;
+    unused_segments_sizes_[power] = 0;
   }
 }
 
@@ -39,6 +39,19 @@ class V8_EXPORT_PRIVATE AccountingAllocator {
 
   size_t GetCurrentPoolSize() const;
 
+  // Number of segment requests that were served from the pool and that had
+  // to be allocated, respectively. Only requests of poolable sizes count.
+  size_t GetPoolHitCount() const;
+  size_t GetPoolMissCount() const;
+
+  // Returns the size of the pool size class that fits |bytes|, or |bytes| if
+  // segments of that size are not pooled. Zones allocate segments in these
+  // sizes so that returned segments can serve later requests of other zones.
+  static size_t RoundUpToSegmentSizeClass(size_t bytes);
+
+  // Trims the pool to half its capacity under moderate memory pressure and
+  // releases all pooled segments under critical memory pressure. Until the
+  // pressure is gone, the pool does not grow beyond that size.
   void MemoryPressureNotification(MemoryPressureLevel level);
   // Configures the zone segment pool size limits so the pool does not
   // grow bigger than max_pool_size.
@@ -51,6 +64,7 @@ class V8_EXPORT_PRIVATE AccountingAllocator {
 
  private:
   FRIEND_TEST(Zone, SegmentPoolConstraints);
+  FRIEND_TEST(Zone, SegmentPoolMemoryPressure);
 
   static const size_t kMinSegmentSizePower = 13;
   static const size_t kMaxSegmentSizePower = 18;
@@ -69,6 +83,14 @@ class V8_EXPORT_PRIVATE AccountingAllocator {
   // Trys to add a segment to the pool. Returns false if the pool is full.
   bool AddSegmentToPool(Segment* segment);
 
+  // Returns the number of segments a bucket may hold at the current memory
+  // pressure level.
+  size_t BucketCapacity(size_t bucket) const;
+
+  // Releases pooled segments until every bucket holds at most as many
+  // segments as its capacity allows.
+  void TrimPool();
+
   // Empties the pool and puts all its contents onto the garbage stack.
   void ClearPool();
 
@@ -82,6 +104,8 @@ class V8_EXPORT_PRIVATE AccountingAllocator {
   base::AtomicWord current_memory_usage_ = 0;
   base::AtomicWord max_memory_usage_ = 0;
   base::AtomicWord current_pool_size_ = 0;
+  base::AtomicWord pool_hits_ = 0;
+  base::AtomicWord pool_misses_ = 0;
 
   base::AtomicValue<MemoryPressureLevel> memory_pressure_level_;
 
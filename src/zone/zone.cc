@@ -134,20 +134,19 @@ Address Zone::NewExpand(size_t size) {
              size);
 
   // Compute the new segment size. We use a 'high water mark'
-  // strategy, where we increase the segment size every time we expand
+  // strategy, where we double the segment size every time we expand
   // except that we employ a maximum segment size when we delete. This
   // is to avoid excessive malloc() and free() overhead.
   Segment* head = segment_head_;
   const size_t old_size = (head == nullptr) ? 0 : head->size();
   static const size_t kSegmentOverhead = sizeof(Segment) + kAlignmentInBytes;
-  const size_t new_size_no_overhead = size + (old_size << 1);
-  size_t new_size = kSegmentOverhead + new_size_no_overhead;
   const size_t min_new_size = kSegmentOverhead + size;
   // Guard against integer overflow.
-  if (new_size_no_overhead < size || new_size < kSegmentOverhead) {
+  if (min_new_size < size) {
     V8::FatalProcessOutOfMemory("Zone");
     return nullptr;
   }
+  size_t new_size = Max(min_new_size, old_size << 1);
   if (new_size < kMinimumSegmentSize) {
     new_size = kMinimumSegmentSize;
   } else if (new_size > kMaximumSegmentSize) {
@@ -157,6 +156,9 @@ Address Zone::NewExpand(size_t size) {
     // requested size.
     new_size = Max(min_new_size, kMaximumSegmentSize);
   }
+  // Use the size classes of the segment pool, so that segments released by
+  // other zones can be reused.
+  new_size = AccountingAllocator::RoundUpToSegmentSizeClass(new_size);
   if (new_size > INT_MAX) {
     V8::FatalProcessOutOfMemory("Zone");
     return nullptr;
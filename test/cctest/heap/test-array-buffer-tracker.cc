@@ -3,7 +3,9 @@
 // found in the LICENSE file.
 
 #include "src/api.h"
+#include "src/heap/array-buffer-collector.h"
 #include "src/heap/array-buffer-tracker.h"
+#include "src/heap/gc-tracer.h"
 #include "src/heap/spaces.h"
 #include "src/isolate.h"
 #include "src/objects-inl.h"
@@ -321,5 +323,53 @@ UNINITIALIZED_TEST(ArrayBuffer_SemiSpaceCopyMultipleTasks) {
   }
 }
 
+TEST(ArrayBuffer_FreeSynchronouslyAboveLimit) {
+  // Backing stores are released on the main thread if more than the limit are
+  // pending.
+  FLAG_array_buffer_freeing_limit_mb = 0;
+  CcTest::InitializeVM();
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  Heap* heap = reinterpret_cast<Isolate*>(isolate)->heap();
+
+  JSArrayBuffer* raw_ab = nullptr;
+  {
+    v8::HandleScope handle_scope(isolate);
+    Local<v8::ArrayBuffer> ab = v8::ArrayBuffer::New(isolate, 100);
+    Handle<JSArrayBuffer> buf = v8::Utils::OpenHandle(*ab);
+    CHECK(IsTracked(*buf));
+    raw_ab = *buf;
+  }
+  heap::GcAndSweep(heap, NEW_SPACE);
+  CHECK(!IsTracked(raw_ab));
+  CHECK_EQ(0u, heap->array_buffer_collector()->pending_bytes());
+}
+
+TEST(ArrayBuffer_FreeOnBackgroundThread) {
+  FLAG_concurrent_array_buffer_freeing = true;
+  CcTest::InitializeVM();
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  Heap* heap = reinterpret_cast<Isolate*>(isolate)->heap();
+  ArrayBufferCollector* collector = heap->array_buffer_collector();
+  collector->WaitForFreeingTasks();
+  const size_t freed_before = heap->tracer()->BackgroundFreedArrayBufferBytes();
+
+  const int kBuffers = 10;
+  const size_t kLength = 100;
+  {
+    v8::HandleScope handle_scope(isolate);
+    for (int i = 0; i < kBuffers; i++) {
+      v8::ArrayBuffer::New(isolate, kLength);
+    }
+  }
+  heap::GcAndSweep(heap, NEW_SPACE);
+  // The scavenge posts a task that frees the dead backing stores.
+  collector->WaitForFreeingTasks();
+  CHECK_EQ(0u, collector->pending_bytes());
+  CHECK_LE(freed_before + kBuffers * kLength,
+           heap->tracer()->BackgroundFreedArrayBufferBytes());
+}
+
 }  // namespace internal
 }  // namespace v8
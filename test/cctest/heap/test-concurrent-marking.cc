@@ -6,23 +6,196 @@
 
 #include "src/v8.h"
 
+#include "src/factory.h"
 #include "src/heap/concurrent-marking.h"
 #include "src/heap/heap-inl.h"
 #include "src/heap/heap.h"
+#include "src/heap/incremental-marking.h"
 #include "test/cctest/cctest.h"
 #include "test/cctest/heap/heap-utils.h"
 
 namespace v8 {
 namespace internal {
+
+static Handle<FixedArray> AllocateOldGraph(Isolate* isolate, int length) {
+  Factory* factory = isolate->factory();
+  Handle<FixedArray> root = factory->NewFixedArray(length, TENURED);
+  for (int i = 0; i < length; i++) {
+    Handle<FixedArray> inner = factory->NewFixedArray(2, TENURED);
+    inner->set(0, *factory->NewHeapNumber(i, IMMUTABLE, TENURED));
+    inner->set(1, *factory->NewStringFromAsciiChecked("concurrent", TENURED));
+    root->set(i, *inner);
+  }
+  return root;
+}
+
+static void CheckOldGraph(Handle<FixedArray> root) {
+  for (int i = 0; i < root->length(); i++) {
+    FixedArray* inner = FixedArray::cast(root->get(i));
+    CHECK_EQ(i, static_cast<int>(HeapNumber::cast(inner->get(0))->value()));
+    CHECK(
+        String::cast(inner->get(1))->IsUtf8EqualTo(CStrVector("concurrent")));
+  }
+}
+
 TEST(ConcurrentMarking) {
-  i::FLAG_concurrent_marking = true;
+  if (!i::FLAG_concurrent_marking) return;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Heap* heap = CcTest::heap();
+  HandleScope scope(isolate);
+  CcTest::CollectAllGarbage(i::Heap::kFinalizeIncrementalMarkingMask);
+  Handle<FixedArray> root = AllocateOldGraph(isolate, 1000);
+  heap::SimulateIncrementalMarking(heap, false);
+  ConcurrentMarking* concurrent_marking = heap->concurrent_marking();
+  concurrent_marking->ScheduleTasks();
+  concurrent_marking->Stop();
+  CcTest::CollectAllGarbage(i::Heap::kFinalizeIncrementalMarkingMask);
+  CHECK(!concurrent_marking->HasPendingWork());
+  CheckOldGraph(root);
+}
+
+TEST(ConcurrentMarkingPreemptAndReschedule) {
+  if (!i::FLAG_concurrent_marking) return;
   CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
   Heap* heap = CcTest::heap();
-  ConcurrentMarking* concurrent_marking = new ConcurrentMarking(heap);
-  concurrent_marking->AddRoot(heap->undefined_value());
-  concurrent_marking->StartMarkingTask();
-  concurrent_marking->WaitForTaskToComplete();
-  delete concurrent_marking;
+  HandleScope scope(isolate);
+  CcTest::CollectAllGarbage(i::Heap::kFinalizeIncrementalMarkingMask);
+  Handle<FixedArray> root = AllocateOldGraph(isolate, 1000);
+  heap::SimulateIncrementalMarking(heap, false);
+  ConcurrentMarking* concurrent_marking = heap->concurrent_marking();
+  for (int i = 0; i < 100; i++) {
+    concurrent_marking->ScheduleTasks();
+    concurrent_marking->Stop();
+  }
+  // Scavenges move objects on the worklists of the concurrent marker.
+  CcTest::CollectGarbage(NEW_SPACE);
+  concurrent_marking->ScheduleTasks();
+  CcTest::CollectAllGarbage(i::Heap::kFinalizeIncrementalMarkingMask);
+  CheckOldGraph(root);
+}
+
+// Returns an old space array that holds the given object. Only the holder is
+// referenced by a handle, so |object| stays white when marking starts.
+static Handle<FixedArray> AllocateHolder(Isolate* isolate,
+                                         Handle<HeapObject> object) {
+  Handle<FixedArray> holder = isolate->factory()->NewFixedArray(1, TENURED);
+  holder->set(0, *object);
+  return holder;
+}
+
+static bool IsWhite(HeapObject* object) {
+  return ObjectMarking::IsWhite(object, MarkingState::Internal(object));
+}
+
+static bool IsBlack(HeapObject* object) {
+  return ObjectMarking::IsBlack(object, MarkingState::Internal(object));
+}
+
+// Pushes a white object onto the shared worklist like the main thread does
+// when it shares work with the concurrent marker.
+static void ShareGreyObject(ConcurrentMarking* concurrent_marking,
+                            HeapObject* object) {
+  CHECK(ObjectMarking::WhiteToGrey(object, MarkingState::Internal(object)));
+  ConcurrentMarking::MarkingWorklist::View shared(
+      concurrent_marking->shared(), ConcurrentMarking::kMainThread);
+  shared.Push(object);
+  shared.FlushToGlobal();
+}
+
+// Moves the objects that the concurrent marker bailed out on to the marking
+// deque of the main thread.
+static void TakeBailoutObjects(Heap* heap) {
+  ConcurrentMarking::MarkingWorklist::View bailout(
+      heap->concurrent_marking()->bailout(), ConcurrentMarking::kMainThread);
+  HeapObject* object;
+  while (bailout.Pop(&object)) {
+    CHECK(heap->mark_compact_collector()->marking_deque()->Push(object));
+  }
+}
+
+// The following tests run a marking task on the main thread, so they do not
+// depend on --concurrent-marking.
+TEST(ConcurrentMarkingTaskMarksGraph) {
+  if (!i::FLAG_incremental_marking) return;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Heap* heap = CcTest::heap();
+  HandleScope scope(isolate);
+  CcTest::CollectAllGarbage(i::Heap::kFinalizeIncrementalMarkingMask);
+  Handle<FixedArray> holder;
+  {
+    HandleScope inner_scope(isolate);
+    holder = inner_scope.CloseAndEscape(
+        AllocateHolder(isolate, AllocateOldGraph(isolate, 100)));
+  }
+  heap::SimulateIncrementalMarking(heap, false);
+  FixedArray* root = FixedArray::cast(holder->get(0));
+  CHECK(IsWhite(root));
+
+  ConcurrentMarking* concurrent_marking = heap->concurrent_marking();
+  size_t marked_bytes = concurrent_marking->TotalMarkedBytes();
+  ShareGreyObject(concurrent_marking, root);
+  concurrent_marking->RunForTesting(1);
+
+  CHECK(concurrent_marking->shared()->IsGlobalEmpty());
+  CHECK(IsBlack(root));
+  int graph_size = root->Size();
+  for (int i = 0; i < root->length(); i++) {
+    FixedArray* inner = FixedArray::cast(root->get(i));
+    CHECK(IsBlack(inner));
+    CHECK(IsBlack(HeapObject::cast(inner->get(0))));
+    CHECK(IsBlack(HeapObject::cast(inner->get(1))));
+    graph_size += inner->Size() + HeapObject::cast(inner->get(0))->Size() +
+                  HeapObject::cast(inner->get(1))->Size();
+  }
+  CHECK_EQ(marked_bytes + graph_size, concurrent_marking->TotalMarkedBytes());
+
+  TakeBailoutObjects(heap);
+  CcTest::CollectAllGarbage(i::Heap::kFinalizeIncrementalMarkingMask);
+  CheckOldGraph(handle(FixedArray::cast(holder->get(0)), isolate));
+}
+
+TEST(ConcurrentMarkingTaskDiscardsSnapshotOfBlackObject) {
+  if (!i::FLAG_incremental_marking) return;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Factory* factory = isolate->factory();
+  Heap* heap = CcTest::heap();
+  HandleScope scope(isolate);
+  CcTest::CollectAllGarbage(i::Heap::kFinalizeIncrementalMarkingMask);
+  Handle<FixedArray> holder;
+  {
+    HandleScope inner_scope(isolate);
+    Handle<JSObject> object =
+        factory->NewJSObject(isolate->object_function(), TENURED);
+    object->set_elements(*factory->NewFixedArrayWithHoles(1, TENURED));
+    holder = inner_scope.CloseAndEscape(AllocateHolder(isolate, object));
+  }
+  heap::SimulateIncrementalMarking(heap, false);
+  JSObject* object = JSObject::cast(holder->get(0));
+  FixedArrayBase* elements = object->elements();
+  CHECK(IsWhite(object));
+  CHECK(IsWhite(elements));
+
+  ConcurrentMarking* concurrent_marking = heap->concurrent_marking();
+  size_t marked_bytes = concurrent_marking->TotalMarkedBytes();
+  ShareGreyObject(concurrent_marking, object);
+  // A layout change on the main thread marks the object black before the
+  // task visits it, so the task must not mark its fields.
+  ObjectMarking::GreyToBlack(object, MarkingState::Internal(object));
+  concurrent_marking->RunForTesting(1);
+
+  CHECK(IsWhite(elements));
+  CHECK_EQ(marked_bytes, concurrent_marking->TotalMarkedBytes());
+
+  // Hand the object back to the main thread, which rescans it.
+  ObjectMarking::BlackToGrey(object, MarkingState::Internal(object));
+  CHECK(heap->mark_compact_collector()->marking_deque()->Push(object));
+  TakeBailoutObjects(heap);
+  CcTest::CollectAllGarbage(i::Heap::kFinalizeIncrementalMarkingMask);
+  CHECK_EQ(1, JSObject::cast(holder->get(0))->elements()->length());
 }
 
 }  // namespace internal
@@ -1222,6 +1222,60 @@ TEST(TestCodeFlushingPreAged) {
 }
 
 
+TEST(TestBytecodeFlushing) {
+  i::FLAG_ignition = true;
+  i::FLAG_opt = false;
+  i::FLAG_always_opt = false;
+  i::FLAG_flush_code = true;
+  i::FLAG_flush_bytecode = true;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Factory* factory = isolate->factory();
+  v8::HandleScope scope(CcTest::isolate());
+  const char* source = "function foo() {"
+                       "  var x = 42;"
+                       "  var y = 42;"
+                       "  var z = x + y;"
+                       "};"
+                       "foo()";
+  Handle<String> foo_name = factory->InternalizeUtf8String("foo");
+
+  { v8::HandleScope scope(CcTest::isolate());
+    CompileRun(source);
+  }
+
+  // Check function is interpreted.
+  Handle<Object> func_value =
+      Object::GetProperty(isolate->global_object(), foo_name).ToHandleChecked();
+  CHECK(func_value->IsJSFunction());
+  Handle<JSFunction> function = Handle<JSFunction>::cast(func_value);
+  CHECK(function->shared()->HasBytecodeArray());
+  CHECK(function->IsInterpreted());
+
+  // The bytecode was just run, so it survives the next GC.
+  CcTest::CollectAllGarbage(i::Heap::kFinalizeIncrementalMarkingMask);
+  CHECK(function->shared()->HasBytecodeArray());
+
+  // Simulate several GCs that use full marking.
+  const int kAgingThreshold = 6;
+  for (int i = 0; i < kAgingThreshold; i++) {
+    CcTest::CollectAllGarbage(i::Heap::kFinalizeIncrementalMarkingMask);
+  }
+
+  // The bytecode was flushed and foo is compiled lazily again.
+  CHECK(!function->shared()->HasBytecodeArray());
+  CHECK(!function->shared()->is_compiled());
+  CHECK(!function->is_compiled());
+  CHECK(function->shared()->bytecode_flushed());
+
+  // Call foo to get it recompiled.
+  CompileRun("foo()");
+  CHECK(function->shared()->HasBytecodeArray());
+  CHECK(function->is_compiled());
+  CHECK(!function->shared()->bytecode_flushed());
+}
+
+
 TEST(TestCodeFlushingIncremental) {
   if (!i::FLAG_incremental_marking) return;
   // If we do not flush code this test is invalid.
@@ -6609,5 +6663,61 @@ HEAP_TEST(Regress5831) {
   CHECK(chunk->NeverEvacuate());
 }
 
+TEST(ParallelScavenge) {
+  FLAG_parallel_scavenge = true;
+  // Force several tasks regardless of the new space size and the number of
+  // cores, and make room for the young objects below.
+  FLAG_parallel_scavenge_tasks = 4;
+  FLAG_min_semi_space_size = 4;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Factory* factory = isolate->factory();
+  Heap* heap = isolate->heap();
+  HandleScope scope(isolate);
+
+  // Old-space arrays pointing to young objects exercise the old-to-new
+  // remembered set in addition to the roots. Every young array references
+  // another young object, so the tasks share enough work to steal from each
+  // other.
+  const int kArrays = 16;
+  const int kLength = 1024;
+  Handle<FixedArray> old_arrays = factory->NewFixedArray(kArrays, TENURED);
+  for (int i = 0; i < kArrays; i++) {
+    Handle<FixedArray> old_array = factory->NewFixedArray(kLength, TENURED);
+    for (int j = 0; j < kLength; j++) {
+      Handle<FixedArray> young = factory->NewFixedArray(2);
+      young->set(0, Smi::FromInt(j));
+      young->set(1, *factory->NewHeapNumber(i));
+      old_array->set(j, *young);
+    }
+    old_arrays->set(i, *old_array);
+  }
+  Handle<FixedArray> young_root = factory->NewFixedArray(kLength);
+  for (int i = 0; i < kLength; i++) {
+    young_root->set(i, *factory->NewHeapNumber(i));
+  }
+  CHECK(heap->InNewSpace(*young_root));
+
+  CcTest::CollectGarbage(NEW_SPACE);
+  CHECK_LT(1, heap->parallel_scavenge_active_tasks());
+  // The second scavenge promotes the survivors of the first one.
+  CcTest::CollectGarbage(NEW_SPACE);
+
+  for (int i = 0; i < kArrays; i++) {
+    FixedArray* old_array = FixedArray::cast(old_arrays->get(i));
+    for (int j = 0; j < kLength; j++) {
+      FixedArray* young = FixedArray::cast(old_array->get(j));
+      CHECK_EQ(Smi::FromInt(j), young->get(0));
+      CHECK_EQ(static_cast<double>(i),
+               HeapNumber::cast(young->get(1))->value());
+    }
+  }
+  for (int i = 0; i < kLength; i++) {
+    CHECK_EQ(static_cast<double>(i),
+             HeapNumber::cast(young_root->get(i))->value());
+  }
+  CHECK(!heap->InNewSpace(*young_root));
+}
+
 }  // namespace internal
 }  // namespace v8
@@ -236,6 +236,48 @@ TEST(Utf8SingleByteChunks) {
   }
 }
 
+TEST(Utf8AdvanceUntil) {
+  // Alternate ASCII runs and two-byte characters across several buffers.
+  const int kRepeat = 1000;
+  std::string utf8;
+  std::vector<uint16_t> ucs2;
+  for (int i = 0; i < kRepeat; i++) {
+    utf8 += "ab\xc3\xa4";
+    ucs2.push_back('a');
+    ucs2.push_back('b');
+    ucs2.push_back(228);
+  }
+
+  for (bool extra_chunky : {false, true}) {
+    ChunkSource chunk_source(reinterpret_cast<const uint8_t*>(utf8.data()),
+                             utf8.size(), extra_chunky);
+    std::unique_ptr<v8::internal::Utf16CharacterStream> stream(
+        v8::internal::ScannerStream::For(
+            &chunk_source, v8::ScriptCompiler::StreamedSource::UTF8, nullptr));
+
+    int found = 0;
+    v8::internal::uc32 c;
+    while ((c = stream->AdvanceUntil([](v8::internal::uc32 ch) {
+              return ch == 228;
+            })) != v8::internal::Utf16CharacterStream::kEndOfInput) {
+      CHECK_EQ(228, c);
+      found++;
+      CHECK_EQ(static_cast<size_t>(found * 3), stream->pos());
+    }
+    CHECK_EQ(kRepeat, found);
+
+    // Seek back into the middle of the stream and read it again.
+    for (size_t pos : {1500u, 7u, 2999u}) {
+      stream->Seek(pos);
+      for (size_t i = pos; i < ucs2.size(); i++) {
+        CHECK_EQ(ucs2[i], stream->Advance());
+      }
+      CHECK_EQ(v8::internal::Utf16CharacterStream::kEndOfInput,
+               stream->Advance());
+    }
+  }
+}
+
 #define CHECK_EQU(v1, v2) CHECK_EQ(static_cast<int>(v1), static_cast<int>(v2))
 
 void TestCharacterStream(const char* reference, i::Utf16CharacterStream* stream,
@@ -25,17 +25,20 @@ void TestStubCacheOffsetCalculation(StubCache::Table table) {
   const int kNumParams = 2;
   CodeAssemblerTester data(isolate, kNumParams);
   AccessorAssembler m(data.state());
+  StubCache* stub_cache = isolate->load_stub_cache();
 
   {
     Node* name = m.Parameter(0);
     Node* map = m.Parameter(1);
-    Node* primary_offset = m.StubCachePrimaryOffsetForTesting(name, map);
+    Node* primary_offset =
+        m.StubCachePrimaryOffsetForTesting(stub_cache, name, map);
     Node* result;
     if (table == StubCache::kPrimary) {
       result = primary_offset;
     } else {
       CHECK_EQ(StubCache::kSecondary, table);
-      result = m.StubCacheSecondaryOffsetForTesting(name, primary_offset);
+      result = m.StubCacheSecondaryOffsetForTesting(stub_cache, name,
+                                                    primary_offset);
     }
     m.Return(m.SmiTag(result));
   }
@@ -78,12 +81,13 @@ void TestStubCacheOffsetCalculation(StubCache::Table table) {
 
       int expected_result;
       {
-        int primary_offset = StubCache::PrimaryOffsetForTesting(*name, *map);
+        int primary_offset =
+            stub_cache->PrimaryOffsetForTesting(*name, *map);
         if (table == StubCache::kPrimary) {
           expected_result = primary_offset;
         } else {
           expected_result =
-              StubCache::SecondaryOffsetForTesting(*name, primary_offset);
+              stub_cache->SecondaryOffsetForTesting(*name, primary_offset);
         }
       }
       Handle<Object> result = ft.Call(name, map).ToHandleChecked();
@@ -116,7 +120,9 @@ Handle<Code> CreateCodeWithFlags(Code::Flags flags) {
 
 }  // namespace
 
-TEST(TryProbeStubCache) {
+namespace {
+
+void TestTryProbeStubCache(bool grow) {
   typedef CodeStubAssembler::Label Label;
   typedef CodeStubAssembler::Variable Variable;
   Isolate* isolate(CcTest::InitIsolateOnce());
@@ -158,6 +164,24 @@ TEST(TryProbeStubCache) {
   Handle<Code> code = data.GenerateCode();
   FunctionTester ft(code, kNumParams);
 
+  if (grow) {
+    // Thrash the cache so that its tables are reallocated when it is cleared.
+    // The generated code must probe the new tables.
+    int old_size = stub_cache.primary_table_size();
+    Handle<Map> map = Map::Create(isolate, 0);
+    Handle<Name> name = isolate->factory()->InternalizeUtf8String("grow");
+    Code::Flags flags = Code::ComputeHandlerFlags(ic_kind);
+    Handle<Code> handler = CreateCodeWithFlags(flags);
+    FLAG_stub_cache_grow = true;
+    for (int i = 0; i <= 4 * old_size; i++) {
+      stub_cache.Set(*name, *map, *handler);
+    }
+    stub_cache.Clear();
+    FLAG_stub_cache_grow = false;
+    CHECK_EQ(2 * old_size, stub_cache.primary_table_size());
+    CHECK_EQ(0u, stub_cache.updates_since_clear());
+  }
+
   std::vector<Handle<Name>> names;
   std::vector<Handle<JSObject>> receivers;
   std::vector<Handle<Code>> handlers;
@@ -165,23 +189,25 @@ TEST(TryProbeStubCache) {
   base::RandomNumberGenerator rand_gen(FLAG_random_seed);
 
   Factory* factory = isolate->factory();
+  const int primary_table_size = stub_cache.primary_table_size();
+  const int secondary_table_size = stub_cache.secondary_table_size();
 
   // Generate some number of names.
-  for (int i = 0; i < StubCache::kPrimaryTableSize / 7; i++) {
+  for (int i = 0; i < primary_table_size / 7; i++) {
     Handle<Name> name;
     switch (rand_gen.NextInt(3)) {
       case 0: {
         // Generate string.
         std::stringstream ss;
         ss << "s" << std::hex
-           << (rand_gen.NextInt(Smi::kMaxValue) % StubCache::kPrimaryTableSize);
+           << (rand_gen.NextInt(Smi::kMaxValue) % primary_table_size);
         name = factory->InternalizeUtf8String(ss.str().c_str());
         break;
       }
       case 1: {
         // Generate number string.
         std::stringstream ss;
-        ss << (rand_gen.NextInt(Smi::kMaxValue) % StubCache::kPrimaryTableSize);
+        ss << (rand_gen.NextInt(Smi::kMaxValue) % primary_table_size);
         name = factory->InternalizeUtf8String(ss.str().c_str());
         break;
       }
@@ -197,7 +223,7 @@ TEST(TryProbeStubCache) {
   }
 
   // Generate some number of receiver maps and receivers.
-  for (int i = 0; i < StubCache::kSecondaryTableSize / 2; i++) {
+  for (int i = 0; i < secondary_table_size / 2; i++) {
     Handle<Map> map = Map::Create(isolate, 0);
     receivers.push_back(factory->NewJSObjectFromMap(map));
   }
@@ -213,7 +239,7 @@ TEST(TryProbeStubCache) {
   DisallowHeapAllocation no_gc;
 
   // Populate {stub_cache}.
-  const int N = StubCache::kPrimaryTableSize + StubCache::kSecondaryTableSize;
+  const int N = primary_table_size + secondary_table_size;
   for (int i = 0; i < N; i++) {
     int index = rand_gen.NextInt();
     Handle<Name> name = names[index % names.size()];
@@ -259,5 +285,11 @@ TEST(TryProbeStubCache) {
   CHECK(queried_existing && queried_non_existing);
 }
 
+}  // namespace
+
+TEST(TryProbeStubCache) { TestTryProbeStubCache(false); }
+
+TEST(TryProbeGrownStubCache) { TestTryProbeStubCache(true); }
+
 }  // namespace internal
 }  // namespace v8
@@ -43,6 +43,7 @@
 #include "src/base/platform/platform.h"
 #include "src/code-stubs.h"
 #include "src/compilation-cache.h"
+#include "src/compiler-dispatcher/compiler-dispatcher.h"
 #include "src/debug/debug.h"
 #include "src/execution.h"
 #include "src/futex-emulation.h"
@@ -14562,6 +14563,56 @@ UNINITIALIZED_TEST(SetJitCodeEventHandler) {
   isolate->Dispose();
 }
 
+static int compilation_statistics_events = 0;
+
+static void CompilationStatisticsHandler(
+    v8::Isolate* isolate, const v8::CompilationStatisticsEvent* event) {
+  if (strcmp(event->function_name, "outer") != 0) return;
+  compilation_statistics_events++;
+  CHECK_EQ(0, strcmp(event->tier, "TurboFan"));
+  CHECK_LE(0, event->script_id);
+  CHECK_LT(0, event->start_position);
+  CHECK_LT(0u, event->code_size);
+  CHECK_LT(0u, event->max_allocated_bytes);
+  CHECK_EQ(1, event->inlined_function_count);
+  CHECK_EQ(0, event->deopt_count);
+  CHECK_LT(0u, event->phase_count);
+  double time_in_ms = 0;
+  for (size_t i = 0; i < event->phase_count; ++i) {
+    CHECK_NOT_NULL(event->phases[i].name);
+    time_in_ms += event->phases[i].time_in_ms;
+  }
+  CHECK_EQ(event->time_in_ms, time_in_ms);
+}
+
+TEST(SetCompilationStatisticsCallback) {
+  i::FLAG_allow_natives_syntax = true;
+  i::FLAG_concurrent_recompilation = false;
+  i::FLAG_ignition = true;
+  i::FLAG_turbo_inlining = true;
+  i::FlagList::EnforceFlagImplications();
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope scope(isolate);
+
+  isolate->SetCompilationStatisticsCallback(CompilationStatisticsHandler);
+  CompileRun(
+      "function inner(a) { return a + 1; }"
+      "function outer(a) { return inner(a) * 2; }"
+      "outer(1); outer(2);"
+      "%OptimizeFunctionOnNextCall(outer);"
+      "outer(3);");
+  CHECK_EQ(1, compilation_statistics_events);
+
+  // No statistics are reported once the callback is removed.
+  isolate->SetCompilationStatisticsCallback(nullptr);
+  CompileRun(
+      "%DeoptimizeFunction(outer);"
+      "%OptimizeFunctionOnNextCall(outer);"
+      "outer(4);");
+  CHECK_EQ(1, compilation_statistics_events);
+}
+
 TEST(ExternalAllocatedMemory) {
   v8::Isolate* isolate = CcTest::isolate();
   v8::HandleScope outer(isolate);
@@ -24805,6 +24856,62 @@ TEST(StreamingProducesParserCache) {
 }
 
 
+TEST(StreamingCompilesEagerFunctionsOnDispatcher) {
+  i::FLAG_compiler_dispatcher_streaming = true;
+  i::FLAG_compiler_dispatcher = true;
+  i::FLAG_ignition = true;
+  i::FLAG_always_opt = false;
+  const char* chunks[] = {"var foo = (function foo() { ret",
+                          "urn 13; }); function bar() { return 1; } ",
+                          "foo(); ", NULL};
+
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  i::Isolate* i_isolate = CcTest::i_isolate();
+  v8::HandleScope scope(isolate);
+
+  v8::ScriptCompiler::StreamedSource source(
+      new TestSourceStream(chunks),
+      v8::ScriptCompiler::StreamedSource::ONE_BYTE);
+  v8::ScriptCompiler::ScriptStreamingTask* task =
+      v8::ScriptCompiler::StartStreamingScript(isolate, &source);
+
+  // TestSourceStream::GetMoreData won't block, so it's OK to just run the
+  // task here in the main thread.
+  task->Run();
+  delete task;
+
+  v8::ScriptOrigin origin(v8_str("http://foo.com"));
+  char* full_source = TestSourceStream::FullSourceString(chunks);
+  v8::Local<Script> script =
+      v8::ScriptCompiler::Compile(env.local(), &source, v8_str(full_source),
+                                  origin)
+          .ToLocalChecked();
+  delete[] full_source;
+
+  // Only the eagerly parsed function is handed to the compiler dispatcher,
+  // the lazy one is compiled when it is first called.
+  i::Handle<i::JSFunction> function = v8::Utils::OpenHandle(*script);
+  i::Handle<i::Script> i_script(i::Script::cast(function->shared()->script()),
+                                i_isolate);
+  i::CompilerDispatcher* dispatcher = i_isolate->compiler_dispatcher();
+  i::SharedFunctionInfo::ScriptIterator iterator(i_script);
+  int enqueued = 0;
+  while (i::SharedFunctionInfo* shared = iterator.Next()) {
+    i::Handle<i::SharedFunctionInfo> info(shared, i_isolate);
+    if (info->is_toplevel()) continue;
+    std::unique_ptr<char[]> name = info->DebugName()->ToCString();
+    bool is_eager = strcmp(name.get(), "foo") == 0;
+    CHECK_EQ(is_eager, dispatcher->IsEnqueued(info));
+    if (is_eager) enqueued++;
+  }
+  CHECK_EQ(1, enqueued);
+
+  v8::Local<Value> result(script->Run(env.local()).ToLocalChecked());
+  CHECK_EQ(13, result->Int32Value(env.local()).FromJust());
+}
+
+
 TEST(StreamingWithDebuggingEnabledLate) {
   // The streaming parser can only parse lazily, i.e. inner functions are not
   // fully parsed. However, we may compile inner functions eagerly when
@@ -31,6 +31,7 @@
 #include "src/v8.h"
 
 #include "src/api.h"
+#include "src/compiler-dispatcher/compiler-dispatcher.h"
 #include "src/compiler.h"
 #include "src/disasm.h"
 #include "src/factory.h"
@@ -640,3 +641,40 @@ TEST(InvocationCount) {
   CompileRun("foo(); foo()");
   CHECK_EQ(4, foo->feedback_vector()->invocation_count());
 }
+
+TEST(DispatchToplevelFunctions) {
+  FLAG_compiler_dispatcher_toplevel_functions = true;
+  FLAG_compiler_dispatcher = true;
+  FLAG_ignition = true;
+  FLAG_always_opt = false;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  v8::HandleScope scope(CcTest::isolate());
+
+  Handle<JSFunction> fun = Compile(
+      "var a = (function f() { return 17; })();"
+      "function g() { return 1; }"
+      "a + (function h() { return 25; })();");
+  CHECK(!fun.is_null());
+
+  // The functions that are called immediately are parsed and compiled on
+  // the compiler dispatcher, other functions stay lazy.
+  CompilerDispatcher* dispatcher = isolate->compiler_dispatcher();
+  Handle<Script> script(Script::cast(fun->shared()->script()), isolate);
+  SharedFunctionInfo::ScriptIterator iterator(script);
+  int enqueued = 0;
+  while (SharedFunctionInfo* shared = iterator.Next()) {
+    Handle<SharedFunctionInfo> info(shared, isolate);
+    if (info->is_toplevel()) continue;
+    std::unique_ptr<char[]> name = info->DebugName()->ToCString();
+    bool likely_called = strcmp(name.get(), "g") != 0;
+    CHECK_EQ(likely_called, dispatcher->IsEnqueued(info));
+    if (likely_called) enqueued++;
+  }
+  CHECK_EQ(2, enqueued);
+
+  Handle<Object> receiver(isolate->native_context()->global_object(), isolate);
+  Handle<Object> result =
+      Execution::Call(isolate, fun, receiver, 0, nullptr).ToHandleChecked();
+  CHECK_EQ(42, Smi::cast(*result)->value());
+}
@@ -702,6 +702,90 @@ TEST(CollectCpuProfileSamples) {
   profile->Delete();
 }
 
+namespace {
+
+class TestProfileStream : public v8::OutputStream {
+ public:
+  TestProfileStream() : end_of_stream_count_(0) {}
+
+  void EndOfStream() override { end_of_stream_count_++; }
+  int GetChunkSize() override { return 64; }
+  WriteResult WriteAsciiChunk(char* data, int size) override {
+    CHECK_LE(size, GetChunkSize());
+    output_.append(data, size);
+    return kContinue;
+  }
+
+  const std::string& output() const { return output_; }
+  int end_of_stream_count() const { return end_of_stream_count_; }
+
+ private:
+  std::string output_;
+  int end_of_stream_count_;
+};
+
+}  // namespace
+
+TEST(StreamCpuProfileSamples) {
+  i::FLAG_allow_natives_syntax = true;
+  LocalContext env;
+  v8::HandleScope scope(env->GetIsolate());
+
+  CompileRun(cpu_profiler_test_source);
+  v8::Local<v8::Function> function = GetFunction(env.local(), "start");
+  v8::Local<v8::Value> args[] = {v8::Integer::New(env->GetIsolate(), 200)};
+
+  v8::CpuProfiler* profiler = v8::CpuProfiler::New(env->GetIsolate());
+  v8::Local<v8::String> profile_name = v8_str("streaming");
+  TestProfileStream stream;
+  profiler->SetSamplingInterval(100);
+  CHECK(profiler->StartStreamingProfiling(profile_name, &stream));
+  v8::sampler::Sampler* sampler =
+      reinterpret_cast<i::CpuProfiler*>(profiler)->processor()->sampler();
+  sampler->StartCountingSamples();
+  do {
+    function->Call(env.local(), env->Global(), arraysize(args), args)
+        .ToLocalChecked();
+  } while (sampler->js_sample_count() < 1000);
+  v8::CpuProfile* profile = profiler->StopProfiling(profile_name);
+  CHECK(profile);
+
+  // Samples are only delivered through the stream.
+  CHECK_EQ(0, profile->GetSamplesCount());
+  CHECK_EQ(1, stream.end_of_stream_count());
+  const std::string& output = stream.output();
+  CHECK_EQ(0u, output.find("{\"startTime\":"));
+  CHECK_NE(std::string::npos, output.find("\"nodes\":["));
+  CHECK_NE(std::string::npos, output.find("\"samples\":["));
+  CHECK_NE(std::string::npos, output.find("\"timeDeltas\":["));
+  CHECK_NE(std::string::npos, output.find("\n{\"endTime\":"));
+  CHECK_EQ('\n', output.back());
+
+  profile->Delete();
+  profiler->Dispose();
+}
+
+TEST(StreamCpuProfileWithTitleInUse) {
+  LocalContext env;
+  v8::HandleScope scope(env->GetIsolate());
+
+  v8::CpuProfiler* profiler = v8::CpuProfiler::New(env->GetIsolate());
+  v8::Local<v8::String> profile_name = v8_str("streaming");
+  profiler->StartProfiling(profile_name, false);
+
+  // The stream cannot be attached to the running profile.
+  TestProfileStream stream;
+  CHECK(!profiler->StartStreamingProfiling(profile_name, &stream));
+
+  v8::CpuProfile* profile = profiler->StopProfiling(profile_name);
+  CHECK(profile);
+  CHECK_EQ(0, stream.end_of_stream_count());
+  CHECK(stream.output().empty());
+
+  profile->Delete();
+  profiler->Dispose();
+}
+
 static const char* cpu_profiler_test_source2 =
     "%NeverOptimizeFunction(loop);\n"
     "%NeverOptimizeFunction(delay);\n"
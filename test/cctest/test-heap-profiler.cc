@@ -1019,6 +1019,84 @@ TEST(HeapSnapshotJSONSerializationAborting) {
   CHECK_EQ(0, stream.eos_signaled());
 }
 
+static void CheckBinaryRoundTrip(const v8::HeapSnapshot* snapshot) {
+  TestJSONStream json_stream;
+  snapshot->Serialize(&json_stream, v8::HeapSnapshot::kJSON);
+  i::ScopedVector<char> json(json_stream.size());
+  json_stream.WriteTo(json);
+
+  TestJSONStream binary_stream;
+  snapshot->Serialize(&binary_stream, v8::HeapSnapshot::kBinary);
+  CHECK_EQ(1, binary_stream.eos_signaled());
+  CHECK_LT(binary_stream.size(), json_stream.size());
+  i::ScopedVector<char> binary(binary_stream.size());
+  binary_stream.WriteTo(binary);
+
+  // The converted snapshot is identical to the JSON snapshot.
+  TestJSONStream converted_stream;
+  CHECK(v8::HeapSnapshot::ConvertBinaryToJSON(binary.start(), binary.length(),
+                                              &converted_stream));
+  CHECK_EQ(1, converted_stream.eos_signaled());
+  CHECK_EQ(json.length(), converted_stream.size());
+  i::ScopedVector<char> converted(converted_stream.size());
+  converted_stream.WriteTo(converted);
+  CHECK_EQ(0, memcmp(json.start(), converted.start(), json.length()));
+
+  // Truncated input is rejected.
+  TestJSONStream truncated_stream;
+  CHECK(!v8::HeapSnapshot::ConvertBinaryToJSON(
+      binary.start(), binary.length() - 1, &truncated_stream));
+  CHECK_EQ(0, truncated_stream.eos_signaled());
+}
+
+
+TEST(HeapSnapshotBinarySerialization) {
+  LocalContext env;
+  v8::HandleScope scope(env->GetIsolate());
+  v8::HeapProfiler* heap_profiler = env->GetIsolate()->GetHeapProfiler();
+  CompileRun(
+      "function A(s) { this.s = s; }\n"
+      "var a = new A(\"String \\n\\u0081\\u0801\\u8001\");\n"
+      "var array = [a, 1.5, 'x', [a]];");
+  const v8::HeapSnapshot* snapshot = heap_profiler->TakeHeapSnapshot();
+  CHECK(ValidateSnapshot(snapshot));
+  CheckBinaryRoundTrip(snapshot);
+
+  TestJSONStream invalid_stream;
+  const char invalid[] = "{\"snapshot\":{}}";
+  CHECK(!v8::HeapSnapshot::ConvertBinaryToJSON(invalid, sizeof(invalid),
+                                               &invalid_stream));
+}
+
+
+TEST(HeapSnapshotBinarySerializationWithAllocationTraces) {
+  LocalContext env;
+  v8::HandleScope scope(env->GetIsolate());
+  v8::HeapProfiler* heap_profiler = env->GetIsolate()->GetHeapProfiler();
+  heap_profiler->StartTrackingHeapObjects(true);
+  CompileRun(
+      "function f(x) { return {x: x}; }\n"
+      "var objects = [];\n"
+      "for (var i = 0; i < 100; i++) objects.push(f(i));");
+  const v8::HeapSnapshot* snapshot = heap_profiler->TakeHeapSnapshot();
+  CHECK(ValidateSnapshot(snapshot));
+  CheckBinaryRoundTrip(snapshot);
+  heap_profiler->StopTrackingHeapObjects();
+}
+
+
+TEST(HeapSnapshotBinarySerializationAborting) {
+  LocalContext env;
+  v8::HandleScope scope(env->GetIsolate());
+  v8::HeapProfiler* heap_profiler = env->GetIsolate()->GetHeapProfiler();
+  const v8::HeapSnapshot* snapshot = heap_profiler->TakeHeapSnapshot();
+  CHECK(ValidateSnapshot(snapshot));
+  TestJSONStream stream(5);
+  snapshot->Serialize(&stream, v8::HeapSnapshot::kBinary);
+  CHECK_GT(stream.size(), 0);
+  CHECK_EQ(0, stream.eos_signaled());
+}
+
 namespace {
 
 class TestStatsStream : public v8::OutputStream {
@@ -1388,6 +1466,72 @@ TEST(TakeHeapSnapshotAborting) {
 }
 
 
+static void CheckSameChildren(const v8::HeapGraphNode* a,
+                              const v8::HeapGraphNode* b) {
+  CHECK_EQ(a->GetId(), b->GetId());
+  CHECK_EQ(a->GetChildrenCount(), b->GetChildrenCount());
+  for (int i = 0, count = a->GetChildrenCount(); i < count; ++i) {
+    const v8::HeapGraphEdge* edge_a = a->GetChild(i);
+    const v8::HeapGraphEdge* edge_b = b->GetChild(i);
+    CHECK_EQ(edge_a->GetType(), edge_b->GetType());
+    CHECK_EQ(edge_a->GetToNode()->GetId(), edge_b->GetToNode()->GetId());
+    v8::String::Utf8Value name_a(edge_a->GetName());
+    v8::String::Utf8Value name_b(edge_b->GetName());
+    CHECK_EQ(0, strcmp(*name_a, *name_b));
+  }
+}
+
+
+TEST(TakeHeapSnapshotInParallel) {
+  LocalContext env;
+  v8::HandleScope scope(env->GetIsolate());
+  v8::HeapProfiler* heap_profiler = env->GetIsolate()->GetHeapProfiler();
+
+  // Spread the objects over many pages.
+  CompileRun(
+      "function X(a) { this.a = a; this.b = [a, {}]; }\n"
+      "var xs = [];\n"
+      "for (var i = 0; i < 50000; i++) xs.push(new X(i));\n");
+
+  bool old_flag = i::FLAG_parallel_heap_snapshot;
+  i::FLAG_parallel_heap_snapshot = true;
+  TestActivityControl control(-1);  // Don't abort.
+  const v8::HeapSnapshot* parallel =
+      heap_profiler->TakeHeapSnapshot(&control);
+  CHECK(ValidateSnapshot(parallel));
+  CHECK_EQ(control.total(), control.done());
+  CHECK_GT(control.total(), 0);
+
+  i::FLAG_parallel_heap_snapshot = false;
+  const v8::HeapSnapshot* sequential = heap_profiler->TakeHeapSnapshot();
+  CHECK(ValidateSnapshot(sequential));
+  i::FLAG_parallel_heap_snapshot = old_flag;
+
+  const v8::HeapGraphNode* global_parallel = GetGlobalObject(parallel);
+  const v8::HeapGraphNode* global_sequential = GetGlobalObject(sequential);
+  CheckSameChildren(global_parallel, global_sequential);
+  const v8::HeapGraphNode* xs_parallel =
+      GetProperty(global_parallel, v8::HeapGraphEdge::kProperty, "xs");
+  const v8::HeapGraphNode* xs_sequential =
+      GetProperty(global_sequential, v8::HeapGraphEdge::kProperty, "xs");
+  CHECK(xs_parallel);
+  CHECK(xs_sequential);
+  CheckSameChildren(xs_parallel, xs_sequential);
+  const v8::HeapGraphNode* elements_parallel =
+      GetProperty(xs_parallel, v8::HeapGraphEdge::kInternal, "elements");
+  const v8::HeapGraphNode* elements_sequential =
+      GetProperty(xs_sequential, v8::HeapGraphEdge::kInternal, "elements");
+  CHECK(elements_parallel);
+  CHECK(elements_sequential);
+  CheckSameChildren(elements_parallel, elements_sequential);
+  for (int i = 0, count = elements_parallel->GetChildrenCount(); i < count;
+       ++i) {
+    CheckSameChildren(elements_parallel->GetChild(i)->GetToNode(),
+                      elements_sequential->GetChild(i)->GetToNode());
+  }
+}
+
+
 namespace {
 
 class TestRetainedObjectInfo : public v8::RetainedObjectInfo {
@@ -29,6 +29,7 @@
 
 #include "include/v8-profiler.h"
 #include "src/api.h"
+#include "src/base/utils/random-number-generator.h"
 #include "src/objects-inl.h"
 #include "src/profiler/cpu-profiler.h"
 #include "src/profiler/profile-generator-inl.h"
@@ -324,6 +325,113 @@ TEST(CodeMapMoveAndDeleteCode) {
 }
 
 
+TEST(CodeMapFindEntries) {
+  CodeMap code_map;
+  CodeEntry entry1(i::CodeEventListener::FUNCTION_TAG, "aaa");
+  CodeEntry entry2(i::CodeEventListener::FUNCTION_TAG, "bbb");
+  CodeEntry entry3(i::CodeEventListener::FUNCTION_TAG, "ccc");
+  code_map.AddCode(ToAddress(0x1500), &entry1, 0x200);
+  code_map.AddCode(ToAddress(0x1700), &entry2, 0x100);
+  code_map.AddCode(ToAddress(0x1900), &entry3, 0x50);
+  // Lookups are not sorted, like the frames of a stack sample.
+  i::Address addresses[] = {ToAddress(0x1900), ToAddress(0x1500 + 0x10),
+                            ToAddress(0x1800), ToAddress(0x1700 + 0x10),
+                            ToAddress(0x1500), ToAddress(0x1900 + 0x50)};
+  CodeEntry* entries[arraysize(addresses)];
+  code_map.FindEntries(addresses, arraysize(addresses), entries);
+  CHECK_EQ(&entry3, entries[0]);
+  CHECK_EQ(&entry1, entries[1]);
+  CHECK(!entries[2]);
+  CHECK_EQ(&entry2, entries[3]);
+  CHECK_EQ(&entry1, entries[4]);
+  CHECK(!entries[5]);
+  // Moved code is visible to batched lookups as well.
+  code_map.MoveCode(ToAddress(0x1900), ToAddress(0x1800));
+  code_map.FindEntries(addresses, arraysize(addresses), entries);
+  CHECK(!entries[0]);
+  CHECK_EQ(&entry3, entries[2]);
+}
+
+
+// Checks single and batched lookups in the code map against a plain
+// std::map, which was the previous implementation of the code map.
+TEST(CodeMapLookupMatchesTreeMap) {
+  static const int kNumEntries = 1000;
+  static const int kCodeSize = 0x100;
+  static const int kNumLookups = 10000;
+  CodeMap code_map;
+  std::map<i::Address, CodeEntry*> tree_map;
+  std::vector<std::unique_ptr<CodeEntry>> entries;
+  for (int i = 0; i < kNumEntries; i++) {
+    entries.emplace_back(
+        new CodeEntry(i::CodeEventListener::FUNCTION_TAG, "function"));
+    i::Address start = ToAddress(0x10000 + i * 2 * kCodeSize);
+    code_map.AddCode(start, entries.back().get(), kCodeSize);
+    tree_map.insert({start, entries.back().get()});
+  }
+  std::vector<i::Address> addresses;
+  v8::base::RandomNumberGenerator rng(1234);
+  for (int i = 0; i < kNumLookups; i++) {
+    addresses.push_back(
+        ToAddress(0x10000 + rng.NextInt(kNumEntries * 2 * kCodeSize)));
+  }
+
+  int tree_hits = 0;
+  for (i::Address address : addresses) {
+    auto it = tree_map.upper_bound(address);
+    if (it == tree_map.begin()) continue;
+    --it;
+    if (address < it->first + kCodeSize) tree_hits++;
+  }
+
+  int hits = 0;
+  for (i::Address address : addresses) {
+    if (code_map.FindEntry(address)) hits++;
+  }
+
+  int batched_hits = 0;
+  CodeEntry* results[TickSample::kMaxFramesCount];
+  for (size_t i = 0; i < addresses.size(); i += arraysize(results)) {
+    size_t count = std::min(arraysize(results), addresses.size() - i);
+    code_map.FindEntries(&addresses[i], count, results);
+    for (size_t j = 0; j < count; j++) {
+      if (results[j]) batched_hits++;
+    }
+  }
+
+  CHECK_LT(0, tree_hits);
+  CHECK_EQ(tree_hits, hits);
+  CHECK_EQ(tree_hits, batched_hits);
+}
+
+// Code creation events and ticks interleave while a profile is recorded.
+// Checks that lookups see newly added code without merging it into the
+// sorted array every time.
+TEST(CodeMapInterleavedAddAndLookup) {
+  static const int kNumEntries = 4000;
+  static const int kCodeSize = 0x100;
+  CodeMap code_map;
+  std::vector<std::unique_ptr<CodeEntry>> entries;
+  std::vector<i::Address> starts;
+  v8::base::RandomNumberGenerator rng(1234);
+  for (int i = 0; i < kNumEntries; i++) {
+    entries.emplace_back(
+        new CodeEntry(i::CodeEventListener::FUNCTION_TAG, "function"));
+    // Spread the code over the address range instead of appending it.
+    int slot = (i * 7919) % kNumEntries;
+    starts.push_back(ToAddress(0x10000 + slot * 2 * kCodeSize));
+    code_map.AddCode(starts.back(), entries.back().get(), kCodeSize);
+
+    // Look up an address in or right after some code added so far.
+    int lookup = rng.NextInt(i + 1);
+    int offset = rng.NextInt(2 * kCodeSize);
+    CodeEntry* expected = offset < kCodeSize ? entries[lookup].get() : nullptr;
+    CHECK_EQ(expected, code_map.FindEntry(starts[lookup] + offset));
+  }
+  // Merging the added code on every lookup would be quadratic.
+  CHECK_LT(code_map.merge_count(), kNumEntries / 20);
+}
+
 namespace {
 
 class TestSetup {
@@ -582,6 +690,50 @@ TEST(Issue51919) {
 }
 
 
+namespace {
+
+class ProfileStartingStream : public v8::OutputStream {
+ public:
+  explicit ProfileStartingStream(CpuProfilesCollection* collection)
+      : collection_(collection), chunks_(0) {}
+
+  void EndOfStream() override {}
+  WriteResult WriteAsciiChunk(char* data, int size) override {
+    // Would deadlock if the collection called the stream with its lock held.
+    CHECK(collection_->StartProfiling("started by stream", false));
+    chunks_++;
+    return kContinue;
+  }
+
+  int chunks() const { return chunks_; }
+
+ private:
+  CpuProfilesCollection* collection_;
+  int chunks_;
+};
+
+}  // namespace
+
+TEST(StreamWithoutHoldingProfilesLock) {
+  CpuProfilesCollection collection(CcTest::i_isolate());
+  CpuProfiler profiler(CcTest::i_isolate());
+  collection.set_cpu_profiler(&profiler);
+  ProfileStartingStream stream(&collection);
+  CHECK(collection.StartProfiling("streaming", false, &stream));
+
+  // Enough samples to flush the pending trace events to the stream.
+  std::vector<CodeEntry*> path;
+  for (int i = 0; i < 100; i++) {
+    collection.AddPathToCurrentProfiles(
+        v8::base::TimeTicks::HighResolutionNow(), path,
+        v8::CpuProfileNode::kNoLineNumberInfo, true);
+  }
+  CHECK_LT(0, stream.chunks());
+
+  CHECK(collection.StopProfiling("streaming"));
+  CHECK(collection.StopProfiling("started by stream"));
+}
+
 static const v8::CpuProfileNode* PickChild(const v8::CpuProfileNode* parent,
                                            const char* name) {
   for (int i = 0; i < parent->GetChildrenCount(); ++i) {
@@ -33,6 +33,8 @@
 
 #include "src/api.h"
 #include "src/assembler-inl.h"
+#include "src/ast/ast.h"
+#include "src/ast/scopes.h"
 #include "src/bootstrapper.h"
 #include "src/compilation-cache.h"
 #include "src/compiler.h"
@@ -40,9 +42,13 @@
 #include "src/heap/spaces.h"
 #include "src/macro-assembler-inl.h"
 #include "src/objects-inl.h"
+#include "src/parsing/parse-info.h"
+#include "src/parsing/parsing.h"
+#include "src/runtime-profiler.h"
 #include "src/runtime/runtime.h"
 #include "src/snapshot/code-serializer.h"
 #include "src/snapshot/deserializer.h"
+#include "src/snapshot/feedback-serializer.h"
 #include "src/snapshot/natives.h"
 #include "src/snapshot/partial-serializer.h"
 #include "src/snapshot/snapshot.h"
@@ -1581,6 +1587,76 @@ TEST(CodeSerializerFlagChange) {
   isolate2->Dispose();
 }
 
+TEST(CodeSerializerPreParsedScopeData) {
+  FLAG_serialize_toplevel = true;
+  FLAG_preparser_scope_analysis = true;
+  FlagList::EnforceFlagImplications();
+
+  // f() is parsed eagerly, so g() is preparsed as a lazy inner function and
+  // the scope data of g() and h() ends up on the Script.
+  const char* source =
+      "var g = (function f() {"
+      "  var x = 'abc';"
+      "  return function g() { function h() { return x; } return h(); };"
+      "})();"
+      "g() + 'def'";
+  v8::ScriptCompiler::CachedData* cache = ProduceCache(source);
+
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate2 = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate2);
+    v8::HandleScope scope(isolate2);
+    v8::Local<v8::Context> context = v8::Context::New(isolate2);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::String> source_str = v8_str(source);
+    v8::ScriptOrigin origin(v8_str("test"));
+    v8::ScriptCompiler::Source source(source_str, origin, cache);
+    v8::Local<v8::UnboundScript> script =
+        v8::ScriptCompiler::CompileUnboundScript(
+            isolate2, &source, v8::ScriptCompiler::kConsumeCodeCache)
+            .ToLocalChecked();
+    CHECK(!cache->rejected);
+
+    Isolate* i_isolate = reinterpret_cast<Isolate*>(isolate2);
+    HandleScope i_scope(i_isolate);
+    Handle<SharedFunctionInfo> toplevel = v8::Utils::OpenHandle(*script);
+    Handle<Script> i_script(Script::cast(toplevel->script()));
+    CHECK(i_script->HasPreparsedScopeData());
+
+    Handle<SharedFunctionInfo> g_shared;
+    SharedFunctionInfo::ScriptIterator iterator(i_script);
+    while (SharedFunctionInfo* shared = iterator.Next()) {
+      if (shared->DebugName()->IsUtf8EqualTo(CStrVector("g"))) {
+        g_shared = handle(shared, i_isolate);
+      }
+    }
+    CHECK(!g_shared.is_null());
+    CHECK(!g_shared->is_compiled());
+
+    // The scope data of the preparsed functions comes with the code cache,
+    // so lazily parsing g() skips h() instead of preparsing it again.
+    ParseInfo parse_info(g_shared);
+    parse_info.preparsed_scope_data()->Deserialize(
+        i_script->GetPreparsedScopeData());
+    CHECK(parsing::ParseFunction(&parse_info, i_isolate));
+    Scope* h_scope = parse_info.literal()->scope()->inner_scope();
+    CHECK_NOT_NULL(h_scope);
+    CHECK(h_scope->is_function_scope());
+    CHECK(h_scope->is_skipped_function());
+
+    v8::Local<v8::Value> result =
+        script->BindToCurrentContext()->Run(context).ToLocalChecked();
+    CHECK(result->ToString(context)
+              .ToLocalChecked()
+              ->Equals(context, v8_str("abcdef"))
+              .FromJust());
+  }
+  isolate2->Dispose();
+}
+
 TEST(CodeSerializerBitFlip) {
   FLAG_serialize_toplevel = true;
 
@@ -1874,6 +1950,289 @@ TEST(CodeSerializerEmbeddedObject) {
   delete script_data;
 }
 
+static const char* kFeedbackSource =
+    "function add(a, b) { return a + b; }"
+    "function run(n) {"
+    "  var sum = 0;"
+    "  for (var i = 0; i < n; i++) sum = add(sum, 0.5);"
+    "  return sum;"
+    "}";
+
+static v8::Local<v8::UnboundScript> CompileFeedbackSource(
+    v8::Isolate* isolate, const char* source) {
+  v8::ScriptOrigin origin(v8_str("test"));
+  v8::ScriptCompiler::Source script_source(v8_str(source), origin);
+  v8::Local<v8::UnboundScript> script =
+      v8::ScriptCompiler::CompileUnboundScript(isolate, &script_source)
+          .ToLocalChecked();
+  script->BindToCurrentContext()
+      ->Run(isolate->GetCurrentContext())
+      .ToLocalChecked();
+  return script;
+}
+
+static Handle<JSFunction> FeedbackFunctionOf(const char* name) {
+  v8::Local<v8::Context> context =
+      v8::Isolate::GetCurrent()->GetCurrentContext();
+  return Handle<JSFunction>::cast(v8::Utils::OpenHandle(
+      *v8::Local<v8::Function>::Cast(
+          context->Global()->Get(context, v8_str(name)).ToLocalChecked())));
+}
+
+static Handle<FeedbackVector> FeedbackVectorOf(const char* name) {
+  Handle<JSFunction> function = FeedbackFunctionOf(name);
+  CHECK(function->has_feedback_vector());
+  return handle(function->feedback_vector());
+}
+
+static FeedbackSlot FirstSlotOfKind(Handle<FeedbackVector> vector,
+                                    FeedbackSlotKind kind) {
+  for (int i = 0; i < vector->slot_count();) {
+    FeedbackSlot slot(i);
+    if (vector->GetKind(slot) == kind) return slot;
+    i += FeedbackMetadata::GetSlotSize(vector->GetKind(slot));
+  }
+  UNREACHABLE();
+  return FeedbackSlot::Invalid();
+}
+
+static v8::ScriptCompiler::CachedData* ProduceFeedbackCache(
+    const char* source, const char* warm_up) {
+  v8::ScriptCompiler::CachedData* cache;
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate1 = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate1);
+    v8::HandleScope scope(isolate1);
+    v8::Local<v8::Context> context = v8::Context::New(isolate1);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::UnboundScript> script =
+        CompileFeedbackSource(isolate1, source);
+    CompileRun(warm_up);
+    v8::ScriptCompiler::CachedData* data =
+        v8::ScriptCompiler::CreateFeedbackCache(script, v8_str(source));
+    // Persist cached data.
+    uint8_t* buffer = NewArray<uint8_t>(data->length);
+    MemCopy(buffer, data->data, data->length);
+    cache = new v8::ScriptCompiler::CachedData(
+        buffer, data->length, v8::ScriptCompiler::CachedData::BufferOwned);
+    delete data;
+  }
+  isolate1->Dispose();
+  return cache;
+}
+
+TEST(FeedbackSerializerIsolates) {
+  FLAG_ignition = true;
+  v8::ScriptCompiler::CachedData* cache =
+      ProduceFeedbackCache(kFeedbackSource, "run(100);");
+
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate2 = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate2);
+    v8::HandleScope scope(isolate2);
+    v8::Local<v8::Context> context = v8::Context::New(isolate2);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::UnboundScript> script =
+        CompileFeedbackSource(isolate2, kFeedbackSource);
+    CHECK(v8::ScriptCompiler::ConsumeFeedbackCache(
+        script, v8_str(kFeedbackSource), cache));
+    CHECK(!cache->rejected);
+
+    // A single call with small integers sees the imported feedback.
+    CompileRun("run(1);");
+    Handle<FeedbackVector> add = FeedbackVectorOf("add");
+    CHECK_LE(100, add->invocation_count());
+    FeedbackSlot binary_op = FirstSlotOfKind(add, FeedbackSlotKind::kBinaryOp);
+    CHECK_EQ(BinaryOperationFeedback::kNumber,
+             Smi::cast(add->Get(binary_op))->value());
+
+    Handle<FeedbackVector> run = FeedbackVectorOf("run");
+    FeedbackSlot call = FirstSlotOfKind(run, FeedbackSlotKind::kCall);
+    CallICNexus nexus(run, call);
+    CHECK_LE(100, nexus.ExtractCallCount());
+  }
+  isolate2->Dispose();
+  delete cache;
+}
+
+TEST(FeedbackSerializerSourceMismatch) {
+  FLAG_ignition = true;
+  v8::ScriptCompiler::CachedData* cache =
+      ProduceFeedbackCache(kFeedbackSource, "run(100);");
+
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate2 = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate2);
+    v8::HandleScope scope(isolate2);
+    v8::Local<v8::Context> context = v8::Context::New(isolate2);
+    v8::Context::Scope context_scope(context);
+
+    // The sources only differ in a single character. The source hash covers
+    // the contents, not just the length.
+    const char* source =
+        "function add(a, b) { return a - b; }"
+        "function run(n) {"
+        "  var sum = 0;"
+        "  for (var i = 0; i < n; i++) sum = add(sum, 0.5);"
+        "  return sum;"
+        "}";
+    CHECK_EQ(strlen(kFeedbackSource), strlen(source));
+    v8::Local<v8::UnboundScript> script =
+        CompileFeedbackSource(isolate2, source);
+    CHECK(!v8::ScriptCompiler::ConsumeFeedbackCache(script, v8_str(source),
+                                                     cache));
+    CHECK(cache->rejected);
+  }
+  isolate2->Dispose();
+  delete cache;
+}
+
+static void FeedbackProfilerTick(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  RuntimeProfiler* profiler =
+      reinterpret_cast<Isolate*>(args.GetIsolate())->runtime_profiler();
+  // Pretend that ICs are still warming up, which keeps the profiler from
+  // optimizing small functions on their first tick.
+  profiler->NotifyICChanged();
+  profiler->MarkCandidatesForOptimization();
+}
+
+TEST(FeedbackSerializerHotInPreviousRun) {
+  FLAG_allow_natives_syntax = true;
+  FLAG_concurrent_recompilation = false;
+  FLAG_ignition = true;
+  FlagList::EnforceFlagImplications();
+
+  const char* source =
+      "function hot() { return tick(); }"
+      "function cold() { return tick(); }"
+      "function getX(o) { tick(); return o.x; }";
+  v8::ScriptCompiler::CachedData* cache = ProduceFeedbackCache(
+      source,
+      "function tick() {}"
+      "hot(); cold(); getX({x: 1});"
+      "%OptimizeFunctionOnNextCall(hot);"
+      "%OptimizeFunctionOnNextCall(getX);"
+      "hot(); getX({x: 1});");
+
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate2 = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate2);
+    v8::HandleScope scope(isolate2);
+    v8::Local<v8::Context> context = v8::Context::New(isolate2);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::UnboundScript> script =
+        CompileFeedbackSource(isolate2, source);
+    CHECK(v8::ScriptCompiler::ConsumeFeedbackCache(script, v8_str(source),
+                                                    cache));
+    CHECK(!cache->rejected);
+    v8::Local<v8::Function> tick =
+        v8::FunctionTemplate::New(isolate2, FeedbackProfilerTick)
+            ->GetFunction(context)
+            .ToLocalChecked();
+    CHECK(context->Global()->Set(context, v8_str("tick"), tick).FromJust());
+
+    // Each call ticks the profiler once with the caller on the stack. Only
+    // the function that was optimized in the recorded run is marked.
+    CompileRun("cold();");
+    Handle<JSFunction> cold = FeedbackFunctionOf("cold");
+    CHECK(!cold->IsMarkedForOptimization());
+    CHECK(!cold->IsMarkedForConcurrentOptimization());
+
+    CompileRun("hot();");
+    Handle<JSFunction> hot = FeedbackFunctionOf("hot");
+    CHECK_EQ(0, hot->shared()->opt_count());
+    CHECK(hot->IsMarkedForOptimization());
+
+    // The property access feedback of getX can't be imported, so it has to
+    // warm up again even though it was optimized in the recorded run.
+    CompileRun("getX({x: 1});");
+    Handle<JSFunction> get_x = FeedbackFunctionOf("getX");
+    CHECK(!get_x->IsMarkedForOptimization());
+    CHECK(!get_x->IsMarkedForConcurrentOptimization());
+  }
+  isolate2->Dispose();
+  delete cache;
+}
+
+TEST(CodeSerializerOptimizationRecipe) {
+  FLAG_serialize_toplevel = true;
+  FLAG_allow_natives_syntax = true;
+  FLAG_concurrent_recompilation = false;
+  FLAG_ignition = true;
+  FlagList::EnforceFlagImplications();
+
+  const char* source =
+      "function add(a, b) { return a + b; }"
+      "function getX(o) { return o.x; }"
+      "function warmUp() {"
+      "  add(1.5, 2); add(1.5, 2);"
+      "  getX({x: 1}); getX({x: 1});"
+      "  %OptimizeFunctionOnNextCall(add);"
+      "  %OptimizeFunctionOnNextCall(getX);"
+      "  add(1.5, 2); getX({x: 1});"
+      "}";
+
+  v8::ScriptCompiler::CachedData* cache;
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate1 = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate1);
+    v8::HandleScope scope(isolate1);
+    v8::Local<v8::Context> context = v8::Context::New(isolate1);
+    v8::Context::Scope context_scope(context);
+
+    v8::ScriptOrigin origin(v8_str("test"));
+    v8::ScriptCompiler::Source script_source(v8_str(source), origin);
+    v8::Local<v8::UnboundScript> script =
+        v8::ScriptCompiler::CompileUnboundScript(
+            isolate1, &script_source, v8::ScriptCompiler::kProduceCodeCache)
+            .ToLocalChecked();
+    script->BindToCurrentContext()->Run(context).ToLocalChecked();
+    CompileRun("warmUp();");
+    cache = v8::ScriptCompiler::CreateOptimizedCodeCache(
+        script, v8_str(source), script_source.GetCachedData());
+    CHECK_NOT_NULL(cache);
+  }
+  isolate1->Dispose();
+
+  v8::Isolate* isolate2 = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate2);
+    v8::HandleScope scope(isolate2);
+    v8::Local<v8::Context> context = v8::Context::New(isolate2);
+    v8::Context::Scope context_scope(context);
+
+    v8::ScriptOrigin origin(v8_str("test"));
+    v8::ScriptCompiler::Source script_source(v8_str(source), origin, cache);
+    v8::Local<v8::UnboundScript> script =
+        v8::ScriptCompiler::CompileUnboundScript(
+            isolate2, &script_source, v8::ScriptCompiler::kConsumeCodeCache)
+            .ToLocalChecked();
+    CHECK(!cache->rejected);
+    script->BindToCurrentContext()->Run(context).ToLocalChecked();
+
+    // Only the function whose feedback was fully restored is optimized on
+    // its first call.
+    CompileRun("add(1.5, 2); getX({x: 1});");
+    CHECK(FeedbackVectorOf("add")->shared_function_info()->opt_count() > 0);
+    CHECK_EQ(0, FeedbackVectorOf("getX")->shared_function_info()->opt_count());
+  }
+  isolate2->Dispose();
+}
+
 TEST(SnapshotCreatorMultipleContexts) {
   DisableAlwaysOpt();
   v8::StartupData blob;
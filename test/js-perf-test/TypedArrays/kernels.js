@@ -0,0 +1,118 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Loops over typed arrays whose element accesses are bounds checked.
+
+new BenchmarkSuite('Sum', [1000], [
+  new Benchmark('Sum', false, false, 0, Sum, KernelsSetup, KernelsTearDown),
+]);
+
+new BenchmarkSuite('Saxpy', [1000], [
+  new Benchmark('Saxpy', false, false, 0, Saxpy, KernelsSetup,
+                KernelsTearDown),
+]);
+
+new BenchmarkSuite('Dot', [1000], [
+  new Benchmark('Dot', false, false, 0, Dot, KernelsSetup, KernelsTearDown),
+]);
+
+new BenchmarkSuite('Stencil', [1000], [
+  new Benchmark('Stencil', false, false, 0, Stencil, KernelsSetup,
+                KernelsTearDown),
+]);
+
+new BenchmarkSuite('Polynomial', [1000], [
+  new Benchmark('Polynomial', false, false, 0, Polynomial, KernelsSetup,
+                KernelsTearDown),
+]);
+
+var kLength = 4096;
+var x;
+var y;
+var result;
+
+function KernelsSetup() {
+  x = new Float64Array(kLength);
+  y = new Float64Array(kLength);
+  for (var i = 0; i < kLength; ++i) {
+    x[i] = i % 7;
+    y[i] = i % 5;
+  }
+  result = 0;
+}
+
+function KernelsTearDown() {
+  if (typeof result !== 'number' || result !== result) {
+    throw new TypeError('Unexpected result: ' + result);
+  }
+  x = void 0;
+  y = void 0;
+}
+
+// The loop condition compares against the length of the accessed array.
+function SumKernel(a) {
+  var sum = 0;
+  for (var i = 0; i < a.length; ++i) {
+    sum += a[i];
+  }
+  return sum;
+}
+
+function Sum() {
+  result = SumKernel(x);
+}
+
+// The loop condition compares against an explicit element count.
+function SaxpyKernel(n, alpha, a, b) {
+  for (var i = 0; i < n; ++i) {
+    b[i] = alpha * a[i] + b[i];
+  }
+}
+
+function Saxpy() {
+  SaxpyKernel(kLength, 0.5, x, y);
+  result = y[kLength - 1];
+}
+
+function DotKernel(n, a, b) {
+  var dot = 0;
+  for (var i = 0; i < n; ++i) {
+    dot += a[i] * b[i];
+  }
+  return dot;
+}
+
+function Dot() {
+  result = DotKernel(kLength, x, y);
+}
+
+function StencilKernel(a, b) {
+  var n = a.length - 1;
+  for (var i = 1; i < n; ++i) {
+    b[i] = (a[i - 1] + a[i] + a[i + 1]) / 3;
+  }
+}
+
+function Stencil() {
+  StencilKernel(x, y);
+  result = y[1];
+}
+
+// Compute heavy code with independent multiplications and a division, whose
+// performance depends on the order of the instructions.
+function PolynomialKernel(n, a, b) {
+  for (var i = 0; i < n; ++i) {
+    var t = a[i] * 0.125;
+    var t2 = t * t;
+    var t4 = t2 * t2;
+    var p = (1.0 + 0.5 * t) + (0.25 + 0.125 * t) * t2 +
+            ((0.0625 + 0.03125 * t) + (0.015625 + 0.0078125 * t) * t2) * t4;
+    b[i] = p / (1.0 + t2);
+  }
+}
+
+function Polynomial() {
+  PolynomialKernel(kLength, x, y);
+  result = y[kLength - 1];
+}
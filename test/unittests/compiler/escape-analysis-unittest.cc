@@ -403,6 +403,287 @@ TEST_F(EscapeAnalysisTest, BranchEscapeThroughStore) {
 }
 
 
+TEST_F(EscapeAnalysisTest, PhiNonEscape) {
+  Node* object1 = Constant(1);
+  Node* object2 = Constant(2);
+  Branch();
+  Node* ifFalse = IfFalse();
+  Node* ifTrue = IfTrue();
+  BeginRegion(graph()->start());
+  Node* allocation1 = Allocate(Constant(kPointerSize), nullptr, ifFalse);
+  Store(FieldAccessAtIndex(0), allocation1, object1, nullptr, ifFalse);
+  Node* finish1 = FinishRegion(allocation1);
+  BeginRegion(graph()->start());
+  Node* allocation2 = Allocate(Constant(kPointerSize), nullptr, ifTrue);
+  Store(FieldAccessAtIndex(0), allocation2, object2, nullptr, ifTrue);
+  Node* finish2 = FinishRegion(allocation2);
+  Node* merge = Merge2(ifFalse, ifTrue);
+  Node* effect_phi =
+      graph()->NewNode(common()->EffectPhi(2), finish1, finish2, merge);
+  Node* phi = graph()->NewNode(common()->Phi(MachineRepresentation::kTagged, 2),
+                               finish1, finish2, merge);
+  Node* load = Load(FieldAccessAtIndex(0), phi, effect_phi, merge);
+  Node* result = Return(load, effect_phi, merge);
+  EndGraph();
+
+  Analysis();
+
+  ExpectVirtual(allocation1);
+  ExpectVirtual(allocation2);
+  ExpectReplacementPhi(load, object1, object2);
+  Node* replacement_phi = escape_analysis()->GetReplacement(load);
+
+  Transformation();
+
+  ASSERT_EQ(replacement_phi, NodeProperties::GetValueInput(result, 1));
+}
+
+
+TEST_F(EscapeAnalysisTest, PhiEscapeThroughUse) {
+  Node* object1 = Constant(1);
+  Node* object2 = Constant(2);
+  Branch();
+  Node* ifFalse = IfFalse();
+  Node* ifTrue = IfTrue();
+  BeginRegion(graph()->start());
+  Node* allocation1 = Allocate(Constant(kPointerSize), nullptr, ifFalse);
+  Store(FieldAccessAtIndex(0), allocation1, object1, nullptr, ifFalse);
+  Node* finish1 = FinishRegion(allocation1);
+  BeginRegion(graph()->start());
+  Node* allocation2 = Allocate(Constant(kPointerSize), nullptr, ifTrue);
+  Store(FieldAccessAtIndex(0), allocation2, object2, nullptr, ifTrue);
+  Node* finish2 = FinishRegion(allocation2);
+  Node* merge = Merge2(ifFalse, ifTrue);
+  Node* effect_phi =
+      graph()->NewNode(common()->EffectPhi(2), finish1, finish2, merge);
+  Node* phi = graph()->NewNode(common()->Phi(MachineRepresentation::kTagged, 2),
+                               finish1, finish2, merge);
+  Node* result = Return(phi, effect_phi, merge);
+  EndGraph();
+
+  Analysis();
+
+  ExpectEscaped(allocation1);
+  ExpectEscaped(allocation2);
+
+  Transformation();
+
+  ASSERT_EQ(phi, NodeProperties::GetValueInput(result, 1));
+}
+
+
+TEST_F(EscapeAnalysisTest, PhiEscapeThroughModification) {
+  Node* object1 = Constant(1);
+  Node* object2 = Constant(2);
+  Branch();
+  Node* ifFalse = IfFalse();
+  Node* ifTrue = IfTrue();
+  BeginRegion(graph()->start());
+  Node* allocation1 = Allocate(Constant(kPointerSize), nullptr, ifFalse);
+  Store(FieldAccessAtIndex(0), allocation1, object1, nullptr, ifFalse);
+  Node* finish1 = FinishRegion(allocation1);
+  Node* effect1 =
+      Store(FieldAccessAtIndex(0), finish1, object2, finish1, ifFalse);
+  BeginRegion(graph()->start());
+  Node* allocation2 = Allocate(Constant(kPointerSize), nullptr, ifTrue);
+  Store(FieldAccessAtIndex(0), allocation2, object2, nullptr, ifTrue);
+  Node* finish2 = FinishRegion(allocation2);
+  Node* merge = Merge2(ifFalse, ifTrue);
+  Node* effect_phi =
+      graph()->NewNode(common()->EffectPhi(2), effect1, finish2, merge);
+  Node* phi = graph()->NewNode(common()->Phi(MachineRepresentation::kTagged, 2),
+                               finish1, finish2, merge);
+  Node* load = Load(FieldAccessAtIndex(0), phi, effect_phi, merge);
+  Node* result = Return(load, effect_phi, merge);
+  EndGraph();
+
+  Analysis();
+
+  ExpectEscaped(allocation1);
+  ExpectEscaped(allocation2);
+
+  Transformation();
+
+  ASSERT_EQ(load, NodeProperties::GetValueInput(result, 1));
+}
+
+
+TEST_F(EscapeAnalysisTest, LoopPhiNonEscape) {
+  Node* object1 = Constant(1);
+  Node* object2 = Constant(2);
+  BeginRegion();
+  Node* allocation1 = Allocate(Constant(kPointerSize));
+  Store(FieldAccessAtIndex(0), allocation1, object1);
+  Node* finish1 = FinishRegion(allocation1);
+  // The back edges are wired up once the loop body is built.
+  Node* loop =
+      graph()->NewNode(common()->Loop(2), graph()->start(), graph()->start());
+  Node* effect_phi =
+      graph()->NewNode(common()->EffectPhi(2), finish1, finish1, loop);
+  Node* phi = graph()->NewNode(common()->Phi(MachineRepresentation::kTagged, 2),
+                               finish1, finish1, loop);
+  Node* load = Load(FieldAccessAtIndex(0), phi, effect_phi, loop);
+  Node* branch = graph()->NewNode(common()->Branch(), Constant(0), loop);
+  Node* if_true = graph()->NewNode(common()->IfTrue(), branch);
+  Node* if_false = graph()->NewNode(common()->IfFalse(), branch);
+  BeginRegion(load);
+  Node* allocation2 = Allocate(Constant(kPointerSize), nullptr, if_true);
+  Store(FieldAccessAtIndex(0), allocation2, object2, nullptr, if_true);
+  Node* finish2 = FinishRegion(allocation2);
+  loop->ReplaceInput(1, if_true);
+  effect_phi->ReplaceInput(1, finish2);
+  phi->ReplaceInput(1, finish2);
+  Node* result = Return(load, load, if_false);
+  EndGraph();
+
+  Analysis();
+
+  // The load from the loop phi is only resolved once the loop body was
+  // analyzed.
+  ExpectVirtual(allocation1);
+  ExpectVirtual(allocation2);
+  ExpectReplacementPhi(load, object1, object2);
+  Node* replacement_phi = escape_analysis()->GetReplacement(load);
+  EXPECT_EQ(loop, NodeProperties::GetControlInput(replacement_phi));
+
+  Transformation();
+
+  ASSERT_EQ(replacement_phi, NodeProperties::GetValueInput(result, 1));
+}
+
+
+TEST_F(EscapeAnalysisTest, LoopPhiEscapeThroughModification) {
+  Node* object1 = Constant(1);
+  Node* object2 = Constant(2);
+  BeginRegion();
+  Node* allocation1 = Allocate(Constant(kPointerSize));
+  Store(FieldAccessAtIndex(0), allocation1, object1);
+  Node* finish1 = FinishRegion(allocation1);
+  Node* loop =
+      graph()->NewNode(common()->Loop(2), graph()->start(), graph()->start());
+  Node* effect_phi =
+      graph()->NewNode(common()->EffectPhi(2), finish1, finish1, loop);
+  Node* phi = graph()->NewNode(common()->Phi(MachineRepresentation::kTagged, 2),
+                               finish1, finish1, loop);
+  Node* load = Load(FieldAccessAtIndex(0), phi, effect_phi, loop);
+  Node* branch = graph()->NewNode(common()->Branch(), Constant(0), loop);
+  Node* if_true = graph()->NewNode(common()->IfTrue(), branch);
+  Node* if_false = graph()->NewNode(common()->IfFalse(), branch);
+  BeginRegion(load);
+  Node* allocation2 = Allocate(Constant(kPointerSize), nullptr, if_true);
+  Store(FieldAccessAtIndex(0), allocation2, object2, nullptr, if_true);
+  Node* finish2 = FinishRegion(allocation2);
+  // The object of the back edge is modified after its region.
+  Node* back_effect =
+      Store(FieldAccessAtIndex(0), finish2, object1, finish2, if_true);
+  loop->ReplaceInput(1, if_true);
+  effect_phi->ReplaceInput(1, back_effect);
+  phi->ReplaceInput(1, finish2);
+  Node* result = Return(load, load, if_false);
+  EndGraph();
+
+  Analysis();
+
+  ExpectEscaped(allocation1);
+  ExpectEscaped(allocation2);
+
+  Transformation();
+
+  ASSERT_EQ(load, NodeProperties::GetValueInput(result, 1));
+}
+
+
+TEST_F(EscapeAnalysisTest, LoopPhiEscapeThroughTypeGuard) {
+  Node* object1 = Constant(1);
+  Node* object2 = Constant(2);
+  BeginRegion();
+  Node* allocation1 = Allocate(Constant(kPointerSize));
+  Store(FieldAccessAtIndex(0), allocation1, object1);
+  Node* finish1 = FinishRegion(allocation1);
+  Node* loop =
+      graph()->NewNode(common()->Loop(2), graph()->start(), graph()->start());
+  Node* effect_phi =
+      graph()->NewNode(common()->EffectPhi(2), finish1, finish1, loop);
+  Node* phi = graph()->NewNode(common()->Phi(MachineRepresentation::kTagged, 2),
+                               finish1, finish1, loop);
+  Node* load = Load(FieldAccessAtIndex(0), phi, effect_phi, loop);
+  Node* branch = graph()->NewNode(common()->Branch(), Constant(0), loop);
+  Node* if_true = graph()->NewNode(common()->IfTrue(), branch);
+  Node* if_false = graph()->NewNode(common()->IfFalse(), branch);
+  BeginRegion(load);
+  Node* allocation2 = Allocate(Constant(kPointerSize), nullptr, if_true);
+  Store(FieldAccessAtIndex(0), allocation2, object2, nullptr, if_true);
+  Node* finish2 = FinishRegion(allocation2);
+  // The object of the back edge is modified through a renaming after its
+  // region.
+  Node* guard =
+      graph()->NewNode(common()->TypeGuard(Type::Any()), finish2, if_true);
+  Node* back_effect =
+      Store(FieldAccessAtIndex(0), guard, object1, finish2, if_true);
+  loop->ReplaceInput(1, if_true);
+  effect_phi->ReplaceInput(1, back_effect);
+  phi->ReplaceInput(1, finish2);
+  Node* result = Return(load, load, if_false);
+  EndGraph();
+
+  Analysis();
+
+  ExpectEscaped(allocation1);
+  ExpectEscaped(allocation2);
+
+  Transformation();
+
+  ASSERT_EQ(load, NodeProperties::GetValueInput(result, 1));
+}
+
+
+TEST_F(EscapeAnalysisTest, LoopPhiEscapeThroughLoadedAlias) {
+  Node* object1 = Constant(1);
+  Node* object2 = Constant(2);
+  BeginRegion();
+  Node* allocation1 = Allocate(Constant(kPointerSize));
+  Store(FieldAccessAtIndex(0), allocation1, object1);
+  Node* finish1 = FinishRegion(allocation1);
+  Node* loop =
+      graph()->NewNode(common()->Loop(2), graph()->start(), graph()->start());
+  Node* effect_phi =
+      graph()->NewNode(common()->EffectPhi(2), finish1, finish1, loop);
+  Node* phi = graph()->NewNode(common()->Phi(MachineRepresentation::kTagged, 2),
+                               finish1, finish1, loop);
+  Node* load = Load(FieldAccessAtIndex(0), phi, effect_phi, loop);
+  Node* branch = graph()->NewNode(common()->Branch(), Constant(0), loop);
+  Node* if_true = graph()->NewNode(common()->IfTrue(), branch);
+  Node* if_false = graph()->NewNode(common()->IfFalse(), branch);
+  BeginRegion(load);
+  Node* allocation2 = Allocate(Constant(kPointerSize), nullptr, if_true);
+  Store(FieldAccessAtIndex(0), allocation2, object2, nullptr, if_true);
+  Node* finish2 = FinishRegion(allocation2);
+  // The object of the back edge is stored into a holder, loaded back and
+  // modified through the loaded value. Only the object analysis sees that
+  // the load is an alias of the object.
+  BeginRegion(finish2);
+  Node* holder = Allocate(Constant(kPointerSize), nullptr, if_true);
+  Store(FieldAccessAtIndex(0), holder, finish2, nullptr, if_true);
+  Node* finish3 = FinishRegion(holder);
+  Node* alias = Load(FieldAccessAtIndex(0), finish3, finish3, if_true);
+  Node* back_effect =
+      Store(FieldAccessAtIndex(0), alias, object1, alias, if_true);
+  loop->ReplaceInput(1, if_true);
+  effect_phi->ReplaceInput(1, back_effect);
+  phi->ReplaceInput(1, finish2);
+  Node* result = Return(load, load, if_false);
+  EndGraph();
+
+  Analysis();
+
+  ExpectEscaped(allocation1);
+
+  Transformation();
+
+  ASSERT_EQ(load, NodeProperties::GetValueInput(result, 1));
+}
+
+
 TEST_F(EscapeAnalysisTest, DanglingLoadOrder) {
   Node* object1 = Constant(1);
   Node* object2 = Constant(2);
@@ -0,0 +1,192 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/compiler/loop-bounds-check-elimination.h"
+#include "src/compiler/js-graph.h"
+#include "src/compiler/js-operator.h"
+#include "src/compiler/machine-operator.h"
+#include "src/compiler/node-properties.h"
+#include "src/compiler/simplified-operator.h"
+#include "test/unittests/compiler/graph-unittest.h"
+#include "test/unittests/compiler/node-test-utils.h"
+
+namespace v8 {
+namespace internal {
+namespace compiler {
+
+class LoopBoundsCheckEliminationTest : public TypedGraphTest {
+ public:
+  LoopBoundsCheckEliminationTest()
+      : TypedGraphTest(3),
+        javascript_(zone()),
+        machine_(zone()),
+        simplified_(zone()),
+        jsgraph_(isolate(), graph(), common(), &javascript_, &simplified_,
+                 &machine_) {}
+  ~LoopBoundsCheckEliminationTest() override {}
+
+ protected:
+  // Where the check is placed in the loop.
+  enum Placement {
+    kInHeader,           // Before the loop condition.
+    kInBody,             // On every iteration after the loop condition.
+    kInConditionalBody,  // Only on some iterations after the loop condition.
+  };
+
+  // A loop for (i = 0; i < limit; i += 1) { index = CheckBounds(i, length) }
+  struct CountingLoop {
+    Node* loop;
+    Node* effect_phi;
+    Node* phi;
+    Node* if_true;
+    Node* check;
+    Node* use;
+  };
+
+  CountingLoop NewCountingLoop(Node* limit, Node* length, Node* effect,
+                               Placement placement = kInBody) {
+    CountingLoop l;
+    Node* zero = NumberConstant(0);
+    Node* one = NumberConstant(1);
+    l.loop = graph()->NewNode(common()->Loop(2), start(), start());
+    l.effect_phi =
+        graph()->NewNode(common()->EffectPhi(2), effect, effect, l.loop);
+    l.phi = graph()->NewNode(common()->Phi(MachineRepresentation::kTagged, 2),
+                             zero, zero, l.loop);
+    NodeProperties::SetType(l.phi, Type::Range(0.0, 1024.0, zone()));
+    Node* add = graph()->NewNode(simplified()->NumberAdd(), l.phi, one);
+    NodeProperties::SetType(add, Type::Range(1.0, 1025.0, zone()));
+    l.phi->ReplaceInput(1, add);
+
+    Node* cond = graph()->NewNode(simplified()->NumberLessThan(), l.phi, limit);
+    Node* branch = graph()->NewNode(common()->Branch(), cond, l.loop);
+    l.if_true = graph()->NewNode(common()->IfTrue(), branch);
+    Node* if_false = graph()->NewNode(common()->IfFalse(), branch);
+
+    Node* control = placement == kInHeader ? l.loop : l.if_true;
+    Node* backedge = l.if_true;
+    if (placement == kInConditionalBody) {
+      Node* body_branch =
+          graph()->NewNode(common()->Branch(), Parameter(2), l.if_true);
+      control = graph()->NewNode(common()->IfTrue(), body_branch);
+      Node* skip = graph()->NewNode(common()->IfFalse(), body_branch);
+      backedge = graph()->NewNode(common()->Merge(2), control, skip);
+    }
+    l.loop->ReplaceInput(1, backedge);
+
+    l.check = graph()->NewNode(simplified()->CheckBounds(), l.phi, length,
+                               l.effect_phi, control);
+    NodeProperties::SetType(l.check, Type::Range(0.0, 1023.0, zone()));
+    Node* backedge_effect = l.check;
+    if (placement == kInConditionalBody) {
+      backedge_effect = graph()->NewNode(common()->EffectPhi(2), l.check,
+                                         l.effect_phi, backedge);
+    }
+    l.effect_phi->ReplaceInput(1, backedge_effect);
+    l.use = graph()->NewNode(simplified()->NumberAdd(), l.check, one);
+
+    Node* ret = graph()->NewNode(common()->Return(), zero, l.use, l.effect_phi,
+                                 if_false);
+    graph()->SetEnd(graph()->NewNode(common()->End(1), ret));
+    return l;
+  }
+
+  void Run(LoopBoundsCheckElimination::Flags flags) {
+    LoopBoundsCheckElimination elimination(jsgraph(), flags, zone());
+    elimination.Run();
+  }
+
+  JSGraph* jsgraph() { return &jsgraph_; }
+  SimplifiedOperatorBuilder* simplified() { return &simplified_; }
+
+ private:
+  JSOperatorBuilder javascript_;
+  MachineOperatorBuilder machine_;
+  SimplifiedOperatorBuilder simplified_;
+  JSGraph jsgraph_;
+};
+
+TEST_F(LoopBoundsCheckEliminationTest, EliminateCheckDominatedByCondition) {
+  Node* length = Parameter(Type::UnsignedSmall(), 0);
+  CountingLoop l = NewCountingLoop(length, length, start());
+
+  Run(LoopBoundsCheckElimination::kNoFlags);
+
+  EXPECT_THAT(l.use->InputAt(0), IsTypeGuard(l.phi, l.if_true));
+  EXPECT_EQ(l.effect_phi, l.effect_phi->InputAt(1));
+}
+
+TEST_F(LoopBoundsCheckEliminationTest, KeepCheckNotDominatedByCondition) {
+  Node* length = Parameter(Type::UnsignedSmall(), 0);
+  CountingLoop l = NewCountingLoop(length, length, start(), kInHeader);
+
+  Run(LoopBoundsCheckElimination::kHoistingEnabled);
+
+  EXPECT_EQ(l.check, l.use->InputAt(0));
+  EXPECT_EQ(IrOpcode::kCheckBounds, l.check->opcode());
+}
+
+TEST_F(LoopBoundsCheckEliminationTest, HoistCheckOfDifferentLimit) {
+  Node* length = Parameter(Type::UnsignedSmall(), 0);
+  Node* limit = Parameter(Type::UnsignedSmall(), 1);
+  Node* checkpoint = graph()->NewNode(common()->Checkpoint(),
+                                      EmptyFrameState(), start(), start());
+  CountingLoop l = NewCountingLoop(limit, length, checkpoint);
+
+  Run(LoopBoundsCheckElimination::kHoistingEnabled);
+
+  EXPECT_THAT(l.use->InputAt(0), IsTypeGuard(l.phi, l.if_true));
+  Node* check_if = l.effect_phi->InputAt(0);
+  ASSERT_EQ(IrOpcode::kCheckIf, check_if->opcode());
+  Node* condition = check_if->InputAt(0);
+  EXPECT_EQ(IrOpcode::kNumberLessThanOrEqual, condition->opcode());
+  EXPECT_EQ(limit, condition->InputAt(0));
+  EXPECT_EQ(length, condition->InputAt(1));
+  Node* hoisted_checkpoint = NodeProperties::GetEffectInput(check_if);
+  ASSERT_EQ(IrOpcode::kCheckpoint, hoisted_checkpoint->opcode());
+  EXPECT_EQ(checkpoint, NodeProperties::GetEffectInput(hoisted_checkpoint));
+}
+
+TEST_F(LoopBoundsCheckEliminationTest, KeepCheckOfDifferentLimit) {
+  Node* length = Parameter(Type::UnsignedSmall(), 0);
+  Node* limit = Parameter(Type::UnsignedSmall(), 1);
+  Node* checkpoint = graph()->NewNode(common()->Checkpoint(),
+                                      EmptyFrameState(), start(), start());
+  CountingLoop l = NewCountingLoop(limit, length, checkpoint);
+
+  Run(LoopBoundsCheckElimination::kNoFlags);
+
+  EXPECT_EQ(l.check, l.use->InputAt(0));
+  EXPECT_EQ(checkpoint, l.effect_phi->InputAt(0));
+}
+
+TEST_F(LoopBoundsCheckEliminationTest, KeepConditionalCheckOfDifferentLimit) {
+  Node* length = Parameter(Type::UnsignedSmall(), 0);
+  Node* limit = Parameter(Type::UnsignedSmall(), 1);
+  Node* checkpoint = graph()->NewNode(common()->Checkpoint(),
+                                      EmptyFrameState(), start(), start());
+  CountingLoop l =
+      NewCountingLoop(limit, length, checkpoint, kInConditionalBody);
+
+  Run(LoopBoundsCheckElimination::kHoistingEnabled);
+
+  // A hoisted check could fail for a loop that never executes the check.
+  EXPECT_EQ(l.check, l.use->InputAt(0));
+  EXPECT_EQ(checkpoint, l.effect_phi->InputAt(0));
+}
+
+TEST_F(LoopBoundsCheckEliminationTest, KeepCheckWithoutCheckpoint) {
+  Node* length = Parameter(Type::UnsignedSmall(), 0);
+  Node* limit = Parameter(Type::UnsignedSmall(), 1);
+  CountingLoop l = NewCountingLoop(limit, length, start());
+
+  Run(LoopBoundsCheckElimination::kHoistingEnabled);
+
+  EXPECT_EQ(l.check, l.use->InputAt(0));
+  EXPECT_EQ(start(), l.effect_phi->InputAt(0));
+}
+
+}  // namespace compiler
+}  // namespace internal
+}  // namespace v8
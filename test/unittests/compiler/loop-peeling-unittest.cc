@@ -521,6 +521,77 @@ TEST_F(LoopPeelingTest, SimpleLoopWithUnmarkedExit) {
   }
 }
 
+TEST_F(LoopPeelingTest, UnrollSimpleLoopWithCounter) {
+  Node* p0 = Parameter(0);
+  While w = NewWhile(p0);
+  Counter c = NewCounter(&w, 0, 1);
+  Node* r = InsertReturn(c.exit_marker, start(), w.exit);
+
+  LoopTree* loop_tree = LoopFinder::BuildLoopTree(graph(), zone());
+  LoopTree::Loop* loop = loop_tree->outer_loops()[0];
+  EXPECT_TRUE(
+      LoopPeeler::Unroll(graph(), common(), loop_tree, loop, 2, zone()));
+
+  // The loop now runs two copies of the body per iteration.
+  Capture<Node*> branch1;
+  EXPECT_THAT(w.loop,
+              IsLoop(start(), IsIfTrue(AllOf(CaptureEq(&branch1),
+                                             IsBranch(p0, w.if_true)))));
+  EXPECT_THAT(c.phi, IsPhi(MachineRepresentation::kTagged, c.base,
+                           IsInt32Add(c.add, c.inc), w.loop));
+
+  // The exits of both copies are merged.
+  Node* merge = NodeProperties::GetControlInput(r);
+  ASSERT_EQ(IrOpcode::kMerge, merge->opcode());
+  ASSERT_EQ(2, merge->InputCount());
+  EXPECT_EQ(w.exit, merge->InputAt(0));
+  Node* exit1 = merge->InputAt(1);
+  ASSERT_EQ(IrOpcode::kLoopExit, exit1->opcode());
+  EXPECT_THAT(exit1->InputAt(0), IsIfFalse(branch1.value()));
+  EXPECT_EQ(w.loop, exit1->InputAt(1));
+
+  Node* phi = NodeProperties::GetValueInput(r, 1);
+  ASSERT_EQ(IrOpcode::kPhi, phi->opcode());
+  EXPECT_EQ(c.exit_marker, phi->InputAt(0));
+  Node* exit_marker1 = phi->InputAt(1);
+  ASSERT_EQ(IrOpcode::kLoopExitValue, exit_marker1->opcode());
+  EXPECT_EQ(c.add, exit_marker1->InputAt(0));
+  EXPECT_EQ(exit1, exit_marker1->InputAt(1));
+  EXPECT_EQ(merge, phi->InputAt(2));
+}
+
+TEST_F(LoopPeelingTest, UnrollLoopWithCounterByThree) {
+  Node* p0 = Parameter(0);
+  While w = NewWhile(p0);
+  Counter c = NewCounter(&w, 0, 1);
+  Node* r = InsertReturn(c.exit_marker, start(), w.exit);
+
+  LoopTree* loop_tree = LoopFinder::BuildLoopTree(graph(), zone());
+  LoopTree::Loop* loop = loop_tree->outer_loops()[0];
+  EXPECT_TRUE(
+      LoopPeeler::Unroll(graph(), common(), loop_tree, loop, 3, zone()));
+
+  EXPECT_THAT(c.phi,
+              IsPhi(MachineRepresentation::kTagged, c.base,
+                    IsInt32Add(IsInt32Add(c.add, c.inc), c.inc), w.loop));
+  Node* merge = NodeProperties::GetControlInput(r);
+  ASSERT_EQ(IrOpcode::kMerge, merge->opcode());
+  EXPECT_EQ(3, merge->InputCount());
+}
+
+TEST_F(LoopPeelingTest, UnrollLoopWithUnmarkedExit) {
+  Node* p0 = Parameter(0);
+  Node* loop = graph()->NewNode(common()->Loop(2), start(), start());
+  Branch b = NewBranch(p0, loop);
+  loop->ReplaceInput(1, b.if_true);
+
+  InsertReturn(p0, start(), b.if_false);
+
+  LoopTree* loop_tree = LoopFinder::BuildLoopTree(graph(), zone());
+  EXPECT_FALSE(LoopPeeler::Unroll(graph(), common(), loop_tree,
+                                  loop_tree->outer_loops()[0], 2, zone()));
+  EXPECT_THAT(loop, IsLoop(start(), b.if_true));
+}
 
 }  // namespace compiler
 }  // namespace internal
@@ -0,0 +1,319 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/compiler/loop-vectorization.h"
+#include "src/compiler/access-builder.h"
+#include "src/compiler/js-graph.h"
+#include "src/compiler/js-operator.h"
+#include "src/compiler/machine-operator.h"
+#include "src/compiler/node-properties.h"
+#include "src/compiler/simplified-operator.h"
+#include "test/unittests/compiler/graph-unittest.h"
+#include "test/unittests/compiler/node-test-utils.h"
+
+using testing::_;
+
+namespace v8 {
+namespace internal {
+namespace compiler {
+
+class LoopVectorizationTest : public GraphTest {
+ public:
+  LoopVectorizationTest()
+      : GraphTest(3),
+        javascript_(zone()),
+        machine_(zone()),
+        simplified_(zone()),
+        jsgraph_(isolate(), graph(), common(), &javascript_, &simplified_,
+                 &machine_) {}
+  ~LoopVectorizationTest() override {}
+
+ protected:
+  // A loop for (i = 0; i < limit; i++) { ... } whose body starts with a
+  // checkpoint.
+  struct CountingLoop {
+    Node* loop;
+    Node* effect_phi;
+    Node* phi;
+    Node* if_true;
+    Node* if_false;
+    Node* checkpoint;
+  };
+
+  // The operands of a typed array access.
+  struct TypedArray {
+    Node* buffer;
+    Node* base;
+    Node* external;
+  };
+
+  CountingLoop NewCountingLoop(Node* limit) {
+    CountingLoop l;
+    Node* zero = Int32Constant(0);
+    l.loop = graph()->NewNode(common()->Loop(2), start(), start());
+    l.effect_phi =
+        graph()->NewNode(common()->EffectPhi(2), start(), start(), l.loop);
+    l.phi = NewPhi(l, zero);
+    l.phi->ReplaceInput(
+        1, graph()->NewNode(machine()->Int32Add(), l.phi, Int32Constant(1)));
+
+    Node* cond = graph()->NewNode(machine()->Int32LessThan(), l.phi, limit);
+    Node* branch = graph()->NewNode(common()->Branch(), cond, l.loop);
+    l.if_true = graph()->NewNode(common()->IfTrue(), branch);
+    l.if_false = graph()->NewNode(common()->IfFalse(), branch);
+    l.loop->ReplaceInput(1, l.if_true);
+
+    l.checkpoint = graph()->NewNode(common()->Checkpoint(), EmptyFrameState(),
+                                    l.effect_phi, l.if_true);
+    return l;
+  }
+
+  Node* NewPhi(CountingLoop const& l, Node* value) {
+    return graph()->NewNode(common()->Phi(MachineRepresentation::kWord32, 2),
+                            value, value, l.loop);
+  }
+
+  TypedArray NewTypedArray(int index) {
+    return {Parameter(index), jsgraph()->ZeroConstant(), Parameter(index + 1)};
+  }
+
+  Node* CheckBounds(CountingLoop const& l, Node* length, Node** effect) {
+    return *effect = graph()->NewNode(simplified()->CheckBounds(), l.phi,
+                                      length, *effect, l.if_true);
+  }
+
+  Node* LoadElement(CountingLoop const& l, ExternalArrayType type,
+                    TypedArray const& array, Node* index, Node** effect) {
+    return *effect = graph()->NewNode(
+               simplified()->LoadTypedElement(type), array.buffer, array.base,
+               array.external, index, *effect, l.if_true);
+  }
+
+  Node* StoreElement(CountingLoop const& l, ExternalArrayType type,
+                     TypedArray const& array, Node* index, Node* value,
+                     Node** effect) {
+    return *effect = graph()->NewNode(
+               simplified()->StoreTypedElement(type), array.buffer, array.base,
+               array.external, index, value, *effect, l.if_true);
+  }
+
+  void Finish(CountingLoop const& l, Node* effect, Node* value) {
+    l.effect_phi->ReplaceInput(1, effect);
+    Node* ret = graph()->NewNode(common()->Return(), Int32Constant(0), value,
+                                 l.effect_phi, l.if_false);
+    graph()->SetEnd(graph()->NewNode(common()->End(1), ret));
+  }
+
+  void Run() {
+    LoopVectorization vectorization(jsgraph(), zone());
+    vectorization.Run();
+  }
+
+  JSGraph* jsgraph() { return &jsgraph_; }
+  MachineOperatorBuilder* machine() { return &machine_; }
+  SimplifiedOperatorBuilder* simplified() { return &simplified_; }
+
+ private:
+  JSOperatorBuilder javascript_;
+  MachineOperatorBuilder machine_;
+  SimplifiedOperatorBuilder simplified_;
+  JSGraph jsgraph_;
+};
+
+TEST_F(LoopVectorizationTest, VectorizeInt32Add) {
+  Node* length = Parameter(0);
+  TypedArray a = NewTypedArray(1);
+  TypedArray b = NewTypedArray(3);
+  TypedArray c = NewTypedArray(5);
+  CountingLoop l = NewCountingLoop(length);
+  Node* effect = l.checkpoint;
+  Node* index = CheckBounds(l, length, &effect);
+  Node* x = LoadElement(l, kExternalInt32Array, a, index, &effect);
+  Node* y = LoadElement(l, kExternalInt32Array, b, index, &effect);
+  Node* sum = graph()->NewNode(machine()->Int32Add(), x, y);
+  StoreElement(l, kExternalInt32Array, c, index, sum, &effect);
+  Finish(l, effect, Int32Constant(0));
+
+  Run();
+
+  // The vector loop advances by four elements and exits into the loop.
+  Node* vector_loop = l.loop->InputAt(0)->InputAt(0)->InputAt(1);
+  EXPECT_THAT(l.loop->InputAt(0),
+              IsIfFalse(IsBranch(
+                  IsInt32LessThan(IsInt32Add(_, IsInt32Constant(3)), length),
+                  vector_loop)));
+  EXPECT_THAT(l.phi->InputAt(0),
+              IsPhi(MachineRepresentation::kWord32, IsInt32Constant(0),
+                    IsInt32Add(_, IsInt32Constant(4)), vector_loop));
+
+  // The elements are stored as one vector.
+  Node* vector_effect_phi = l.effect_phi->InputAt(0);
+  ASSERT_EQ(IrOpcode::kEffectPhi, vector_effect_phi->opcode());
+  Node* store = vector_effect_phi->InputAt(1);
+  ASSERT_EQ(IrOpcode::kStore, store->opcode());
+  EXPECT_EQ(MachineRepresentation::kSimd128,
+            StoreRepresentationOf(store->op()).representation());
+  EXPECT_EQ(c.external, store->InputAt(0));
+  Node* value = store->InputAt(2);
+  ASSERT_EQ(IrOpcode::kI32x4Add, value->opcode());
+  for (int i = 0; i < 2; ++i) {
+    Node* load = value->InputAt(i);
+    ASSERT_EQ(IrOpcode::kLoad, load->opcode());
+    EXPECT_EQ(MachineType::Simd128(), LoadRepresentationOf(load->op()));
+  }
+
+  // Both loaded arrays are checked for overlap with the stored array.
+  Node* retain = NodeProperties::GetEffectInput(store);
+  ASSERT_EQ(IrOpcode::kRetain, retain->opcode());
+  Node* check = NodeProperties::GetEffectInput(retain);
+  EXPECT_EQ(IrOpcode::kCheckIf, check->opcode());
+  EXPECT_EQ(IrOpcode::kCheckIf,
+            NodeProperties::GetEffectInput(check)->opcode());
+}
+
+TEST_F(LoopVectorizationTest, VectorizeFloat32Mul) {
+  Node* length = Parameter(0);
+  TypedArray a = NewTypedArray(1);
+  TypedArray b = NewTypedArray(3);
+  CountingLoop l = NewCountingLoop(length);
+  Node* effect = l.checkpoint;
+  Node* index = CheckBounds(l, length, &effect);
+  Node* x = LoadElement(l, kExternalFloat32Array, a, index, &effect);
+  Node* product = graph()->NewNode(
+      machine()->TruncateFloat64ToFloat32(),
+      graph()->NewNode(
+          machine()->Float64Mul(),
+          graph()->NewNode(machine()->ChangeFloat32ToFloat64(), x),
+          Float64Constant(0.5)));
+  StoreElement(l, kExternalFloat32Array, b, index, product, &effect);
+  Finish(l, effect, Int32Constant(0));
+
+  Run();
+
+  Node* store = l.effect_phi->InputAt(0)->InputAt(1);
+  ASSERT_EQ(IrOpcode::kStore, store->opcode());
+  Node* value = store->InputAt(2);
+  ASSERT_EQ(IrOpcode::kF32x4Mul, value->opcode());
+  EXPECT_EQ(IrOpcode::kLoad, value->InputAt(0)->opcode());
+  EXPECT_EQ(IrOpcode::kF32x4Splat, value->InputAt(1)->opcode());
+}
+
+TEST_F(LoopVectorizationTest, VectorizeOnHeapTypedArray) {
+  Node* length = Parameter(0);
+  TypedArray a = NewTypedArray(1);
+  TypedArray b = NewTypedArray(3);
+  // The base pointers of arrays whose elements may be on the heap.
+  FieldAccess const access = AccessBuilder::ForFixedTypedArrayBaseBasePointer();
+  a.base = graph()->NewNode(simplified()->LoadField(access), Parameter(5),
+                            start(), start());
+  b.base = graph()->NewNode(simplified()->LoadField(access), Parameter(6),
+                            a.base, start());
+  CountingLoop l = NewCountingLoop(length);
+  Node* effect = l.checkpoint;
+  Node* index = CheckBounds(l, length, &effect);
+  Node* x = LoadElement(l, kExternalFloat32Array, a, index, &effect);
+  Node* product = graph()->NewNode(
+      machine()->TruncateFloat64ToFloat32(),
+      graph()->NewNode(
+          machine()->Float64Mul(),
+          graph()->NewNode(machine()->ChangeFloat32ToFloat64(), x),
+          Float64Constant(0.5)));
+  StoreElement(l, kExternalFloat32Array, b, index, product, &effect);
+  Finish(l, effect, Int32Constant(0));
+
+  Run();
+
+  // The storage pointers are computed on the effect chain of the accesses.
+  Node* store = l.effect_phi->InputAt(0)->InputAt(1);
+  ASSERT_EQ(IrOpcode::kStore, store->opcode());
+  Node* store_storage = store->InputAt(0);
+  ASSERT_EQ(IrOpcode::kUnsafePointerAdd, store_storage->opcode());
+  EXPECT_EQ(b.base, store_storage->InputAt(0));
+  EXPECT_EQ(b.external, store_storage->InputAt(1));
+  bool on_effect_chain = false;
+  for (Node* node = store; node->op()->EffectInputCount() == 1;
+       node = NodeProperties::GetEffectInput(node)) {
+    if (node == store_storage) on_effect_chain = true;
+  }
+  EXPECT_TRUE(on_effect_chain);
+
+  Node* load = store->InputAt(2)->InputAt(0);
+  ASSERT_EQ(IrOpcode::kLoad, load->opcode());
+  Node* load_storage = load->InputAt(0);
+  ASSERT_EQ(IrOpcode::kUnsafePointerAdd, load_storage->opcode());
+  EXPECT_EQ(a.base, load_storage->InputAt(0));
+  EXPECT_EQ(a.external, load_storage->InputAt(1));
+  EXPECT_EQ(load_storage, NodeProperties::GetEffectInput(load));
+  EXPECT_EQ(IrOpcode::kRetain,
+            NodeProperties::GetEffectInput(load_storage)->opcode());
+}
+
+TEST_F(LoopVectorizationTest, VectorizeInt32Sum) {
+  Node* length = Parameter(0);
+  TypedArray a = NewTypedArray(1);
+  CountingLoop l = NewCountingLoop(length);
+  Node* effect = l.checkpoint;
+  Node* index = CheckBounds(l, length, &effect);
+  Node* x = LoadElement(l, kExternalInt32Array, a, index, &effect);
+  Node* sum = NewPhi(l, Int32Constant(0));
+  sum->ReplaceInput(1, graph()->NewNode(machine()->Int32Add(), sum, x));
+  Finish(l, effect, sum);
+
+  Run();
+
+  // The loop continues with the sum of all lanes.
+  Node* entry = sum->InputAt(0);
+  for (int lane = 3; lane >= 0; --lane) {
+    ASSERT_EQ(IrOpcode::kInt32Add, entry->opcode());
+    Node* extract = entry->InputAt(1);
+    ASSERT_EQ(IrOpcode::kI32x4ExtractLane, extract->opcode());
+    EXPECT_EQ(lane, OpParameter<int32_t>(extract));
+    EXPECT_EQ(IrOpcode::kI32x4Add, extract->InputAt(0)->InputAt(1)->opcode());
+    entry = entry->InputAt(0);
+  }
+  EXPECT_THAT(entry, IsInt32Constant(0));
+}
+
+TEST_F(LoopVectorizationTest, KeepLoopWithShiftedIndex) {
+  Node* length = Parameter(0);
+  TypedArray a = NewTypedArray(1);
+  TypedArray b = NewTypedArray(3);
+  CountingLoop l = NewCountingLoop(length);
+  Node* effect = l.checkpoint;
+  Node* index = CheckBounds(l, length, &effect);
+  Node* next = graph()->NewNode(simplified()->CheckBounds(),
+                                graph()->NewNode(machine()->Int32Add(), l.phi,
+                                                 Int32Constant(1)),
+                                length, effect, l.if_true);
+  effect = next;
+  Node* x = LoadElement(l, kExternalInt32Array, a, next, &effect);
+  StoreElement(l, kExternalInt32Array, b, index, x, &effect);
+  Finish(l, effect, Int32Constant(0));
+
+  Run();
+
+  EXPECT_EQ(start(), l.loop->InputAt(0));
+  EXPECT_EQ(start(), l.effect_phi->InputAt(0));
+}
+
+TEST_F(LoopVectorizationTest, KeepLoopWithStoreBeforeCheck) {
+  Node* length = Parameter(0);
+  TypedArray a = NewTypedArray(1);
+  TypedArray b = NewTypedArray(3);
+  CountingLoop l = NewCountingLoop(length);
+  Node* effect = l.checkpoint;
+  Node* index = CheckBounds(l, length, &effect);
+  Node* x = LoadElement(l, kExternalInt32Array, a, index, &effect);
+  StoreElement(l, kExternalInt32Array, b, index, x, &effect);
+  CheckBounds(l, Parameter(5), &effect);
+  Finish(l, effect, Int32Constant(0));
+
+  Run();
+
+  EXPECT_EQ(start(), l.loop->InputAt(0));
+}
+
+}  // namespace compiler
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,211 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/compiler/memory-optimizer.h"
+#include "src/compiler/access-builder.h"
+#include "src/compiler/all-nodes.h"
+#include "src/compiler/js-graph.h"
+#include "src/compiler/js-operator.h"
+#include "src/compiler/machine-operator.h"
+#include "src/compiler/node-properties.h"
+#include "src/compiler/simplified-operator.h"
+#include "test/unittests/compiler/graph-unittest.h"
+#include "test/unittests/compiler/node-test-utils.h"
+
+namespace v8 {
+namespace internal {
+namespace compiler {
+
+class MemoryOptimizerTest : public GraphTest {
+ public:
+  MemoryOptimizerTest()
+      : GraphTest(3),
+        javascript_(zone()),
+        machine_(zone()),
+        simplified_(zone()),
+        jsgraph_(isolate(), graph(), common(), &javascript_, &simplified_,
+                 &machine_) {}
+  ~MemoryOptimizerTest() override {}
+
+ protected:
+  void Optimize() {
+    MemoryOptimizer optimizer(jsgraph(), zone());
+    optimizer.Optimize();
+  }
+
+  Node* Allocate(Node* size, PretenureFlag pretenure, Node* effect,
+                 Node* control) {
+    return graph()->NewNode(simplified()->Allocate(pretenure), size, effect,
+                            control);
+  }
+
+  Node* Allocate(int size, PretenureFlag pretenure, Node* effect,
+                 Node* control) {
+    return Allocate(Int32Constant(size), pretenure, effect, control);
+  }
+
+  // Makes {value} and {effect} live by returning them from the graph.
+  void Return(Node* value, Node* effect, Node* control) {
+    Node* ret = graph()->NewNode(common()->Return(), Int32Constant(0), value,
+                                 effect, control);
+    end()->ReplaceInput(0, ret);
+  }
+
+  // Returns the number of limit checks, i.e. loads of the allocation limit,
+  // for the space selected by {pretenure}.
+  int CountLimitLoads(PretenureFlag pretenure) {
+    ExternalReference const limit_address =
+        pretenure == NOT_TENURED
+            ? ExternalReference::new_space_allocation_limit_address(isolate())
+            : ExternalReference::old_space_allocation_limit_address(
+                  isolate());
+    AllNodes all(zone(), graph());
+    int count = 0;
+    for (Node* node : all.reachable) {
+      if (node->opcode() != IrOpcode::kLoad) continue;
+      Node* const base = node->InputAt(0);
+      if (base->opcode() == IrOpcode::kExternalConstant &&
+          OpParameter<ExternalReference>(base) == limit_address) {
+        count++;
+      }
+    }
+    return count;
+  }
+
+  // Returns the pointer Phis on {merge}.
+  NodeVector PointerPhis(Node* merge) {
+    NodeVector phis(zone());
+    AllNodes all(zone(), graph());
+    for (Node* node : all.reachable) {
+      if (node->opcode() == IrOpcode::kPhi &&
+          NodeProperties::GetControlInput(node) == merge &&
+          PhiRepresentationOf(node->op()) ==
+              MachineType::PointerRepresentation()) {
+        phis.push_back(node);
+      }
+    }
+    return phis;
+  }
+
+  bool HasReachableInt32Constant(int32_t value) {
+    AllNodes all(zone(), graph());
+    for (Node* node : all.reachable) {
+      if (node->opcode() == IrOpcode::kInt32Constant &&
+          OpParameter<int32_t>(node) == value) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  JSGraph* jsgraph() { return &jsgraph_; }
+  MachineOperatorBuilder* machine() { return &machine_; }
+  SimplifiedOperatorBuilder* simplified() { return &simplified_; }
+
+ private:
+  JSOperatorBuilder javascript_;
+  MachineOperatorBuilder machine_;
+  SimplifiedOperatorBuilder simplified_;
+  JSGraph jsgraph_;
+};
+
+// -----------------------------------------------------------------------------
+// Allocation folding across merges.
+
+TEST_F(MemoryOptimizerTest, DiamondWithAllocationsOnBothArms) {
+  Node* a = Allocate(16, NOT_TENURED, start(), start());
+  Node* branch = graph()->NewNode(common()->Branch(), Parameter(0), start());
+  Node* if_true = graph()->NewNode(common()->IfTrue(), branch);
+  Node* if_false = graph()->NewNode(common()->IfFalse(), branch);
+  Node* b = Allocate(16, NOT_TENURED, a, if_true);
+  Node* c = Allocate(32, NOT_TENURED, a, if_false);
+  Node* merge = graph()->NewNode(common()->Merge(2), if_true, if_false);
+  Node* effect_phi = graph()->NewNode(common()->EffectPhi(2), b, c, merge);
+  Node* d = Allocate(16, NOT_TENURED, effect_phi, merge);
+  Return(d, d, merge);
+
+  Optimize();
+
+  // All four allocations share the limit check of {a}, whose reservation
+  // covers the larger arm.
+  EXPECT_EQ(1, CountLimitLoads(NOT_TENURED));
+  EXPECT_EQ(0, CountLimitLoads(TENURED));
+  EXPECT_TRUE(HasReachableInt32Constant(16 + 32 + 16));
+
+  // The tops of the arms are merged by a Phi that {d} bumps.
+  NodeVector phis = PointerPhis(merge);
+  ASSERT_EQ(1u, phis.size());
+  Node* top = phis[0];
+  EXPECT_EQ(machine()->IntAdd()->opcode(), top->InputAt(0)->opcode());
+  EXPECT_EQ(machine()->IntAdd()->opcode(), top->InputAt(1)->opcode());
+  bool bumped = false;
+  for (Node* use : top->uses()) {
+    if (use->opcode() == machine()->IntAdd()->opcode()) bumped = true;
+  }
+  EXPECT_TRUE(bumped);
+}
+
+TEST_F(MemoryOptimizerTest, DiamondWithAllocationOnOneArm) {
+  Node* a = Allocate(16, NOT_TENURED, start(), start());
+  Node* branch = graph()->NewNode(common()->Branch(), Parameter(0), start());
+  Node* if_true = graph()->NewNode(common()->IfTrue(), branch);
+  Node* if_false = graph()->NewNode(common()->IfFalse(), branch);
+  Node* b = Allocate(16, NOT_TENURED, a, if_true);
+  Node* merge = graph()->NewNode(common()->Merge(2), if_true, if_false);
+  Node* effect_phi = graph()->NewNode(common()->EffectPhi(2), b, a, merge);
+  Node* d = Allocate(16, NOT_TENURED, effect_phi, merge);
+  Return(d, d, merge);
+
+  Optimize();
+
+  // The arm without allocations continues with the open state of {a}.
+  EXPECT_EQ(1, CountLimitLoads(NOT_TENURED));
+  EXPECT_EQ(1u, PointerPhis(merge).size());
+}
+
+TEST_F(MemoryOptimizerTest, DiamondWithUnfoldableAllocationOnOneArm) {
+  Node* a = Allocate(16, NOT_TENURED, start(), start());
+  Node* branch = graph()->NewNode(common()->Branch(), Parameter(0), start());
+  Node* if_true = graph()->NewNode(common()->IfTrue(), branch);
+  Node* if_false = graph()->NewNode(common()->IfFalse(), branch);
+  Node* b = Allocate(16, NOT_TENURED, a, if_true);
+  // An allocation of unknown size starts a closed group.
+  Node* c = Allocate(Parameter(1), NOT_TENURED, a, if_false);
+  Node* merge = graph()->NewNode(common()->Merge(2), if_true, if_false);
+  Node* effect_phi = graph()->NewNode(common()->EffectPhi(2), b, c, merge);
+  Node* d = Allocate(16, NOT_TENURED, effect_phi, merge);
+  Return(d, d, merge);
+
+  Optimize();
+
+  // The merge closes the group of {a}, so {d} needs its own limit check.
+  EXPECT_EQ(3, CountLimitLoads(NOT_TENURED));
+  EXPECT_EQ(0u, PointerPhis(merge).size());
+}
+
+// -----------------------------------------------------------------------------
+// Pretenuring.
+
+TEST_F(MemoryOptimizerTest, ChildrenOfTenuredAllocationAreTenured) {
+  FieldAccess const access = AccessBuilder::ForJSObjectProperties();
+  Node* parent = Allocate(16, TENURED, start(), start());
+  Node* child1 = Allocate(16, NOT_TENURED, parent, start());
+  Node* child2 = Allocate(16, NOT_TENURED, child1, start());
+  Node* store1 = graph()->NewNode(simplified()->StoreField(access), parent,
+                                  child1, child2, start());
+  Node* store2 = graph()->NewNode(simplified()->StoreField(access), parent,
+                                  child2, store1, start());
+  Return(parent, store2, start());
+
+  Optimize();
+
+  // Only one child is pretenured when {parent} is lowered; the other one
+  // sees the lowered {parent} in the tenured group. Both fold into it.
+  EXPECT_EQ(1, CountLimitLoads(TENURED));
+  EXPECT_EQ(0, CountLimitLoads(NOT_TENURED));
+}
+
+}  // namespace compiler
+}  // namespace internal
+}  // namespace v8
@@ -685,6 +685,107 @@ TEST_F(RegisterAllocatorTest, MultipleDeferredBlockSpills) {
             GetParallelMoveCount(start_of_b3, Instruction::START, sequence()));
 }
 
+class FastRegisterAllocatorTest : public RegisterAllocatorTest {
+ public:
+  FastRegisterAllocatorTest()
+      : saved_flag_(FLAG_turbo_fast_register_allocation) {
+    FLAG_turbo_fast_register_allocation = true;
+  }
+  ~FastRegisterAllocatorTest() override {
+    FLAG_turbo_fast_register_allocation = saved_flag_;
+  }
+
+ private:
+  bool saved_flag_;
+};
+
+TEST_F(FastRegisterAllocatorTest, CanAllocateThreeRegisters) {
+  StartBlock();
+  auto a_reg = Parameter();
+  auto b_reg = Parameter();
+  auto c_reg = EmitOI(Reg(1), Reg(a_reg, 1), Reg(b_reg, 0));
+  Return(c_reg);
+  EndBlock(Last());
+
+  Allocate();
+}
+
+TEST_F(FastRegisterAllocatorTest, SpillWhenOutOfRegisters) {
+  StartBlock();
+  VReg values[kDefaultNRegs + 2];
+  for (size_t i = 0; i < arraysize(values); ++i) {
+    values[i] = EmitOI(Reg());
+  }
+  for (size_t i = 0; i < arraysize(values); ++i) {
+    EmitI(Reg(values[i]));
+  }
+  EndBlock(Last());
+
+  Allocate();
+}
+
+TEST_F(FastRegisterAllocatorTest, SimpleLoop) {
+  StartBlock();
+  auto i_reg = DefineConstant();
+  EndBlock();
+
+  {
+    StartLoop(1);
+
+    StartBlock();
+    auto phi = Phi(i_reg, 2);
+    auto ipp = EmitOI(Same(), Reg(phi), Use(DefineConstant()));
+    SetInput(phi, 1, ipp);
+    EndBlock(Jump(0));
+
+    EndLoop();
+  }
+
+  Allocate();
+}
+
+TEST_F(FastRegisterAllocatorTest, SpillPhi) {
+  StartBlock();
+  EndBlock(Branch(Imm(), 1, 2));
+
+  StartBlock();
+  auto left = Define(Reg(0));
+  EndBlock(Jump(2));
+
+  StartBlock();
+  auto right = Define(Reg(0));
+  EndBlock();
+
+  StartBlock();
+  auto phi = Phi(left, right);
+  EmitCall(Slot(-1));
+  Return(Reg(phi));
+  EndBlock();
+
+  Allocate();
+}
+
+TEST_F(FastRegisterAllocatorTest, DiamondWithCall) {
+  StartBlock();
+  auto x = EmitOI(Reg(0));
+  EndBlock(Branch(Reg(x), 1, 2));
+
+  StartBlock();
+  EmitCall(Slot(-1));
+  auto occupy = EmitOI(Reg(0));
+  EndBlock(Jump(2));
+
+  StartBlock();
+  EndBlock(FallThrough());
+
+  StartBlock();
+  Use(occupy);
+  Return(Reg(x));
+  EndBlock();
+
+  Allocate();
+}
+
 namespace {
 
 enum class ParameterType { kFixedSlot, kSlot, kRegister, kFixedRegister };
@@ -0,0 +1,121 @@
+// Copyright 2017 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/heap/worklist.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace v8 {
+namespace internal {
+
+class SomeObject {};
+
+typedef Worklist<SomeObject*, 64> TestWorklist;
+
+TEST(WorkListTest, PushPop) {
+  TestWorklist worklist;
+  TestWorklist::View view(&worklist, 0);
+  SomeObject dummy;
+  SomeObject* retrieved = nullptr;
+  EXPECT_TRUE(view.Push(&dummy));
+  EXPECT_FALSE(view.IsLocalEmpty());
+  EXPECT_TRUE(view.Pop(&retrieved));
+  EXPECT_EQ(&dummy, retrieved);
+  EXPECT_TRUE(view.IsLocalEmpty());
+  EXPECT_FALSE(view.Pop(&retrieved));
+}
+
+TEST(WorkListTest, LocalPushStaysPrivate) {
+  TestWorklist worklist;
+  TestWorklist::View view1(&worklist, 0);
+  TestWorklist::View view2(&worklist, 1);
+  SomeObject dummy;
+  SomeObject* retrieved = nullptr;
+  EXPECT_TRUE(worklist.IsGlobalEmpty());
+  EXPECT_TRUE(view1.Push(&dummy));
+  EXPECT_FALSE(worklist.IsGlobalEmpty());
+  EXPECT_TRUE(worklist.IsGlobalPoolEmpty());
+  EXPECT_FALSE(view2.Pop(&retrieved));
+  EXPECT_EQ(nullptr, retrieved);
+  EXPECT_TRUE(view1.Pop(&retrieved));
+  EXPECT_EQ(&dummy, retrieved);
+  EXPECT_TRUE(worklist.IsGlobalEmpty());
+}
+
+TEST(WorkListTest, FlushToGlobalAndSteal) {
+  TestWorklist worklist;
+  TestWorklist::View view1(&worklist, 0);
+  TestWorklist::View view2(&worklist, 1);
+  SomeObject dummy;
+  SomeObject* retrieved = nullptr;
+  EXPECT_TRUE(view1.Push(&dummy));
+  view1.FlushToGlobal();
+  EXPECT_TRUE(view1.IsLocalEmpty());
+  EXPECT_FALSE(worklist.IsGlobalPoolEmpty());
+  EXPECT_TRUE(view2.Pop(&retrieved));
+  EXPECT_EQ(&dummy, retrieved);
+  EXPECT_TRUE(worklist.IsGlobalEmpty());
+}
+
+TEST(WorkListTest, FullSegmentIsPublished) {
+  TestWorklist worklist;
+  TestWorklist::View view1(&worklist, 0);
+  TestWorklist::View view2(&worklist, 1);
+  SomeObject dummy;
+  SomeObject* retrieved = nullptr;
+  // The first push after filling a segment publishes the full segment.
+  for (int i = 0; i <= TestWorklist::kSegmentCapacity; i++) {
+    EXPECT_TRUE(view1.Push(&dummy));
+  }
+  EXPECT_FALSE(worklist.IsGlobalPoolEmpty());
+  for (int i = 0; i < TestWorklist::kSegmentCapacity; i++) {
+    EXPECT_TRUE(view2.Pop(&retrieved));
+    EXPECT_EQ(&dummy, retrieved);
+  }
+  EXPECT_FALSE(view2.Pop(&retrieved));
+  EXPECT_TRUE(view1.Pop(&retrieved));
+  EXPECT_FALSE(view1.Pop(&retrieved));
+  EXPECT_TRUE(worklist.IsGlobalEmpty());
+}
+
+TEST(WorkListTest, Clear) {
+  TestWorklist worklist;
+  TestWorklist::View view(&worklist, 0);
+  SomeObject dummy;
+  for (int i = 0; i < 3 * TestWorklist::kSegmentCapacity; i++) {
+    EXPECT_TRUE(view.Push(&dummy));
+  }
+  EXPECT_FALSE(worklist.IsGlobalEmpty());
+  worklist.Clear();
+  EXPECT_TRUE(worklist.IsGlobalEmpty());
+}
+
+TEST(WorkListTest, Update) {
+  TestWorklist worklist;
+  TestWorklist::View view1(&worklist, 0);
+  TestWorklist::View view2(&worklist, 1);
+  SomeObject objects[3];
+  SomeObject* retrieved = nullptr;
+  // Fill more than one segment so that both the private segments and the
+  // global pool are updated.
+  for (int i = 0; i <= TestWorklist::kSegmentCapacity; i++) {
+    EXPECT_TRUE(view1.Push(&objects[0]));
+  }
+  EXPECT_TRUE(view2.Push(&objects[1]));
+  worklist.Update([&objects](SomeObject* object, SomeObject** out) {
+    if (object == &objects[1]) return false;
+    *out = &objects[2];
+    return true;
+  });
+  EXPECT_TRUE(view2.IsLocalEmpty());
+  for (int i = 0; i <= TestWorklist::kSegmentCapacity; i++) {
+    EXPECT_TRUE(view1.Pop(&retrieved));
+    EXPECT_EQ(&objects[2], retrieved);
+  }
+  EXPECT_FALSE(view1.Pop(&retrieved));
+  EXPECT_TRUE(worklist.IsGlobalEmpty());
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -56,5 +56,48 @@ TEST(TaskQueueTest, TerminateMultipleReaders) {
   thread2.Join();
 }
 
+
+TEST(TaskQueueTest, ShortRunningLaneFirst) {
+  TaskQueue queue;
+  MockTask long_task;
+  MockTask short_task;
+  queue.Append(&long_task, TaskQueue::kLongRunningLane);
+  queue.Append(&short_task, TaskQueue::kShortRunningLane);
+  EXPECT_EQ(&short_task, queue.GetNext());
+  EXPECT_EQ(&long_task, queue.GetNext());
+  queue.Terminate();
+  EXPECT_THAT(queue.GetNext(), IsNull());
+}
+
+
+TEST(TaskQueueTest, FifoWithinLane) {
+  TaskQueue queue;
+  static const int kNumTasks = 8;
+  MockTask long_tasks[kNumTasks];
+  MockTask short_tasks[kNumTasks];
+  for (int i = 0; i < kNumTasks; i++) {
+    queue.Append(&long_tasks[i], TaskQueue::kLongRunningLane);
+    queue.Append(&short_tasks[i], TaskQueue::kShortRunningLane);
+  }
+  // Short running tasks come first, and each lane keeps the order in which
+  // the tasks were appended.
+  for (int i = 0; i < kNumTasks; i++) {
+    EXPECT_EQ(&short_tasks[i], queue.GetNext());
+  }
+  for (int i = 0; i < kNumTasks; i++) {
+    EXPECT_EQ(&long_tasks[i], queue.GetNext());
+  }
+  BackgroundTaskQueueStatistics statistics;
+  queue.GetStatistics(&statistics);
+  EXPECT_EQ(static_cast<size_t>(kNumTasks),
+            statistics.short_running_tasks_run);
+  EXPECT_EQ(static_cast<size_t>(kNumTasks), statistics.long_running_tasks_run);
+  EXPECT_LE(0.0, statistics.total_queue_time_in_seconds);
+  EXPECT_LE(statistics.max_queue_time_in_seconds,
+            statistics.total_queue_time_in_seconds);
+  queue.Terminate();
+  EXPECT_THAT(queue.GetNext(), IsNull());
+}
+
 }  // namespace platform
 }  // namespace v8
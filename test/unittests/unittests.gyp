@@ -66,9 +66,12 @@
       'compiler/live-range-builder.h',
       'compiler/regalloc/live-range-unittest.cc',
       'compiler/load-elimination-unittest.cc',
+      'compiler/loop-bounds-check-elimination-unittest.cc',
       'compiler/loop-peeling-unittest.cc',
+      'compiler/loop-vectorization-unittest.cc',
       'compiler/machine-operator-reducer-unittest.cc',
       'compiler/machine-operator-unittest.cc',
+      'compiler/memory-optimizer-unittest.cc',
       'compiler/regalloc/move-optimizer-unittest.cc',
       'compiler/node-cache-unittest.cc',
       'compiler/node-matchers-unittest.cc',
@@ -127,6 +130,7 @@
       'heap/scavenge-job-unittest.cc',
       'heap/slot-set-unittest.cc',
       'heap/unmapper-unittest.cc',
+      'heap/worklist-unittest.cc',
       'locked-queue-unittest.cc',
       'object-unittest.cc',
       'register-configuration-unittest.cc',
@@ -25,11 +25,65 @@ TEST(Zone, SegmentPoolConstraints) {
     for (size_t power = 0; power < AccountingAllocator::kNumberBuckets;
          ++power) {
       total_size +=
-          allocator.unused_segments_max_sizes_[power] * (size_t(1) << power);
+          allocator.unused_segments_max_sizes_[power] *
+          (size_t(1) << (power + AccountingAllocator::kMinSegmentSizePower));
     }
     EXPECT_LE(total_size, size);
   }
 }
 
+TEST(Zone, SegmentPoolReuse) {
+  AccountingAllocator allocator;
+  size_t size = AccountingAllocator::RoundUpToSegmentSizeClass(10 * KB);
+  EXPECT_EQ(16 * KB, size);
+
+  Segment* segment = allocator.GetSegment(size);
+  EXPECT_EQ(0u, allocator.GetPoolHitCount());
+  EXPECT_EQ(1u, allocator.GetPoolMissCount());
+  allocator.ReturnSegment(segment);
+  EXPECT_EQ(size, allocator.GetCurrentPoolSize());
+
+  // Any request of the same size class is served from the pool.
+  segment = allocator.GetSegment(size - KB);
+  EXPECT_EQ(size, segment->size());
+  EXPECT_EQ(1u, allocator.GetPoolHitCount());
+  EXPECT_EQ(0u, allocator.GetCurrentPoolSize());
+  allocator.ReturnSegment(segment);
+
+  // Segments above the largest size class are not pooled.
+  size_t large = 1 * MB;
+  EXPECT_EQ(large, AccountingAllocator::RoundUpToSegmentSizeClass(large));
+  segment = allocator.GetSegment(large);
+  allocator.ReturnSegment(segment);
+  EXPECT_EQ(size, allocator.GetCurrentPoolSize());
+  EXPECT_EQ(1u, allocator.GetPoolMissCount());
+}
+
+TEST(Zone, SegmentPoolMemoryPressure) {
+  static const int kSegments = 4;
+  AccountingAllocator allocator;
+  size_t size = 8 * KB;
+  Segment* segments[kSegments];
+  for (int i = 0; i < kSegments; i++) segments[i] = allocator.GetSegment(size);
+  for (int i = 0; i < kSegments; i++) allocator.ReturnSegment(segments[i]);
+  EXPECT_EQ(kSegments * size, allocator.GetCurrentPoolSize());
+
+  // Moderate pressure trims the pool to half its capacity.
+  allocator.MemoryPressureNotification(MemoryPressureLevel::kModerate);
+  size_t capacity = allocator.unused_segments_max_sizes_[0] / 2;
+  EXPECT_EQ(capacity * size, allocator.GetCurrentPoolSize());
+
+  // Critical pressure releases all segments and disables pooling.
+  allocator.MemoryPressureNotification(MemoryPressureLevel::kCritical);
+  EXPECT_EQ(0u, allocator.GetCurrentPoolSize());
+  allocator.ReturnSegment(allocator.GetSegment(size));
+  EXPECT_EQ(0u, allocator.GetCurrentPoolSize());
+
+  allocator.MemoryPressureNotification(MemoryPressureLevel::kNone);
+  allocator.ReturnSegment(allocator.GetSegment(size));
+  EXPECT_EQ(size, allocator.GetCurrentPoolSize());
+  EXPECT_EQ(kSegments * size, allocator.GetMaxMemoryUsage());
+}
+
 }  // namespace internal
 }  // namespace v8